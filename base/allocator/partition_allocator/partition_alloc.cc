@@ -53,7 +53,10 @@ internal::PartitionRootBase::~PartitionRootBase() = default;
 PartitionRoot::PartitionRoot() = default;
 PartitionRoot::~PartitionRoot() = default;
 PartitionRootGeneric::PartitionRootGeneric() = default;
-PartitionRootGeneric::~PartitionRootGeneric() = default;
+PartitionRootGeneric::~PartitionRootGeneric() {
+  if (thread_cache_index >= 0)
+    internal::ThreadCache::DisableForPartition(this);
+}
 PartitionAllocatorGeneric::PartitionAllocatorGeneric() = default;
 PartitionAllocatorGeneric::~PartitionAllocatorGeneric() = default;
 
@@ -192,6 +195,13 @@ void PartitionRootGeneric::Init() {
   *bucket_ptr = internal::PartitionBucket::get_sentinel_bucket();
 }
 
+void PartitionRootGeneric::EnableThreadCache() {
+  DCHECK(initialized);
+  DCHECK_LT(thread_cache_index, 0);
+  thread_cache_index =
+      static_cast<int>(internal::ThreadCache::EnableForPartition(this));
+}
+
 bool PartitionReallocDirectMappedInPlace(PartitionRootGeneric* root,
                                          internal::PartitionPage* page,
                                          size_t raw_size) {
@@ -506,6 +516,11 @@ void PartitionRoot::PurgeMemory(int flags) {
 }
 
 void PartitionRootGeneric::PurgeMemory(int flags) {
+  // Give the cached slots back first, so that their pages can be decommitted
+  // or discarded if they become empty.
+  if (thread_cache_index >= 0)
+    internal::ThreadCache::PurgeForPartition(this);
+
   subtle::SpinLock::Guard guard(this->lock);
   if (flags & PartitionPurgeDecommitEmptyPages)
     DecommitEmptyPages();
@@ -633,6 +648,14 @@ void PartitionRootGeneric::DumpStats(const char* partition_name,
       else
         PartitionDumpBucketStats(&bucket_stats[i], bucket);
       if (bucket_stats[i].is_valid) {
+        if (i < internal::kThreadCacheNumBuckets) {
+          const uint32_t thread_cache_bytes =
+              this->thread_cached_slots[i] * bucket->slot_size;
+          DCHECK_LE(thread_cache_bytes, bucket_stats[i].active_bytes);
+          bucket_stats[i].active_bytes -= thread_cache_bytes;
+          bucket_stats[i].thread_cache_bytes = thread_cache_bytes;
+          stats.total_thread_cache_bytes += thread_cache_bytes;
+        }
         stats.total_resident_bytes += bucket_stats[i].resident_bytes;
         stats.total_active_bytes += bucket_stats[i].active_bytes;
         stats.total_decommittable_bytes += bucket_stats[i].decommittable_bytes;
@@ -33,6 +33,8 @@
 //
 // And for PartitionRootGeneric::Alloc():
 // - Multi-threaded use against a single partition is ok; locking is handled.
+// - Small allocations can be served from a per-thread cache, without locking,
+//   if the partition enables it. See PartitionRootGeneric::EnableThreadCache().
 // - Allocations of any arbitrary size can be handled (subject to a limit of
 // INT_MAX bytes for security reasons).
 // - Bucketing is by approximate size, for example an allocation of 4000 bytes
@@ -70,6 +72,7 @@
 #include "base/allocator/partition_allocator/partition_page.h"
 #include "base/allocator/partition_allocator/partition_root_base.h"
 #include "base/allocator/partition_allocator/spin_lock.h"
+#include "base/allocator/partition_allocator/thread_cache.h"
 #include "base/base_export.h"
 #include "base/bits.h"
 #include "base/compiler_specific.h"
@@ -141,10 +144,24 @@ struct BASE_EXPORT PartitionRootGeneric : public internal::PartitionRootBase {
       bucket_lookups[((kBitsPerSizeT + 1) * kGenericNumBucketsPerOrder) + 1] =
           {};
   internal::PartitionBucket buckets[kGenericNumBuckets] = {};
+  // The index of this partition in the thread caches, or -1 if it has none.
+  int thread_cache_index = -1;
+  // The number of slots of each of the first kThreadCacheNumBuckets buckets
+  // that are held by thread caches. They are allocated as far as the buckets
+  // are concerned, but DumpStats() doesn't report them as active.
+  uint32_t thread_cached_slots[internal::kThreadCacheNumBuckets] = {};
 
   // Public API.
   void Init();
 
+  // Makes each thread cache free slots of the small buckets of this partition,
+  // so that most small allocations and frees don't take |lock|. Costs each
+  // thread that uses the partition up to about
+  // kThreadCacheNumBuckets * kThreadCacheMaxBytesPerBucket bytes. Must be
+  // called after Init() and before the partition is used. At most
+  // kMaxThreadCachedPartitions partitions can have a thread cache at a time.
+  void EnableThreadCache();
+
   ALWAYS_INLINE void* Alloc(size_t size, const char* type_name);
   ALWAYS_INLINE void* AllocFlags(int flags, size_t size, const char* type_name);
   ALWAYS_INLINE void Free(void* ptr);
@@ -172,6 +189,8 @@ struct PartitionMemoryStats {
   size_t total_active_bytes;     // Total active bytes in the partition.
   size_t total_decommittable_bytes;  // Total bytes that could be decommitted.
   size_t total_discardable_bytes;    // Total bytes that could be discarded.
+  size_t total_thread_cache_bytes;   // Total bytes in free slots held by
+                                     // thread caches, not counted as active.
 };
 
 // Struct used to retrieve memory statistics about a partition bucket. Used by
@@ -194,6 +213,8 @@ struct PartitionBucketMemoryStats {
                                  // but not decommitted.
   uint32_t num_decommitted_pages;  // Number of pages that are empty
                                    // and decommitted.
+  uint32_t thread_cache_bytes;     // Total bytes in free slots held by thread
+                                   // caches, not counted as active.
 };
 
 // Interface that is passed to PartitionDumpStats and
@@ -367,8 +388,15 @@ ALWAYS_INLINE void* PartitionAllocGenericFlags(PartitionRootGeneric* root,
   size_t requested_size = size;
   size = internal::PartitionCookieSizeAdjustAdd(size);
   internal::PartitionBucket* bucket = PartitionGenericSizeToBucket(root, size);
+  internal::ThreadCache* thread_cache = nullptr;
+  if (root->thread_cache_index >= 0 &&
+      size <= internal::kThreadCacheMaxSlotSize) {
+    thread_cache = internal::ThreadCache::Get();
+  }
   void* ret = nullptr;
-  {
+  if (LIKELY(thread_cache)) {
+    ret = thread_cache->Alloc(root, bucket, flags, size);
+  } else {
     subtle::SpinLock::Guard guard(root->lock);
     ret = root->AllocFromBucket(bucket, flags, size);
   }
@@ -399,13 +427,21 @@ ALWAYS_INLINE void PartitionRootGeneric::Free(void* ptr) {
     return;
 
   PartitionAllocHooks::FreeHookIfEnabled(ptr);
-  ptr = internal::PartitionCookieFreePointerAdjust(ptr);
-  internal::PartitionPage* page = internal::PartitionPage::FromPointer(ptr);
+  void* slot = internal::PartitionCookieFreePointerAdjust(ptr);
+  internal::PartitionPage* page = internal::PartitionPage::FromPointer(slot);
   // TODO(palmer): See if we can afford to make this a CHECK.
   DCHECK(IsValidPage(page));
+  if (this->thread_cache_index >= 0 &&
+      page->bucket->slot_size <= internal::kThreadCacheMaxSlotSize) {
+    internal::ThreadCache* thread_cache = internal::ThreadCache::Get();
+    if (LIKELY(thread_cache)) {
+      thread_cache->Free(this, page->bucket, ptr);
+      return;
+    }
+  }
   {
     subtle::SpinLock::Guard guard(this->lock);
-    page->Free(ptr);
+    page->Free(slot);
   }
 #endif
 }
@@ -434,6 +470,77 @@ ALWAYS_INLINE size_t PartitionRootGeneric::ActualSize(size_t size) {
 #endif
 }
 
+ALWAYS_INLINE void* internal::ThreadCache::Alloc(PartitionRootGeneric* root,
+                                                 PartitionBucket* bucket,
+                                                 int flags,
+                                                 size_t size) {
+  DCHECK_LE(size, kThreadCacheMaxSlotSize);
+  if (UNLIKELY(should_purge_[root->thread_cache_index].load(
+          std::memory_order_relaxed))) {
+    Purge(root);
+  }
+
+  const size_t bucket_index = bucket - root->buckets;
+  DCHECK_LT(bucket_index, kThreadCacheNumBuckets);
+  Bucket& cached = buckets_[root->thread_cache_index][bucket_index];
+  if (UNLIKELY(!cached.freelist_head)) {
+    FillBucket(root, bucket_index, flags);
+    if (UNLIKELY(!cached.freelist_head))
+      return nullptr;
+  }
+
+  PartitionFreelistEntry* entry = cached.freelist_head;
+  cached.freelist_head = PartitionFreelistEntry::Transform(entry->next);
+  --cached.count;
+
+  // Fill the slot like PartitionRootBase::AllocFromBucket() does. Its leading
+  // cookie is intact, but the freelist link may have overwritten the trailing
+  // one.
+  char* ret = reinterpret_cast<char*>(entry);
+  if (flags & PartitionAllocZeroFill)
+    memset(ret, 0, PartitionCookieSizeAdjustSubtract(size));
+#if DCHECK_IS_ON()
+  const size_t no_cookie_size =
+      PartitionCookieSizeAdjustSubtract(bucket->slot_size);
+  if (!(flags & PartitionAllocZeroFill))
+    memset(ret, kUninitializedByte, no_cookie_size);
+  PartitionCookieWriteValue(ret + no_cookie_size);
+#endif
+  return ret;
+}
+
+ALWAYS_INLINE void internal::ThreadCache::Free(PartitionRootGeneric* root,
+                                               PartitionBucket* bucket,
+                                               void* ptr) {
+  DCHECK_LE(bucket->slot_size, kThreadCacheMaxSlotSize);
+  if (UNLIKELY(should_purge_[root->thread_cache_index].load(
+          std::memory_order_relaxed))) {
+    Purge(root);
+  }
+
+  const size_t bucket_index = bucket - root->buckets;
+  DCHECK_LT(bucket_index, kThreadCacheNumBuckets);
+  Bucket& cached = buckets_[root->thread_cache_index][bucket_index];
+
+#if DCHECK_IS_ON()
+  // Check the cookies and scribble over the slot as PartitionPage::Free()
+  // would, since that only happens once the slot leaves the cache.
+  char* slot = static_cast<char*>(PartitionCookieFreePointerAdjust(ptr));
+  PartitionCookieCheckValue(slot);
+  PartitionCookieCheckValue(slot + bucket->slot_size - kCookieSize);
+  memset(ptr, kFreedByte, PartitionCookieSizeAdjustSubtract(bucket->slot_size));
+#endif
+  CHECK(ptr != cached.freelist_head);  // Catches an immediate double free.
+  PartitionFreelistEntry* entry = static_cast<PartitionFreelistEntry*>(ptr);
+  entry->next = PartitionFreelistEntry::Transform(cached.freelist_head);
+  cached.freelist_head = entry;
+  ++cached.count;
+
+  const uint16_t limit = bucket_limits_[bucket_index];
+  if (UNLIKELY(cached.count >= limit))
+    ClearBucket(root, bucket_index, limit / 2);
+}
+
 template <size_t N>
 class SizeSpecificPartitionAllocator {
  public:
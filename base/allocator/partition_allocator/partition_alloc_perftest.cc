@@ -0,0 +1,145 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/allocator/partition_allocator/partition_alloc.h"
+#include "base/macros.h"
+#include "base/process/process_metrics.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#if !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+
+namespace base {
+
+namespace {
+
+constexpr int kIterations = 20000;
+constexpr size_t kBatchSize = 64;
+constexpr size_t kMaxSmallSize = 240;
+constexpr size_t kLargeSize = 4096;
+// One allocation in this many is of kLargeSize bytes.
+constexpr uint32_t kLargeAllocationPeriod = 32;
+
+// Allocates and frees batches of mostly small objects of varying sizes, as a
+// thread doing DOM or string work would.
+class AllocatingThread : public DelegateSimpleThread::Delegate {
+ public:
+  AllocatingThread(PartitionRootGeneric* root,
+                   uint32_t seed,
+                   WaitableEvent* start,
+                   WaitableEvent* can_exit)
+      : root_(root),
+        seed_(seed | 1),
+        start_(start),
+        can_exit_(can_exit),
+        done_(WaitableEvent::ResetPolicy::MANUAL,
+              WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void Run() override {
+    void* ptrs[kBatchSize];
+    start_->Wait();
+    for (int i = 0; i < kIterations; ++i) {
+      for (void*& ptr : ptrs)
+        ptr = root_->Alloc(NextSize(), "");
+      for (void* ptr : ptrs)
+        root_->Free(ptr);
+    }
+    done_.Signal();
+    // Exiting gives the thread cache back, so wait until memory is measured.
+    can_exit_->Wait();
+  }
+
+  void WaitUntilDone() { done_.Wait(); }
+
+ private:
+  size_t NextSize() {
+    // Xorshift, to draw sizes without locking.
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    if (seed_ % kLargeAllocationPeriod == 0)
+      return kLargeSize;
+    return 1 + seed_ % kMaxSmallSize;
+  }
+
+  PartitionRootGeneric* const root_;
+  uint32_t seed_;
+  WaitableEvent* const start_;
+  WaitableEvent* const can_exit_;
+  WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocatingThread);
+};
+
+void RunAllocFreeTest(size_t num_threads, bool use_thread_cache) {
+  PartitionAllocatorGeneric allocator;
+  allocator.init();
+  if (use_thread_cache)
+    allocator.root()->EnableThreadCache();
+
+  WaitableEvent start(WaitableEvent::ResetPolicy::MANUAL,
+                      WaitableEvent::InitialState::NOT_SIGNALED);
+  WaitableEvent can_exit(WaitableEvent::ResetPolicy::MANUAL,
+                         WaitableEvent::InitialState::NOT_SIGNALED);
+  std::vector<std::unique_ptr<AllocatingThread>> delegates;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    delegates.push_back(std::make_unique<AllocatingThread>(
+        allocator.root(), static_cast<uint32_t>(i + 1), &start, &can_exit));
+    threads.push_back(std::make_unique<DelegateSimpleThread>(
+        delegates.back().get(), "PartitionAllocPerfTest"));
+    threads.back()->Start();
+  }
+
+  const TimeTicks start_time = TimeTicks::Now();
+  start.Signal();
+  for (auto& delegate : delegates)
+    delegate->WaitUntilDone();
+  const TimeDelta elapsed = TimeTicks::Now() - start_time;
+
+  const std::string modifier = use_thread_cache ? "_thread_cache" : "";
+  const std::string trace = StringPrintf("%zu_threads", num_threads);
+  const double ops = 2.0 * num_threads * kIterations * kBatchSize;
+  perf_test::PrintResult("partition_alloc_alloc_free", modifier, trace,
+                         ops / elapsed.InSecondsF(), "runs/s", true);
+  perf_test::PrintResult(
+      "partition_alloc_committed", modifier, trace,
+      allocator.root()->total_size_of_committed_pages / 1024, "KiB", false);
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  perf_test::PrintResult(
+      "partition_alloc_rss", modifier, trace,
+      ProcessMetrics::CreateCurrentProcessMetrics()->GetResidentSetSize() /
+          1024,
+      "KiB", false);
+#endif
+
+  can_exit.Signal();
+  for (auto& thread : threads)
+    thread->Join();
+}
+
+}  // namespace
+
+TEST(PartitionAllocPerfTest, MultiThreadedAllocFree) {
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    RunAllocFreeTest(num_threads, false /* use_thread_cache */);
+    RunAllocFreeTest(num_threads, true /* use_thread_cache */);
+  }
+}
+
+}  // namespace base
+
+#endif  // !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
@@ -0,0 +1,225 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/partition_allocator/thread_cache.h"
+
+#include <algorithm>
+
+#include "base/allocator/partition_allocator/partition_alloc.h"
+#include "base/allocator/partition_allocator/spin_lock.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Guards the list of thread caches and |g_partitions|, and keeps the latter
+// alive while an exiting thread gives its slots back. Must not be acquired
+// while holding a partition lock.
+subtle::SpinLock& GetRegistryLock() {
+  static NoDestructor<subtle::SpinLock> registry_lock;
+  return *registry_lock;
+}
+
+ThreadCache* g_thread_caches = nullptr;
+PartitionRootGeneric* g_partitions[kMaxThreadCachedPartitions] = {};
+
+}  // namespace
+
+// static
+uint16_t ThreadCache::bucket_limits_[kThreadCacheNumBuckets] = {};
+
+// static
+ThreadCache* ThreadCache::Get() {
+  static NoDestructor<ThreadLocalStorage::Slot> thread_cache_tls(
+      &ThreadCache::Delete);
+  if (UNLIKELY(ThreadLocalStorage::HasBeenDestroyed()))
+    return nullptr;
+
+  ThreadCache* cache = static_cast<ThreadCache*>(thread_cache_tls->Get());
+  if (LIKELY(cache))
+    return cache;
+
+  // Allocated from the system heap, which doesn't use a thread cache.
+  cache = new ThreadCache();
+  thread_cache_tls->Set(cache);
+  return cache;
+}
+
+// static
+size_t ThreadCache::EnableForPartition(PartitionRootGeneric* root) {
+  DCHECK(root->initialized);
+  DCHECK_EQ(kThreadCacheMaxSlotSize,
+            root->buckets[kThreadCacheNumBuckets - 1].slot_size);
+
+  subtle::SpinLock::Guard guard(GetRegistryLock());
+  if (!bucket_limits_[0]) {
+    for (size_t i = 0; i < kThreadCacheNumBuckets; ++i) {
+      bucket_limits_[i] = static_cast<uint16_t>(
+          std::max(kThreadCacheMaxBytesPerBucket / root->buckets[i].slot_size,
+                   kThreadCacheMinSlotsPerBucket));
+    }
+  }
+
+  size_t index = 0;
+  while (index < kMaxThreadCachedPartitions && g_partitions[index])
+    ++index;
+  CHECK_LT(index, kMaxThreadCachedPartitions)
+      << "Too many partitions with a thread cache";
+  g_partitions[index] = root;
+  return index;
+}
+
+// static
+void ThreadCache::DisableForPartition(PartitionRootGeneric* root) {
+  subtle::SpinLock::Guard guard(GetRegistryLock());
+  const size_t index = root->thread_cache_index;
+  DCHECK_EQ(root, g_partitions[index]);
+  for (ThreadCache* cache = g_thread_caches; cache; cache = cache->next_) {
+    for (Bucket& bucket : cache->buckets_[index])
+      bucket = Bucket();
+    cache->should_purge_[index].store(false, std::memory_order_relaxed);
+  }
+  g_partitions[index] = nullptr;
+}
+
+// static
+void ThreadCache::PurgeForPartition(PartitionRootGeneric* root) {
+  ThreadCache* current = Get();
+  const size_t index = root->thread_cache_index;
+  {
+    subtle::SpinLock::Guard guard(GetRegistryLock());
+    for (ThreadCache* cache = g_thread_caches; cache; cache = cache->next_) {
+      if (cache != current)
+        cache->should_purge_[index].store(true, std::memory_order_relaxed);
+    }
+  }
+  // The caller uses |root|, so it can't be destroyed meanwhile.
+  if (current)
+    current->ClearPartition(root);
+}
+
+size_t ThreadCache::GetCachedSlotCountForTesting(
+    const PartitionRootGeneric* root) const {
+  size_t count = 0;
+  for (const Bucket& bucket : buckets_[root->thread_cache_index])
+    count += bucket.count;
+  return count;
+}
+
+ThreadCache::ThreadCache() {
+  subtle::SpinLock::Guard guard(GetRegistryLock());
+  next_ = g_thread_caches;
+  if (next_)
+    next_->prev_ = this;
+  g_thread_caches = this;
+}
+
+ThreadCache::~ThreadCache() {
+  subtle::SpinLock::Guard guard(GetRegistryLock());
+  if (prev_)
+    prev_->next_ = next_;
+  else
+    g_thread_caches = next_;
+  if (next_)
+    next_->prev_ = prev_;
+}
+
+// static
+void ThreadCache::Delete(void* cache_ptr) {
+  ThreadCache* cache = static_cast<ThreadCache*>(cache_ptr);
+  {
+    // The exiting thread may not use any of the partitions anymore, so only
+    // the registry lock keeps them from being destroyed meanwhile. This is
+    // the one place that takes partition locks under it.
+    subtle::SpinLock::Guard guard(GetRegistryLock());
+    for (PartitionRootGeneric* root : g_partitions) {
+      if (root)
+        cache->ClearPartition(root);
+    }
+  }
+  delete cache;
+}
+
+void ThreadCache::FillBucket(PartitionRootGeneric* root,
+                             size_t bucket_index,
+                             int flags) {
+  Bucket& cached = buckets_[root->thread_cache_index][bucket_index];
+  DCHECK(!cached.freelist_head);
+  PartitionBucket* bucket = &root->buckets[bucket_index];
+  const size_t count = std::max(bucket_limits_[bucket_index] / 2, 1);
+  // The slots are filled as they are handed out, so only pass on whether
+  // failing to allocate should crash.
+  const int fill_flags = flags & PartitionAllocReturnNull;
+
+  subtle::SpinLock::Guard guard(root->lock);
+  for (size_t i = 0; i < count; ++i) {
+    void* ptr = root->AllocFromBucket(bucket, fill_flags, bucket->slot_size);
+    if (!ptr)
+      break;
+    PartitionFreelistEntry* entry = static_cast<PartitionFreelistEntry*>(ptr);
+    entry->next = PartitionFreelistEntry::Transform(cached.freelist_head);
+    cached.freelist_head = entry;
+    ++cached.count;
+    ++root->thread_cached_slots[bucket_index];
+  }
+}
+
+void ThreadCache::ClearBucket(PartitionRootGeneric* root,
+                              size_t bucket_index,
+                              size_t count_to_keep) {
+  Bucket& cached = buckets_[root->thread_cache_index][bucket_index];
+  if (cached.count <= count_to_keep)
+    return;
+
+  // Keep the most recently freed slots, which are at the head of the list and
+  // the most likely to still be in the CPU cache.
+  PartitionFreelistEntry* entry = cached.freelist_head;
+  PartitionFreelistEntry* last_kept = nullptr;
+  for (size_t i = 0; i < count_to_keep; ++i) {
+    last_kept = entry;
+    entry = PartitionFreelistEntry::Transform(entry->next);
+  }
+  if (last_kept)
+    last_kept->next = PartitionFreelistEntry::Transform(nullptr);
+  else
+    cached.freelist_head = nullptr;
+  cached.count = static_cast<uint16_t>(count_to_keep);
+
+#if DCHECK_IS_ON()
+  const size_t slot_size = root->buckets[bucket_index].slot_size;
+#endif
+  subtle::SpinLock::Guard guard(root->lock);
+  while (entry) {
+    PartitionFreelistEntry* next =
+        PartitionFreelistEntry::Transform(entry->next);
+    char* slot = static_cast<char*>(PartitionCookieFreePointerAdjust(entry));
+#if DCHECK_IS_ON()
+    // The freelist link overwrites the trailing cookie of slots too small for
+    // it. The other cookies were checked when the slot was cached.
+    PartitionCookieWriteValue(slot + slot_size - kCookieSize);
+#endif
+    PartitionPage::FromPointer(slot)->Free(slot);
+    DCHECK(root->thread_cached_slots[bucket_index]);
+    --root->thread_cached_slots[bucket_index];
+    entry = next;
+  }
+}
+
+void ThreadCache::ClearPartition(PartitionRootGeneric* root) {
+  for (size_t i = 0; i < kThreadCacheNumBuckets; ++i)
+    ClearBucket(root, i, 0);
+}
+
+void ThreadCache::Purge(PartitionRootGeneric* root) {
+  should_purge_[root->thread_cache_index].store(false,
+                                                std::memory_order_relaxed);
+  ClearPartition(root);
+}
+
+}  // namespace internal
+}  // namespace base
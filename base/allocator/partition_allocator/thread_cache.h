@@ -0,0 +1,152 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_ALLOCATOR_PARTITION_ALLOCATOR_THREAD_CACHE_H_
+#define BASE_ALLOCATOR_PARTITION_ALLOCATOR_THREAD_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/allocator/partition_allocator/partition_alloc_constants.h"
+#include "base/allocator/partition_allocator/partition_bucket.h"
+#include "base/allocator/partition_allocator/partition_freelist_entry.h"
+#include "base/base_export.h"
+#include "base/compiler_specific.h"
+#include "base/macros.h"
+
+namespace base {
+
+struct PartitionRootGeneric;
+
+namespace internal {
+
+// Slots of at most this size, cookies included, are cached per thread. It is
+// the first bucket of its order, so that the cached generic buckets, which are
+// sorted by slot size, are exactly the first kThreadCacheNumBuckets.
+static const size_t kThreadCacheMaxSlotSizeOrder = 9;
+static const size_t kThreadCacheMaxSlotSize =
+    1 << (kThreadCacheMaxSlotSizeOrder - 1);  // 256 bytes.
+static const size_t kThreadCacheNumBuckets =
+    (kThreadCacheMaxSlotSizeOrder - kGenericMinBucketedOrder) *
+        kGenericNumBucketsPerOrder +
+    1;
+
+// At most this many partitions can have a thread cache at a time.
+static const size_t kMaxThreadCachedPartitions = 4;
+
+// Each thread caches at most about this many bytes per bucket and partition,
+// and at least kThreadCacheMinSlotsPerBucket slots.
+static const size_t kThreadCacheMaxBytesPerBucket = 2048;
+static const size_t kThreadCacheMinSlotsPerBucket = 8;
+
+// A per-thread cache of the free slots of the small buckets of the generic
+// partitions that enabled it with PartitionRootGeneric::EnableThreadCache().
+// It serves most allocations and frees of those sizes without taking the
+// partition lock, which the threads sharing a partition would contend on.
+//
+// Slots move between a cache and its partition in batches: an empty bucket is
+// refilled to half its capacity, and a full one gives half of its slots back.
+// Slots in a cache are allocated as far as the partition is concerned, but
+// its statistics report them as thread cache bytes rather than active bytes.
+//
+// A thread's cache is given back when the thread exits, and
+// PartitionRootGeneric::PurgeMemory() empties the calling thread's cache of
+// the partition. Other threads only empty theirs on their next allocation or
+// free in that partition, as a cache is never touched by another thread while
+// its own may use it. A thread that stays idle, or stops using the partition,
+// keeps its slots, up to about kThreadCacheNumBuckets *
+// kThreadCacheMaxBytesPerBucket bytes, until it uses it again or exits.
+//
+// A partition with a thread cache must not be destroyed while other threads
+// still use it, which is already the case for any partition.
+class BASE_EXPORT ThreadCache {
+ public:
+  // Returns the cache of the current thread, creating it if needed. Returns
+  // nullptr if the thread is being torn down and can't have a cache anymore.
+  static ThreadCache* Get();
+
+  // Reserves a slot in every thread cache for |root|, and returns its index.
+  // CHECKs that fewer than kMaxThreadCachedPartitions partitions have one.
+  static size_t EnableForPartition(PartitionRootGeneric* root);
+
+  // Forgets the slots of |root| in every thread cache without giving them
+  // back, and releases its index. Called when |root| is destroyed.
+  static void DisableForPartition(PartitionRootGeneric* root);
+
+  // Gives the slots of |root| cached by the current thread back, and makes
+  // every other thread do the same on its next allocation or free in |root|.
+  // Threads that don't use |root| anymore keep their slots until they exit.
+  static void PurgeForPartition(PartitionRootGeneric* root);
+
+  // Returns a slot of |bucket| of |root| for an allocation of |size| bytes,
+  // cookies included, which must be at most kThreadCacheMaxSlotSize. Returns
+  // nullptr if the bucket can't be refilled and |flags| allows it. Defined in
+  // partition_alloc.h, as it needs PartitionRootGeneric.
+  ALWAYS_INLINE void* Alloc(PartitionRootGeneric* root,
+                            PartitionBucket* bucket,
+                            int flags,
+                            size_t size);
+
+  // Caches |ptr|, as returned by Alloc() or by the partition, which is a slot
+  // of |bucket| of |root|. Defined in partition_alloc.h.
+  ALWAYS_INLINE void Free(PartitionRootGeneric* root,
+                          PartitionBucket* bucket,
+                          void* ptr);
+
+  // Returns the number of slots of |root| cached by this thread.
+  size_t GetCachedSlotCountForTesting(const PartitionRootGeneric* root) const;
+
+ private:
+  struct Bucket {
+    PartitionFreelistEntry* freelist_head = nullptr;
+    uint16_t count = 0;
+  };
+
+  ThreadCache();
+  ~ThreadCache();
+
+  // The TLS destructor: gives all cached slots back and deletes |cache|.
+  static void Delete(void* cache);
+
+  // Refills the empty |bucket_index| of |root| from the partition. The
+  // partition counts the cached slots in |thread_cached_slots|, as it does
+  // the ones given back by ClearBucket(), under its lock.
+  void FillBucket(PartitionRootGeneric* root, size_t bucket_index, int flags);
+
+  // Gives slots of |bucket_index| of |root| back to the partition until
+  // |count_to_keep| remain.
+  void ClearBucket(PartitionRootGeneric* root,
+                   size_t bucket_index,
+                   size_t count_to_keep);
+
+  // Gives all the slots of |root| back.
+  void ClearPartition(PartitionRootGeneric* root);
+
+  // Gives all the slots of |root| back, as requested by another thread
+  // through |should_purge_|. Only takes the lock of |root|, which the caller
+  // uses and so keeps alive.
+  NOINLINE void Purge(PartitionRootGeneric* root);
+
+  // The maximum number of slots cached per bucket, which depends only on its
+  // slot size and so is the same for all partitions.
+  static uint16_t bucket_limits_[kThreadCacheNumBuckets];
+
+  Bucket buckets_[kMaxThreadCachedPartitions][kThreadCacheNumBuckets];
+
+  // Set by other threads to request a Purge() of each partition.
+  std::atomic<bool> should_purge_[kMaxThreadCachedPartitions] = {};
+
+  // The list of all thread caches. Guarded by the registry lock.
+  ThreadCache* next_ = nullptr;
+  ThreadCache* prev_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadCache);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_ALLOCATOR_PARTITION_ALLOCATOR_THREAD_CACHE_H_
@@ -0,0 +1,262 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/partition_allocator/thread_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/allocator/partition_allocator/partition_alloc.h"
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+
+namespace base {
+namespace internal {
+
+namespace {
+
+constexpr size_t kSmallSize = 32;
+constexpr size_t kLargeSize = 4 * kThreadCacheMaxSlotSize;
+
+// Records the active and thread cache bytes of a partition.
+class ActiveBytesDumper : public PartitionStatsDumper {
+ public:
+  ActiveBytesDumper() = default;
+
+  void PartitionDumpTotals(const char* partition_name,
+                           const PartitionMemoryStats* stats) override {
+    active_bytes_ = stats->total_active_bytes;
+    thread_cache_bytes_ = stats->total_thread_cache_bytes;
+  }
+
+  void PartitionsDumpBucketStats(
+      const char* partition_name,
+      const PartitionBucketMemoryStats* stats) override {}
+
+  size_t active_bytes() const { return active_bytes_; }
+  size_t thread_cache_bytes() const { return thread_cache_bytes_; }
+
+ private:
+  size_t active_bytes_ = 0;
+  size_t thread_cache_bytes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ActiveBytesDumper);
+};
+
+// Runs a callback on a new thread, and joins it.
+class CallbackThread : public PlatformThread::Delegate {
+ public:
+  explicit CallbackThread(OnceClosure callback)
+      : callback_(std::move(callback)) {}
+
+  void Run() {
+    PlatformThreadHandle handle;
+    ASSERT_TRUE(PlatformThread::Create(0, this, &handle));
+    PlatformThread::Join(handle);
+  }
+
+  void ThreadMain() override { std::move(callback_).Run(); }
+
+ private:
+  OnceClosure callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(CallbackThread);
+};
+
+class ThreadCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    allocator_.init();
+    root()->EnableThreadCache();
+  }
+
+  PartitionRootGeneric* root() { return allocator_.root(); }
+
+  size_t GetCachedSlotCount() {
+    return ThreadCache::Get()->GetCachedSlotCountForTesting(root());
+  }
+
+  size_t GetActiveBytes() {
+    ActiveBytesDumper dumper;
+    root()->DumpStats("test", true /* is_light_dump */, &dumper);
+    return dumper.active_bytes();
+  }
+
+  size_t GetThreadCacheBytes() {
+    ActiveBytesDumper dumper;
+    root()->DumpStats("test", true /* is_light_dump */, &dumper);
+    return dumper.thread_cache_bytes();
+  }
+
+ private:
+  PartitionAllocatorGeneric allocator_;
+};
+
+}  // namespace
+
+TEST_F(ThreadCacheTest, ReusesFreedSlot) {
+  void* ptr = root()->Alloc(kSmallSize, "");
+  ASSERT_TRUE(ptr);
+  // The first allocation refilled the bucket.
+  const size_t cached_count = GetCachedSlotCount();
+  EXPECT_LT(0u, cached_count);
+
+  root()->Free(ptr);
+  EXPECT_EQ(cached_count + 1, GetCachedSlotCount());
+
+  void* ptr2 = root()->Alloc(kSmallSize, "");
+  EXPECT_EQ(ptr, ptr2);
+  EXPECT_EQ(cached_count, GetCachedSlotCount());
+  root()->Free(ptr2);
+}
+
+TEST_F(ThreadCacheTest, ZeroFill) {
+  char* ptr = static_cast<char*>(root()->Alloc(kSmallSize, ""));
+  memset(ptr, 'A', kSmallSize);
+  root()->Free(ptr);
+
+  char* ptr2 = static_cast<char*>(
+      root()->AllocFlags(PartitionAllocZeroFill, kSmallSize, ""));
+  EXPECT_EQ(ptr, ptr2);
+  for (size_t i = 0; i < kSmallSize; ++i)
+    EXPECT_EQ(0, ptr2[i]);
+  root()->Free(ptr2);
+}
+
+TEST_F(ThreadCacheTest, LargeAllocationsAreNotCached) {
+  void* ptr = root()->Alloc(kLargeSize, "");
+  ASSERT_TRUE(ptr);
+  EXPECT_EQ(0u, GetCachedSlotCount());
+  root()->Free(ptr);
+  EXPECT_EQ(0u, GetCachedSlotCount());
+}
+
+TEST_F(ThreadCacheTest, CacheIsBounded) {
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 10000; ++i)
+    ptrs.push_back(root()->Alloc(kSmallSize, ""));
+  for (void* ptr : ptrs)
+    root()->Free(ptr);
+
+  // The slot size is at least kSmallSize.
+  EXPECT_GE(std::max(kThreadCacheMaxBytesPerBucket / kSmallSize,
+                     kThreadCacheMinSlotsPerBucket),
+            GetCachedSlotCount());
+}
+
+// Tests that cached slots are reported separately from active ones.
+TEST_F(ThreadCacheTest, Stats) {
+  void* ptr = root()->Alloc(kSmallSize, "");
+  const size_t slot_size =
+      PartitionPage::FromPointer(PartitionCookieFreePointerAdjust(ptr))
+          ->bucket->slot_size;
+  EXPECT_EQ(slot_size, GetActiveBytes());
+  EXPECT_EQ(GetCachedSlotCount() * slot_size, GetThreadCacheBytes());
+
+  root()->Free(ptr);
+  EXPECT_EQ(0u, GetActiveBytes());
+  EXPECT_EQ(GetCachedSlotCount() * slot_size, GetThreadCacheBytes());
+}
+
+TEST_F(ThreadCacheTest, PurgeMemory) {
+  void* ptr = root()->Alloc(kSmallSize, "");
+  root()->Free(ptr);
+  EXPECT_LT(0u, GetCachedSlotCount());
+  EXPECT_LT(0u, GetThreadCacheBytes());
+
+  root()->PurgeMemory(PartitionPurgeDecommitEmptyPages);
+  EXPECT_EQ(0u, GetCachedSlotCount());
+  EXPECT_EQ(0u, GetThreadCacheBytes());
+  EXPECT_EQ(0u, GetActiveBytes());
+}
+
+TEST_F(ThreadCacheTest, PurgeMemoryFromAnotherThread) {
+  void* ptr = root()->Alloc(kSmallSize, "");
+  const size_t cached_count = GetCachedSlotCount();
+  EXPECT_LT(0u, cached_count);
+
+  CallbackThread thread(BindOnce(
+      [](PartitionRootGeneric* root) {
+        root->PurgeMemory(PartitionPurgeDecommitEmptyPages);
+      },
+      root()));
+  thread.Run();
+  EXPECT_EQ(cached_count, GetCachedSlotCount());
+
+  // This thread gives its slots back on its next allocation or free.
+  root()->Free(ptr);
+  EXPECT_EQ(1u, GetCachedSlotCount());
+}
+
+// Tests that a purge request only applies to the partition it was made for.
+TEST_F(ThreadCacheTest, PurgeMemoryOfOtherPartition) {
+  PartitionAllocatorGeneric other_allocator;
+  other_allocator.init();
+  PartitionRootGeneric* other_root = other_allocator.root();
+  other_root->EnableThreadCache();
+  ThreadCache* cache = ThreadCache::Get();
+
+  void* ptr = root()->Alloc(kSmallSize, "");
+  void* other_ptr = other_root->Alloc(kSmallSize, "");
+  const size_t cached_count = GetCachedSlotCount();
+  const size_t other_cached_count =
+      cache->GetCachedSlotCountForTesting(other_root);
+
+  CallbackThread thread(BindOnce(
+      [](PartitionRootGeneric* root) {
+        root->PurgeMemory(PartitionPurgeDecommitEmptyPages);
+      },
+      root()));
+  thread.Run();
+
+  // Using the other partition doesn't purge this one.
+  other_root->Free(other_ptr);
+  EXPECT_EQ(other_cached_count + 1,
+            cache->GetCachedSlotCountForTesting(other_root));
+  EXPECT_EQ(cached_count, GetCachedSlotCount());
+
+  root()->Free(ptr);
+  EXPECT_EQ(1u, GetCachedSlotCount());
+  EXPECT_EQ(other_cached_count + 1,
+            cache->GetCachedSlotCountForTesting(other_root));
+}
+
+TEST_F(ThreadCacheTest, ThreadExitGivesSlotsBack) {
+  CallbackThread thread(BindOnce(
+      [](PartitionRootGeneric* root) {
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 100; ++i)
+          ptrs.push_back(root->Alloc(kSmallSize, ""));
+        for (void* ptr : ptrs)
+          root->Free(ptr);
+        EXPECT_LT(0u, ThreadCache::Get()->GetCachedSlotCountForTesting(root));
+      },
+      root()));
+  thread.Run();
+
+  EXPECT_EQ(0u, GetThreadCacheBytes());
+  EXPECT_EQ(0u, GetActiveBytes());
+}
+
+TEST_F(ThreadCacheTest, FreeOnAnotherThread) {
+  void* ptr = root()->Alloc(kSmallSize, "");
+  CallbackThread thread(BindOnce(
+      [](PartitionRootGeneric* root, void* ptr) { root->Free(ptr); }, root(),
+      ptr));
+  thread.Run();
+
+  root()->PurgeMemory(PartitionPurgeDecommitEmptyPages);
+  EXPECT_EQ(0u, GetActiveBytes());
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
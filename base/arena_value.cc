@@ -0,0 +1,327 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/arena_value.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "base/containers/flat_tree.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+
+namespace base {
+
+namespace {
+
+// The first block is big enough for small documents; blocks then double up to
+// kMaxBlockSize, so that a large tree takes few blocks without wasting much of
+// the last one.
+constexpr size_t kFirstBlockSize = 4 * 1024;
+constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+// Allocations of at least this size get a block of their own.
+constexpr size_t kLargeAllocationSize = kMaxBlockSize / 4;
+
+bool KeyLess(const ArenaValue::DictEntry& lhs,
+             const ArenaValue::DictEntry& rhs) {
+  return lhs.key < rhs.key;
+}
+
+}  // namespace
+
+// ValueArena //////////////////////////////////////////////////////////////////
+
+ValueArena::ValueArena() : next_block_size_(kFirstBlockSize) {}
+
+ValueArena::~ValueArena() = default;
+
+void* ValueArena::Allocate(size_t size, size_t alignment) {
+  DCHECK(alignment && !(alignment & (alignment - 1)));
+  DCHECK_LE(alignment, alignof(std::max_align_t));
+
+  allocated_bytes_ += size;
+  size_t padding = -reinterpret_cast<uintptr_t>(next_) & (alignment - 1);
+  if (size + padding > static_cast<size_t>(end_ - next_)) {
+    // Large allocations get a block of their own, so that the rest of the
+    // current block isn't wasted.
+    if (size >= kLargeAllocationSize)
+      return AllocateBlock(size);
+    const size_t block_size = std::max(size, next_block_size_);
+    next_ = AllocateBlock(block_size);
+    end_ = next_ + block_size;
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+    padding = 0;
+  }
+  char* result = next_ + padding;
+  next_ = result + size;
+  return result;
+}
+
+StringPiece ValueArena::CopyString(StringPiece string) {
+  if (string.empty())
+    return StringPiece();
+  char* copy = AllocateArray<char>(string.size());
+  memcpy(copy, string.data(), string.size());
+  return StringPiece(copy, string.size());
+}
+
+char* ValueArena::AllocateBlock(size_t size) {
+  // new[] returns memory aligned for any fundamental type.
+  blocks_.push_back(std::make_unique<char[]>(size));
+  reserved_bytes_ += size;
+  return blocks_.back().get();
+}
+
+// ArenaValue //////////////////////////////////////////////////////////////////
+
+ArenaValue::ArenaValue(bool in_bool)
+    : type_(Type::BOOLEAN), size_(0), bool_value_(in_bool) {}
+
+ArenaValue::ArenaValue(int in_int)
+    : type_(Type::INTEGER), size_(0), int_value_(in_int) {}
+
+ArenaValue::ArenaValue(double in_double)
+    : type_(Type::DOUBLE), size_(0), double_value_(in_double) {
+  if (!std::isfinite(double_value_)) {
+    NOTREACHED() << "Non-finite (i.e. NaN or positive/negative infinity) "
+                 << "values cannot be represented in JSON";
+    double_value_ = 0.0;
+  }
+}
+
+ArenaValue::ArenaValue(StringPiece in_string, ValueArena* arena)
+    : type_(Type::STRING),
+      size_(checked_cast<uint32_t>(in_string.size())),
+      string_data_(arena->CopyString(in_string).data()) {}
+
+ArenaValue::ArenaValue(span<const ArenaValue> in_list, ValueArena* arena)
+    : type_(Type::LIST), size_(checked_cast<uint32_t>(in_list.size())) {
+  ArenaValue* list = arena->AllocateArray<ArenaValue>(in_list.size());
+  std::copy(in_list.begin(), in_list.end(), list);
+  list_data_ = list;
+}
+
+ArenaValue::ArenaValue(span<DictEntry> in_dict, ValueArena* arena)
+    : type_(Type::DICTIONARY) {
+  // Mirror flat_map's construction from a vector with KEEP_LAST_OF_DUPES.
+  std::stable_sort(in_dict.begin(), in_dict.end(), &KeyLess);
+  auto end = internal::LastUnique(
+      in_dict.begin(), in_dict.end(),
+      [](const DictEntry& lhs, const DictEntry& rhs) {
+        return !KeyLess(lhs, rhs);
+      });
+  const size_t size = end - in_dict.begin();
+  size_ = checked_cast<uint32_t>(size);
+  DictEntry* dict = arena->AllocateArray<DictEntry>(size);
+  std::copy(in_dict.begin(), end, dict);
+  dict_data_ = dict;
+}
+
+bool ArenaValue::GetBool() const {
+  CHECK(is_bool());
+  return bool_value_;
+}
+
+int ArenaValue::GetInt() const {
+  CHECK(is_int());
+  return int_value_;
+}
+
+double ArenaValue::GetDouble() const {
+  if (is_double())
+    return double_value_;
+  if (is_int())
+    return int_value_;
+  CHECK(false);
+  return 0.0;
+}
+
+StringPiece ArenaValue::GetString() const {
+  CHECK(is_string());
+  return StringPiece(string_data_, size_);
+}
+
+span<const ArenaValue> ArenaValue::GetList() const {
+  CHECK(is_list());
+  return make_span(list_data_, size_);
+}
+
+span<const ArenaValue::DictEntry> ArenaValue::GetDict() const {
+  CHECK(is_dict());
+  return make_span(dict_data_, size_);
+}
+
+const ArenaValue* ArenaValue::FindKey(StringPiece key) const {
+  span<const DictEntry> dict = GetDict();
+  auto found = std::lower_bound(
+      dict.begin(), dict.end(), key,
+      [](const DictEntry& entry, StringPiece key) { return entry.key < key; });
+  if (found == dict.end() || found->key != key)
+    return nullptr;
+  return &found->value;
+}
+
+const ArenaValue* ArenaValue::FindKeyOfType(StringPiece key, Type type) const {
+  const ArenaValue* result = FindKey(key);
+  if (!result || result->type() != type)
+    return nullptr;
+  return result;
+}
+
+Value ArenaValue::ToValue() const {
+  switch (type_) {
+    case Type::NONE:
+      return Value();
+    case Type::BOOLEAN:
+      return Value(bool_value_);
+    case Type::INTEGER:
+      return Value(int_value_);
+    case Type::DOUBLE:
+      return Value(double_value_);
+    case Type::STRING:
+      return Value(GetString());
+    case Type::BINARY:
+      break;
+    case Type::DICTIONARY: {
+      std::vector<Value::DictStorage::value_type> storage;
+      storage.reserve(size_);
+      for (const DictEntry& entry : GetDict()) {
+        storage.emplace_back(entry.key.as_string(),
+                             std::make_unique<Value>(entry.value.ToValue()));
+      }
+      // The keys are already sorted and unique.
+      return Value(Value::DictStorage(std::move(storage), KEEP_LAST_OF_DUPES));
+    }
+    case Type::LIST: {
+      Value::ListStorage storage;
+      storage.reserve(size_);
+      for (const ArenaValue& item : GetList())
+        storage.push_back(item.ToValue());
+      return Value(std::move(storage));
+    }
+  }
+
+  NOTREACHED();
+  return Value();
+}
+
+// ArenaValue::DictBuilder /////////////////////////////////////////////////////
+
+ArenaValue::DictBuilder::DictBuilder(ValueArena* arena) : arena_(arena) {}
+
+ArenaValue::DictBuilder::~DictBuilder() = default;
+
+void ArenaValue::DictBuilder::Set(StringPiece key, ArenaValue value) {
+  entries_.push_back({arena_->CopyString(key), value});
+}
+
+ArenaValue ArenaValue::DictBuilder::Build() {
+  ArenaValue result(make_span(entries_), arena_);
+  entries_.clear();
+  return result;
+}
+
+// Comparisons /////////////////////////////////////////////////////////////////
+
+bool operator==(const ArenaValue& lhs, const ArenaValue& rhs) {
+  if (lhs.type() != rhs.type())
+    return false;
+
+  switch (lhs.type()) {
+    case ArenaValue::Type::NONE:
+      return true;
+    case ArenaValue::Type::BOOLEAN:
+      return lhs.GetBool() == rhs.GetBool();
+    case ArenaValue::Type::INTEGER:
+      return lhs.GetInt() == rhs.GetInt();
+    case ArenaValue::Type::DOUBLE:
+      return lhs.GetDouble() == rhs.GetDouble();
+    case ArenaValue::Type::STRING:
+      return lhs.GetString() == rhs.GetString();
+    case ArenaValue::Type::BINARY:
+      break;
+    case ArenaValue::Type::DICTIONARY: {
+      span<const ArenaValue::DictEntry> lhs_dict = lhs.GetDict();
+      span<const ArenaValue::DictEntry> rhs_dict = rhs.GetDict();
+      return lhs_dict.size() == rhs_dict.size() &&
+             std::equal(lhs_dict.begin(), lhs_dict.end(), rhs_dict.begin(),
+                        [](const ArenaValue::DictEntry& u,
+                           const ArenaValue::DictEntry& v) {
+                          return u.key == v.key && u.value == v.value;
+                        });
+    }
+    case ArenaValue::Type::LIST: {
+      span<const ArenaValue> lhs_list = lhs.GetList();
+      span<const ArenaValue> rhs_list = rhs.GetList();
+      return lhs_list.size() == rhs_list.size() &&
+             std::equal(lhs_list.begin(), lhs_list.end(), rhs_list.begin(),
+                        [](const ArenaValue& u, const ArenaValue& v) {
+                          return u == v;
+                        });
+    }
+  }
+
+  NOTREACHED();
+  return false;
+}
+
+bool operator!=(const ArenaValue& lhs, const ArenaValue& rhs) {
+  return !(lhs == rhs);
+}
+
+bool operator==(const ArenaValue& lhs, const Value& rhs) {
+  if (lhs.type() != rhs.type())
+    return false;
+
+  switch (lhs.type()) {
+    case ArenaValue::Type::NONE:
+      return true;
+    case ArenaValue::Type::BOOLEAN:
+      return lhs.GetBool() == rhs.GetBool();
+    case ArenaValue::Type::INTEGER:
+      return lhs.GetInt() == rhs.GetInt();
+    case ArenaValue::Type::DOUBLE:
+      return lhs.GetDouble() == rhs.GetDouble();
+    case ArenaValue::Type::STRING:
+      return lhs.GetString() == rhs.GetString();
+    case ArenaValue::Type::BINARY:
+      break;
+    case ArenaValue::Type::DICTIONARY: {
+      span<const ArenaValue::DictEntry> lhs_dict = lhs.GetDict();
+      if (lhs_dict.size() != rhs.DictSize())
+        return false;
+      // Both are sorted by key.
+      auto lhs_it = lhs_dict.begin();
+      for (const auto& rhs_entry : rhs.DictItems()) {
+        if (lhs_it->key != rhs_entry.first || lhs_it->value != rhs_entry.second)
+          return false;
+        ++lhs_it;
+      }
+      return true;
+    }
+    case ArenaValue::Type::LIST: {
+      span<const ArenaValue> lhs_list = lhs.GetList();
+      const Value::ListStorage& rhs_list = rhs.GetList();
+      return lhs_list.size() == rhs_list.size() &&
+             std::equal(lhs_list.begin(), lhs_list.end(), rhs_list.begin(),
+                        [](const ArenaValue& u, const Value& v) {
+                          return u == v;
+                        });
+    }
+  }
+
+  NOTREACHED();
+  return false;
+}
+
+bool operator!=(const ArenaValue& lhs, const Value& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace base
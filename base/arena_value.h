@@ -0,0 +1,209 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// ArenaValue is a read-only counterpart of base::Value whose nodes, lists,
+// dictionary entries and strings are all allocated from a ValueArena. Building
+// a tree costs a pointer bump per node instead of a heap allocation per
+// dictionary entry and per string, and the whole tree is freed at once when
+// the arena is destroyed.
+//
+// This is meant for large trees that are inspected and thrown away, such as
+// the result of parsing a big JSON document to pick a few fields out of it.
+// Trees that are kept around or modified should be converted to a Value with
+// ToValue(), which makes a deep copy that no longer depends on the arena.
+//
+// EXAMPLE:
+//
+//   ValueArena arena;
+//   Optional<ArenaValue> root = JSONReader::ReadIntoArena(json, &arena);
+//   if (!root || !root->is_dict())
+//     return;
+//   const ArenaValue* version = root->FindKeyOfType("version",
+//                                                   ArenaValue::Type::STRING);
+//   const ArenaValue* settings = root->FindKey("settings");
+//   if (settings)
+//     settings_ = settings->ToValue();
+//
+//   // Dictionaries can also be built directly.
+//   ArenaValue::DictBuilder builder(&arena);
+//   builder.Set("name", ArenaValue("foo", &arena));
+//   builder.Set("count", ArenaValue(3));
+//   ArenaValue dict = builder.Build();
+//
+// ArenaValues are small, trivially copyable handles: copying one does not copy
+// the list, dictionary or string it refers to, and every ArenaValue that
+// refers to a ValueArena is invalidated when that arena is destroyed.
+
+#ifndef BASE_ARENA_VALUE_H_
+#define BASE_ARENA_VALUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+
+namespace base {
+
+// A bump allocator for ArenaValue trees. Memory is obtained from the heap in
+// blocks of increasing size, and is only returned when the arena is
+// destroyed.
+class BASE_EXPORT ValueArena {
+ public:
+  ValueArena();
+  ~ValueArena();
+
+  // Returns |size| bytes aligned to |alignment|, which must be a power of two
+  // no larger than alignof(std::max_align_t). Never returns null.
+  void* Allocate(size_t size, size_t alignment);
+
+  // Returns an uninitialized array of |count| Ts. T must be trivially
+  // destructible, since the arena never runs destructors.
+  template <typename T>
+  T* AllocateArray(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "The arena doesn't run destructors");
+    return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  // Returns a copy of |string| that lives as long as the arena.
+  StringPiece CopyString(StringPiece string);
+
+  // Returns the number of bytes handed out by Allocate().
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  // Returns the number of bytes the arena holds on the heap.
+  size_t EstimateMemoryUsage() const { return reserved_bytes_; }
+
+ private:
+  // Returns a new block of |size| bytes, owned by the arena.
+  char* AllocateBlock(size_t size);
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+
+  // The unused part of the current block.
+  char* next_ = nullptr;
+  char* end_ = nullptr;
+
+  // The size of the next block, which doubles up to a limit.
+  size_t next_block_size_;
+
+  size_t allocated_bytes_ = 0;
+  size_t reserved_bytes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueArena);
+};
+
+class BASE_EXPORT ArenaValue {
+ public:
+  using Type = Value::Type;
+  struct DictEntry;
+  class DictBuilder;
+
+  // A null value.
+  constexpr ArenaValue() : type_(Type::NONE), size_(0), int_value_(0) {}
+
+  explicit ArenaValue(bool in_bool);
+  explicit ArenaValue(int in_int);
+  explicit ArenaValue(double in_double);
+
+  // Strings, lists and dictionaries are copied into |arena|. Dictionaries
+  // keep the last of any duplicate keys, like a Value constructed from a
+  // DictStorage; |in_dict| is sorted in the process. The keys and values in
+  // |in_list| and |in_dict| must already live in |arena|.
+  ArenaValue(StringPiece in_string, ValueArena* arena);
+  ArenaValue(span<const ArenaValue> in_list, ValueArena* arena);
+  ArenaValue(span<DictEntry> in_dict, ValueArena* arena);
+
+  // Would otherwise pick the bool constructor; strings need an arena.
+  explicit ArenaValue(const char* in_string) = delete;
+
+  Type type() const { return type_; }
+
+  bool is_none() const { return type() == Type::NONE; }
+  bool is_bool() const { return type() == Type::BOOLEAN; }
+  bool is_int() const { return type() == Type::INTEGER; }
+  bool is_double() const { return type() == Type::DOUBLE; }
+  bool is_string() const { return type() == Type::STRING; }
+  bool is_dict() const { return type() == Type::DICTIONARY; }
+  bool is_list() const { return type() == Type::LIST; }
+
+  // These will all fatally assert if the type doesn't match.
+  bool GetBool() const;
+  int GetInt() const;
+  double GetDouble() const;  // Implicitly converts from int if necessary.
+  StringPiece GetString() const;
+  span<const ArenaValue> GetList() const;
+
+  // The entries are sorted by key.
+  span<const DictEntry> GetDict() const;
+
+  // Looks up |key| in the dictionary, in O(log(size)). Returns nullptr if it
+  // is missing, or if its value doesn't have type |type|.
+  // Note: These fatally assert if type() is not Type::DICTIONARY.
+  const ArenaValue* FindKey(StringPiece key) const;
+  const ArenaValue* FindKeyOfType(StringPiece key, Type type) const;
+
+  // Returns a deep copy of this value that is independent of the arena.
+  Value ToValue() const;
+
+ private:
+  Type type_;
+
+  // The length of a string, or the number of elements in a list or
+  // dictionary.
+  uint32_t size_;
+
+  union {
+    bool bool_value_;
+    int int_value_;
+    double double_value_;
+    const char* string_data_;
+    const ArenaValue* list_data_;
+    const DictEntry* dict_data_;
+  };
+};
+
+struct ArenaValue::DictEntry {
+  StringPiece key;
+  ArenaValue value;
+};
+
+// Collects the entries of a dictionary, copying their keys into the arena.
+// Setting a key that is already present replaces its value.
+class BASE_EXPORT ArenaValue::DictBuilder {
+ public:
+  explicit DictBuilder(ValueArena* arena);
+  ~DictBuilder();
+
+  void Set(StringPiece key, ArenaValue value);
+
+  // Returns the dictionary. The builder is left empty.
+  ArenaValue Build();
+
+ private:
+  ValueArena* const arena_;
+  std::vector<DictEntry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(DictBuilder);
+};
+
+BASE_EXPORT bool operator==(const ArenaValue& lhs, const ArenaValue& rhs);
+BASE_EXPORT bool operator!=(const ArenaValue& lhs, const ArenaValue& rhs);
+
+// Compares an ArenaValue to the Value it would convert to, without converting
+// it.
+BASE_EXPORT bool operator==(const ArenaValue& lhs, const Value& rhs);
+BASE_EXPORT bool operator!=(const ArenaValue& lhs, const Value& rhs);
+
+}  // namespace base
+
+#endif  // BASE_ARENA_VALUE_H_
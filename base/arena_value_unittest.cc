@@ -0,0 +1,148 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/arena_value.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(ValueArenaTest, Allocate) {
+  ValueArena arena;
+  EXPECT_EQ(0u, arena.EstimateMemoryUsage());
+
+  char* c = static_cast<char*>(arena.Allocate(1, 1));
+  double* d = arena.AllocateArray<double>(3);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(d) % alignof(double));
+  EXPECT_LE(c + 1, reinterpret_cast<char*>(d));
+  EXPECT_EQ(1 + 3 * sizeof(double), arena.allocated_bytes());
+  EXPECT_LE(arena.allocated_bytes(), arena.EstimateMemoryUsage());
+
+  // Fill several blocks; earlier allocations must stay intact.
+  std::vector<int*> ints;
+  for (int i = 0; i < 100000; ++i) {
+    ints.push_back(arena.AllocateArray<int>(1));
+    *ints.back() = i;
+  }
+  for (int i = 0; i < 100000; ++i)
+    ASSERT_EQ(i, *ints[i]);
+
+  // Large allocations get a block of their own.
+  const size_t before = arena.EstimateMemoryUsage();
+  char* large = static_cast<char*>(arena.Allocate(4 * 1024 * 1024, 1));
+  large[4 * 1024 * 1024 - 1] = 'x';
+  EXPECT_EQ(before + 4 * 1024 * 1024, arena.EstimateMemoryUsage());
+}
+
+TEST(ValueArenaTest, CopyString) {
+  ValueArena arena;
+  std::string original = "string";
+  StringPiece copy = arena.CopyString(original);
+  original[0] = 'S';
+  EXPECT_EQ("string", copy);
+  EXPECT_TRUE(arena.CopyString(StringPiece()).empty());
+}
+
+TEST(ArenaValueTest, TriviallyCopyable) {
+  static_assert(std::is_trivially_copyable<ArenaValue>::value,
+                "ArenaValue should be a cheap handle");
+  static_assert(std::is_trivially_destructible<ArenaValue::DictEntry>::value,
+                "Dictionary entries live in the arena");
+  EXPECT_LE(sizeof(ArenaValue), 16u);
+}
+
+TEST(ArenaValueTest, Scalars) {
+  ValueArena arena;
+  EXPECT_TRUE(ArenaValue().is_none());
+  EXPECT_TRUE(ArenaValue(true).GetBool());
+  EXPECT_EQ(-3, ArenaValue(-3).GetInt());
+  EXPECT_EQ(-3.0, ArenaValue(-3).GetDouble());
+  EXPECT_EQ(2.5, ArenaValue(2.5).GetDouble());
+  EXPECT_EQ("str", ArenaValue("str", &arena).GetString());
+  EXPECT_EQ(Value::Type::STRING, ArenaValue("", &arena).type());
+  EXPECT_EQ("", ArenaValue("", &arena).GetString());
+}
+
+TEST(ArenaValueTest, List) {
+  ValueArena arena;
+  std::vector<ArenaValue> items = {ArenaValue(1), ArenaValue("two", &arena)};
+  ArenaValue list(items, &arena);
+  items.clear();
+
+  ASSERT_TRUE(list.is_list());
+  ASSERT_EQ(2u, list.GetList().size());
+  EXPECT_EQ(1, list.GetList()[0].GetInt());
+  EXPECT_EQ("two", list.GetList()[1].GetString());
+
+  Value expected(Value::Type::LIST);
+  expected.GetList().emplace_back(1);
+  expected.GetList().emplace_back("two");
+  EXPECT_EQ(list, expected);
+  EXPECT_EQ(expected, list.ToValue());
+
+  EXPECT_TRUE(ArenaValue(span<const ArenaValue>(), &arena).GetList().empty());
+}
+
+TEST(ArenaValueTest, DictBuilder) {
+  ValueArena arena;
+  ArenaValue::DictBuilder builder(&arena);
+  std::string key = "b";
+  builder.Set(key, ArenaValue(1));
+  key = "a";
+  builder.Set(key, ArenaValue("x", &arena));
+  builder.Set("b", ArenaValue(2));
+  ArenaValue dict = builder.Build();
+
+  ASSERT_TRUE(dict.is_dict());
+  // Sorted, with the last of the duplicate keys.
+  ASSERT_EQ(2u, dict.GetDict().size());
+  EXPECT_EQ("a", dict.GetDict()[0].key);
+  EXPECT_EQ("b", dict.GetDict()[1].key);
+  EXPECT_EQ(2, dict.FindKey("b")->GetInt());
+  EXPECT_EQ("x", dict.FindKeyOfType("a", Value::Type::STRING)->GetString());
+  EXPECT_FALSE(dict.FindKeyOfType("a", Value::Type::INTEGER));
+  EXPECT_FALSE(dict.FindKey("c"));
+  EXPECT_FALSE(dict.FindKey(""));
+
+  // The builder can be reused.
+  builder.Set("nested", dict);
+  ArenaValue outer = builder.Build();
+  EXPECT_EQ(1u, outer.GetDict().size());
+  EXPECT_EQ(dict, *outer.FindKey("nested"));
+
+  Value expected(Value::Type::DICTIONARY);
+  expected.SetKey("a", Value("x"));
+  expected.SetKey("b", Value(2));
+  EXPECT_EQ(dict, expected);
+  EXPECT_EQ(expected, dict.ToValue());
+  expected.SetKey("b", Value(3));
+  EXPECT_NE(dict, expected);
+}
+
+TEST(ArenaValueTest, Comparisons) {
+  ValueArena arena;
+  EXPECT_EQ(ArenaValue(), ArenaValue());
+  EXPECT_EQ(ArenaValue("a", &arena), ArenaValue("a", &arena));
+  EXPECT_NE(ArenaValue("a", &arena), ArenaValue("b", &arena));
+  // Like Values, ints and doubles are different types.
+  EXPECT_NE(ArenaValue(1), ArenaValue(1.0));
+  EXPECT_NE(ArenaValue(1), Value(1.0));
+  EXPECT_EQ(ArenaValue(1.0), Value(1.0));
+  EXPECT_NE(ArenaValue(false), Value());
+
+  std::vector<ArenaValue> items = {ArenaValue(1)};
+  ArenaValue list(items, &arena);
+  EXPECT_EQ(list, ArenaValue(items, &arena));
+  items.push_back(ArenaValue(2));
+  EXPECT_NE(list, ArenaValue(items, &arena));
+}
+
+}  // namespace base
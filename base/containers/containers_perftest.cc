@@ -0,0 +1,153 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/containers/hash_map.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/trace_event/memory_usage_estimator.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// The number of operations timed for each measurement.
+constexpr size_t kOperationsPerMeasurement = 1 << 21;
+
+// Operations are timed in batches of at least this many, over as many maps as
+// needed, so that reading the clock doesn't skew the results for small maps.
+constexpr size_t kOperationsPerBatch = 1 << 12;
+
+// flat_map inserts and erases are O(size), so it is only measured up to this
+// size.
+constexpr size_t kMaxFlatMapSize = 4096;
+
+// The maps are from 64-bit keys, such as SimpleIndex's entry hashes, to
+// pointer-sized values.
+using Key = uint64_t;
+using Mapped = uintptr_t;
+
+// Returns |count| distinct pseudo-random keys.
+std::vector<Key> MakeKeys(size_t count, uint64_t seed) {
+  std::vector<Key> keys;
+  keys.reserve(count);
+  uint64_t state = seed;
+  while (keys.size() < count) {
+    // Xorshift*, so that the keys aren't in order.
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    keys.push_back(state * UINT64_C(0x2545F4914F6CDD1D));
+  }
+  return keys;
+}
+
+// Returns the average time in nanoseconds of |operations| that took |elapsed|
+// in total.
+double NanosecondsPerOperation(TimeDelta elapsed, size_t operations) {
+  return elapsed.InNanoseconds() / static_cast<double>(operations);
+}
+
+void PrintResult(const std::string& measurement,
+                 const std::string& container,
+                 size_t size,
+                 double value,
+                 const std::string& units) {
+  perf_test::PrintResult(measurement, "", StringPrintf("%s_%zu",
+                                                       container.c_str(), size),
+                         value, units, true);
+}
+
+// Measures inserting |size| keys into an empty |Map|, looking them up, looking
+// up absent keys, and erasing them, and the memory the map uses.
+template <class Map>
+void RunMapTest(const std::string& container, size_t size) {
+  const std::vector<Key> keys = MakeKeys(size, 1);
+  std::vector<Key> lookup_keys = keys;
+  std::reverse(lookup_keys.begin(), lookup_keys.end());
+  const std::vector<Key> absent_keys = MakeKeys(size, 2);
+  const size_t maps_per_batch = std::max<size_t>(1, kOperationsPerBatch / size);
+  const size_t batches =
+      std::max<size_t>(1, kOperationsPerMeasurement / (maps_per_batch * size));
+
+  TimeDelta insert_time;
+  TimeDelta hit_time;
+  TimeDelta miss_time;
+  TimeDelta erase_time;
+  size_t memory_usage = 0;
+  size_t found = 0;
+  for (size_t batch = 0; batch < batches; ++batch) {
+    std::vector<Map> maps(maps_per_batch);
+    TimeTicks start = TimeTicks::Now();
+    for (Map& map : maps) {
+      for (Key key : keys)
+        map.insert(std::make_pair(key, static_cast<Mapped>(key)));
+    }
+    insert_time += TimeTicks::Now() - start;
+
+    start = TimeTicks::Now();
+    for (const Map& map : maps) {
+      for (Key key : lookup_keys)
+        found += map.find(key) != map.end();
+    }
+    hit_time += TimeTicks::Now() - start;
+
+    start = TimeTicks::Now();
+    for (const Map& map : maps) {
+      for (Key key : absent_keys)
+        found += map.find(key) != map.end();
+    }
+    miss_time += TimeTicks::Now() - start;
+
+    memory_usage = sizeof(Map) + trace_event::EstimateMemoryUsage(maps[0]);
+
+    start = TimeTicks::Now();
+    for (Map& map : maps) {
+      for (Key key : lookup_keys)
+        map.erase(key);
+    }
+    erase_time += TimeTicks::Now() - start;
+    ASSERT_TRUE(maps[0].empty());
+  }
+  // The absent keys are all distinct from the present ones.
+  const size_t operations = batches * maps_per_batch * size;
+  ASSERT_EQ(operations, found);
+
+  PrintResult("map_insert", container, size,
+              NanosecondsPerOperation(insert_time, operations), "ns");
+  PrintResult("map_find_hit", container, size,
+              NanosecondsPerOperation(hit_time, operations), "ns");
+  PrintResult("map_find_miss", container, size,
+              NanosecondsPerOperation(miss_time, operations), "ns");
+  PrintResult("map_erase", container, size,
+              NanosecondsPerOperation(erase_time, operations), "ns");
+  PrintResult("map_memory_per_element", container, size,
+              static_cast<double>(memory_usage) / size, "bytes");
+}
+
+}  // namespace
+
+TEST(ContainersPerfTest, Maps) {
+  for (size_t size : {16, 256, 4096, 65536}) {
+    RunMapTest<std::map<Key, Mapped>>("std_map", size);
+    RunMapTest<std::unordered_map<Key, Mapped>>("std_unordered_map", size);
+    if (size <= kMaxFlatMapSize)
+      RunMapTest<flat_map<Key, Mapped>>("flat_map", size);
+    RunMapTest<HashMap<Key, Mapped>>("HashMap", size);
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,213 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_HASH_MAP_H_
+#define BASE_CONTAINERS_HASH_MAP_H_
+
+#include <functional>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "base/containers/flat_map.h"
+#include "base/containers/hash_table.h"
+#include "base/logging.h"
+
+namespace base {
+
+// HashMap is a container with a std::unordered_map-like interface that stores
+// its elements in one open-addressing array, probed a group of slots at a time
+// (see hash_table.h).
+//
+// Please see //base/containers/README.md for an overview of which container
+// to select.
+//
+// PROS
+//
+//  - Lookups touch one or two cache lines, and usually compare a single key.
+//  - No allocation per element: 1 byte of overhead per slot, with slots kept
+//    between 7/16 and 7/8 full.
+//  - Inserts and removals are O(1).
+//
+// CONS
+//
+//  - Larger than flat_map and small_map for small maps.
+//  - Iteration order is unspecified.
+//
+// IMPORTANT NOTES
+//
+//  - Iterators and references are invalidated by inserts, which may move
+//    every element. Erasing doesn't move other elements.
+//  - Elements must be move-constructible.
+//
+// QUICK REFERENCE
+//
+// Most of the core functionality is inherited from internal::HashTable. As a
+// quick reference, the functions available are:
+//
+// Constructors:
+//   HashMap(size_t bucket_count, const Hash& = Hash(),
+//           const KeyEqual& = KeyEqual());
+//   HashMap(InputIterator first, InputIterator last);
+//   HashMap(std::initializer_list<value_type>);
+//   HashMap(const HashMap&);
+//   HashMap(HashMap&&);
+//
+// Assignment functions:
+//   HashMap& operator=(const HashMap&);
+//   HashMap& operator=(HashMap&&);
+//   HashMap& operator=(initializer_list<value_type>);
+//
+// Memory management functions:
+//   void   reserve(size_t);
+//   size_t capacity() const;
+//
+// Size management functions:
+//   void   clear();
+//   size_t size() const;
+//   bool   empty() const;
+//
+// Iterator functions:
+//   iterator       begin();
+//   const_iterator begin() const;
+//   const_iterator cbegin() const;
+//   iterator       end();
+//   const_iterator end() const;
+//   const_iterator cend() const;
+//
+// Insert and accessor functions:
+//   mapped_type&         operator[](const key_type&);
+//   mapped_type&         operator[](key_type&&);
+//   mapped_type&         at(const key_type&);
+//   const mapped_type&   at(const key_type&) const;
+//   pair<iterator, bool> insert(const value_type&);
+//   pair<iterator, bool> insert(value_type&&);
+//   void                 insert(InputIterator first, InputIterator last);
+//   pair<iterator, bool> insert_or_assign(K&&, M&&);
+//   pair<iterator, bool> emplace(Args&&...);
+//   pair<iterator, bool> try_emplace(K&&, Args&&...);
+//
+// Erase functions:
+//   iterator erase(iterator);
+//   iterator erase(const_iterator);
+//   iterator erase(const_iterator first, const_iterator last);
+//   size_t   erase(const key_type&);
+//
+// Search functions:
+//   size_t         count(const key_type&) const;
+//   iterator       find(const key_type&);
+//   const_iterator find(const key_type&) const;
+//   bool           contains(const key_type&) const;
+//
+// General functions:
+//   void swap(HashMap&);
+//
+// Non-member operators:
+//   bool operator==(const HashMap&, const HashMap&);
+//   bool operator!=(const HashMap&, const HashMap&);
+//
+template <class Key,
+          class Mapped,
+          class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class HashMap : public ::base::internal::HashTable<
+                    Key,
+                    std::pair<Key, Mapped>,
+                    ::base::internal::GetKeyFromValuePairFirst<Key, Mapped>,
+                    Hash,
+                    KeyEqual> {
+ private:
+  using table = typename ::base::internal::HashTable<
+      Key,
+      std::pair<Key, Mapped>,
+      ::base::internal::GetKeyFromValuePairFirst<Key, Mapped>,
+      Hash,
+      KeyEqual>;
+
+ public:
+  using key_type = typename table::key_type;
+  using mapped_type = Mapped;
+  using value_type = typename table::value_type;
+  using iterator = typename table::iterator;
+  using const_iterator = typename table::const_iterator;
+
+  // --------------------------------------------------------------------------
+  // Lifetime and assignments.
+
+  HashMap() = default;
+  explicit HashMap(size_t bucket_count,
+                   const Hash& hash = Hash(),
+                   const KeyEqual& eq = KeyEqual())
+      : table(bucket_count, hash, eq) {}
+
+  template <class InputIterator>
+  HashMap(InputIterator first, InputIterator last) : table(first, last) {}
+
+  HashMap(std::initializer_list<value_type> ilist) : table(ilist) {}
+
+  HashMap(const HashMap&) = default;
+  HashMap(HashMap&&) noexcept = default;
+  ~HashMap() = default;
+
+  HashMap& operator=(const HashMap&) = default;
+  HashMap& operator=(HashMap&&) = default;
+  HashMap& operator=(std::initializer_list<value_type> ilist) {
+    table::operator=(ilist);
+    return *this;
+  }
+
+  // --------------------------------------------------------------------------
+  // Map-specific insert and accessor operations.
+  //
+  // Normal insert() functions are inherited from internal::HashTable.
+
+  mapped_type& operator[](const key_type& key) {
+    return try_emplace(key).first->second;
+  }
+  mapped_type& operator[](key_type&& key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  mapped_type& at(const key_type& key) {
+    iterator found = table::find(key);
+    CHECK(found != table::end());
+    return found->second;
+  }
+  const mapped_type& at(const key_type& key) const {
+    const_iterator found = table::find(key);
+    CHECK(found != table::end());
+    return found->second;
+  }
+
+  template <class K, class M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+    auto result = table::emplace_key_args(key, std::forward<K>(key),
+                                          std::forward<M>(obj));
+    if (!result.second)
+      result.first->second = std::forward<M>(obj);
+    return result;
+  }
+
+  template <class K, class... Args>
+  std::enable_if_t<std::is_constructible<key_type, K&&>::value,
+                   std::pair<iterator, bool>>
+  try_emplace(K&& key, Args&&... args) {
+    return table::emplace_key_args(
+        key, std::piecewise_construct,
+        std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  // --------------------------------------------------------------------------
+  // General operations.
+
+  void swap(HashMap& other) noexcept { table::swap(other); }
+
+  friend void swap(HashMap& lhs, HashMap& rhs) noexcept { lhs.swap(rhs); }
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_HASH_MAP_H_
@@ -0,0 +1,307 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/hash_map.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/test/move_only_int.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::UnorderedElementsAre;
+
+namespace base {
+
+namespace {
+
+int live_count = 0;
+
+// Counts its live instances.
+class Counted {
+ public:
+  explicit Counted(int value) : value_(value) { ++live_count; }
+  Counted(const Counted& other) : value_(other.value_) { ++live_count; }
+  Counted(Counted&& other) : value_(other.value_) { ++live_count; }
+  ~Counted() { --live_count; }
+
+  Counted& operator=(const Counted& other) = default;
+
+  int value() const { return value_; }
+
+ private:
+  int value_;
+};
+
+// Sends every key to the same probe sequence.
+struct ConstantHash {
+  size_t operator()(int) const { return 42; }
+};
+
+}  // namespace
+
+TEST(HashMap, Empty) {
+  HashMap<int, int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(0u, map.capacity());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.end(), map.find(1));
+  EXPECT_EQ(0u, map.count(1));
+  EXPECT_EQ(0u, map.erase(1));
+}
+
+TEST(HashMap, InsertFindErase) {
+  HashMap<int, std::string> map;
+  auto result = map.insert(std::make_pair(1, "one"));
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(1, result.first->first);
+  EXPECT_EQ("one", result.first->second);
+
+  result = map.insert(std::make_pair(1, "uno"));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("one", result.first->second);
+
+  EXPECT_TRUE(map.emplace(2, "two").second);
+  EXPECT_EQ(2u, map.size());
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_EQ("two", map.find(2)->second);
+  EXPECT_THAT(map, UnorderedElementsAre(std::make_pair(1, "one"),
+                                        std::make_pair(2, "two")));
+
+  EXPECT_EQ(1u, map.erase(1));
+  EXPECT_EQ(0u, map.erase(1));
+  EXPECT_EQ(map.end(), map.find(1));
+  EXPECT_THAT(map, UnorderedElementsAre(std::make_pair(2, "two")));
+}
+
+TEST(HashMap, InitializerList) {
+  HashMap<int, int> map = {{1, 10}, {2, 20}, {1, 30}};
+  EXPECT_THAT(map, UnorderedElementsAre(std::make_pair(1, 10),
+                                        std::make_pair(2, 20)));
+
+  map = {{3, 30}};
+  EXPECT_THAT(map, UnorderedElementsAre(std::make_pair(3, 30)));
+}
+
+TEST(HashMap, SubscriptAndAt) {
+  HashMap<std::string, int> map;
+  map["a"] = 1;
+  std::string b = "b";
+  map[b] = 2;
+  ++map["a"];
+  EXPECT_EQ(2, map["a"]);
+  EXPECT_EQ(2, map.at("b"));
+  const HashMap<std::string, int>& const_map = map;
+  EXPECT_EQ(2, const_map.at("a"));
+  EXPECT_EQ(0, map["c"]);
+  EXPECT_EQ(3u, map.size());
+}
+
+TEST(HashMap, TryEmplaceAndInsertOrAssign) {
+  HashMap<int, MoveOnlyInt> map;
+  auto result = map.try_emplace(1, 10);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(10, result.first->second.data());
+
+  // Doesn't construct a value for an existing key.
+  result = map.try_emplace(1, 20);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(10, result.first->second.data());
+
+  result = map.insert_or_assign(1, MoveOnlyInt(30));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(30, map.find(1)->second.data());
+
+  result = map.insert_or_assign(2, MoveOnlyInt(40));
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(40, map.find(2)->second.data());
+}
+
+TEST(HashMap, GrowsAndKeepsElements) {
+  HashMap<int, int> map;
+  for (int i = 0; i < 10000; ++i) {
+    EXPECT_TRUE(map.insert(std::make_pair(i, -i)).second);
+    // Never more than 7/8 full.
+    EXPECT_LE(map.size() * 8, map.capacity() * 7 + 7);
+  }
+  EXPECT_EQ(10000u, map.size());
+  for (int i = 0; i < 10000; ++i)
+    ASSERT_EQ(-i, map.find(i)->second);
+  EXPECT_EQ(map.end(), map.find(10000));
+
+  size_t iterated = 0;
+  for (const auto& pair : map) {
+    EXPECT_EQ(-pair.first, pair.second);
+    ++iterated;
+  }
+  EXPECT_EQ(10000u, iterated);
+}
+
+TEST(HashMap, Reserve) {
+  HashMap<int, int> map;
+  map.reserve(1000);
+  const size_t capacity = map.capacity();
+  EXPECT_LE(1000u, capacity);
+  for (int i = 0; i < 1000; ++i)
+    map[i] = i;
+  EXPECT_EQ(capacity, map.capacity());
+
+  HashMap<int, int> sized(1000);
+  EXPECT_EQ(capacity, sized.capacity());
+}
+
+TEST(HashMap, EraseDuringIteration) {
+  HashMap<int, int> map;
+  for (int i = 0; i < 100; ++i)
+    map[i] = i;
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->first % 2)
+      it = map.erase(it);
+    else
+      ++it;
+  }
+  EXPECT_EQ(50u, map.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i % 2 ? 0u : 1u, map.count(i));
+
+  map.erase(map.begin(), map.end());
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(HashMap, ChurnDoesNotGrow) {
+  // A steady-state workload, as in an MRU cache: tombstones left by erases
+  // must be reused or cleaned up rather than make the table grow.
+  HashMap<int, int> map;
+  for (int i = 0; i < 500; ++i)
+    map[i] = i;
+  const size_t capacity = map.capacity();
+  for (int i = 500; i < 100000; ++i) {
+    map[i] = i;
+    ASSERT_EQ(1u, map.erase(i - 500));
+  }
+  EXPECT_EQ(500u, map.size());
+  EXPECT_EQ(capacity, map.capacity());
+  for (int i = 100000 - 500; i < 100000; ++i)
+    ASSERT_EQ(i, map.find(i)->second);
+}
+
+TEST(HashMap, CollidingHashes) {
+  HashMap<int, int, ConstantHash> map;
+  for (int i = 0; i < 100; ++i)
+    map[i] = i;
+  for (int i = 0; i < 100; i += 2)
+    EXPECT_EQ(1u, map.erase(i));
+  EXPECT_EQ(50u, map.size());
+  for (int i = 0; i < 100; ++i) {
+    auto it = map.find(i);
+    if (i % 2)
+      EXPECT_EQ(i, it->second);
+    else
+      EXPECT_EQ(map.end(), it);
+  }
+}
+
+TEST(HashMap, MatchesStdUnorderedMap) {
+  HashMap<uint64_t, int> map;
+  std::unordered_map<uint64_t, int> expected;
+  // Keys in a small range, to mix inserts of new and existing keys, and erases
+  // of present and absent ones.
+  uint32_t seed = 1;
+  for (int i = 0; i < 200000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const uint64_t key = (seed >> 8) % 4096;
+    switch ((seed >> 4) % 3) {
+      case 0:
+        map[key] = i;
+        expected[key] = i;
+        break;
+      case 1:
+        ASSERT_EQ(expected.erase(key), map.erase(key));
+        break;
+      case 2:
+        ASSERT_EQ(expected.count(key), map.count(key));
+        break;
+    }
+    ASSERT_EQ(expected.size(), map.size());
+  }
+  for (const auto& pair : expected)
+    ASSERT_EQ(pair.second, map.find(pair.first)->second);
+  EXPECT_EQ(expected.size(),
+            static_cast<size_t>(std::distance(map.begin(), map.end())));
+}
+
+TEST(HashMap, DestroysElements) {
+  live_count = 0;
+  {
+    HashMap<int, Counted> map;
+    for (int i = 0; i < 1000; ++i)
+      map.emplace(i, Counted(i));
+    EXPECT_EQ(1000, live_count);
+    for (int i = 0; i < 1000; i += 3)
+      map.erase(i);
+    EXPECT_EQ(666, live_count);
+
+    HashMap<int, Counted> copy(map);
+    EXPECT_EQ(2 * 666, live_count);
+    copy.clear();
+    EXPECT_EQ(666, live_count);
+    EXPECT_TRUE(copy.empty());
+  }
+  EXPECT_EQ(0, live_count);
+}
+
+TEST(HashMap, CopyMoveAndSwap) {
+  HashMap<int, int> original = {{1, 1}, {2, 2}, {3, 3}};
+
+  HashMap<int, int> copy(original);
+  EXPECT_EQ(original, copy);
+  copy[4] = 4;
+  EXPECT_NE(original, copy);
+
+  HashMap<int, int> moved(std::move(copy));
+  EXPECT_EQ(4u, moved.size());
+  EXPECT_TRUE(copy.empty());  // NOLINT(bugprone-use-after-move)
+  copy[5] = 5;
+  EXPECT_EQ(1u, copy.size());
+
+  moved.swap(original);
+  EXPECT_EQ(3u, moved.size());
+  EXPECT_EQ(4u, original.size());
+
+  original = moved;
+  EXPECT_EQ(moved, original);
+  original = std::move(copy);
+  EXPECT_THAT(original, UnorderedElementsAre(std::make_pair(5, 5)));
+}
+
+TEST(HashMap, MoveOnlyKeys) {
+  struct MoveOnlyIntHash {
+    size_t operator()(const MoveOnlyInt& value) const { return value.data(); }
+  };
+  HashMap<MoveOnlyInt, MoveOnlyInt, MoveOnlyIntHash> map;
+  for (int i = 0; i < 100; ++i)
+    map.try_emplace(MoveOnlyInt(i), i * 2);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i * 2, map.find(MoveOnlyInt(i))->second.data());
+}
+
+TEST(HashMap, ConstIterators) {
+  HashMap<int, int> map = {{1, 1}};
+  HashMap<int, int>::const_iterator it = map.begin();
+  EXPECT_EQ(it, map.cbegin());
+  EXPECT_EQ(1, it->second);
+  map.erase(it);
+  EXPECT_TRUE(map.empty());
+}
+
+}  // namespace base
@@ -0,0 +1,125 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_HASH_SET_H_
+#define BASE_CONTAINERS_HASH_SET_H_
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include "base/containers/flat_tree.h"
+#include "base/containers/hash_table.h"
+
+namespace base {
+
+// HashSet is a container with a std::unordered_set-like interface, built on
+// the same open-addressing table as HashMap. See hash_map.h for its tradeoffs
+// and hash_table.h for its design.
+//
+// Please see //base/containers/README.md for an overview of which container
+// to select.
+//
+// QUICK REFERENCE
+//
+// The functions available are those of HashMap, except for operator[], at(),
+// insert_or_assign() and try_emplace().
+//
+// Elements of a HashSet are const: modifying them would change their hash.
+template <class Key,
+          class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class HashSet : public ::base::internal::HashTable<
+                    Key,
+                    Key,
+                    ::base::internal::GetKeyFromValueIdentity<Key>,
+                    Hash,
+                    KeyEqual> {
+ private:
+  using table = typename ::base::internal::HashTable<
+      Key,
+      Key,
+      ::base::internal::GetKeyFromValueIdentity<Key>,
+      Hash,
+      KeyEqual>;
+
+ public:
+  using value_type = typename table::value_type;
+  // Like std::unordered_set, only allows const access to the elements.
+  using iterator = typename table::const_iterator;
+  using const_iterator = typename table::const_iterator;
+
+  // --------------------------------------------------------------------------
+  // Lifetime and assignments.
+
+  HashSet() = default;
+  explicit HashSet(size_t bucket_count,
+                   const Hash& hash = Hash(),
+                   const KeyEqual& eq = KeyEqual())
+      : table(bucket_count, hash, eq) {}
+
+  template <class InputIterator>
+  HashSet(InputIterator first, InputIterator last) : table(first, last) {}
+
+  HashSet(std::initializer_list<value_type> ilist) : table(ilist) {}
+
+  HashSet(const HashSet&) = default;
+  HashSet(HashSet&&) noexcept = default;
+  ~HashSet() = default;
+
+  HashSet& operator=(const HashSet&) = default;
+  HashSet& operator=(HashSet&&) = default;
+  HashSet& operator=(std::initializer_list<value_type> ilist) {
+    table::operator=(ilist);
+    return *this;
+  }
+
+  // --------------------------------------------------------------------------
+  // Const-only access to the elements.
+
+  const_iterator begin() const { return table::begin(); }
+  const_iterator cbegin() const { return table::begin(); }
+  const_iterator end() const { return table::end(); }
+  const_iterator cend() const { return table::end(); }
+
+  const_iterator find(const Key& key) const { return table::find(key); }
+
+  std::pair<const_iterator, bool> insert(const value_type& value) {
+    return table::insert(value);
+  }
+  std::pair<const_iterator, bool> insert(value_type&& value) {
+    return table::insert(std::move(value));
+  }
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    table::insert(first, last);
+  }
+  void insert(std::initializer_list<value_type> ilist) {
+    table::insert(ilist);
+  }
+
+  template <class... Args>
+  std::pair<const_iterator, bool> emplace(Args&&... args) {
+    return table::emplace(std::forward<Args>(args)...);
+  }
+
+  const_iterator erase(const_iterator position) {
+    return table::erase(position);
+  }
+  const_iterator erase(const_iterator first, const_iterator last) {
+    return table::erase(first, last);
+  }
+  size_t erase(const Key& key) { return table::erase(key); }
+
+  // --------------------------------------------------------------------------
+  // General operations.
+
+  void swap(HashSet& other) noexcept { table::swap(other); }
+
+  friend void swap(HashSet& lhs, HashSet& rhs) noexcept { lhs.swap(rhs); }
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_HASH_SET_H_
@@ -0,0 +1,63 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/hash_set.h"
+
+#include <string>
+#include <utility>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// A HashSet is an interface to the same table as HashMap, so only the basic
+// operations are tested here; the bulk of the tests are in
+// hash_map_unittest.cc.
+
+using ::testing::UnorderedElementsAre;
+
+namespace base {
+
+TEST(HashSet, InsertFindErase) {
+  HashSet<std::string> set;
+  EXPECT_TRUE(set.insert("a").second);
+  EXPECT_FALSE(set.insert("a").second);
+  EXPECT_TRUE(set.emplace(3, 'b').second);
+  EXPECT_THAT(set, UnorderedElementsAre("a", "bbb"));
+
+  EXPECT_EQ("bbb", *set.find("bbb"));
+  EXPECT_EQ(set.end(), set.find("b"));
+  EXPECT_EQ(1u, set.erase("a"));
+  EXPECT_EQ(0u, set.erase("a"));
+  EXPECT_THAT(set, UnorderedElementsAre("bbb"));
+}
+
+TEST(HashSet, RangeConstructor) {
+  const int input[] = {1, 2, 3, 2, 1};
+  HashSet<int> set(std::begin(input), std::end(input));
+  EXPECT_THAT(set, UnorderedElementsAre(1, 2, 3));
+}
+
+TEST(HashSet, EraseDuringIteration) {
+  HashSet<int> set;
+  for (int i = 0; i < 1000; ++i)
+    set.insert(i);
+  for (auto it = set.begin(); it != set.end();)
+    it = *it % 10 ? set.erase(it) : std::next(it);
+  EXPECT_EQ(100u, set.size());
+  for (int i = 0; i < 1000; i += 10)
+    EXPECT_EQ(1u, set.count(i));
+}
+
+TEST(HashSet, Comparison) {
+  HashSet<int> a = {1, 2, 3};
+  HashSet<int> b = {3, 2, 1};
+  EXPECT_EQ(a, b);
+  b.erase(2);
+  EXPECT_NE(a, b);
+  swap(a, b);
+  EXPECT_EQ(2u, a.size());
+  EXPECT_EQ(3u, b.size());
+}
+
+}  // namespace base
@@ -0,0 +1,737 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_HASH_TABLE_H_
+#define BASE_CONTAINERS_HASH_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/compiler_specific.h"
+#include "base/logging.h"
+#include "base/sys_byteorder.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace base {
+namespace internal {
+
+// The implementation of HashMap and HashSet: an open-addressing hash table
+// which stores its elements in a single array of slots, and probes groups of
+// slots at a time using one control byte per slot.
+//
+// Each control byte is either kEmpty, kDeleted (a tombstone left by an erase),
+// kSentinel (the byte after the last slot, which stops iteration), or, for a
+// full slot, the low 7 bits of its element's hash ("H2"). A lookup hashes the
+// key once, then for each group of kWidth slots along the probe sequence
+// compares H2 against all the control bytes of the group at once, and only
+// compares keys for the slots that match. The first group with an empty slot
+// ends the probe. The remaining bits of the hash ("H1") select where the probe
+// sequence starts.
+//
+// The capacity is always 2^n - 1, so that the table wraps around with a mask.
+// The control bytes of the first kWidth - 1 slots are cloned after the
+// sentinel, so that a group starting at any slot can be loaded without
+// wrapping. The table grows when it would become more than 7/8 full, counting
+// tombstones.
+//
+// This is the same design as Abseil's flat_hash_map ("Swiss tables").
+
+using HashTableCtrl = int8_t;
+
+enum : HashTableCtrl {
+  kHashTableEmpty = -128,
+  kHashTableDeleted = -2,
+  kHashTableSentinel = -1,
+};
+
+inline bool HashTableIsFull(HashTableCtrl c) {
+  return c >= 0;
+}
+
+inline bool HashTableIsEmptyOrDeleted(HashTableCtrl c) {
+  return c < kHashTableSentinel;
+}
+
+// The set bits of a mask returned by a group match, one per matching slot.
+// Each slot occupies 2^Shift bits of the mask.
+template <class T, int SignificantBits, int Shift = 0>
+class HashTableBitMask {
+ public:
+  explicit HashTableBitMask(T mask) : mask_(mask) {}
+
+  explicit operator bool() const { return mask_ != 0; }
+
+  // The index of the first matching slot. The mask must not be empty.
+  int LowestBitSet() const { return TrailingZeros(); }
+
+  void ClearLowestBitSet() { mask_ &= mask_ - 1; }
+
+  // The number of non-matching slots before the first matching one, or after
+  // the last one.
+  int TrailingZeros() const {
+    return static_cast<int>(bits::CountTrailingZeroBits(mask_)) >> Shift;
+  }
+  int LeadingZeros() const {
+    constexpr int kExtraBits = sizeof(T) * 8 - (SignificantBits << Shift);
+    return static_cast<int>(bits::CountLeadingZeroBits(
+               static_cast<T>(mask_ << kExtraBits))) >>
+           Shift;
+  }
+
+ private:
+  T mask_;
+};
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// Matches the 16 control bytes of a group with SSE2.
+class HashTableGroup {
+ public:
+  static constexpr size_t kWidth = 16;
+  using BitMask = HashTableBitMask<uint32_t, kWidth>;
+
+  explicit HashTableGroup(const HashTableCtrl* pos)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+  BitMask Match(uint8_t h2) const {
+    const __m128i match = _mm_set1_epi8(static_cast<char>(h2));
+    return BitMask(static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(match, ctrl_))));
+  }
+
+  BitMask MatchEmpty() const {
+    return Match(static_cast<uint8_t>(kHashTableEmpty));
+  }
+
+  BitMask MatchEmptyOrDeleted() const {
+    const __m128i sentinel = _mm_set1_epi8(kHashTableSentinel);
+    return BitMask(static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(sentinel, ctrl_))));
+  }
+
+ private:
+  __m128i ctrl_;
+};
+
+#else
+
+// Matches the 8 control bytes of a group as one 64-bit word. Match() may
+// report false positives, which the key comparison weeds out.
+class HashTableGroup {
+ public:
+  static constexpr size_t kWidth = 8;
+  using BitMask = HashTableBitMask<uint64_t, kWidth, 3>;
+
+  explicit HashTableGroup(const HashTableCtrl* pos) {
+    memcpy(&ctrl_, pos, sizeof(ctrl_));
+    ctrl_ = ByteSwapToLE64(ctrl_);
+  }
+
+  BitMask Match(uint8_t h2) const {
+    const uint64_t x = ctrl_ ^ (kLsbs * h2);
+    return BitMask((x - kLsbs) & ~x & kMsbs);
+  }
+
+  // kEmpty is the only control byte with the top bit set and bit 1 clear.
+  BitMask MatchEmpty() const {
+    return BitMask((ctrl_ & (~ctrl_ << 6)) & kMsbs);
+  }
+
+  // kEmpty and kDeleted are the only ones with the top bit set and bit 0
+  // clear.
+  BitMask MatchEmptyOrDeleted() const {
+    return BitMask((ctrl_ & (~ctrl_ << 7)) & kMsbs);
+  }
+
+ private:
+  static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+  static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+
+  uint64_t ctrl_;
+};
+
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+// The control bytes of a table with no slots. Lookups stop at the first group,
+// and iteration at the sentinel.
+inline HashTableCtrl* HashTableEmptyGroup() {
+  alignas(16) static constexpr HashTableCtrl kEmptyGroup[16] = {
+      kHashTableSentinel, kHashTableEmpty, kHashTableEmpty, kHashTableEmpty,
+      kHashTableEmpty,    kHashTableEmpty, kHashTableEmpty, kHashTableEmpty,
+      kHashTableEmpty,    kHashTableEmpty, kHashTableEmpty, kHashTableEmpty,
+      kHashTableEmpty,    kHashTableEmpty, kHashTableEmpty, kHashTableEmpty};
+  // Never written to: tables with no slots never set a control byte.
+  return const_cast<HashTableCtrl*>(kEmptyGroup);
+}
+
+// Iterates over the full slots of a HashTable. |T| is the table's value_type,
+// const-qualified for a const_iterator.
+template <class T>
+class HashTableIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  HashTableIterator() = default;
+  HashTableIterator(const HashTableCtrl* ctrl, T* slot)
+      : ctrl_(ctrl), slot_(slot) {}
+
+  // Converts an iterator to a const_iterator.
+  template <class U,
+            class = std::enable_if_t<std::is_same<const U, T>::value &&
+                                     !std::is_same<U, T>::value>>
+  HashTableIterator(const HashTableIterator<U>& other)  // NOLINT
+      : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+  reference operator*() const { return *slot_; }
+  pointer operator->() const { return slot_; }
+
+  HashTableIterator& operator++() {
+    ++ctrl_;
+    ++slot_;
+    SkipEmptyOrDeleted();
+    return *this;
+  }
+  HashTableIterator operator++(int) {
+    HashTableIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  friend bool operator==(const HashTableIterator& a,
+                         const HashTableIterator& b) {
+    return a.ctrl_ == b.ctrl_;
+  }
+  friend bool operator!=(const HashTableIterator& a,
+                         const HashTableIterator& b) {
+    return !(a == b);
+  }
+
+ private:
+  template <class U>
+  friend class HashTableIterator;
+  template <class Key, class Value, class GetKeyFromValue, class H, class Eq>
+  friend class HashTable;
+
+  // Moves forward to the next full slot, or to the sentinel.
+  void SkipEmptyOrDeleted() {
+    while (HashTableIsEmptyOrDeleted(*ctrl_)) {
+      ++ctrl_;
+      ++slot_;
+    }
+  }
+
+  const HashTableCtrl* ctrl_ = nullptr;
+  T* slot_ = nullptr;
+};
+
+// Implementation -------------------------------------------------------------
+
+// Both HashMap and HashSet are HashTables: |Value| is the element type, from
+// which |GetKeyFromValue| extracts the |Key| that |Hash| and |KeyEqual| apply
+// to.
+//
+// Inserting invalidates iterators and references if the table grows, or has
+// to be rehashed to clean up tombstones. Erasing never moves other elements.
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual>
+class HashTable {
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = HashTableIterator<value_type>;
+  using const_iterator = HashTableIterator<const value_type>;
+
+  // --------------------------------------------------------------------------
+  // Lifetime and assignments.
+
+  HashTable() = default;
+  explicit HashTable(size_t bucket_count,
+                     const Hash& hash = Hash(),
+                     const KeyEqual& eq = KeyEqual())
+      : hash_(hash), eq_(eq) {
+    reserve(bucket_count);
+  }
+
+  template <class InputIterator>
+  HashTable(InputIterator first, InputIterator last) {
+    insert(first, last);
+  }
+
+  HashTable(std::initializer_list<value_type> ilist)
+      : HashTable(ilist.begin(), ilist.end()) {}
+
+  HashTable(const HashTable& other) : hash_(other.hash_), eq_(other.eq_) {
+    reserve(other.size());
+    for (const value_type& value : other)
+      insert(value);
+  }
+
+  HashTable(HashTable&& other) noexcept
+      : ctrl_(other.ctrl_),
+        slots_(other.slots_),
+        size_(other.size_),
+        capacity_(other.capacity_),
+        growth_left_(other.growth_left_),
+        hash_(std::move(other.hash_)),
+        eq_(std::move(other.eq_)) {
+    other.ResetToEmpty();
+  }
+
+  ~HashTable() { DestroyAndDeallocate(); }
+
+  HashTable& operator=(const HashTable& other) {
+    if (this != &other) {
+      HashTable copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  HashTable& operator=(HashTable&& other) noexcept {
+    if (this != &other) {
+      DestroyAndDeallocate();
+      ResetToEmpty();
+      swap(other);
+    }
+    return *this;
+  }
+
+  HashTable& operator=(std::initializer_list<value_type> ilist) {
+    clear();
+    insert(ilist);
+    return *this;
+  }
+
+  // --------------------------------------------------------------------------
+  // Memory management.
+
+  // Makes room for |new_size| elements without growing.
+  void reserve(size_t new_size) {
+    if (new_size > size_ + growth_left_)
+      Resize(NormalizeCapacity(GrowthToLowerboundCapacity(new_size)));
+  }
+
+  // The number of slots, including the ones that can't be filled before the
+  // table grows.
+  size_t capacity() const { return capacity_; }
+
+  // --------------------------------------------------------------------------
+  // Size management.
+
+  // Destroys the elements, but keeps the storage.
+  void clear() {
+    if (!capacity_)
+      return;
+    DestroyElements();
+    ResetCtrl();
+    size_ = 0;
+    growth_left_ = CapacityToGrowth(capacity_);
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return !size_; }
+
+  // --------------------------------------------------------------------------
+  // Iterators.
+  //
+  // The iteration order is unspecified, and changes when the table grows.
+
+  iterator begin() {
+    iterator it(ctrl_, slots_);
+    it.SkipEmptyOrDeleted();
+    return it;
+  }
+  const_iterator begin() const { return const_cast<HashTable*>(this)->begin(); }
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+  const_iterator end() const { return const_cast<HashTable*>(this)->end(); }
+  const_iterator cend() const { return end(); }
+
+  // --------------------------------------------------------------------------
+  // Insert operations.
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return emplace_key_args(GetKeyFromValue()(value), value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return emplace_key_args(GetKeyFromValue()(value), std::move(value));
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  void insert(std::initializer_list<value_type> ilist) {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  // Unlike insert(), constructs the value before looking up its key.
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return insert(std::move(value));
+  }
+
+  // --------------------------------------------------------------------------
+  // Erase operations.
+
+  // Returns the iterator to the next element.
+  iterator erase(const_iterator position) {
+    iterator next = MutableIterator(position);
+    EraseAt(static_cast<size_t>(position.ctrl_ - ctrl_));
+    ++next;
+    return next;
+  }
+  iterator erase(iterator position) {
+    return erase(static_cast<const_iterator>(position));
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    while (first != last)
+      first = erase(first);
+    return MutableIterator(last);
+  }
+
+  size_t erase(const key_type& key) {
+    const size_t index = FindIndex(key);
+    if (index == capacity_)
+      return 0;
+    EraseAt(index);
+    return 1;
+  }
+
+  // --------------------------------------------------------------------------
+  // Search operations.
+
+  iterator find(const key_type& key) { return IteratorAt(FindIndex(key)); }
+  const_iterator find(const key_type& key) const {
+    return const_cast<HashTable*>(this)->find(key);
+  }
+
+  size_t count(const key_type& key) const {
+    return FindIndex(key) == capacity_ ? 0 : 1;
+  }
+
+  bool contains(const key_type& key) const {
+    return FindIndex(key) != capacity_;
+  }
+
+  // --------------------------------------------------------------------------
+  // General operations.
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return eq_; }
+
+  void swap(HashTable& other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(hash_, other.hash_);
+    std::swap(eq_, other.eq_);
+  }
+
+  friend bool operator==(const HashTable& lhs, const HashTable& rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    for (const value_type& value : lhs) {
+      const_iterator it = rhs.find(GetKeyFromValue()(value));
+      if (it == rhs.end() || !(*it == value))
+        return false;
+    }
+    return true;
+  }
+
+  friend bool operator!=(const HashTable& lhs, const HashTable& rhs) {
+    return !(lhs == rhs);
+  }
+
+ protected:
+  // Constructs a value_type from |args| if there is no element with |key|
+  // yet, and returns the iterator to the element with |key|.
+  template <class K, class... Args>
+  std::pair<iterator, bool> emplace_key_args(const K& key, Args&&... args) {
+    const std::pair<size_t, bool> found = FindOrPrepareInsert(key);
+    if (found.second) {
+      new (slots_ + found.first) value_type(std::forward<Args>(args)...);
+    }
+    return {IteratorAt(found.first), found.second};
+  }
+
+ private:
+  using Group = HashTableGroup;
+
+  static_assert(alignof(value_type) <= alignof(std::max_align_t),
+                "HashTable does not support over-aligned types");
+
+  // The sequence of groups a lookup visits: the group at H1, then groups at
+  // triangular offsets from it, which visit every group of a table whose
+  // number of slots is a power of two.
+  class ProbeSeq {
+   public:
+    ProbeSeq(size_t hash, size_t mask) : mask_(mask), offset_(hash & mask) {}
+
+    size_t offset() const { return offset_; }
+    size_t offset(size_t i) const { return (offset_ + i) & mask_; }
+    size_t index() const { return index_; }
+
+    void next() {
+      index_ += Group::kWidth;
+      offset_ += index_;
+      offset_ &= mask_;
+    }
+
+   private:
+    size_t mask_;
+    size_t offset_;
+    size_t index_ = 0;
+  };
+
+  // Mixes the bits of |hash| so that both H1 and H2 depend on all of them:
+  // std::hash is the identity on integers, and pointers have low bits clear.
+  static size_t MixHash(size_t hash) {
+    const uint64_t product =
+        static_cast<uint64_t>(hash) * UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_t>(product ^ (product >> 32));
+  }
+  static size_t H1(size_t hash) { return hash >> 7; }
+  static uint8_t H2(size_t hash) { return hash & 0x7F; }
+
+  // Capacities are 2^n - 1, so that the table can be masked by them.
+  static size_t NormalizeCapacity(size_t n) {
+    return n ? ~size_t{0} >> bits::CountLeadingZeroBits(n) : 1;
+  }
+
+  // The number of elements a table of |capacity| holds before growing. A
+  // table that fits in one group may be full, since lookups stop at the empty
+  // control bytes after its clones; larger ones keep 1/8 of their slots free.
+  static size_t CapacityToGrowth(size_t capacity) {
+    if (Group::kWidth == 8 && capacity == 7)
+      return 6;
+    return capacity - capacity / 8;
+  }
+  static size_t GrowthToLowerboundCapacity(size_t growth) {
+    if (Group::kWidth == 8 && growth == 7)
+      return 8;
+    return growth + (growth - 1) / 7;
+  }
+
+  static size_t CtrlBytes(size_t capacity) { return capacity + Group::kWidth; }
+  static size_t SlotOffset(size_t capacity) {
+    return bits::Align(CtrlBytes(capacity), alignof(value_type));
+  }
+
+  size_t HashKey(const key_type& key) const { return MixHash(hash_(key)); }
+
+  iterator IteratorAt(size_t index) {
+    return iterator(ctrl_ + index, slots_ + index);
+  }
+  iterator MutableIterator(const_iterator it) {
+    return IteratorAt(static_cast<size_t>(it.ctrl_ - ctrl_));
+  }
+
+  // Returns the index of the element with |key|, or capacity_.
+  template <class K>
+  size_t FindIndex(const K& key) const {
+    const size_t hash = HashKey(key);
+    ProbeSeq seq(H1(hash), capacity_);
+    while (true) {
+      const Group group(ctrl_ + seq.offset());
+      for (auto match = group.Match(H2(hash)); match;
+           match.ClearLowestBitSet()) {
+        const size_t index = seq.offset(match.LowestBitSet());
+        if (LIKELY(eq_(key, GetKeyFromValue()(slots_[index]))))
+          return index;
+      }
+      if (LIKELY(group.MatchEmpty()))
+        return capacity_;
+      seq.next();
+      DCHECK_LE(seq.index(), capacity_) << "full table";
+    }
+  }
+
+  // Returns the index of the first empty or deleted slot along the probe
+  // sequence of |hash|.
+  size_t FindFirstNonFull(size_t hash) const {
+    ProbeSeq seq(H1(hash), capacity_);
+    while (true) {
+      const Group group(ctrl_ + seq.offset());
+      const auto mask = group.MatchEmptyOrDeleted();
+      if (mask)
+        return seq.offset(mask.LowestBitSet());
+      seq.next();
+      DCHECK_LE(seq.index(), capacity_) << "full table";
+    }
+  }
+
+  // Returns the index of the element with |key| and false, or the index of a
+  // slot reserved for it and true. The caller constructs the element.
+  template <class K>
+  std::pair<size_t, bool> FindOrPrepareInsert(const K& key) {
+    const size_t hash = HashKey(key);
+    ProbeSeq seq(H1(hash), capacity_);
+    while (true) {
+      const Group group(ctrl_ + seq.offset());
+      for (auto match = group.Match(H2(hash)); match;
+           match.ClearLowestBitSet()) {
+        const size_t index = seq.offset(match.LowestBitSet());
+        if (LIKELY(eq_(key, GetKeyFromValue()(slots_[index]))))
+          return {index, false};
+      }
+      if (LIKELY(group.MatchEmpty()))
+        break;
+      seq.next();
+      DCHECK_LE(seq.index(), capacity_) << "full table";
+    }
+    return {PrepareInsert(hash), true};
+  }
+
+  size_t PrepareInsert(size_t hash) {
+    size_t target = FindFirstNonFull(hash);
+    // Reusing a tombstone doesn't use up growth.
+    if (UNLIKELY(growth_left_ == 0 && ctrl_[target] != kHashTableDeleted)) {
+      RehashAndGrowIfNecessary();
+      target = FindFirstNonFull(hash);
+    }
+    ++size_;
+    growth_left_ -= ctrl_[target] == kHashTableEmpty;
+    SetCtrl(target, H2(hash));
+    return target;
+  }
+
+  // Sets the control byte of slot |i|, and of its clone.
+  void SetCtrl(size_t i, HashTableCtrl h) {
+    DCHECK_LT(i, capacity_);
+    constexpr size_t kClonedBytes = Group::kWidth - 1;
+    ctrl_[i] = h;
+    ctrl_[((i - kClonedBytes) & capacity_) + (kClonedBytes & capacity_)] = h;
+  }
+
+  void EraseAt(size_t index) {
+    DCHECK(HashTableIsFull(ctrl_[index]));
+    slots_[index].~value_type();
+    --size_;
+    // If no group containing the slot was ever full, no probe went past it,
+    // so it can be marked empty instead of leaving a tombstone.
+    const size_t index_before = (index - Group::kWidth) & capacity_;
+    const auto empty_after = Group(ctrl_ + index).MatchEmpty();
+    const auto empty_before = Group(ctrl_ + index_before).MatchEmpty();
+    const bool was_never_full =
+        empty_before && empty_after &&
+        static_cast<size_t>(empty_after.TrailingZeros() +
+                            empty_before.LeadingZeros()) < Group::kWidth;
+    SetCtrl(index, was_never_full ? kHashTableEmpty : kHashTableDeleted);
+    growth_left_ += was_never_full;
+  }
+
+  // Called when there is no room left for an insert: if tombstones take up a
+  // large part of the table, rehashes it at the same capacity to clear them;
+  // otherwise doubles the capacity.
+  void RehashAndGrowIfNecessary() {
+    if (capacity_ > Group::kWidth && size_ * 32 <= capacity_ * 25)
+      Resize(capacity_);
+    else
+      Resize(capacity_ * 2 + 1);
+  }
+
+  void Resize(size_t new_capacity) {
+    DCHECK_EQ(0u, new_capacity & (new_capacity + 1));
+    HashTableCtrl* const old_ctrl = ctrl_;
+    value_type* const old_slots = slots_;
+    const size_t old_capacity = capacity_;
+
+    char* const memory = static_cast<char*>(
+        ::operator new(SlotOffset(new_capacity) +
+                       new_capacity * sizeof(value_type)));
+    ctrl_ = reinterpret_cast<HashTableCtrl*>(memory);
+    slots_ = reinterpret_cast<value_type*>(memory + SlotOffset(new_capacity));
+    capacity_ = new_capacity;
+    ResetCtrl();
+    growth_left_ = CapacityToGrowth(capacity_) - size_;
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (!HashTableIsFull(old_ctrl[i]))
+        continue;
+      const size_t hash = HashKey(GetKeyFromValue()(old_slots[i]));
+      const size_t target = FindFirstNonFull(hash);
+      SetCtrl(target, H2(hash));
+      new (slots_ + target) value_type(std::move(old_slots[i]));
+      old_slots[i].~value_type();
+    }
+    if (old_capacity)
+      ::operator delete(old_ctrl);
+  }
+
+  void ResetCtrl() {
+    memset(ctrl_, kHashTableEmpty, CtrlBytes(capacity_));
+    ctrl_[capacity_] = kHashTableSentinel;
+  }
+
+  void DestroyElements() {
+    if (std::is_trivially_destructible<value_type>::value)
+      return;
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (HashTableIsFull(ctrl_[i]))
+        slots_[i].~value_type();
+    }
+  }
+
+  void DestroyAndDeallocate() {
+    if (!capacity_)
+      return;
+    DestroyElements();
+    ::operator delete(ctrl_);
+  }
+
+  void ResetToEmpty() {
+    ctrl_ = HashTableEmptyGroup();
+    slots_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    growth_left_ = 0;
+  }
+
+  HashTableCtrl* ctrl_ = HashTableEmptyGroup();
+  value_type* slots_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  size_t growth_left_ = 0;
+  Hash hash_;
+  KeyEqual eq_;
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_HASH_TABLE_H_
@@ -22,9 +22,9 @@
 #include <functional>
 #include <list>
 #include <map>
-#include <unordered_map>
 #include <utility>
 
+#include "base/containers/hash_map.h"
 #include "base/logging.h"
 #include "base/macros.h"
 
@@ -240,12 +240,12 @@ class MRUCache : public MRUCacheBase<KeyType, PayloadType, CompareType> {
 
 template <class KeyType, class ValueType, class HashType>
 struct MRUCacheHashMap {
-  typedef std::unordered_map<KeyType, ValueType, HashType> Type;
+  typedef HashMap<KeyType, ValueType, HashType> Type;
 };
 
-// This class is similar to MRUCache, except that it uses std::unordered_map as
-// the map type instead of std::map. Note that your KeyType must be hashable to
-// use this cache or you need to provide a hashing class.
+// This class is similar to MRUCache, except that it uses base::HashMap as the
+// map type instead of std::map. Note that your KeyType must be hashable to use
+// this cache or you need to provide a hashing class.
 template <class KeyType, class PayloadType, class HashType = std::hash<KeyType>>
 class HashingMRUCache
     : public MRUCacheBase<KeyType, PayloadType, HashType, MRUCacheHashMap> {
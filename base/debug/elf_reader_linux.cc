@@ -7,11 +7,13 @@
 #include <arpa/inet.h>
 #include <elf.h>
 
+#include <string.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "base/bits.h"
 #include "base/containers/span.h"
-#include "base/sha1.h"
 #include "base/strings/stringprintf.h"
 
 namespace base {
@@ -37,6 +39,9 @@ using Word = Elf64_Word;
 
 using ElfSegment = span<const char>;
 
+// The size of the GUID that breakpad derives from the build ID.
+constexpr size_t kGuidSize = 16;
+
 Optional<std::string> ElfSegmentBuildIDNoteAsString(const ElfSegment& segment) {
   const void* section_end = segment.data() + segment.size_bytes();
   const Nhdr* note_header = reinterpret_cast<const Nhdr*>(segment.data());
@@ -49,20 +54,33 @@ Optional<std::string> ElfSegmentBuildIDNoteAsString(const ElfSegment& segment) {
         bits::Align(note_header->n_descsz, 4));
   }
 
-  if (note_header >= section_end || note_header->n_descsz != kSHA1Length)
+  if (note_header >= section_end || note_header->n_descsz == 0)
     return nullopt;
 
-  const uint8_t* guid = reinterpret_cast<const uint8_t*>(note_header) +
-                        sizeof(Nhdr) + bits::Align(note_header->n_namesz, 4);
-
-  uint32_t dword = htonl(*reinterpret_cast<const int32_t*>(guid));
-  uint16_t word1 = htons(*reinterpret_cast<const int16_t*>(guid + 4));
-  uint16_t word2 = htons(*reinterpret_cast<const int16_t*>(guid + 6));
+  const uint8_t* build_id =
+      reinterpret_cast<const uint8_t*>(note_header) + sizeof(Nhdr) +
+      bits::Align(note_header->n_namesz, 4);
+  const size_t build_id_size = note_header->n_descsz;
+
+  // Like breakpad, pad build IDs shorter than a GUID with zeros.
+  uint8_t guid[kGuidSize] = {};
+  memcpy(guid, build_id, std::min(build_id_size, kGuidSize));
+
+  uint32_t dword;
+  uint16_t word1;
+  uint16_t word2;
+  memcpy(&dword, guid, sizeof(dword));
+  memcpy(&word1, guid + 4, sizeof(word1));
+  memcpy(&word2, guid + 6, sizeof(word2));
   std::string identifier;
-  identifier.reserve(kSHA1Length * 2);  // as hex string
-  SStringPrintf(&identifier, "%08X%04X%04X", dword, word1, word2);
-  for (size_t i = 8; i < note_header->n_descsz; ++i)
+  // As a hex string.
+  identifier.reserve(std::max(build_id_size, kGuidSize) * 2);
+  SStringPrintf(&identifier, "%08X%04X%04X", htonl(dword), htons(word1),
+                htons(word2));
+  for (size_t i = 8; i < kGuidSize; ++i)
     StringAppendF(&identifier, "%02X", guid[i]);
+  for (size_t i = kGuidSize; i < build_id_size; ++i)
+    StringAppendF(&identifier, "%02X", build_id[i]);
 
   return identifier;
 }
@@ -14,8 +14,10 @@ namespace base {
 namespace debug {
 
 // Returns the ELF section .note.gnu.build-id from the ELF file mapped at
-// |elf_base|, if present. The caller must ensure that the file is fully mapped
-// in memory.
+// |elf_base|, if present, as an upper-case hex string in breakpad's format:
+// build IDs shorter than 16 bytes are padded with zeros, and the first three
+// fields of the GUID formed by the first 16 bytes are byte-swapped. The caller
+// must ensure that the file is fully mapped in memory.
 Optional<std::string> BASE_EXPORT ReadElfBuildId(const void* elf_base);
 
 // Returns the library name from the ELF file mapped at |elf_base|, if present.
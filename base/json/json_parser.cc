@@ -8,6 +8,8 @@
 #include <utility>
 #include <vector>
 
+#include "base/arena_value.h"
+#include "base/containers/span.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/numerics/safe_conversions.h"
@@ -55,6 +57,53 @@ constexpr uint32_t kUnicodeReplacementPoint = 0xFFFD;
 // This is U+FFFD.
 const char kUnicodeReplacementString[] = "\xEF\xBF\xBD";
 
+// Builds a tree of ArenaValues, as returned by ParseIntoArena(). The elements
+// of the lists and dictionaries being parsed are collected on stacks shared
+// by all nesting levels, and copied into the arena once complete, so that
+// parsing doesn't allocate from the heap once the stacks have grown.
+class JSONParser::ArenaValueBuilder {
+ public:
+  using Node = ArenaValue;
+  // The index on the stack of the first element.
+  using List = size_t;
+  using Dict = size_t;
+
+  explicit ArenaValueBuilder(ValueArena* arena) : arena_(arena) {}
+
+  List BeginList() { return list_stack_.size(); }
+  void Append(List* list, ArenaValue item) { list_stack_.push_back(item); }
+  ArenaValue EndList(List* list) {
+    ArenaValue result(make_span(list_stack_).subspan(*list), arena_);
+    list_stack_.resize(*list);
+    return result;
+  }
+
+  Dict BeginDict() { return dict_stack_.size(); }
+  void Insert(Dict* dict, StringBuilder* key, ArenaValue value) {
+    dict_stack_.push_back({arena_->CopyString(key->AsStringPiece()), value});
+  }
+  ArenaValue EndDict(Dict* dict) {
+    ArenaValue result(make_span(dict_stack_).subspan(*dict), arena_);
+    dict_stack_.resize(*dict);
+    return result;
+  }
+
+  ArenaValue String(StringBuilder* string) {
+    return ArenaValue(string->AsStringPiece(), arena_);
+  }
+  ArenaValue Int(int value) { return ArenaValue(value); }
+  ArenaValue Double(double value) { return ArenaValue(value); }
+  ArenaValue Bool(bool value) { return ArenaValue(value); }
+  ArenaValue Null() { return ArenaValue(); }
+
+ private:
+  ValueArena* const arena_;
+  std::vector<ArenaValue> list_stack_;
+  std::vector<ArenaValue::DictEntry> dict_stack_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArenaValueBuilder);
+};
+
 JSONParser::JSONParser(int options, int max_depth)
     : options_(options),
       max_depth_(max_depth),
@@ -71,39 +120,14 @@ JSONParser::JSONParser(int options, int max_depth)
 JSONParser::~JSONParser() = default;
 
 Optional<Value> JSONParser::Parse(StringPiece input) {
-  input_ = input;
-  index_ = 0;
-  line_number_ = 1;
-  index_last_line_ = 0;
-
-  error_code_ = JSONReader::JSON_NO_ERROR;
-  error_line_ = 0;
-  error_column_ = 0;
-
-  // ICU and ReadUnicodeCharacter() use int32_t for lengths, so ensure
-  // that the index_ will not overflow when parsing.
-  if (!base::IsValueInRangeForNumericType<int32_t>(input.length())) {
-    ReportError(JSONReader::JSON_TOO_LARGE, 0);
-    return nullopt;
-  }
-
-  // When the input JSON string starts with a UTF-8 Byte-Order-Mark,
-  // advance the start position to avoid the ParseNextToken function mis-
-  // treating a Unicode BOM as an invalid character and returning NULL.
-  ConsumeIfMatch("\xEF\xBB\xBF");
-
-  // Parse the first and any nested tokens.
-  Optional<Value> root(ParseNextToken());
-  if (!root)
-    return nullopt;
-
-  // Make sure the input stream is at an end.
-  if (GetNextToken() != T_END_OF_INPUT) {
-    ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
-    return nullopt;
-  }
+  ValueBuilder builder;
+  return ParseWithBuilder(input, &builder);
+}
 
-  return root;
+Optional<ArenaValue> JSONParser::ParseIntoArena(StringPiece input,
+                                                ValueArena* arena) {
+  ArenaValueBuilder builder(arena);
+  return ParseWithBuilder(input, &builder);
 }
 
 JSONReader::JsonParseError JSONParser::error_code() const {
@@ -163,8 +187,53 @@ std::string JSONParser::StringBuilder::DestructiveAsString() {
   return std::string(pos_, length_);
 }
 
+StringPiece JSONParser::StringBuilder::AsStringPiece() const {
+  if (string_)
+    return *string_;
+  return StringPiece(pos_, length_);
+}
+
 // JSONParser private //////////////////////////////////////////////////////////
 
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ParseWithBuilder(
+    StringPiece input,
+    Builder* builder) {
+  input_ = input;
+  index_ = 0;
+  line_number_ = 1;
+  index_last_line_ = 0;
+
+  error_code_ = JSONReader::JSON_NO_ERROR;
+  error_line_ = 0;
+  error_column_ = 0;
+
+  // ICU and ReadUnicodeCharacter() use int32_t for lengths, so ensure
+  // that the index_ will not overflow when parsing.
+  if (!base::IsValueInRangeForNumericType<int32_t>(input.length())) {
+    ReportError(JSONReader::JSON_TOO_LARGE, 0);
+    return nullopt;
+  }
+
+  // When the input JSON string starts with a UTF-8 Byte-Order-Mark,
+  // advance the start position to avoid the ParseNextToken function mis-
+  // treating a Unicode BOM as an invalid character and returning NULL.
+  ConsumeIfMatch("\xEF\xBB\xBF");
+
+  // Parse the first and any nested tokens.
+  Optional<typename Builder::Node> root(ParseNextToken(builder));
+  if (!root)
+    return nullopt;
+
+  // Make sure the input stream is at an end.
+  if (GetNextToken() != T_END_OF_INPUT) {
+    ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
+    return nullopt;
+  }
+
+  return root;
+}
+
 Optional<StringPiece> JSONParser::PeekChars(size_t count) {
   if (index_ + count > input_.length())
     return nullopt;
@@ -301,31 +370,36 @@ bool JSONParser::EatComment() {
   return false;
 }
 
-Optional<Value> JSONParser::ParseNextToken() {
-  return ParseToken(GetNextToken());
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ParseNextToken(Builder* builder) {
+  return ParseToken(GetNextToken(), builder);
 }
 
-Optional<Value> JSONParser::ParseToken(Token token) {
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ParseToken(Token token,
+                                                        Builder* builder) {
   switch (token) {
     case T_OBJECT_BEGIN:
-      return ConsumeDictionary();
+      return ConsumeDictionary(builder);
     case T_ARRAY_BEGIN:
-      return ConsumeList();
+      return ConsumeList(builder);
     case T_STRING:
-      return ConsumeString();
+      return ConsumeString(builder);
     case T_NUMBER:
-      return ConsumeNumber();
+      return ConsumeNumber(builder);
     case T_BOOL_TRUE:
     case T_BOOL_FALSE:
     case T_NULL:
-      return ConsumeLiteral();
+      return ConsumeLiteral(builder);
     default:
       ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
       return nullopt;
   }
 }
 
-Optional<Value> JSONParser::ConsumeDictionary() {
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ConsumeDictionary(
+    Builder* builder) {
   if (ConsumeChar() != '{') {
     ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
     return nullopt;
@@ -337,7 +411,7 @@ Optional<Value> JSONParser::ConsumeDictionary() {
     return nullopt;
   }
 
-  std::vector<Value::DictStorage::value_type> dict_storage;
+  typename Builder::Dict dict = builder->BeginDict();
 
   Token token = GetNextToken();
   while (token != T_OBJECT_END) {
@@ -361,14 +435,13 @@ Optional<Value> JSONParser::ConsumeDictionary() {
 
     // The next token is the value. Ownership transfers to |dict|.
     ConsumeChar();
-    Optional<Value> value = ParseNextToken();
+    Optional<typename Builder::Node> value = ParseNextToken(builder);
     if (!value) {
       // ReportError from deeper level.
       return nullopt;
     }
 
-    dict_storage.emplace_back(key.DestructiveAsString(),
-                              std::make_unique<Value>(std::move(*value)));
+    builder->Insert(&dict, &key, std::move(*value));
 
     token = GetNextToken();
     if (token == T_LIST_SEPARATOR) {
@@ -386,10 +459,11 @@ Optional<Value> JSONParser::ConsumeDictionary() {
 
   ConsumeChar();  // Closing '}'.
 
-  return Value(Value::DictStorage(std::move(dict_storage), KEEP_LAST_OF_DUPES));
+  return builder->EndDict(&dict);
 }
 
-Optional<Value> JSONParser::ConsumeList() {
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ConsumeList(Builder* builder) {
   if (ConsumeChar() != '[') {
     ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
     return nullopt;
@@ -401,17 +475,17 @@ Optional<Value> JSONParser::ConsumeList() {
     return nullopt;
   }
 
-  Value::ListStorage list_storage;
+  typename Builder::List list = builder->BeginList();
 
   Token token = GetNextToken();
   while (token != T_ARRAY_END) {
-    Optional<Value> item = ParseToken(token);
+    Optional<typename Builder::Node> item = ParseToken(token, builder);
     if (!item) {
       // ReportError from deeper level.
       return nullopt;
     }
 
-    list_storage.push_back(std::move(*item));
+    builder->Append(&list, std::move(*item));
 
     token = GetNextToken();
     if (token == T_LIST_SEPARATOR) {
@@ -429,15 +503,16 @@ Optional<Value> JSONParser::ConsumeList() {
 
   ConsumeChar();  // Closing ']'.
 
-  return Value(std::move(list_storage));
+  return builder->EndList(&list);
 }
 
-Optional<Value> JSONParser::ConsumeString() {
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ConsumeString(Builder* builder) {
   StringBuilder string;
   if (!ConsumeStringRaw(&string))
     return nullopt;
 
-  return Value(string.DestructiveAsString());
+  return builder->String(&string);
 }
 
 bool JSONParser::ConsumeStringRaw(StringBuilder* out) {
@@ -618,7 +693,8 @@ bool JSONParser::DecodeUTF16(uint32_t* out_code_point) {
   return true;
 }
 
-Optional<Value> JSONParser::ConsumeNumber() {
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ConsumeNumber(Builder* builder) {
   const char* num_start = pos();
   const int start_index = index_;
   int end_index = start_index;
@@ -679,12 +755,12 @@ Optional<Value> JSONParser::ConsumeNumber() {
 
   int num_int;
   if (StringToInt(num_string, &num_int))
-    return Value(num_int);
+    return builder->Int(num_int);
 
   double num_double;
   if (StringToDouble(num_string.as_string(), &num_double) &&
       std::isfinite(num_double)) {
-    return Value(num_double);
+    return builder->Double(num_double);
   }
 
   return nullopt;
@@ -714,17 +790,25 @@ bool JSONParser::ReadInt(bool allow_leading_zeros) {
   return true;
 }
 
-Optional<Value> JSONParser::ConsumeLiteral() {
+template <typename Builder>
+Optional<typename Builder::Node> JSONParser::ConsumeLiteral(Builder* builder) {
   if (ConsumeIfMatch("true"))
-    return Value(true);
+    return builder->Bool(true);
   if (ConsumeIfMatch("false"))
-    return Value(false);
+    return builder->Bool(false);
   if (ConsumeIfMatch("null"))
-    return Value(Value::Type::NONE);
+    return builder->Null();
   ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
   return nullopt;
 }
 
+// The tests call these directly, with a ValueBuilder.
+template Optional<Value> JSONParser::ConsumeDictionary(ValueBuilder* builder);
+template Optional<Value> JSONParser::ConsumeList(ValueBuilder* builder);
+template Optional<Value> JSONParser::ConsumeString(ValueBuilder* builder);
+template Optional<Value> JSONParser::ConsumeNumber(ValueBuilder* builder);
+template Optional<Value> JSONParser::ConsumeLiteral(ValueBuilder* builder);
+
 bool JSONParser::ConsumeIfMatch(StringPiece match) {
   if (match == PeekChars(match.size())) {
     ConsumeChars(match.size());
@@ -10,6 +10,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/compiler_specific.h"
@@ -18,10 +20,12 @@
 #include "base/macros.h"
 #include "base/optional.h"
 #include "base/strings/string_piece.h"
+#include "base/values.h"
 
 namespace base {
 
-class Value;
+class ArenaValue;
+class ValueArena;
 
 namespace internal {
 
@@ -52,6 +56,10 @@ class BASE_EXPORT JSONParser {
   // convert to a FooValue at the same time.
   Optional<Value> Parse(StringPiece input);
 
+  // Parses the input string like Parse(), but allocates the result and all of
+  // its strings from |arena|.
+  Optional<ArenaValue> ParseIntoArena(StringPiece input, ValueArena* arena);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -115,6 +123,10 @@ class BASE_EXPORT JSONParser {
     // in cases where the builder will not be needed any more.
     std::string DestructiveAsString();
 
+    // Returns the builder as a StringPiece, which is valid until the builder
+    // is modified or destroyed.
+    StringPiece AsStringPiece() const;
+
    private:
     // The beginning of the input string.
     const char* pos_;
@@ -127,6 +139,44 @@ class BASE_EXPORT JSONParser {
     base::Optional<std::string> string_;
   };
 
+  // The policies with which the functions below build the parse tree, out of
+  // Values or out of ArenaValues respectively. Builder::Node is the type of the
+  // tree's nodes. ValueBuilder is declared here so that tests can call those
+  // functions directly; ArenaValueBuilder is in json_parser.cc.
+  class ValueBuilder {
+   public:
+    using Node = Value;
+    using List = Value::ListStorage;
+    using Dict = std::vector<Value::DictStorage::value_type>;
+
+    List BeginList() { return List(); }
+    void Append(List* list, Value item) { list->push_back(std::move(item)); }
+    Value EndList(List* list) { return Value(std::move(*list)); }
+
+    Dict BeginDict() { return Dict(); }
+    void Insert(Dict* dict, StringBuilder* key, Value value) {
+      dict->emplace_back(key->DestructiveAsString(),
+                         std::make_unique<Value>(std::move(value)));
+    }
+    Value EndDict(Dict* dict) {
+      return Value(Value::DictStorage(std::move(*dict), KEEP_LAST_OF_DUPES));
+    }
+
+    Value String(StringBuilder* string) {
+      return Value(string->DestructiveAsString());
+    }
+    Value Int(int value) { return Value(value); }
+    Value Double(double value) { return Value(value); }
+    Value Bool(bool value) { return Value(value); }
+    Value Null() { return Value(Value::Type::NONE); }
+  };
+  class ArenaValueBuilder;
+
+  // Implements Parse() and ParseIntoArena().
+  template <typename Builder>
+  Optional<typename Builder::Node> ParseWithBuilder(StringPiece input,
+                                                    Builder* builder);
+
   // Returns the next |count| bytes of the input stream, or nullopt if fewer
   // than |count| bytes remain.
   Optional<StringPiece> PeekChars(size_t count);
@@ -156,22 +206,27 @@ class BASE_EXPORT JSONParser {
   bool EatComment();
 
   // Calls GetNextToken() and then ParseToken().
-  Optional<Value> ParseNextToken();
+  template <typename Builder>
+  Optional<typename Builder::Node> ParseNextToken(Builder* builder);
 
   // Takes a token that represents the start of a Value ("a structural token"
-  // in RFC terms) and consumes it, returning the result as a Value.
-  Optional<Value> ParseToken(Token token);
+  // in RFC terms) and consumes it, returning the result as a Node.
+  template <typename Builder>
+  Optional<typename Builder::Node> ParseToken(Token token, Builder* builder);
 
   // Assuming that the parser is currently wound to '{', this parses a JSON
-  // object into a Value.
-  Optional<Value> ConsumeDictionary();
+  // object into a Node.
+  template <typename Builder>
+  Optional<typename Builder::Node> ConsumeDictionary(Builder* builder);
 
   // Assuming that the parser is wound to '[', this parses a JSON list into a
-  // Value.
-  Optional<Value> ConsumeList();
+  // Node.
+  template <typename Builder>
+  Optional<typename Builder::Node> ConsumeList(Builder* builder);
 
-  // Calls through ConsumeStringRaw and wraps it in a value.
-  Optional<Value> ConsumeString();
+  // Calls through ConsumeStringRaw and wraps it in a Node.
+  template <typename Builder>
+  Optional<typename Builder::Node> ConsumeString(Builder* builder);
 
   // Assuming that the parser is wound to a double quote, this parses a string,
   // decoding any escape sequences and converts UTF-16 to UTF-8. Returns true on
@@ -186,14 +241,16 @@ class BASE_EXPORT JSONParser {
 
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
-  Optional<Value> ConsumeNumber();
+  template <typename Builder>
+  Optional<typename Builder::Node> ConsumeNumber(Builder* builder);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
 
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
-  Optional<Value> ConsumeLiteral();
+  template <typename Builder>
+  Optional<typename Builder::Node> ConsumeLiteral(Builder* builder);
 
   // Helper function that returns true if the byte squence |match| can be
   // consumed at the current parser position. Returns false if there are fewer
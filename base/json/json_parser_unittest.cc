@@ -67,7 +67,8 @@ TEST_F(JSONParserTest, NextChar) {
 TEST_F(JSONParserTest, ConsumeString) {
   std::string input("\"test\",|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
-  Optional<Value> value(parser->ConsumeString());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeString(&builder));
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -81,7 +82,8 @@ TEST_F(JSONParserTest, ConsumeString) {
 TEST_F(JSONParserTest, ConsumeList) {
   std::string input("[true, false],|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
-  Optional<Value> value(parser->ConsumeList());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeList(&builder));
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -95,7 +97,8 @@ TEST_F(JSONParserTest, ConsumeList) {
 TEST_F(JSONParserTest, ConsumeDictionary) {
   std::string input("{\"abc\":\"def\"},|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
-  Optional<Value> value(parser->ConsumeDictionary());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeDictionary(&builder));
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -112,7 +115,8 @@ TEST_F(JSONParserTest, ConsumeLiterals) {
   // Literal |true|.
   std::string input("true,|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
-  Optional<Value> value(parser->ConsumeLiteral());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeLiteral(&builder));
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -125,7 +129,7 @@ TEST_F(JSONParserTest, ConsumeLiterals) {
   // Literal |false|.
   input = "false,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeLiteral();
+  value = parser->ConsumeLiteral(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -137,7 +141,7 @@ TEST_F(JSONParserTest, ConsumeLiterals) {
   // Literal |null|.
   input = "null,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeLiteral();
+  value = parser->ConsumeLiteral(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -150,7 +154,8 @@ TEST_F(JSONParserTest, ConsumeNumbers) {
   // Integer.
   std::string input("1234,|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
-  Optional<Value> value(parser->ConsumeNumber());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeNumber(&builder));
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -163,7 +168,7 @@ TEST_F(JSONParserTest, ConsumeNumbers) {
   // Negative integer.
   input = "-1234,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeNumber();
+  value = parser->ConsumeNumber(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -175,7 +180,7 @@ TEST_F(JSONParserTest, ConsumeNumbers) {
   // Double.
   input = "12.34,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeNumber();
+  value = parser->ConsumeNumber(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -188,7 +193,7 @@ TEST_F(JSONParserTest, ConsumeNumbers) {
   // Scientific.
   input = "42e3,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeNumber();
+  value = parser->ConsumeNumber(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -200,7 +205,7 @@ TEST_F(JSONParserTest, ConsumeNumbers) {
   // Negative scientific.
   input = "314159e-5,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeNumber();
+  value = parser->ConsumeNumber(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -212,7 +217,7 @@ TEST_F(JSONParserTest, ConsumeNumbers) {
   // Positive scientific.
   input = "0.42e+3,|";
   parser.reset(NewTestParser(input));
-  value = parser->ConsumeNumber();
+  value = parser->ConsumeNumber(&builder);
   EXPECT_EQ(',', *parser->pos());
 
   TestLastThree(parser.get());
@@ -365,7 +370,8 @@ TEST_F(JSONParserTest, ReplaceInvalidCharacters) {
   const std::string quoted_bogus_char = "\"" + bogus_char + "\"";
   std::unique_ptr<JSONParser> parser(
       NewTestParser(quoted_bogus_char, JSON_REPLACE_INVALID_CHARACTERS));
-  Optional<Value> value(parser->ConsumeString());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeString(&builder));
   ASSERT_TRUE(value);
   std::string str;
   EXPECT_TRUE(value->GetAsString(&str));
@@ -376,7 +382,8 @@ TEST_F(JSONParserTest, ReplaceInvalidUTF16EscapeSequence) {
   const std::string invalid = "\"\\ufffe\"";
   std::unique_ptr<JSONParser> parser(
       NewTestParser(invalid, JSON_REPLACE_INVALID_CHARACTERS));
-  Optional<Value> value(parser->ConsumeString());
+  JSONParser::ValueBuilder builder;
+  Optional<Value> value(parser->ConsumeString(&builder));
   ASSERT_TRUE(value);
   std::string str;
   EXPECT_TRUE(value->GetAsString(&str));
@@ -2,9 +2,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "base/arena_value.h"
+#include "base/bind.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/memory/ptr_util.h"
+#include "base/process/process_metrics.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -48,6 +57,55 @@ std::unique_ptr<DictionaryValue> GenerateLayeredDict(int breadth, int depth) {
   return root;
 }
 
+// Generates a list of |count| dictionaries like GenerateDict(), as in a
+// preference or policy file with many small records.
+std::unique_ptr<ListValue> GenerateRecordList(int count) {
+  auto list = std::make_unique<ListValue>();
+  for (int i = 0; i < count; ++i) {
+    auto dict = GenerateDict();
+    dict->SetString("Id", "record_" + std::to_string(i));
+    list->Append(std::move(dict));
+  }
+  return list;
+}
+
+// The number of input bytes parsed for each measurement.
+constexpr size_t kParseBytesPerMeasurement = 64 * 1024 * 1024;
+
+// The number of times the peak heap use of parsing is sampled over.
+constexpr int kPeakMemoryIterations = 20;
+
+// Runs |task| |iterations| times and returns the highest malloc usage of the
+// process meanwhile, less the usage beforehand. The usage is sampled from
+// another thread, so short-lived peaks can be missed on a single run.
+size_t PeakMallocUsageOf(RepeatingClosure task, int iterations) {
+  std::unique_ptr<ProcessMetrics> metrics =
+      ProcessMetrics::CreateCurrentProcessMetrics();
+  const size_t before = metrics->GetMallocUsage();
+  std::atomic<size_t> peak(before);
+  std::atomic<bool> done(false);
+
+  Thread sampler("MallocUsageSampler");
+  sampler.Start();
+  sampler.task_runner()->PostTask(
+      FROM_HERE,
+      BindOnce(
+          [](ProcessMetrics* metrics, std::atomic<size_t>* peak,
+             const std::atomic<bool>* done) {
+            while (!done->load()) {
+              peak->store(std::max(peak->load(), metrics->GetMallocUsage()));
+              PlatformThread::Sleep(TimeDelta::FromMicroseconds(100));
+            }
+          },
+          metrics.get(), &peak, &done));
+  for (int i = 0; i < iterations; ++i)
+    task.Run();
+  done.store(true);
+  sampler.Stop();
+
+  return std::max(peak.load(), metrics->GetMallocUsage()) - before;
+}
+
 }  // namespace
 
 class JSONPerfTest : public testing::Test {
@@ -72,13 +130,71 @@ class JSONPerfTest : public testing::Test {
                            (end_read - start_read).InMillisecondsF(), "ms",
                            true);
   }
+
+  // Measures parsing |json| into a Value and into an ArenaValue and throwing
+  // the result away, copying the ArenaValue out into a Value, and the peak
+  // heap use of parsing into each.
+  void TestParseAndDiscard(const std::string& description,
+                           const std::string& json) {
+    const size_t iterations =
+        std::max<size_t>(1, kParseBytesPerMeasurement / json.size());
+    const double megabytes =
+        iterations * json.size() / static_cast<double>(1024 * 1024);
+
+    TimeTicks start = TimeTicks::Now();
+    for (size_t i = 0; i < iterations; ++i)
+      ASSERT_TRUE(JSONReader::Read(json));
+    TimeDelta value_time = TimeTicks::Now() - start;
+
+    start = TimeTicks::Now();
+    for (size_t i = 0; i < iterations; ++i) {
+      ValueArena arena;
+      ASSERT_TRUE(JSONReader::ReadIntoArena(json, &arena));
+    }
+    TimeDelta arena_time = TimeTicks::Now() - start;
+
+    TimeDelta copy_time;
+    {
+      ValueArena arena;
+      Optional<ArenaValue> arena_root = JSONReader::ReadIntoArena(json, &arena);
+      start = TimeTicks::Now();
+      Value copy = arena_root->ToValue();
+      copy_time = TimeTicks::Now() - start;
+    }
+
+    perf_test::PrintResult("ParseAndDiscard", "_Value", description,
+                           megabytes / value_time.InSecondsF(), "MB/s", true);
+    perf_test::PrintResult("ParseAndDiscard", "_ArenaValue", description,
+                           megabytes / arena_time.InSecondsF(), "MB/s", true);
+    perf_test::PrintResult("ArenaValueToValue", "", description,
+                           copy_time.InMillisecondsF(), "ms", true);
+
+    const size_t value_peak = PeakMallocUsageOf(
+        BindRepeating([](const std::string* json) { JSONReader::Read(*json); },
+                      &json),
+        kPeakMemoryIterations);
+    const size_t arena_peak = PeakMallocUsageOf(
+        BindRepeating(
+            [](const std::string* json) {
+              ValueArena arena;
+              JSONReader::ReadIntoArena(*json, &arena);
+            },
+            &json),
+        kPeakMemoryIterations);
+    perf_test::PrintResult("PeakMemory", "_Value", description, value_peak,
+                           "bytes", true);
+    perf_test::PrintResult("PeakMemory", "_ArenaValue", description,
+                           arena_peak, "bytes", true);
+  }
 };
 
 // Times out on Android (crbug.com/906686).
 #if defined(OS_ANDROID)
 #define MAYBE_StressTest DISABLED_StressTest
+#define MAYBE_ParseAndDiscard DISABLED_ParseAndDiscard
 #else
 #define MAYBE_StressTest StressTest
+#define MAYBE_ParseAndDiscard ParseAndDiscard
 #endif
 TEST_F(JSONPerfTest, MAYBE_StressTest) {
   for (int i = 0; i < 4; ++i) {
@@ -88,4 +204,12 @@ TEST_F(JSONPerfTest, MAYBE_StressTest) {
   }
 }
 
+TEST_F(JSONPerfTest, MAYBE_ParseAndDiscard) {
+  std::string json;
+  JSONWriter::Write(*GenerateLayeredDict(4, 8), &json);
+  TestParseAndDiscard("LayeredDict", json);
+  JSONWriter::Write(*GenerateRecordList(50000), &json);
+  TestParseAndDiscard("RecordList", json);
+}
+
 }  // namespace base
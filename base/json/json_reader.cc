@@ -7,6 +7,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/arena_value.h"
 #include "base/json/json_parser.h"
 #include "base/logging.h"
 #include "base/optional.h"
@@ -52,6 +53,15 @@ Optional<Value> JSONReader::Read(StringPiece json, int options, int max_depth) {
   return parser.Parse(json);
 }
 
+// static
+Optional<ArenaValue> JSONReader::ReadIntoArena(StringPiece json,
+                                               ValueArena* arena,
+                                               int options,
+                                               int max_depth) {
+  internal::JSONParser parser(options, max_depth);
+  return parser.ParseIntoArena(json, arena);
+}
+
 std::unique_ptr<Value> JSONReader::ReadDeprecated(StringPiece json,
                                                   int options,
                                                   int max_depth) {
@@ -37,7 +37,9 @@
 
 namespace base {
 
+class ArenaValue;
 class Value;
+class ValueArena;
 
 namespace internal {
 class JSONParser;
@@ -99,6 +101,14 @@ class BASE_EXPORT JSONReader {
                               int options = JSON_PARSE_RFC,
                               int max_depth = kStackMaxDepth);
 
+  // Reads and parses |json| like Read(), but allocates the result from
+  // |arena|, which must outlive it. This is cheaper to build and to destroy
+  // than a Value; see base/arena_value.h.
+  static Optional<ArenaValue> ReadIntoArena(StringPiece json,
+                                            ValueArena* arena,
+                                            int options = JSON_PARSE_RFC,
+                                            int max_depth = kStackMaxDepth);
+
   // Deprecated. Use the Read() method above.
   // Reads and parses |json|, returning a Value.
   // If |json| is not a properly formed JSON string, returns nullptr.
@@ -8,6 +8,7 @@
 
 #include <memory>
 
+#include "base/arena_value.h"
 #include "base/base_paths.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
@@ -672,4 +673,53 @@ TEST(JSONReaderTest, MaxNesting) {
   EXPECT_TRUE(JSONReader::Read(json, JSON_PARSE_RFC, 4));
 }
 
+TEST(JSONReaderTest, ReadIntoArenaMatchesRead) {
+  const char* const kJson[] = {
+      "null",
+      "[]",
+      "{}",
+      "[true, false, 1, -2.5, 1e300, \"a\", [[]], {\"x\": {}}]",
+      R"({"b": 1, "a": [1, {"c": "\u00e9\n"}], "b": 2, "": null})",
+      "\xEF\xBB\xBF{\"bom\": \"\xE2\x82\xAC\"}",
+  };
+
+  for (const char* json : kJson) {
+    SCOPED_TRACE(json);
+    Optional<Value> expected = JSONReader::Read(json);
+    ASSERT_TRUE(expected);
+    ValueArena arena;
+    Optional<ArenaValue> root = JSONReader::ReadIntoArena(json, &arena);
+    ASSERT_TRUE(root);
+    EXPECT_EQ(*root, *expected);
+    EXPECT_EQ(*expected, root->ToValue());
+  }
+}
+
+TEST(JSONReaderTest, ReadIntoArenaOutlivesInput) {
+  ValueArena arena;
+  Optional<ArenaValue> root;
+  {
+    std::string json = R"({"key": ["value", "esc\"aped"]})";
+    root = JSONReader::ReadIntoArena(json, &arena);
+    json.assign(json.size(), 'x');
+  }
+  ASSERT_TRUE(root);
+  const ArenaValue* list = root->FindKeyOfType("key", Value::Type::LIST);
+  ASSERT_TRUE(list);
+  ASSERT_EQ(2u, list->GetList().size());
+  EXPECT_EQ("value", list->GetList()[0].GetString());
+  EXPECT_EQ("esc\"aped", list->GetList()[1].GetString());
+}
+
+TEST(JSONReaderTest, ReadIntoArenaErrors) {
+  ValueArena arena;
+  EXPECT_FALSE(JSONReader::ReadIntoArena("[1, 2", &arena));
+  EXPECT_FALSE(JSONReader::ReadIntoArena("[1, 2,]", &arena));
+  EXPECT_TRUE(
+      JSONReader::ReadIntoArena("[1, 2,]", &arena, JSON_ALLOW_TRAILING_COMMAS));
+  std::string json(R"({"outer": { "inner": {"foo": true}}})");
+  EXPECT_FALSE(JSONReader::ReadIntoArena(json, &arena, JSON_PARSE_RFC, 3));
+  EXPECT_TRUE(JSONReader::ReadIntoArena(json, &arena, JSON_PARSE_RFC, 4));
+}
+
 }  // namespace base
@@ -6,15 +6,454 @@
 
 #include <pthread.h>
 
+#include "base/debug/debugging_buildflags.h"
 #include "base/threading/platform_thread.h"
 #include "build/build_config.h"
 
+// The Linux sampler interrupts the target thread with a signal, copies its
+// stack from the signal handler, and then walks the copy with its frame
+// pointers on the sampling thread.
+#if defined(OS_LINUX) && BUILDFLAG(CAN_UNWIND_WITH_FRAME_POINTERS) && \
+    (defined(ARCH_CPU_X86_64) || defined(ARCH_CPU_ARM64))
+#define NATIVE_STACK_SAMPLER_LINUX 1
+#endif
+
+#if defined(NATIVE_STACK_SAMPLER_LINUX)
+#include <errno.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "base/debug/proc_maps_linux.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/sampling_heap_profiler/module_cache.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#endif
+
 namespace base {
 
+#if defined(NATIVE_STACK_SAMPLER_LINUX)
+
+using Frame = StackSamplingProfiler::Frame;
+using ProfileBuilder = StackSamplingProfiler::ProfileBuilder;
+
+namespace {
+
+// Not otherwise used by Chrome on Linux, and ignored by default, so a signal
+// that arrives after its handler was uninstalled is harmless.
+constexpr int kSamplerSignal = SIGURG;
+
+// How long to wait for the target thread to run the signal handler, which it
+// doesn't if it blocks the signal.
+constexpr TimeDelta kSignalTimeout = TimeDelta::FromMilliseconds(100);
+
+// How often to check whether the signal handler is done.
+constexpr TimeDelta kSignalPollInterval = TimeDelta::FromMicroseconds(50);
+
+// Stops walking after this many frames, in case of a corrupt stack.
+constexpr size_t kMaxFrames = 1024;
+
+// Enough to resume almost all frame pointer chains broken by system libraries,
+// like base::debug::TraceStackFramePointers() does.
+constexpr uintptr_t kMaxStackScanArea = 8192;
+
+// Assume huge stack frames are bogus.
+constexpr uintptr_t kMaxFrameSize = 100000;
+
+// The states of a stack copy, shared by the sampling thread and the signal
+// handler. Only one of them can move the copy out of kPending, so the sampling
+// thread can give up on the target thread without racing with the handler.
+enum CopyState : int {
+  // No copy is pending. The handler does nothing.
+  kIdle,
+  // The sampling thread has signaled the target thread.
+  kPending,
+  // The handler is copying the stack.
+  kCopying,
+};
+
+// The input and output of the signal handler. There is a single instance,
+// since the handler can run after the sampling thread gave up on it, and
+// GetCopyLock() allows a single copy at a time.
+struct CopyParams {
+  CopyParams() { sem_init(&done, 0, 0); }
+
+  std::atomic<int> state{kIdle};
+  // Posted by the handler once it has copied the stack.
+  sem_t done;
+
+  // The thread to copy the stack of. Set before |state| moves to kPending, and
+  // read by handlers on any thread to tell whether the copy is theirs.
+  std::atomic<pid_t> target_tid{0};
+
+  // Inputs. The stack is copied only if its stack pointer is within
+  // [stack_bottom, stack_top) and it fits in the buffer.
+  uintptr_t stack_bottom = 0;
+  uintptr_t stack_top = 0;
+  uintptr_t* buffer = nullptr;
+  size_t buffer_size = 0;
+
+  // Outputs.
+  uintptr_t pc = 0;
+  uintptr_t sp = 0;
+  uintptr_t fp = 0;
+  bool copied = false;
+};
+
+CopyParams& GetCopyParams() {
+  static NoDestructor<CopyParams> params;
+  return *params;
+}
+
+Lock& GetCopyLock() {
+  static NoDestructor<Lock> lock;
+  return *lock;
+}
+
+// Copies [|bottom|, |top|) to |buffer|, word by word.
+//
+// Note that this is called from a signal handler, on the thread whose stack is
+// copied. It must only call async-signal-safe functions.
+void CopyStack(uintptr_t* buffer,
+               const uintptr_t* bottom,
+               const uintptr_t* top) NO_SANITIZE("address") {
+  while (bottom < top)
+    *buffer++ = *bottom++;
+}
+
+void HandleSignal(int signal, siginfo_t* info, void* context) {
+  CopyParams& params = GetCopyParams();
+  // A signal to a thread the sampling thread gave up on can arrive during
+  // another copy. Leave that copy alone rather than claiming it and handing it
+  // back, which would make the sampling thread wait on this thread.
+  const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  if (params.state.load(std::memory_order_acquire) != kPending ||
+      params.target_tid.load(std::memory_order_relaxed) != tid) {
+    return;
+  }
+  int expected = kPending;
+  if (!params.state.compare_exchange_strong(expected, kCopying,
+                                            std::memory_order_acquire)) {
+    return;
+  }
+  // The sampling thread may have given up and moved on to another thread
+  // between the check above and the exchange.
+  if (params.target_tid.load(std::memory_order_relaxed) != tid) {
+    params.state.store(kPending, std::memory_order_release);
+    return;
+  }
+  // Don't clobber the errno of the interrupted code.
+  const int saved_errno = errno;
+  const ucontext_t* ucontext = static_cast<ucontext_t*>(context);
+#if defined(ARCH_CPU_X86_64)
+  params.pc = ucontext->uc_mcontext.gregs[REG_RIP];
+  params.sp = ucontext->uc_mcontext.gregs[REG_RSP];
+  params.fp = ucontext->uc_mcontext.gregs[REG_RBP];
+#elif defined(ARCH_CPU_ARM64)
+  params.pc = ucontext->uc_mcontext.pc;
+  params.sp = ucontext->uc_mcontext.sp;
+  params.fp = ucontext->uc_mcontext.regs[29];
+#endif
+
+  const uintptr_t sp = params.sp & ~(sizeof(uintptr_t) - 1);
+  params.copied = sp >= params.stack_bottom && sp < params.stack_top &&
+                  params.stack_top - sp <= params.buffer_size;
+  if (params.copied) {
+    CopyStack(params.buffer, reinterpret_cast<const uintptr_t*>(sp),
+              reinterpret_cast<const uintptr_t*>(params.stack_top));
+    params.sp = sp;
+  }
+
+  params.state.store(kIdle, std::memory_order_release);
+  sem_post(&params.done);
+  errno = saved_errno;
+}
+
+// Installs HandleSignal() for kSamplerSignal for the lifetime of the object.
+class ScopedSignalHandler {
+ public:
+  ScopedSignalHandler() {
+    struct sigaction action = {};
+    action.sa_sigaction = &HandleSignal;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    succeeded_ = sigaction(kSamplerSignal, &action, &original_action_) == 0;
+  }
+
+  ~ScopedSignalHandler() {
+    if (succeeded_)
+      sigaction(kSamplerSignal, &original_action_, nullptr);
+  }
+
+  bool succeeded() const { return succeeded_; }
+
+ private:
+  struct sigaction original_action_;
+  bool succeeded_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedSignalHandler);
+};
+
+// The registers and stack of a thread, as copied by CopyThreadStack().
+struct ThreadStackCopy {
+  uintptr_t pc = 0;
+  uintptr_t sp = 0;
+  uintptr_t fp = 0;
+  bool copied = false;
+};
+
+// Makes |thread_id| copy its stack to |buffer| if its stack pointer is within
+// [|stack_bottom|, |stack_top|), and return its registers. Returns false if the
+// thread didn't handle the signal in time.
+bool CopyThreadStack(PlatformThreadId thread_id,
+                     uintptr_t stack_bottom,
+                     uintptr_t stack_top,
+                     uintptr_t* buffer,
+                     size_t buffer_size,
+                     ThreadStackCopy* copy) {
+  AutoLock lock(GetCopyLock());
+  CopyParams& params = GetCopyParams();
+  params.target_tid.store(thread_id, std::memory_order_relaxed);
+  params.stack_bottom = stack_bottom;
+  params.stack_top = stack_top;
+  params.buffer = buffer;
+  params.buffer_size = buffer_size;
+
+  ScopedSignalHandler handler;
+  if (!handler.succeeded())
+    return false;
+
+  params.state.store(kPending, std::memory_order_release);
+  if (syscall(SYS_tgkill, getpid(), thread_id, kSamplerSignal) != 0) {
+    params.state.store(kIdle, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Poll rather than use sem_timedwait(), whose deadline is on CLOCK_REALTIME,
+  // so that a clock change doesn't stretch or cut short the wait.
+  const TimeTicks deadline = TimeTicks::Now() + kSignalTimeout;
+  bool handled;
+  while (!(handled = sem_trywait(&params.done) == 0) &&
+         TimeTicks::Now() < deadline) {
+    PlatformThread::Sleep(kSignalPollInterval);
+  }
+
+  if (!handled) {
+    // Give up, unless the handler is running, in which case it finishes soon:
+    // it doesn't block.
+    while (true) {
+      int expected = kPending;
+      if (params.state.compare_exchange_strong(expected, kIdle,
+                                               std::memory_order_acquire)) {
+        return false;
+      }
+      if (expected == kIdle)
+        break;
+      PlatformThread::YieldCurrentThread();
+    }
+    while (sem_wait(&params.done) != 0 && errno == EINTR) {
+    }
+  }
+  DCHECK_EQ(kIdle, params.state.load(std::memory_order_acquire));
+
+  copy->pc = params.pc;
+  copy->sp = params.sp;
+  copy->fp = params.fp;
+  copy->copied = params.copied;
+  return true;
+}
+
+// NativeStackSamplerLinux ----------------------------------------------------
+
+class NativeStackSamplerLinux : public NativeStackSampler {
+ public:
+  NativeStackSamplerLinux(PlatformThreadId thread_id,
+                          NativeStackSamplerTestDelegate* test_delegate);
+  ~NativeStackSamplerLinux() override;
+
+  // StackSamplingProfiler::NativeStackSampler:
+  void ProfileRecordingStarting() override;
+  std::vector<Frame> RecordStackFrames(
+      StackBuffer* stack_buffer,
+      ProfileBuilder* profile_builder) override;
+
+ private:
+  // Finds the mapping of the stack of |thread_id_|, from its stack pointer.
+  // Returns false if it can't.
+  bool FindStackBounds();
+
+  // Walks the copy of the stack at |stack_copy|, whose original started at
+  // |copy.sp|, with its frame pointers. Appends the frames to |frames|.
+  void WalkStack(const ThreadStackCopy& copy,
+                 const uintptr_t* stack_copy,
+                 std::vector<Frame>* frames);
+
+  const PlatformThreadId thread_id_;
+
+  NativeStackSamplerTestDelegate* const test_delegate_;
+
+  // The bounds of the stack of |thread_id_|, or 0 if not found yet. The
+  // bottom is 0 for the main thread, whose stack mapping grows on demand.
+  uintptr_t stack_bottom_ = 0;
+  uintptr_t stack_top_ = 0;
+
+  // Maps a module's address range to the module.
+  ModuleCache module_cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeStackSamplerLinux);
+};
+
+NativeStackSamplerLinux::NativeStackSamplerLinux(
+    PlatformThreadId thread_id,
+    NativeStackSamplerTestDelegate* test_delegate)
+    : thread_id_(thread_id), test_delegate_(test_delegate) {}
+
+NativeStackSamplerLinux::~NativeStackSamplerLinux() = default;
+
+void NativeStackSamplerLinux::ProfileRecordingStarting() {
+  module_cache_.Clear();
+  if (!stack_top_ && !FindStackBounds())
+    DLOG(WARNING) << "Could not find the stack of thread " << thread_id_;
+}
+
+std::vector<Frame> NativeStackSamplerLinux::RecordStackFrames(
+    StackBuffer* stack_buffer,
+    ProfileBuilder* profile_builder) {
+  std::vector<Frame> frames;
+  if (!stack_top_)
+    return frames;
+
+  ThreadStackCopy copy;
+  uintptr_t* const stack_copy =
+      reinterpret_cast<uintptr_t*>(stack_buffer->buffer());
+  if (!CopyThreadStack(thread_id_, stack_bottom_, stack_top_, stack_copy,
+                       stack_buffer->size(), &copy) ||
+      !copy.copied) {
+    return frames;
+  }
+
+  // The thread has resumed, so unlike on the platforms that suspend it, this
+  // happens just after the stack is copied rather than while it is.
+  profile_builder->RecordMetadata();
+
+  if (test_delegate_)
+    test_delegate_->OnPreStackWalk();
+
+  // Reserve enough memory for most stacks, to avoid repeated allocations.
+  // Approximately 99.9% of recorded stacks are 128 frames or fewer.
+  frames.reserve(128);
+  WalkStack(copy, stack_copy, &frames);
+  return frames;
+}
+
+bool NativeStackSamplerLinux::FindStackBounds() {
+  ThreadStackCopy copy;
+  if (!CopyThreadStack(thread_id_, 0, 0, nullptr, 0, &copy))
+    return false;
+
+  std::string proc_maps;
+  std::vector<debug::MappedMemoryRegion> regions;
+  if (!debug::ReadProcMaps(&proc_maps) ||
+      !debug::ParseProcMaps(proc_maps, &regions)) {
+    return false;
+  }
+  for (const debug::MappedMemoryRegion& region : regions) {
+    if (copy.sp >= region.start && copy.sp < region.end) {
+      stack_bottom_ = region.path == "[stack]" ? 0 : region.start;
+      stack_top_ = region.end;
+      return true;
+    }
+  }
+  return false;
+}
+
+void NativeStackSamplerLinux::WalkStack(const ThreadStackCopy& copy,
+                                        const uintptr_t* stack_copy,
+                                        std::vector<Frame>* frames) {
+  const uintptr_t stack_bottom = copy.sp;
+  const uintptr_t stack_top = stack_top_;
+
+  // Reads the word at |address| of the original stack from the copy. The
+  // address must be word-aligned and within the copied range.
+  const auto read_word = [stack_copy, stack_bottom](uintptr_t address) {
+    return stack_copy[(address - stack_bottom) / sizeof(uintptr_t)];
+  };
+
+  // Whether |fp| is a frame record, made of the caller's frame pointer and the
+  // return address, older than the frame at |prev_fp|.
+  const auto is_valid_frame = [stack_top](uintptr_t fp, uintptr_t prev_fp) {
+    return fp > prev_fp && fp - prev_fp <= kMaxFrameSize &&
+           !(fp & (sizeof(uintptr_t) - 1)) &&
+           fp <= stack_top - 2 * sizeof(uintptr_t);
+  };
+
+  // Looks for a frame record above |fp| whose caller's frame is itself valid,
+  // to resume past code built without frame pointers, such as system
+  // libraries. Returns 0 if it finds none.
+  const auto scan_for_frame = [&](uintptr_t fp) -> uintptr_t {
+    const uintptr_t scan_end =
+        std::min(fp + kMaxStackScanArea, stack_top - 2 * sizeof(uintptr_t));
+    for (fp += sizeof(uintptr_t); fp <= scan_end; fp += sizeof(uintptr_t)) {
+      const uintptr_t next_fp = read_word(fp);
+      if (is_valid_frame(next_fp, fp) &&
+          is_valid_frame(read_word(next_fp), next_fp) &&
+          module_cache_.GetModuleForAddress(read_word(fp + sizeof(uintptr_t)))
+              .is_valid) {
+        return fp;
+      }
+    }
+    return 0;
+  };
+
+  const ModuleCache::Module& leaf_module =
+      module_cache_.GetModuleForAddress(copy.pc);
+  if (!leaf_module.is_valid)
+    return;
+  frames->emplace_back(copy.pc, leaf_module);
+
+  uintptr_t prev_fp = stack_bottom;
+  uintptr_t fp = copy.fp;
+  while (frames->size() < kMaxFrames) {
+    if (!is_valid_frame(fp, prev_fp) && (fp = scan_for_frame(prev_fp)) == 0)
+      return;
+
+    const uintptr_t return_address = read_word(fp + sizeof(uintptr_t));
+    // Ensure the return address is in a module. Stop at the unknown code,
+    // like the code of an unloaded library, rather than record a frame that
+    // can't be symbolized.
+    const ModuleCache::Module& module =
+        module_cache_.GetModuleForAddress(return_address);
+    if (!module.is_valid)
+      return;
+    frames->emplace_back(return_address, module);
+
+    prev_fp = fp;
+    fp = read_word(fp);
+  }
+}
+
+}  // namespace
+
+#endif  // defined(NATIVE_STACK_SAMPLER_LINUX)
+
 std::unique_ptr<NativeStackSampler> NativeStackSampler::Create(
     PlatformThreadId thread_id,
     NativeStackSamplerTestDelegate* test_delegate) {
+#if defined(NATIVE_STACK_SAMPLER_LINUX)
+  return std::make_unique<NativeStackSamplerLinux>(thread_id, test_delegate);
+#else
   return std::unique_ptr<NativeStackSampler>();
+#endif
 }
 
 size_t NativeStackSampler::GetStackBufferSize() {
@@ -0,0 +1,199 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/debug/debugging_buildflags.h"
+#include "base/macros.h"
+#include "base/profiler/stack_sampling_profiler.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/bind_test_util.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+// The platforms where NativeStackSampler::Create() returns a sampler.
+#if defined(_WIN64) || (defined(OS_MACOSX) && !defined(OS_IOS)) || \
+    (defined(OS_LINUX) && BUILDFLAG(CAN_UNWIND_WITH_FRAME_POINTERS) &&  \
+     (defined(ARCH_CPU_X86_64) || defined(ARCH_CPU_ARM64)))
+#define MAYBE_SamplingOverhead SamplingOverhead
+#else
+#define MAYBE_SamplingOverhead DISABLED_SamplingOverhead
+#endif
+
+namespace base {
+
+namespace {
+
+using Frame = StackSamplingProfiler::Frame;
+
+// The depth of the stack sampled, in frames of SpinAtDepth().
+constexpr int kStackDepth = 32;
+
+// Gaps between two readings of the clock by the sampled thread longer than
+// this are counted as the thread being paused.
+constexpr TimeDelta kPauseThreshold = TimeDelta::FromMicroseconds(2);
+
+constexpr int kSamples = 1000;
+constexpr TimeDelta kSamplingInterval = TimeDelta::FromMilliseconds(1);
+
+// Runs a busy loop at the bottom of a stack of kStackDepth frames, and
+// measures for how long it is paused, by the profiler or by the scheduler.
+class SpinningThread : public DelegateSimpleThread::Delegate {
+ public:
+  SpinningThread()
+      : started_(WaitableEvent::ResetPolicy::MANUAL,
+                 WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void Run() override {
+    thread_id_ = PlatformThread::CurrentId();
+    SpinAtDepth(kStackDepth);
+  }
+
+  PlatformThreadId WaitForThreadId() {
+    started_.Wait();
+    return thread_id_;
+  }
+
+  // Returns the total time the loop was paused for since the last call.
+  TimeDelta TakePausedTime() {
+    return TimeDelta::FromMicroseconds(
+        paused_us_.exchange(0, std::memory_order_relaxed));
+  }
+
+  void Stop() { stop_.store(true, std::memory_order_relaxed); }
+
+ private:
+  NOINLINE void SpinAtDepth(int depth) {
+    if (depth > 0) {
+      SpinAtDepth(depth - 1);
+      // Prevent a tail call.
+      stop_.load(std::memory_order_relaxed);
+      return;
+    }
+
+    started_.Signal();
+    TimeTicks last = TimeTicks::Now();
+    while (!stop_.load(std::memory_order_relaxed)) {
+      const TimeTicks now = TimeTicks::Now();
+      if (now - last > kPauseThreshold) {
+        paused_us_.fetch_add((now - last).InMicroseconds(),
+                             std::memory_order_relaxed);
+      }
+      last = now;
+    }
+  }
+
+  PlatformThreadId thread_id_ = kInvalidThreadId;
+  WaitableEvent started_;
+  std::atomic<int64_t> paused_us_{0};
+  std::atomic<bool> stop_{false};
+
+  DISALLOW_COPY_AND_ASSIGN(SpinningThread);
+};
+
+// Counts the samples and frames recorded.
+class CountingProfileBuilder : public StackSamplingProfiler::ProfileBuilder {
+ public:
+  using CompletedCallback = OnceCallback<void(size_t samples,
+                                              size_t frames,
+                                              TimeDelta profile_duration)>;
+
+  explicit CountingProfileBuilder(CompletedCallback callback)
+      : callback_(std::move(callback)) {}
+
+  // StackSamplingProfiler::ProfileBuilder:
+  void OnSampleCompleted(std::vector<Frame> frames) override {
+    ++samples_;
+    frames_ += frames.size();
+  }
+
+  void OnProfileCompleted(TimeDelta profile_duration,
+                          TimeDelta sampling_period) override {
+    std::move(callback_).Run(samples_, frames_,
+                             profile_duration - sampling_period);
+  }
+
+ private:
+  CompletedCallback callback_;
+  size_t samples_ = 0;
+  size_t frames_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingProfileBuilder);
+};
+
+// Profiles |thread_id| with |params|, and returns the number of samples, the
+// average number of frames per sample, and the duration of the profile.
+void Profile(PlatformThreadId thread_id,
+             const StackSamplingProfiler::SamplingParams& params,
+             size_t* samples,
+             size_t* frames,
+             TimeDelta* duration) {
+  WaitableEvent completed(WaitableEvent::ResetPolicy::MANUAL,
+                          WaitableEvent::InitialState::NOT_SIGNALED);
+  StackSamplingProfiler profiler(
+      thread_id, params,
+      std::make_unique<CountingProfileBuilder>(BindLambdaForTesting(
+          [&](size_t profile_samples, size_t profile_frames,
+              TimeDelta profile_duration) {
+            *samples = profile_samples;
+            *frames = profile_frames;
+            *duration = profile_duration;
+            completed.Signal();
+          })));
+  profiler.Start();
+  completed.Wait();
+}
+
+}  // namespace
+
+// Measures the time the sampling thread takes to record a sample, and the time
+// the sampled thread is paused for by each sample.
+TEST(StackSamplingProfilerPerfTest, MAYBE_SamplingOverhead) {
+  SpinningThread spinning_thread;
+  DelegateSimpleThread thread(&spinning_thread, "SpinningThread");
+  thread.Start();
+  const PlatformThreadId thread_id = spinning_thread.WaitForThreadId();
+
+  // Sample back to back: the profile lasts as long as the samples take.
+  StackSamplingProfiler::SamplingParams params;
+  params.samples_per_profile = kSamples;
+  params.sampling_interval = TimeDelta();
+  size_t samples = 0;
+  size_t frames = 0;
+  TimeDelta duration;
+  Profile(thread_id, params, &samples, &frames, &duration);
+  ASSERT_EQ(static_cast<size_t>(kSamples), samples);
+  EXPECT_LT(static_cast<size_t>(kStackDepth), frames / samples);
+  perf_test::PrintResult("stack_sampling", "", "time_per_sample",
+                         duration.InMicrosecondsF() / samples, "us", true);
+  perf_test::PrintResult("stack_sampling", "", "frames_per_sample",
+                         frames / samples, "frames", false);
+
+  // Compare the time the thread is paused for while sampled periodically with
+  // the time it is paused for by the scheduler alone, over as long.
+  params.sampling_interval = kSamplingInterval;
+  spinning_thread.TakePausedTime();
+  Profile(thread_id, params, &samples, &frames, &duration);
+  const TimeDelta sampled_paused_time = spinning_thread.TakePausedTime();
+  PlatformThread::Sleep(duration);
+  const TimeDelta baseline_paused_time = spinning_thread.TakePausedTime();
+  perf_test::PrintResult(
+      "stack_sampling", "", "thread_pause_per_sample",
+      (sampled_paused_time - baseline_paused_time).InMicrosecondsF() / samples,
+      "us", true);
+
+  spinning_thread.Stop();
+  thread.Join();
+}
+
+}  // namespace base
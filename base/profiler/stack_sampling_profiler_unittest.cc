@@ -14,6 +14,7 @@
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/debug/debugging_buildflags.h"
 #include "base/files/file_util.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
@@ -44,8 +45,11 @@
 #endif
 
 // STACK_SAMPLING_PROFILER_SUPPORTED is used to conditionally enable the tests
-// below for supported platforms (currently Win x64 and Mac x64).
-#if defined(_WIN64) || (defined(OS_MACOSX) && !defined(OS_IOS))
+// below for supported platforms (currently Win x64, Mac x64, and Linux x64 and
+// arm64 with frame pointers).
+#if defined(_WIN64) || (defined(OS_MACOSX) && !defined(OS_IOS)) || \
+    (defined(OS_LINUX) && BUILDFLAG(CAN_UNWIND_WITH_FRAME_POINTERS) &&  \
+     (defined(ARCH_CPU_X86_64) || defined(ARCH_CPU_ARM64)))
 #define STACK_SAMPLING_PROFILER_SUPPORTED 1
 #endif
 
@@ -4,12 +4,82 @@
 
 #include "base/sampling_heap_profiler/module_cache.h"
 
+#include <dlfcn.h>
+#include <elf.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "build/build_config.h"
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include "base/debug/elf_reader_linux.h"
+#endif
+
 namespace base {
 
+namespace {
+
+#if __SIZEOF_POINTER__ == 4
+using Ehdr = Elf32_Ehdr;
+using Phdr = Elf32_Phdr;
+#else
+using Ehdr = Elf64_Ehdr;
+using Phdr = Elf64_Phdr;
+#endif
+
+// Returns the size of the address range spanned by the loadable segments of
+// the ELF module loaded at |module_addr|, or 0 if it isn't one.
+size_t GetModuleSize(const void* module_addr) {
+  const char* base = static_cast<const char*>(module_addr);
+  if (memcmp(base, ELFMAG, SELFMAG) != 0)
+    return 0;
+
+  const Ehdr* elf_header = reinterpret_cast<const Ehdr*>(base);
+  const Phdr* phdrs = reinterpret_cast<const Phdr*>(base + elf_header->e_phoff);
+  uintptr_t first_vaddr = UINTPTR_MAX;
+  uintptr_t last_vaddr_end = 0;
+  for (size_t i = 0; i < elf_header->e_phnum; ++i) {
+    if (phdrs[i].p_type != PT_LOAD)
+      continue;
+    first_vaddr = std::min<uintptr_t>(first_vaddr, phdrs[i].p_vaddr);
+    last_vaddr_end = std::max<uintptr_t>(last_vaddr_end,
+                                         phdrs[i].p_vaddr + phdrs[i].p_memsz);
+  }
+  return last_vaddr_end > first_vaddr ? last_vaddr_end - first_vaddr : 0;
+}
+
+// Returns the module's build ID in the format of the symbol server: the GUID
+// breakpad forms from the ELF build ID, followed by an age of 0.
+// ReadElfBuildId() already pads the build ID and byte-swaps the GUID fields,
+// so the GUID is the first 32 hex digits of its result.
+std::string GetUniqueId(const void* module_addr) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  Optional<std::string> build_id = debug::ReadElfBuildId(module_addr);
+  if (build_id)
+    return build_id->substr(0, 32) + "0";
+#endif
+  return std::string();
+}
+
+}  // namespace
+
 // static
 ModuleCache::Module ModuleCache::CreateModuleForAddress(uintptr_t address) {
-  // TODO(alph): Implement it.
-  return Module();
+  Dl_info info;
+  if (!dladdr(reinterpret_cast<const void*>(address), &info) ||
+      !info.dli_fbase) {
+    return Module();
+  }
+
+  const size_t size = GetModuleSize(info.dli_fbase);
+  if (!size)
+    return Module();
+
+  return Module(reinterpret_cast<uintptr_t>(info.dli_fbase),
+                GetUniqueId(info.dli_fbase), FilePath(info.dli_fname), size);
 }
 
 }  // namespace base
@@ -17,7 +17,8 @@ int AFunctionForTest() {
 
 // Checks that ModuleCache returns the same module instance for
 // addresses within the module.
-#if defined(OS_MACOSX) && !defined(OS_IOS) || defined(OS_WIN)
+#if defined(OS_MACOSX) && !defined(OS_IOS) || defined(OS_WIN) || \
+    defined(OS_LINUX)
 #define MAYBE_ModuleCache ModuleCache
 #define MAYBE_ModulesList ModulesList
 #else
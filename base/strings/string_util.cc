@@ -20,6 +20,7 @@
 #include <limits>
 #include <vector>
 
+#include "base/bits.h"
 #include "base/logging.h"
 #include "base/no_destructor.h"
 #include "base/stl_util.h"
@@ -28,6 +29,12 @@
 #include "base/third_party/icu/icu_utf.h"
 #include "build/build_config.h"
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace base {
 
 namespace {
@@ -97,6 +104,28 @@ struct NonASCIIMask<wchar_t> {
 };
 #endif  // WCHAR_T_IS_UTF32
 
+// Returns the length of the run of ASCII characters at the start of |str|,
+// looking at 16 of them at a time where possible.
+int32_t CountLeadingASCII(const char* str, int32_t length) {
+  int32_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  for (; length - i >= 16; i += 16) {
+    const uint32_t non_ascii = _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)));
+    if (non_ascii)
+      return i + bits::CountTrailingZeroBits(non_ascii);
+  }
+#elif defined(ARCH_CPU_ARM64)
+  for (; length - i >= 16; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(str + i))) >= 0x80)
+      break;
+  }
+#endif
+  while (i < length && CBU8_IS_SINGLE(str[i]))
+    ++i;
+  return i;
+}
+
 }  // namespace
 
 bool IsWprintfFormatPortable(const wchar_t* format) {
@@ -512,6 +541,33 @@ bool IsStringUTF8(StringPiece str) {
   int32_t char_index = 0;
 
   while (char_index < src_len) {
+    const uint8_t lead = static_cast<uint8_t>(src[char_index]);
+    if (CBU8_IS_SINGLE(lead)) {
+      ++char_index;
+      // Only look for the end of longer runs of ASCII a block at a time, as
+      // text in other scripts has single ASCII spaces and punctuation.
+      if (char_index < src_len && CBU8_IS_SINGLE(src[char_index])) {
+        char_index +=
+            CountLeadingASCII(src + char_index, src_len - char_index);
+      }
+      continue;
+    }
+
+    // Check the two and three byte sequences which can't be overlong,
+    // surrogates or non-characters, and so are valid as soon as they are
+    // complete, directly.
+    if (lead >= 0xC2 && lead <= 0xDF && char_index + 1 < src_len &&
+        CBU8_IS_TRAIL(src[char_index + 1])) {
+      char_index += 2;
+      continue;
+    }
+    if (((lead >= 0xE1 && lead <= 0xEC) || lead == 0xEE) &&
+        char_index + 2 < src_len && CBU8_IS_TRAIL(src[char_index + 1]) &&
+        CBU8_IS_TRAIL(src[char_index + 2])) {
+      char_index += 3;
+      continue;
+    }
+
     int32_t code_point;
     CBU8_NEXT(src, char_index, src_len, code_point);
     if (!IsValidCharacter(code_point))
@@ -10,12 +10,20 @@
 #include <type_traits>
 
 #include "base/bit_cast.h"
+#include "base/bits.h"
+#include "base/compiler_specific.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversion_utils.h"
 #include "base/third_party/icu/icu_utf.h"
 #include "build/build_config.h"
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace base {
 
 namespace {
@@ -85,6 +93,132 @@ void UnicodeAppendUnsafe(Char* out, int32_t* size, uint32_t code_point) {
   out[(*size)++] = code_point;
 }
 
+// Vectorized runs -------------------------------------------------------------
+// Functions converting the characters at the start of the source 16 bytes at a
+// time, for as long as they are of one kind, and returning how many they
+// converted. They may write the output of the whole last block read, past
+// that of the characters converted.
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// Returns a mask of the 16-bit lanes of |v| in [lo, hi], which must both be
+// under 0x8000.
+inline __m128i CharsInRange(__m128i v, int16_t lo, int16_t hi) {
+  return _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16(lo - 1)),
+                       _mm_cmplt_epi16(v, _mm_set1_epi16(hi + 1)));
+}
+
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+template <typename DestChar>
+int32_t ConvertASCIIBlocks(const char* src, int32_t src_len, DestChar* dest) {
+  return 0;
+}
+
+// Widens the ASCII characters of |src| to UTF-16. This is kept out of line,
+// which measurably speeds up the per-character loop of DoUTFConversion() for
+// text with many short runs of ASCII.
+NOINLINE int32_t ConvertASCIIBlocks(const char* src,
+                                    int32_t src_len,
+                                    char16* dest) {
+  int32_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  const __m128i zero = _mm_setzero_si128();
+  for (; src_len - i >= 16; i += 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_unpacklo_epi8(block, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8),
+                     _mm_unpackhi_epi8(block, zero));
+    const uint32_t non_ascii = _mm_movemask_epi8(block);
+    if (non_ascii)
+      return i + bits::CountTrailingZeroBits(non_ascii);
+  }
+#elif defined(ARCH_CPU_ARM64)
+  for (; src_len - i >= 16; i += 16) {
+    const uint8x16_t block =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    if (vmaxvq_u8(block) >= 0x80)
+      break;
+    vst1q_u16(reinterpret_cast<uint16_t*>(dest + i),
+              vmovl_u8(vget_low_u8(block)));
+    vst1q_u16(reinterpret_cast<uint16_t*>(dest + i + 8),
+              vmovl_high_u8(block));
+  }
+#endif
+  return i;
+}
+
+// Narrows the ASCII characters of |src| to UTF-8.
+int32_t ConvertASCIIBlocks(const char16* src, int32_t src_len, char* dest) {
+  int32_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  for (; src_len - i >= 16; i += 16) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_packus_epi16(low, high));
+    // Lanes of 0x8000 and more are negative, which is out of range.
+    const uint32_t ascii = _mm_movemask_epi8(_mm_packs_epi16(
+        CharsInRange(low, 0, 0x7F), CharsInRange(high, 0, 0x7F)));
+    if (ascii != 0xFFFF)
+      return i + bits::CountTrailingZeroBits(~ascii);
+  }
+#elif defined(ARCH_CPU_ARM64)
+  for (; src_len - i >= 16; i += 16) {
+    const uint16x8_t low =
+        vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+    const uint16x8_t high =
+        vld1q_u16(reinterpret_cast<const uint16_t*>(src + i + 8));
+    if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80)
+      break;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest + i),
+             vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+  }
+#endif
+  return i;
+}
+
+// Encodes the characters of |src| in [0x80, 0x7FF], which take two bytes in
+// UTF-8, such as those of the Latin-1 Supplement, Greek, Cyrillic, Hebrew and
+// Arabic blocks.
+int32_t ConvertTwoByteBlocks(const char16* src, int32_t src_len, char* dest) {
+  int32_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  for (; src_len - i >= 8; i += 8) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Each lane becomes the lead byte, followed by the trail byte.
+    const __m128i lead =
+        _mm_or_si128(_mm_srli_epi16(block, 6), _mm_set1_epi16(0xC0));
+    const __m128i trail = _mm_or_si128(
+        _mm_and_si128(block, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 2 * i),
+                     _mm_or_si128(lead, _mm_slli_epi16(trail, 8)));
+    const uint32_t two_byte =
+        _mm_movemask_epi8(CharsInRange(block, 0x80, 0x7FF));
+    if (two_byte != 0xFFFF)
+      return i + bits::CountTrailingZeroBits(~two_byte) / 2;
+  }
+#elif defined(ARCH_CPU_ARM64)
+  for (; src_len - i >= 8; i += 8) {
+    const uint16x8_t block =
+        vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+    if (vminvq_u16(block) < 0x80 || vmaxvq_u16(block) > 0x7FF)
+      break;
+    const uint16x8_t lead = vorrq_u16(vshrq_n_u16(block, 6), vdupq_n_u16(0xC0));
+    const uint16x8_t trail =
+        vorrq_u16(vandq_u16(block, vdupq_n_u16(0x3F)), vdupq_n_u16(0x80));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest + 2 * i),
+             vreinterpretq_u8_u16(vorrq_u16(lead, vshlq_n_u16(trail, 8))));
+  }
+#endif
+  return i;
+}
+
 // DoUTFConversion ------------------------------------------------------------
 // Main driver of UTFConversion specialized for different Src encodings.
 // dest has to have enough room for the converted text.
@@ -97,6 +231,43 @@ bool DoUTFConversion(const char* src,
   bool success = true;
 
   for (int32_t i = 0; i < src_len;) {
+    const uint8_t lead = static_cast<uint8_t>(src[i]);
+
+    if (CBU8_IS_SINGLE(lead)) {
+      dest[(*dest_len)++] = lead;
+      ++i;
+      // Text in other scripts has ASCII spaces and punctuation, only convert
+      // longer runs of ASCII a block at a time.
+      if (i < src_len && CBU8_IS_SINGLE(src[i])) {
+        int32_t ascii_len =
+            ConvertASCIIBlocks(src + i, src_len - i, dest + *dest_len);
+        while (i + ascii_len < src_len &&
+               CBU8_IS_SINGLE(src[i + ascii_len])) {
+          dest[*dest_len + ascii_len] = src[i + ascii_len];
+          ++ascii_len;
+        }
+        i += ascii_len;
+        *dest_len += ascii_len;
+      }
+      continue;
+    }
+
+    // Decode the two and three byte sequences which can't be overlong or
+    // surrogates, and so are valid as soon as they are complete, directly.
+    if (lead >= 0xC2 && lead <= 0xDF && i + 1 < src_len &&
+        CBU8_IS_TRAIL(src[i + 1])) {
+      dest[(*dest_len)++] = ((lead & 0x1F) << 6) | (src[i + 1] & 0x3F);
+      i += 2;
+      continue;
+    }
+    if (lead >= 0xE1 && lead <= 0xEF && lead != 0xED && i + 2 < src_len &&
+        CBU8_IS_TRAIL(src[i + 1]) && CBU8_IS_TRAIL(src[i + 2])) {
+      dest[(*dest_len)++] = ((lead & 0x0F) << 12) |
+                            ((src[i + 1] & 0x3F) << 6) | (src[i + 2] & 0x3F);
+      i += 3;
+      continue;
+    }
+
     int32_t code_point;
     CBU8_NEXT(src, i, src_len, code_point);
 
@@ -111,6 +282,70 @@ bool DoUTFConversion(const char* src,
   return success;
 }
 
+bool DoUTFConversion(const char16* src,
+                     int32_t src_len,
+                     char* dest,
+                     int32_t* dest_len) {
+  bool success = true;
+
+  for (int32_t i = 0; i < src_len;) {
+    const char16 c = src[i];
+
+    if (c < 0x80) {
+      dest[(*dest_len)++] = static_cast<char>(c);
+      ++i;
+      // As above, only convert longer runs of ASCII a block at a time.
+      if (i < src_len && src[i] < 0x80) {
+        int32_t ascii_len =
+            ConvertASCIIBlocks(src + i, src_len - i, dest + *dest_len);
+        while (i + ascii_len < src_len && src[i + ascii_len] < 0x80) {
+          dest[*dest_len + ascii_len] = static_cast<char>(src[i + ascii_len]);
+          ++ascii_len;
+        }
+        i += ascii_len;
+        *dest_len += ascii_len;
+      }
+      continue;
+    }
+
+    if (c < 0x800) {
+      const int32_t two_byte_len =
+          ConvertTwoByteBlocks(src + i, src_len - i, dest + *dest_len);
+      if (two_byte_len) {
+        i += two_byte_len;
+        *dest_len += 2 * two_byte_len;
+        continue;
+      }
+      dest[(*dest_len)++] = static_cast<char>(0xC0 | (c >> 6));
+      dest[(*dest_len)++] = static_cast<char>(0x80 | (c & 0x3F));
+      ++i;
+      continue;
+    }
+
+    if (!CBU16_IS_SURROGATE(c)) {
+      dest[(*dest_len)++] = static_cast<char>(0xE0 | (c >> 12));
+      dest[(*dest_len)++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      dest[(*dest_len)++] = static_cast<char>(0x80 | (c & 0x3F));
+      ++i;
+      continue;
+    }
+
+    int32_t code_point;
+    if (CBU16_IS_LEAD(c) && i + 1 < src_len && CBU16_IS_TRAIL(src[i + 1])) {
+      code_point = CBU16_GET_SUPPLEMENTARY(c, src[i + 1]);
+      i += 2;
+    } else {
+      success = false;
+      code_point = kErrorCodePoint;
+      ++i;
+    }
+
+    UnicodeAppendUnsafe(dest, dest_len, code_point);
+  }
+
+  return success;
+}
+
 template <typename DestChar>
 bool DoUTFConversion(const char16* src,
                      int32_t src_len,
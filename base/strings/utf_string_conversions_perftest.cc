@@ -0,0 +1,125 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/utf_string_conversions.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+
+#include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+struct Input {
+  const char* name;
+  // UTF-8 text, repeated to make up inputs of each size.
+  const char* text;
+};
+
+constexpr Input kInputs[] = {
+    {"ascii", "The quick brown fox jumps over the lazy dog. "},
+    // "Le cœur déçu mais l'âme plutôt naïve, Louÿs rêva de crapaüter. "
+    {"latin",
+     "Le c\xc5\x93ur d\xc3\xa9\xc3\xa7u mais l'\xc3\xa2me plut\xc3\xb4t "
+     "na\xc3\xafve, Lou\xc3\xbfs r\xc3\xaava de crapa\xc3\xbcter. "},
+    // "Съешь же ещё этих мягких французских булок, да выпей чаю. "
+    {"cyrillic",
+     "\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 "
+     "\xd0\xb5\xd1\x89\xd1\x91 \xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 "
+     "\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85 "
+     "\xd1\x84\xd1\x80\xd0\xb0\xd0\xbd\xd1\x86\xd1\x83\xd0\xb7\xd1\x81"
+     "\xd0\xba\xd0\xb8\xd1\x85 \xd0\xb1\xd1\x83\xd0\xbb\xd0\xbe\xd0\xba, "
+     "\xd0\xb4\xd0\xb0 \xd0\xb2\xd1\x8b\xd0\xbf\xd0\xb5\xd0\xb9 "
+     "\xd1\x87\xd0\xb0\xd1\x8e. "},
+    // "我能吞下玻璃而不伤身体。私はガラスを食べられます。"
+    {"cjk",
+     "\xe6\x88\x91\xe8\x83\xbd\xe5\x90\x9e\xe4\xb8\x8b\xe7\x8e\xbb\xe7\x92\x83"
+     "\xe8\x80\x8c\xe4\xb8\x8d\xe4\xbc\xa4\xe8\xba\xab\xe4\xbd\x93\xe3\x80\x82"
+     "\xe7\xa7\x81\xe3\x81\xaf\xe3\x82\xac\xe3\x83\xa9\xe3\x82\xb9\xe3\x82\x92"
+     "\xe9\xa3\x9f\xe3\x81\xb9\xe3\x82\x89\xe3\x82\x8c\xe3\x81\xbe\xe3\x81\x99"
+     "\xe3\x80\x82"},
+    // "検索 or type a URL 🔍 https://例え.jp/パス?q=テスト "
+    {"mixed",
+     "\xe6\xa4\x9c\xe7\xb4\xa2 or type a URL \xf0\x9f\x94\x8d "
+     "https://\xe4\xbe\x8b\xe3\x81\x88.jp/\xe3\x83\x91\xe3\x82\xb9?q="
+     "\xe3\x83\x86\xe3\x82\xb9\xe3\x83\x88 "},
+};
+
+constexpr size_t kMinSize = 16;
+constexpr size_t kMaxSize = 1 << 20;
+
+// The number of bytes of UTF-8 processed by each measurement.
+constexpr size_t kBytesPerMeasurement = 64 << 20;
+
+// Returns |text| repeated up to |size| bytes, without splitting a character.
+std::string MakeInput(StringPiece text, size_t size) {
+  std::string input;
+  while (input.size() < size)
+    text.AppendToString(&input);
+  size_t end = size;
+  while (end > 0 && (input[end] & 0xC0) == 0x80)
+    --end;
+  input.resize(end);
+  return input;
+}
+
+// Runs |function| over an input of |input_size| bytes of UTF-8 until
+// kBytesPerMeasurement were processed, and returns the throughput in MiB/s.
+template <typename Function>
+double MeasureThroughput(size_t input_size, Function function) {
+  const size_t iterations = std::max<size_t>(
+      1, kBytesPerMeasurement / std::max<size_t>(1, input_size));
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    function();
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+  return iterations * input_size / elapsed.InSecondsF() / (1 << 20);
+}
+
+}  // namespace
+
+TEST(UTFStringConversionsPerfTest, ConvertAndValidate) {
+  for (const Input& input : kInputs) {
+    for (size_t size = kMinSize; size <= kMaxSize; size *= 16) {
+      const std::string utf8 = MakeInput(input.text, size);
+      const string16 utf16 = UTF8ToUTF16(utf8);
+      const std::string trace = StringPrintf("%s_%zuB", input.name, size);
+
+      string16 utf16_output;
+      double throughput = MeasureThroughput(utf8.size(), [&] {
+        UTF8ToUTF16(utf8.data(), utf8.size(), &utf16_output);
+      });
+      perf_test::PrintResult("utf8_to_utf16", "", trace, throughput, "MiB/s",
+                             true);
+      EXPECT_EQ(utf16, utf16_output);
+
+      std::string utf8_output;
+      throughput = MeasureThroughput(utf8.size(), [&] {
+        UTF16ToUTF8(utf16.data(), utf16.size(), &utf8_output);
+      });
+      perf_test::PrintResult("utf16_to_utf8", "", trace, throughput, "MiB/s",
+                             true);
+      EXPECT_EQ(utf8, utf8_output);
+
+      bool is_utf8 = true;
+      throughput = MeasureThroughput(
+          utf8.size(), [&] { is_utf8 &= IsStringUTF8(utf8); });
+      perf_test::PrintResult("is_string_utf8", "", trace, throughput, "MiB/s",
+                             true);
+      EXPECT_TRUE(is_utf8);
+    }
+  }
+}
+
+}  // namespace base
@@ -180,6 +180,54 @@ TEST(UTFStringConversionsTest, ConvertUTF32ToUTF8) {
 }
 #endif  // defined(WCHAR_T_IS_UTF32)
 
+TEST(UTFStringConversionsTest, ConvertRunsAcrossBlocks) {
+  // Runs of ASCII and of two byte characters are converted 16 units at a time,
+  // so check runs of every length up to a few blocks, after prefixes of every
+  // length up to a block, against the characters converted one at a time.
+  static const struct {
+    const char* utf8;
+    const char16 utf16[3];
+  } kChars[] = {
+      {"a", {'a'}},
+      {"\xc3\xa9", {0xe9}},
+      {"\xd0\x96", {0x416}},
+      {"\xe4\xb8\xad", {0x4e2d}},
+      {"\xf0\x9f\x98\x80", {0xd83d, 0xde00}},
+  };
+
+  for (const auto& prefix : kChars) {
+    for (const auto& run : kChars) {
+      for (size_t prefix_length = 0; prefix_length <= 16; ++prefix_length) {
+        for (size_t run_length = 0; run_length <= 40; ++run_length) {
+          std::string utf8;
+          string16 utf16;
+          for (size_t i = 0; i < prefix_length; ++i) {
+            utf8 += prefix.utf8;
+            utf16 += prefix.utf16;
+          }
+          for (size_t i = 0; i < run_length; ++i) {
+            utf8 += run.utf8;
+            utf16 += run.utf16;
+          }
+          utf8 += "\xe4\xb8\xad";
+          utf16 += 0x4e2d;
+
+          EXPECT_EQ(utf16, UTF8ToUTF16(utf8));
+          EXPECT_EQ(utf8, UTF16ToUTF8(utf16));
+          EXPECT_TRUE(IsStringUTF8(utf8));
+
+          // An invalid character at the end of the run is still found.
+          string16 converted;
+          EXPECT_FALSE(UTF8ToUTF16((utf8 + "\xff").c_str(), utf8.size() + 1,
+                                   &converted));
+          EXPECT_EQ(utf16 + char16(0xfffd), converted);
+          EXPECT_FALSE(IsStringUTF8(utf8 + "\xed\xa0\x80"));
+        }
+      }
+    }
+  }
+}
+
 TEST(UTFStringConversionsTest, ConvertMultiString) {
   static char16 multi16[] = {
     'f', 'o', 'o', '\0',
@@ -39,6 +39,7 @@ class MallocDumpProvider;
 
 namespace internal {
 
+class ThreadCache;
 class ThreadLocalStorageTestInternal;
 
 // WARNING: You should *NOT* use this class directly.
@@ -160,6 +161,7 @@ class BASE_EXPORT ThreadLocalStorage {
   // thread destruction. Attempting to call Slot::Get() during destruction is
   // disallowed and will hit a DCHECK. Any code that relies on TLS during thread
   // destruction must first check this method before calling Slot::Get().
+  friend class base::internal::ThreadCache;
   friend class base::internal::ThreadLocalStorageTestInternal;
   friend class base::trace_event::MallocDumpProvider;
   friend class debug::GlobalActivityTracker;
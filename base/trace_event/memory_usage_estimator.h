@@ -25,6 +25,8 @@
 #include "base/containers/circular_deque.h"
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
+#include "base/containers/hash_map.h"
+#include "base/containers/hash_set.h"
 #include "base/containers/linked_list.h"
 #include "base/containers/mru_cache.h"
 #include "base/containers/queue.h"
@@ -166,6 +168,12 @@ size_t EstimateMemoryUsage(const base::flat_set<T, C>& set);
 template <class K, class V, class C>
 size_t EstimateMemoryUsage(const base::flat_map<K, V, C>& map);
 
+template <class T, class H, class E>
+size_t EstimateMemoryUsage(const base::HashSet<T, H, E>& set);
+
+template <class K, class V, class H, class E>
+size_t EstimateMemoryUsage(const base::HashMap<K, V, H, E>& map);
+
 template <class Key,
           class Payload,
           class HashOrComp,
@@ -639,6 +647,22 @@ size_t EstimateMemoryUsage(const base::flat_map<K, V, C>& map) {
   return sizeof(value_type) * map.capacity() + EstimateIterableMemoryUsage(map);
 }
 
+// Open-addressing hash containers: one control byte and one slot per bucket.
+
+template <class T, class H, class E>
+size_t EstimateMemoryUsage(const base::HashSet<T, H, E>& set) {
+  using value_type = typename base::HashSet<T, H, E>::value_type;
+  return (sizeof(value_type) + 1) * set.capacity() +
+         EstimateIterableMemoryUsage(set);
+}
+
+template <class K, class V, class H, class E>
+size_t EstimateMemoryUsage(const base::HashMap<K, V, H, E>& map) {
+  using value_type = typename base::HashMap<K, V, H, E>::value_type;
+  return (sizeof(value_type) + 1) * map.capacity() +
+         EstimateIterableMemoryUsage(map);
+}
+
 template <class Key,
           class Payload,
           class HashOrComp,
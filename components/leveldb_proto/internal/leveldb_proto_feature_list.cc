@@ -9,4 +9,9 @@ namespace leveldb_proto {
 const base::Feature kProtoDBSharedMigration{"ProtoDBSharedMigration",
                                             base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Parses the entries of large LoadEntries() calls on the thread pool instead
+// of on the database task runner.
+const base::Feature kProtoDBParallelParse{"ProtoDBParallelParse",
+                                          base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace leveldb_proto
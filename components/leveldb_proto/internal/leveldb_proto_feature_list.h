@@ -10,6 +10,7 @@
 namespace leveldb_proto {
 
 extern const base::Feature kProtoDBSharedMigration;
+extern const base::Feature kProtoDBParallelParse;
 
 }  // namespace leveldb_proto
 
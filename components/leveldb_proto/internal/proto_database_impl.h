@@ -5,16 +5,21 @@
 #ifndef COMPONENTS_LEVELDB_PROTO_INTERNAL_PROTO_DATABASE_IMPL_H_
 #define COMPONENTS_LEVELDB_PROTO_INTERNAL_PROTO_DATABASE_IMPL_H_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/barrier_closure.h"
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/task/post_task.h"
 #include "base/threading/sequenced_task_runner_handle.h"
+#include "components/leveldb_proto/internal/leveldb_proto_feature_list.h"
 #include "components/leveldb_proto/internal/proto_database_selector.h"
 #include "components/leveldb_proto/internal/shared_proto_database.h"
 #include "components/leveldb_proto/internal/shared_proto_database_provider.h"
@@ -179,6 +184,13 @@ class ProtoDatabaseImpl : public ProtoDatabase<T> {
 
 namespace {
 
+// Loads of at least kMinimumEntriesForParallelParse entries are parsed on the
+// thread pool, kParallelParseBatchSize entries per task, when
+// kProtoDBParallelParse is enabled. Smaller loads are not worth the task
+// hops.
+constexpr size_t kParallelParseBatchSize = 1024;
+constexpr size_t kMinimumEntriesForParallelParse = 4 * kParallelParseBatchSize;
+
 // Update transactions need to serialize the entries to be updated on background
 // task runner. The database can be accessed on same task runner. The caller
 // must wrap the callback using RunUpdateCallback() to ensure the callback runs
@@ -222,6 +234,64 @@ void UpdateEntriesWithRemoveFilterFromTaskRunner(
                                     target_prefix, std::move(callback));
 }
 
+// Parses |serialized_entries| [begin, end) into the same positions of
+// |entries|. Each serialized entry is freed as soon as it is parsed, so a large
+// load does not hold both the serialized and the parsed copy of every entry.
+template <typename T>
+void ParseEntriesInRange(ValueVector* serialized_entries,
+                         size_t begin,
+                         size_t end,
+                         std::vector<T>* entries) {
+  for (size_t i = begin; i < end; ++i) {
+    if (!(*entries)[i].ParseFromString((*serialized_entries)[i])) {
+      DLOG(WARNING) << "Unable to parse leveldb_proto entry";
+      // TODO(cjhopman): Decide what to do about un-parseable entries.
+    }
+    std::string().swap((*serialized_entries)[i]);
+  }
+}
+
+template <typename T>
+void RunLoadCallbackWithParsedEntries(
+    scoped_refptr<base::SequencedTaskRunner> callback_task_runner,
+    typename Callbacks::Internal<T>::LoadCallback callback,
+    std::unique_ptr<ValueVector> serialized_entries,
+    std::unique_ptr<std::vector<T>> entries) {
+  callback_task_runner->PostTask(
+      FROM_HERE, base::BindOnce(std::move(callback), true, std::move(entries)));
+}
+
+// Splits parsing of |loaded_entries| into batches of
+// kParallelParseBatchSize entries that run concurrently on the thread pool.
+// The callback is posted to |callback_task_runner| once every batch is done.
+template <typename T>
+void ParseLoadedEntriesInParallel(
+    scoped_refptr<base::SequencedTaskRunner> callback_task_runner,
+    typename Callbacks::Internal<T>::LoadCallback callback,
+    std::unique_ptr<ValueVector> loaded_entries,
+    std::unique_ptr<std::vector<T>> entries) {
+  // The barrier owns both vectors, and runs after the last batch replies, so
+  // the raw pointers given to the batches stay valid while they run.
+  ValueVector* serialized_entries = loaded_entries.get();
+  std::vector<T>* parsed_entries = entries.get();
+  const size_t count = serialized_entries->size();
+  const size_t num_batches =
+      (count + kParallelParseBatchSize - 1) / kParallelParseBatchSize;
+  base::RepeatingClosure batch_done = base::BarrierClosure(
+      num_batches,
+      base::BindOnce(&RunLoadCallbackWithParsedEntries<T>,
+                     std::move(callback_task_runner), std::move(callback),
+                     std::move(loaded_entries), std::move(entries)));
+  for (size_t begin = 0; begin < count; begin += kParallelParseBatchSize) {
+    const size_t end = std::min(count, begin + kParallelParseBatchSize);
+    base::PostTaskWithTraitsAndReply(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&ParseEntriesInRange<T>, serialized_entries, begin, end,
+                       parsed_entries),
+        batch_done);
+  }
+}
+
 // Load transactions happen on background task runner. The loaded entries need
 // to be parsed into proto in background thread. This wraps the load callback
 // and parses the entries and posts result onto client task runner.
@@ -236,15 +306,18 @@ void ParseLoadedEntries(
   if (!success || !loaded_entries) {
     entries.reset();
   } else {
-    for (const auto& serialized_entry : *loaded_entries) {
-      T entry;
-      if (!entry.ParseFromString(serialized_entry)) {
-        DLOG(WARNING) << "Unable to parse leveldb_proto entry";
-        // TODO(cjhopman): Decide what to do about un-parseable entries.
-      }
-
-      entries->push_back(entry);
+    // Parse in place into default constructed protos, so no entry is copied.
+    const size_t count = loaded_entries->size();
+    entries->resize(count);
+    if (count >= kMinimumEntriesForParallelParse &&
+        base::FeatureList::IsEnabled(kProtoDBParallelParse)) {
+      ParseLoadedEntriesInParallel<T>(std::move(callback_task_runner),
+                                      std::move(callback),
+                                      std::move(loaded_entries),
+                                      std::move(entries));
+      return;
     }
+    ParseEntriesInRange<T>(loaded_entries.get(), 0, count, entries.get());
   }
 
   callback_task_runner->PostTask(
@@ -272,7 +345,7 @@ void ParseLoadedKeysAndEntries(
         // TODO(cjhopman): Decide what to do about un-parseable entries.
       }
 
-      keys_entries->insert(std::make_pair(pair.first, entry));
+      keys_entries->emplace(pair.first, std::move(entry));
     }
   }
 
@@ -6,8 +6,11 @@
 
 #include "base/bind.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/scoped_task_environment.h"
 #include "base/threading/thread.h"
+#include "components/leveldb_proto/internal/leveldb_proto_feature_list.h"
 #include "components/leveldb_proto/internal/shared_proto_database_provider.h"
 #include "components/leveldb_proto/public/proto_database_provider.h"
 #include "components/leveldb_proto/testing/proto/test_db.pb.h"
@@ -541,4 +544,39 @@ TEST_F(ProtoDatabaseImplTest, Migration_SharedToUnique_UniqueObsolete) {
             GetClientMigrationStatus());
 }
 
+TEST_F(ProtoDatabaseImplTest, LoadEntries_ParallelParse) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kProtoDBParallelParse);
+
+  // Enough entries to be split into several parse batches, the last one
+  // partial.
+  auto data_set = std::make_unique<std::vector<std::string>>();
+  for (int i = 0; i < 5000; i++)
+    data_set->push_back(base::StringPrintf("entry%05d", i));
+
+  auto db_provider = CreateProviderNoSharedDB();
+  auto wrapper = CreateWrapper(ProtoDbType::TEST_DATABASE1, temp_dir(),
+                               GetTestThreadTaskRunner(),
+                               CreateSharedProvider(db_provider.get()));
+  InitWrapperAndWait(wrapper.get(), kDefaultClientName, false,
+                     Enums::InitStatus::kOK);
+  AddDataToWrapper(wrapper.get(), data_set.get());
+
+  base::RunLoop load_loop;
+  wrapper->LoadEntries(base::BindOnce(
+      [](base::OnceClosure closure, std::vector<std::string>* entry_keys,
+         bool success, std::unique_ptr<std::vector<TestProto>> entries) {
+        ASSERT_TRUE(success);
+        ASSERT_EQ(entry_keys->size(), entries->size());
+        // Entries come back in key order, which |entry_keys| is in.
+        for (size_t i = 0; i < entries->size(); i++) {
+          EXPECT_EQ((*entry_keys)[i], (*entries)[i].id());
+          EXPECT_EQ((*entry_keys)[i], (*entries)[i].data());
+        }
+        std::move(closure).Run();
+      },
+      load_loop.QuitClosure(), data_set.get()));
+  load_loop.Run();
+}
+
 }  // namespace leveldb_proto
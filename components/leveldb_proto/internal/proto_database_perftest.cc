@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -16,14 +17,19 @@
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/location.h"
+#include "base/macros.h"
 #include "base/memory/ptr_util.h"
-#include "base/message_loop/message_loop.h"
+#include "base/process/process_metrics.h"
 #include "base/run_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/scoped_task_environment.h"
 #include "base/threading/thread.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "build/build_config.h"
 #include "components/leveldb_proto/internal/leveldb_database.h"
+#include "components/leveldb_proto/internal/leveldb_proto_feature_list.h"
 #include "components/leveldb_proto/internal/proto_database_impl.h"
 #include "components/leveldb_proto/internal/unique_proto_database.h"
 #include "components/leveldb_proto/testing/proto/test_db.pb.h"
@@ -33,7 +39,6 @@
 #include "third_party/leveldatabase/env_chromium.h"
 #include "third_party/leveldatabase/leveldb_chrome.h"
 
-using base::MessageLoop;
 using base::ScopedTempDir;
 using leveldb_env::Options;
 using testing::_;
@@ -122,18 +127,62 @@ class TestDatabase {
   std::unique_ptr<ProtoDatabaseImpl<TestProto>> db_;
 };
 
+// Samples the malloc usage of the process on a thread of its own, so that
+// memory held only while entries are being loaded is seen as well as what is
+// still held afterwards.
+class PeakMallocUsageSampler {
+ public:
+  PeakMallocUsageSampler()
+      : metrics_(base::ProcessMetrics::CreateCurrentProcessMetrics()),
+        baseline_(metrics_->GetMallocUsage()),
+        peak_(baseline_),
+        thread_("MallocUsageSampler") {
+    thread_.Start();
+    thread_.task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&PeakMallocUsageSampler::Sample,
+                                  base::Unretained(this)));
+  }
+
+  // Stops sampling and returns the highest malloc usage seen, less the usage
+  // at construction.
+  size_t Stop() {
+    thread_.Stop();
+    peak_ = std::max(peak_, metrics_->GetMallocUsage());
+    return peak_ - baseline_;
+  }
+
+ private:
+  void Sample() {
+    peak_ = std::max(peak_, metrics_->GetMallocUsage());
+    thread_.task_runner()->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&PeakMallocUsageSampler::Sample, base::Unretained(this)),
+        base::TimeDelta::FromMilliseconds(1));
+  }
+
+  std::unique_ptr<base::ProcessMetrics> metrics_;
+  const size_t baseline_;
+  // Written on |thread_| only, until Stop() has joined it.
+  size_t peak_;
+  base::Thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(PeakMallocUsageSampler);
+};
+
 }  // namespace
 
 class ProtoDBPerfTest : public testing::Test {
  public:
   void SetUp() override {
-    main_loop_.reset(new MessageLoop());
-    task_runner_ = main_loop_->task_runner();
+    // The task environment also provides the thread pool that parallel
+    // parsing of loaded entries runs on.
+    task_environment_ = std::make_unique<base::test::ScopedTaskEnvironment>();
+    task_runner_ = base::ThreadTaskRunnerHandle::Get();
   }
 
   void TearDown() override {
     base::RunLoop().RunUntilIdle();
-    main_loop_.reset();
+    task_environment_.reset();
     ShutdownDBs();
   }
 
@@ -340,6 +389,7 @@ class ProtoDBPerfTest : public testing::Test {
     TestDatabase* db;
     GetDatabase(kSingleDBName, &db);
 
+    PeakMallocUsageSampler malloc_sampler;
     uint64_t time_ms = 0;
     uint64_t max_time_ms = 0;
     if (dbs_to_load.size() == 0) {
@@ -357,6 +407,7 @@ class ProtoDBPerfTest : public testing::Test {
         time_ms += curr_time_ms;
       }
     }
+    size_t peak_malloc_use = malloc_sampler.Stop();
     uint64_t memory_use_after;
     GetApproximateMemoryUsage(&memory_use_after);
 
@@ -368,6 +419,9 @@ class ProtoDBPerfTest : public testing::Test {
     perf_test::PrintResult(
         "ProtoDBPerfTest", test_modifier_str, "Memory use after load",
         static_cast<size_t>(memory_use_after), "bytes", true);
+    perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
+                           "Peak malloc use during load", peak_malloc_use,
+                           "bytes", true);
     perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
                            "Total time taken", static_cast<size_t>(time_ms),
                            "ms", true);
@@ -398,6 +452,7 @@ class ProtoDBPerfTest : public testing::Test {
 
     ShutdownDBs();
 
+    PeakMallocUsageSampler malloc_sampler;
     uint64_t time_ms = 0;
     uint64_t max_time_ms = 0;
     for (unsigned int i = 0; i < num_dbs; i++) {
@@ -417,6 +472,7 @@ class ProtoDBPerfTest : public testing::Test {
       time_ms += curr_time_ms;
     }
 
+    size_t peak_malloc_use = malloc_sampler.Stop();
     uint64_t memory_use_after;
     GetApproximateMemoryUsage(&memory_use_after);
     auto test_modifier_str = base::StringPrintf(
@@ -427,6 +483,9 @@ class ProtoDBPerfTest : public testing::Test {
     perf_test::PrintResult(
         "ProtoDBPerfTest", test_modifier_str, "Memory use after load",
         static_cast<size_t>(memory_use_after), "bytes", true);
+    perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
+                           "Peak malloc use during load", peak_malloc_use,
+                           "bytes", true);
     perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
                            "Total time taken", static_cast<size_t>(time_ms),
                            "ms", true);
@@ -437,6 +496,72 @@ class ProtoDBPerfTest : public testing::Test {
     ShutdownDBs();
   }
 
+  // Loads a database of |num_entries| entries in one LoadEntries() call, with
+  // the entries parsed either on the database task runner or in parallel on
+  // the thread pool, and reports the load time, the peak memory use while
+  // loading and the memory held once the entries are handed to the caller.
+  void RunBulkLoadTestAndCleanup(unsigned int num_entries,
+                                 size_t data_size,
+                                 bool parallel_parse) {
+    base::test::ScopedFeatureList feature_list;
+    if (parallel_parse)
+      feature_list.InitAndEnableFeature(kProtoDBParallelParse);
+    else
+      feature_list.InitAndDisableFeature(kProtoDBParallelParse);
+
+    ScopedTempDir temp_dir;
+    ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+    std::vector<std::string> prefixes = {"bulk_"};
+    PrefillDatabase(kSingleDBName, prefixes, num_entries, data_size, temp_dir);
+    ShutdownDBs();
+
+    InitDB(kSingleDBName, temp_dir.GetPath());
+    TestDatabase* db;
+    GetDatabase(kSingleDBName, &db);
+
+    std::unique_ptr<base::ProcessMetrics> metrics =
+        base::ProcessMetrics::CreateCurrentProcessMetrics();
+    const size_t malloc_usage_before = metrics->GetMallocUsage();
+    size_t malloc_usage_loaded = 0;
+    size_t num_entries_loaded = 0;
+
+    PeakMallocUsageSampler malloc_sampler;
+    base::ElapsedTimer timer;
+    base::RunLoop run_load_entries;
+    db->proto_db()->LoadEntries(base::BindOnce(
+        [](base::OnceClosure signal, base::ProcessMetrics* metrics,
+           size_t* malloc_usage_loaded, size_t* num_entries_loaded,
+           bool success, std::unique_ptr<std::vector<TestProto>> entries) {
+          EXPECT_TRUE(success);
+          *malloc_usage_loaded = metrics->GetMallocUsage();
+          *num_entries_loaded = entries->size();
+          std::move(signal).Run();
+        },
+        run_load_entries.QuitClosure(), metrics.get(), &malloc_usage_loaded,
+        &num_entries_loaded));
+    run_load_entries.Run();
+    double time_ms = timer.Elapsed().InMillisecondsF();
+    size_t peak_memory_use = malloc_sampler.Stop();
+    EXPECT_EQ(num_entries, num_entries_loaded);
+
+    auto test_modifier_str =
+        base::StringPrintf("BulkLoad_%s_%u_%zu",
+                           parallel_parse ? "Parallel" : "Sequential",
+                           num_entries, data_size);
+    perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
+                           "Total time taken", time_ms, "ms", true);
+    size_t memory_use = malloc_usage_loaded > malloc_usage_before
+                            ? malloc_usage_loaded - malloc_usage_before
+                            : 0;
+    perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
+                           "Memory use after load", memory_use, "bytes", true);
+    perf_test::PrintResult("ProtoDBPerfTest", test_modifier_str,
+                           "Peak memory use during load", peak_memory_use,
+                           "bytes", true);
+
+    ShutdownDBs();
+  }
+
   void InitDBs(bool single_db,
                const std::vector<std::string>& prefixes,
                std::vector<std::unique_ptr<ScopedTempDir>>* temp_dirs) {
@@ -554,7 +679,7 @@ class ProtoDBPerfTest : public testing::Test {
   }
 
   std::map<std::string, std::unique_ptr<TestDatabase>> dbs_;
-  std::unique_ptr<MessageLoop> main_loop_;
+  std::unique_ptr<base::test::ScopedTaskEnvironment> task_environment_;
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
 };
 
@@ -1099,4 +1224,28 @@ TEST_F(ProtoDBPerfTest, LoadEntriesMulti_DifferingNumDBs_SkipReadCache_Large) {
   ASSERT_NE(num_entries, 0U);
 }
 
+TEST_F(ProtoDBPerfTest, BulkLoad_Sequential_10k) {
+  RunBulkLoadTestAndCleanup(10000, kMediumDataSize, false);
+}
+
+TEST_F(ProtoDBPerfTest, BulkLoad_Parallel_10k) {
+  RunBulkLoadTestAndCleanup(10000, kMediumDataSize, true);
+}
+
+TEST_F(ProtoDBPerfTest, BulkLoad_Sequential_100k) {
+  RunBulkLoadTestAndCleanup(100000, kMediumDataSize, false);
+}
+
+TEST_F(ProtoDBPerfTest, BulkLoad_Parallel_100k) {
+  RunBulkLoadTestAndCleanup(100000, kMediumDataSize, true);
+}
+
+TEST_F(ProtoDBPerfTest, BulkLoad_Sequential_1M) {
+  RunBulkLoadTestAndCleanup(1000000, kSmallDataSize, false);
+}
+
+TEST_F(ProtoDBPerfTest, BulkLoad_Parallel_1M) {
+  RunBulkLoadTestAndCleanup(1000000, kSmallDataSize, true);
+}
+
 }  // namespace leveldb_proto
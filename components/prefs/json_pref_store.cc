@@ -7,7 +7,9 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
@@ -15,7 +17,8 @@
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/json/json_file_value_serializer.h"
-#include "base/json/json_string_value_serializer.h"
+#include "base/json/json_writer.h"
+#include "base/json/string_escape.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram.h"
@@ -195,6 +198,9 @@ bool JsonPrefStore::GetMutableValue(const std::string& key,
                                     base::Value** result) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  // The value is modified in place, and may only be reported as changed after
+  // other writes.
+  InvalidateSerializedEntry(key);
   return prefs_->Get(key, result);
 }
 
@@ -221,6 +227,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key,
   base::Value* old_value = nullptr;
   prefs_->Get(key, &old_value);
   if (!old_value || !value->Equals(old_value)) {
+    InvalidateSerializedEntry(key);
     prefs_->Set(key, std::move(value));
     ScheduleWrite(flags);
   }
@@ -237,7 +244,8 @@ void JsonPrefStore::RemoveValueSilently(const std::string& key,
                                         uint32_t flags) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  prefs_->RemovePath(key, nullptr);
+  if (prefs_->RemovePath(key, nullptr))
+    InvalidateSerializedEntry(key);
   ScheduleWrite(flags);
 }
 
@@ -309,6 +317,8 @@ void JsonPrefStore::SchedulePendingLossyWrites() {
 void JsonPrefStore::ReportValueChanged(const std::string& key, uint32_t flags) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  InvalidateSerializedEntry(key);
+
   if (pref_filter_)
     pref_filter_->FilterUpdate(key);
 
@@ -466,14 +476,45 @@ bool JsonPrefStore::SerializeData(std::string* output) {
         pref_filter_->FilterSerializeData(prefs_.get());
     if (!callbacks.first.is_null() || !callbacks.second.is_null())
       RegisterOnNextWriteSynchronousCallbacks(callbacks);
+
+    base::Optional<std::vector<std::string>> modified_keys =
+        pref_filter_->GetKeysModifiedBySerializeData();
+    if (modified_keys) {
+      for (const std::string& key : *modified_keys)
+        serialized_entries_.erase(key);
+    } else {
+      serialized_entries_.clear();
+    }
   }
 
-  JSONStringValueSerializer serializer(output);
+  // Only the entries which changed since the last write are serialized, the
+  // output being otherwise the same as that of JSONWriter::Write(*prefs_).
   // Not pretty-printing prefs shrinks pref file size by ~30%. To obtain
   // readable prefs for debugging purposes, you can dump your prefs into any
   // command-line or online JSON pretty printing tool.
-  serializer.set_pretty_print(false);
-  bool success = serializer.Serialize(*prefs_);
+  bool success = true;
+  output->clear();
+  output->push_back('{');
+  for (const auto& item : prefs_->DictItems()) {
+    auto entry = serialized_entries_.lower_bound(item.first);
+    if (entry == serialized_entries_.end() || entry->first != item.first) {
+      std::string serialized_value;
+      if (!base::JSONWriter::Write(item.second, &serialized_value)) {
+        success = false;
+        continue;
+      }
+      std::string serialized_entry;
+      base::EscapeJSONString(item.first, true, &serialized_entry);
+      serialized_entry.push_back(':');
+      serialized_entry.append(serialized_value);
+      entry = serialized_entries_.emplace_hint(entry, item.first,
+                                               std::move(serialized_entry));
+    }
+    if (output->size() > 1)
+      output->push_back(',');
+    output->append(entry->second);
+  }
+  output->push_back('}');
   DCHECK(success);
   return success;
 }
@@ -493,6 +534,7 @@ void JsonPrefStore::FinalizeFileRead(
   }
 
   prefs_ = std::move(prefs);
+  serialized_entries_.clear();
 
   initialized_ = true;
 
@@ -517,3 +559,7 @@ void JsonPrefStore::ScheduleWrite(uint32_t flags) {
   else
     writer_.ScheduleWrite(this);
 }
+
+void JsonPrefStore::InvalidateSerializedEntry(const std::string& path) {
+  serialized_entries_.erase(path.substr(0, path.find('.')));
+}
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -169,11 +170,20 @@ class COMPONENTS_PREFS_EXPORT JsonPrefStore
   // WriteablePrefStore::LOSSY_PREF_WRITE_FLAG.
   void ScheduleWrite(uint32_t flags);
 
+  // Drops the cached serialization of the top-level entry of |prefs_| holding
+  // the value at |path|, which is about to be modified.
+  void InvalidateSerializedEntry(const std::string& path);
+
   const base::FilePath path_;
   const scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
 
   std::unique_ptr<base::DictionaryValue> prefs_;
 
+  // The serialization, as "key":value, of the top-level entries of |prefs_|
+  // that haven't changed since the last SerializeData(). Writes only
+  // serialize the entries missing from it.
+  std::map<std::string, std::string> serialized_entries_;
+
   bool read_only_;
 
   // Helper for safely writing pref data.
@@ -0,0 +1,122 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/prefs/json_pref_store.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+// Roughly the size and shape of the Preferences file of a profile which has
+// been in use for a while: a few hundred top-level dictionaries, for a total
+// of ~500 KiB.
+constexpr int kTopLevelKeys = 400;
+constexpr int kValuesPerKey = 25;
+constexpr int kCommits = 200;
+
+std::string MakePrefsJson() {
+  DictionaryValue prefs;
+  for (int i = 0; i < kTopLevelKeys; ++i) {
+    for (int j = 0; j < kValuesPerKey; ++j) {
+      prefs.SetString(StringPrintf("key%d.value%d", i, j),
+                      StringPrintf("%032d", i * kValuesPerKey + j));
+    }
+  }
+  std::string json;
+  JSONWriter::Write(prefs, &json);
+  return json;
+}
+
+class JsonPrefStorePerfTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  test::ScopedTaskEnvironment scoped_task_environment_;
+  ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+// Measures the cost of committing a single pref change to a large store: the
+// time spent serializing on the store's sequence, the time until the file is
+// written, and the number of bytes written.
+TEST_F(JsonPrefStorePerfTest, CommitSingleChange) {
+  const FilePath pref_file = temp_dir_.GetPath().AppendASCII("Preferences");
+  const std::string json = MakePrefsJson();
+  ASSERT_EQ(static_cast<int>(json.size()),
+            WriteFile(pref_file, json.data(), static_cast<int>(json.size())));
+
+  auto pref_store = MakeRefCounted<JsonPrefStore>(pref_file);
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, pref_store->ReadPrefs());
+
+  TimeDelta serialization_time;
+  TimeDelta commit_time;
+  int64_t bytes_written = 0;
+  // The first write serializes all of the prefs, and is left out.
+  for (int i = -1; i < kCommits; ++i) {
+    pref_store->SetValue(
+        StringPrintf("key%d.value0", (i + kTopLevelKeys) % kTopLevelKeys),
+        std::make_unique<Value>(i),
+        WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+
+    WaitableEvent written;
+    const TimeTicks start = TimeTicks::Now();
+    // Serialization happens synchronously, the write on the file task runner.
+    pref_store->CommitPendingWrite(
+        OnceClosure(), BindOnce(&WaitableEvent::Signal, Unretained(&written)));
+    const TimeTicks serialized = TimeTicks::Now();
+    written.Wait();
+    const TimeTicks end = TimeTicks::Now();
+
+    int64_t file_size = 0;
+    ASSERT_TRUE(GetFileSize(pref_file, &file_size));
+    if (i < 0)
+      continue;
+    serialization_time += serialized - start;
+    commit_time += end - start;
+    bytes_written += file_size;
+  }
+
+  perf_test::PrintResult("json_pref_store", "", "serialization_per_commit",
+                         serialization_time.InMicrosecondsF() / kCommits, "us",
+                         true);
+  perf_test::PrintResult("json_pref_store", "", "commit_latency",
+                         commit_time.InMicrosecondsF() / kCommits, "us", true);
+  perf_test::PrintResult("json_pref_store", "", "bytes_written_per_commit",
+                         static_cast<size_t>(bytes_written / kCommits), "bytes",
+                         true);
+
+  // For comparison, serializing all of the prefs, as every write would without
+  // reuse of the serialization of unchanged values.
+  std::unique_ptr<DictionaryValue> values = pref_store->GetValues();
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kCommits; ++i) {
+    std::string output;
+    JSONWriter::Write(*values, &output);
+  }
+  perf_test::PrintResult(
+      "json_pref_store", "", "full_serialization",
+      (TimeTicks::Now() - start).InMicrosecondsF() / kCommits, "us", false);
+}
+
+}  // namespace base
@@ -7,12 +7,15 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_samples.h"
@@ -22,6 +25,7 @@
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/test/metrics/histogram_tester.h"
@@ -113,6 +117,45 @@ void InterceptingPrefFilter::ReleasePrefs() {
   post_filter_on_load_callback_.Reset();
 }
 
+// A PrefFilter that stores the number of writes so far under kStampKey in
+// FilterSerializeData(), and only reports doing so if |reports_stamp_key|.
+class StampingPrefFilter : public PrefFilter {
+ public:
+  static constexpr char kStampKey[] = "stamp";
+
+  explicit StampingPrefFilter(bool reports_stamp_key)
+      : reports_stamp_key_(reports_stamp_key) {}
+  ~StampingPrefFilter() override = default;
+
+  // PrefFilter implementation:
+  void FilterOnLoad(
+      const PostFilterOnLoadCallback& post_filter_on_load_callback,
+      std::unique_ptr<base::DictionaryValue> pref_store_contents) override {
+    post_filter_on_load_callback.Run(std::move(pref_store_contents), false);
+  }
+  void FilterUpdate(const std::string& path) override {}
+  OnWriteCallbackPair FilterSerializeData(
+      base::DictionaryValue* pref_store_contents) override {
+    pref_store_contents->SetInteger(kStampKey, ++writes_);
+    return OnWriteCallbackPair();
+  }
+  base::Optional<std::vector<std::string>> GetKeysModifiedBySerializeData()
+      const override {
+    if (!reports_stamp_key_)
+      return base::nullopt;
+    return std::vector<std::string>{kStampKey};
+  }
+  void OnStoreDeletionFromDisk() override {}
+
+ private:
+  const bool reports_stamp_key_;
+  int writes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(StampingPrefFilter);
+};
+
+constexpr char StampingPrefFilter::kStampKey[];
+
 class MockPrefStoreObserver : public PrefStore::Observer {
  public:
   MOCK_METHOD1(OnPrefValueChanged, void (const std::string&));
@@ -538,6 +581,80 @@ TEST_P(JsonPrefStoreTest, ReadAsyncWithInterceptor) {
                             &scoped_task_environment_);
 }
 
+// Tests that writes which reuse the serialization of the values that didn't
+// change still write the whole of the prefs.
+TEST_P(JsonPrefStoreTest, IncrementalWrites) {
+  base::FilePath pref_file = temp_dir_.GetPath().AppendASCII("write.json");
+  ASSERT_LT(0,
+            base::WriteFile(pref_file, kReadJson, base::size(kReadJson) - 1));
+  auto pref_store = base::MakeRefCounted<JsonPrefStore>(pref_file);
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, pref_store->ReadPrefs());
+
+  auto expect_file_matches_prefs = [&]() {
+    CommitPendingWrite(pref_store.get(), GetParam(),
+                       &scoped_task_environment_);
+    std::string expected_contents;
+    ASSERT_TRUE(
+        JSONWriter::Write(*pref_store->GetValues(), &expected_contents));
+    std::string contents;
+    ASSERT_TRUE(base::ReadFileToString(pref_file, &contents));
+    EXPECT_EQ(expected_contents, contents);
+  };
+
+  pref_store->SetValue("tabs.max_tabs", std::make_unique<Value>(10),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  expect_file_matches_prefs();
+
+  pref_store->SetValueSilently("tabs.new_windows_in_tabs",
+                               std::make_unique<Value>(false),
+                               WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  pref_store->SetValue("\"quoted\" key", std::make_unique<Value>("a\nb"),
+                       WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  expect_file_matches_prefs();
+
+  // Values modified in place are reserialized once reported as changed.
+  Value* tabs = nullptr;
+  ASSERT_TRUE(pref_store->GetMutableValue("tabs", &tabs));
+  tabs->SetKey("max_tabs", Value(30));
+  pref_store->ReportValueChanged("tabs",
+                                 WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  expect_file_matches_prefs();
+
+  pref_store->RemoveValue(kHomePage,
+                          WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  pref_store->RemoveValueSilently("tabs.max_tabs",
+                                  WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  expect_file_matches_prefs();
+}
+
+// Tests that the values a PrefFilter modifies when data is serialized are
+// written, whether or not it reports which values it modifies.
+TEST_P(JsonPrefStoreTest, IncrementalWritesWithFilter) {
+  for (bool reports_stamp_key : {false, true}) {
+    base::FilePath pref_file = temp_dir_.GetPath().AppendASCII("write.json");
+    auto pref_store = base::MakeRefCounted<JsonPrefStore>(
+        pref_file, std::make_unique<StampingPrefFilter>(reports_stamp_key));
+    ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE,
+              pref_store->ReadPrefs());
+
+    for (int write = 1; write <= 2; ++write) {
+      pref_store->SetValue("writes", std::make_unique<Value>(write),
+                           WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+      CommitPendingWrite(pref_store.get(), GetParam(),
+                         &scoped_task_environment_);
+
+      std::string contents;
+      ASSERT_TRUE(base::ReadFileToString(pref_file, &contents));
+      EXPECT_EQ(base::StringPrintf("{\"stamp\":%d,\"writes\":%d}", write,
+                                   write),
+                contents);
+    }
+    pref_store = nullptr;
+    scoped_task_environment_.RunUntilIdle();
+    ASSERT_TRUE(base::DeleteFile(pref_file, false));
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     WithoutCallback,
     JsonPrefStoreTest,
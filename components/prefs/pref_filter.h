@@ -8,8 +8,10 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/callback_forward.h"
+#include "base/optional.h"
 #include "components/prefs/prefs_export.h"
 
 namespace base {
@@ -59,6 +61,15 @@ class COMPONENTS_PREFS_EXPORT PrefFilter {
   virtual OnWriteCallbackPair FilterSerializeData(
       base::DictionaryValue* pref_store_contents) = 0;
 
+  // Returns the top-level keys of the |pref_store_contents| which
+  // FilterSerializeData() may modify, or nullopt if it may modify any of them.
+  // The store reserializes these on every write, and reuses the serialization
+  // of the other values for as long as they don't change.
+  virtual base::Optional<std::vector<std::string>>
+  GetKeysModifiedBySerializeData() const {
+    return base::nullopt;
+  }
+
   // Cleans preference data that may have been saved outside of the store.
   virtual void OnStoreDeletionFromDisk() = 0;
 };
@@ -42,7 +42,8 @@ mojom::ActivationState ComputeActivationState(
             "SubresourceFilter.PageLoad.Activation.CPUDuration", delta);
       });
 
-  IndexedRulesetMatcher matcher(ruleset->data(), ruleset->length());
+  IndexedRulesetMatcher matcher(ruleset->data(), ruleset->length(),
+                                ruleset->GetFallbackLiterals());
   mojom::ActivationState activation_state = parent_activation_state;
   if (activation_state.filtering_disabled_for_document)
     return activation_state;
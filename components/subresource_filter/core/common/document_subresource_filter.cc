@@ -4,9 +4,12 @@
 
 #include "components/subresource_filter/core/common/document_subresource_filter.h"
 
+#include <string>
 #include <utility>
 
+#include "base/hash.h"
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/trace_event/trace_event.h"
 #include "components/subresource_filter/core/common/first_party_origin.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
@@ -17,13 +20,28 @@
 
 namespace subresource_filter {
 
+namespace {
+
+// The number of subresources whose match result is cached per document.
+constexpr size_t kMatchCacheSize = 64;
+
+uint32_t HashSpec(const std::string& spec) {
+  return base::Hash(spec);
+}
+
+}  // namespace
+
 DocumentSubresourceFilter::DocumentSubresourceFilter(
     url::Origin document_origin,
     mojom::ActivationState activation_state,
     scoped_refptr<const MemoryMappedRuleset> ruleset)
     : activation_state_(activation_state),
       ruleset_(std::move(ruleset)),
-      ruleset_matcher_(ruleset_->data(), ruleset_->length()) {
+      ruleset_matcher_(ruleset_->data(),
+                       ruleset_->length(),
+                       ruleset_->GetFallbackLiterals()),
+      match_cache_(kMatchCacheSize),
+      spec_hash_function_(&HashSpec) {
   DCHECK_NE(activation_state_.activation_level,
             mojom::ActivationLevel::kDisabled);
   if (!activation_state_.filtering_disabled_for_document)
@@ -46,6 +64,66 @@ LoadPolicy DocumentSubresourceFilter::GetLoadPolicy(
   if (subresource_url.SchemeIs(url::kDataScheme))
     return LoadPolicy::ALLOW;
 
+  return TimeAndEvaluateLoadPolicy(subresource_url, subresource_type);
+}
+
+std::vector<LoadPolicy> DocumentSubresourceFilter::GetLoadPolicies(
+    base::span<const GURL> subresource_urls,
+    url_pattern_index::proto::ElementType subresource_type) {
+  TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("loading"),
+               "DocumentSubresourceFilter::GetLoadPolicies", "count",
+               subresource_urls.size());
+
+  statistics_.num_loads_total +=
+      base::checked_cast<int32_t>(subresource_urls.size());
+
+  std::vector<LoadPolicy> policies(subresource_urls.size(), LoadPolicy::ALLOW);
+  if (activation_state_.filtering_disabled_for_document)
+    return policies;
+
+  for (size_t i = 0; i < subresource_urls.size(); ++i) {
+    if (subresource_urls[i].SchemeIs(url::kDataScheme))
+      continue;
+    policies[i] =
+        TimeAndEvaluateLoadPolicy(subresource_urls[i], subresource_type);
+  }
+  return policies;
+}
+
+const url_pattern_index::flat::UrlRule*
+DocumentSubresourceFilter::FindMatchingUrlRule(
+    const GURL& subresource_url,
+    url_pattern_index::proto::ElementType subresource_type) {
+  if (activation_state_.filtering_disabled_for_document)
+    return nullptr;
+  if (subresource_url.SchemeIs(url::kDataScheme))
+    return nullptr;
+
+  return ruleset_matcher_.MatchedUrlRule(
+      subresource_url, *document_origin_, subresource_type,
+      activation_state_.generic_blocking_rules_disabled);
+}
+
+void DocumentSubresourceFilter::set_activation_state(
+    const mojom::ActivationState& state) {
+  activation_state_ = state;
+  match_cache_.Clear();
+}
+
+void DocumentSubresourceFilter::SetSpecHashFunctionForTesting(
+    SpecHashFunction spec_hash_function) {
+  spec_hash_function_ = spec_hash_function;
+  match_cache_.Clear();
+}
+
+size_t DocumentSubresourceFilter::MatchCacheKeyHash::operator()(
+    const MatchCacheKey& key) const {
+  return base::HashInts32(key.spec_hash, static_cast<uint32_t>(key.type));
+}
+
+LoadPolicy DocumentSubresourceFilter::TimeAndEvaluateLoadPolicy(
+    const GURL& subresource_url,
+    url_pattern_index::proto::ElementType subresource_type) {
   // If ThreadTicks is not supported, then no CPU time measurements have been
   // collected. Don't report both CPU and wall duration to be consistent.
   auto wall_duration_timer = ScopedTimers::StartIf(
@@ -63,11 +141,14 @@ LoadPolicy DocumentSubresourceFilter::GetLoadPolicy(
             "SubresourceFilter.SubresourceLoad.Evaluation.CPUDuration", delta);
       });
 
+  return EvaluateLoadPolicy(subresource_url, subresource_type);
+}
+
+LoadPolicy DocumentSubresourceFilter::EvaluateLoadPolicy(
+    const GURL& subresource_url,
+    url_pattern_index::proto::ElementType subresource_type) {
   ++statistics_.num_loads_evaluated;
-  DCHECK(document_origin_);
-  if (ruleset_matcher_.ShouldDisallowResourceLoad(
-          subresource_url, *document_origin_, subresource_type,
-          activation_state_.generic_blocking_rules_disabled)) {
+  if (ShouldDisallowResourceLoad(subresource_url, subresource_type)) {
     ++statistics_.num_loads_matching_rules;
     if (activation_state_.activation_level ==
         mojom::ActivationLevel::kEnabled) {
@@ -81,18 +162,21 @@ LoadPolicy DocumentSubresourceFilter::GetLoadPolicy(
   return LoadPolicy::ALLOW;
 }
 
-const url_pattern_index::flat::UrlRule*
-DocumentSubresourceFilter::FindMatchingUrlRule(
+bool DocumentSubresourceFilter::ShouldDisallowResourceLoad(
     const GURL& subresource_url,
     url_pattern_index::proto::ElementType subresource_type) {
-  if (activation_state_.filtering_disabled_for_document)
-    return nullptr;
-  if (subresource_url.SchemeIs(url::kDataScheme))
-    return nullptr;
+  const std::string& spec = subresource_url.possibly_invalid_spec();
+  MatchCacheKey key = {subresource_type, spec_hash_function_(spec)};
+  auto it = match_cache_.Get(key);
+  if (it != match_cache_.end() && it->second.spec == spec)
+    return it->second.disallow;
 
-  return ruleset_matcher_.MatchedUrlRule(
+  DCHECK(document_origin_);
+  const bool disallow = ruleset_matcher_.ShouldDisallowResourceLoad(
       subresource_url, *document_origin_, subresource_type,
       activation_state_.generic_blocking_rules_disabled);
+  match_cache_.Put(key, MatchCacheEntry{spec, disallow});
+  return disallow;
 }
 
 }  // namespace subresource_filter
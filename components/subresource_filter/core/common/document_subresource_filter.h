@@ -6,10 +6,14 @@
 #define COMPONENTS_SUBRESOURCE_FILTER_CORE_COMMON_DOCUMENT_SUBRESOURCE_FILTER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
+#include "base/containers/span.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "components/subresource_filter/core/common/indexed_ruleset.h"
@@ -58,6 +62,14 @@ class DocumentSubresourceFilter {
       const GURL& subresource_url,
       url_pattern_index::proto::ElementType subresource_type);
 
+  // Like GetLoadPolicy, but for a batch of |subresource_urls| of the same
+  // |subresource_type|, such as the resources found by a preload scan. Returns
+  // the policies in the same order. Each URL is timed and recorded to the
+  // evaluation histograms as if it had been passed to GetLoadPolicy.
+  std::vector<LoadPolicy> GetLoadPolicies(
+      base::span<const GURL> subresource_urls,
+      url_pattern_index::proto::ElementType subresource_type);
+
   // Returns the matching rule that determines whether the request url and type
   // should be allowed. If no rule matches, returns nullptr.
   const url_pattern_index::flat::UrlRule* FindMatchingUrlRule(
@@ -66,11 +78,54 @@ class DocumentSubresourceFilter {
 
   // Called if the DocumentSubresourceFilter needs to change how it filters
   // subresources.
-  void set_activation_state(const mojom::ActivationState& state) {
-    activation_state_ = state;
-  }
+  void set_activation_state(const mojom::ActivationState& state);
+
+  // Replaces the hash of URL specs used by the match cache, so that tests can
+  // make URLs collide.
+  using SpecHashFunction = uint32_t (*)(const std::string& spec);
+  void SetSpecHashFunctionForTesting(SpecHashFunction spec_hash_function);
 
  private:
+  // Recently evaluated subresources are keyed by type and a hash of the URL
+  // spec, so that looking up a URL that isn't cached doesn't copy its spec.
+  struct MatchCacheKey {
+    bool operator==(const MatchCacheKey& other) const {
+      return type == other.type && spec_hash == other.spec_hash;
+    }
+
+    url_pattern_index::proto::ElementType type;
+    uint32_t spec_hash;
+  };
+
+  // The cached result keeps its spec: the page chooses its subresource URLs,
+  // so a URL whose hash collides with a cached one must not reuse its result.
+  struct MatchCacheEntry {
+    std::string spec;
+    bool disallow;
+  };
+
+  struct MatchCacheKeyHash {
+    size_t operator()(const MatchCacheKey& key) const;
+  };
+
+  // Evaluates |subresource_url|, which must not be a data: URL, recording the
+  // evaluation durations if the activation state asks for it.
+  LoadPolicy TimeAndEvaluateLoadPolicy(
+      const GURL& subresource_url,
+      url_pattern_index::proto::ElementType subresource_type);
+
+  // Evaluates the ruleset for a subresource that is subject to filtering, and
+  // updates the statistics other than the evaluation durations.
+  LoadPolicy EvaluateLoadPolicy(
+      const GURL& subresource_url,
+      url_pattern_index::proto::ElementType subresource_type);
+
+  // Returns whether the ruleset disallows loading |subresource_url| as
+  // |subresource_type|, looking it up in |match_cache_| first.
+  bool ShouldDisallowResourceLoad(
+      const GURL& subresource_url,
+      url_pattern_index::proto::ElementType subresource_type);
+
   mojom::ActivationState activation_state_;
   const scoped_refptr<const MemoryMappedRuleset> ruleset_;
   const IndexedRulesetMatcher ruleset_matcher_;
@@ -80,6 +135,15 @@ class DocumentSubresourceFilter {
 
   mojom::DocumentLoadStatistics statistics_;
 
+  // Whether the ruleset disallows recently evaluated subresources. Pages tend
+  // to load the same URLs several times, e.g. beacons and images repeated in
+  // lists, and each of those loads would otherwise repeat the third-party
+  // check and the N-gram, domain and activation matching of every candidate
+  // rule. Cleared when the activation state changes.
+  base::HashingMRUCache<MatchCacheKey, MatchCacheEntry, MatchCacheKeyHash>
+      match_cache_;
+  SpecHashFunction spec_hash_function_;
+
   DISALLOW_COPY_AND_ASSIGN(DocumentSubresourceFilter);
 };
 
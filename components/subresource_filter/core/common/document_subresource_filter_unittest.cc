@@ -4,10 +4,15 @@
 
 #include "components/subresource_filter/core/common/document_subresource_filter.h"
 
+#include <string>
+#include <vector>
+
 #include "base/files/file.h"
 #include "base/macros.h"
 #include "base/strings/string_piece.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
+#include "components/subresource_filter/core/common/scoped_timers.h"
 #include "components/subresource_filter/core/common/test_ruleset_creator.h"
 #include "components/subresource_filter/core/common/test_ruleset_utils.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -172,4 +177,91 @@ TEST_F(DocumentSubresourceFilterTest, MatchingRuleEnabled) {
             filter.FindMatchingUrlRule(GURL(kTestBetaURL), kSubdocumentType));
 }
 
+TEST_F(DocumentSubresourceFilterTest, GetLoadPolicies) {
+  mojom::ActivationState activation_state;
+  activation_state.activation_level = kEnabled;
+  activation_state.measure_performance = true;
+  DocumentSubresourceFilter filter(url::Origin(), activation_state, ruleset());
+
+  base::HistogramTester histogram_tester;
+  const GURL kUrls[] = {GURL(kTestAlphaURL), GURL(kTestAlphaDataURI),
+                        GURL(kTestBetaURL), GURL(kTestAlphaURL)};
+  EXPECT_EQ(std::vector<LoadPolicy>({LoadPolicy::DISALLOW, LoadPolicy::ALLOW,
+                                     LoadPolicy::ALLOW, LoadPolicy::DISALLOW}),
+            filter.GetLoadPolicies(kUrls, kImageType));
+  EXPECT_TRUE(filter.GetLoadPolicies({}, kImageType).empty());
+
+  // Each evaluated URL is recorded as if it had been loaded on its own.
+  if (ScopedThreadTimers::IsSupported()) {
+    histogram_tester.ExpectTotalCount(
+        "SubresourceFilter.SubresourceLoad.Evaluation.WallDuration", 3);
+    histogram_tester.ExpectTotalCount(
+        "SubresourceFilter.SubresourceLoad.Evaluation.CPUDuration", 3);
+  }
+
+  const auto& statistics = filter.statistics();
+  EXPECT_EQ(4, statistics.num_loads_total);
+  EXPECT_EQ(3, statistics.num_loads_evaluated);
+  EXPECT_EQ(2, statistics.num_loads_matching_rules);
+  EXPECT_EQ(2, statistics.num_loads_disallowed);
+}
+
+TEST_F(DocumentSubresourceFilterTest, GetLoadPoliciesFilteringDisabled) {
+  mojom::ActivationState activation_state;
+  activation_state.activation_level = kEnabled;
+  activation_state.filtering_disabled_for_document = true;
+  DocumentSubresourceFilter filter(url::Origin(), activation_state, ruleset());
+
+  const GURL kUrls[] = {GURL(kTestAlphaURL), GURL(kTestBetaURL)};
+  EXPECT_EQ(std::vector<LoadPolicy>({LoadPolicy::ALLOW, LoadPolicy::ALLOW}),
+            filter.GetLoadPolicies(kUrls, kImageType));
+  EXPECT_EQ(2, filter.statistics().num_loads_total);
+  EXPECT_EQ(0, filter.statistics().num_loads_evaluated);
+}
+
+// Repeated loads are served from the match cache, which must not outlive a
+// change in how the document is filtered.
+TEST_F(DocumentSubresourceFilterTest, RepeatedLoadsAfterActivationChange) {
+  mojom::ActivationState activation_state;
+  activation_state.activation_level = kEnabled;
+  DocumentSubresourceFilter filter(url::Origin(), activation_state, ruleset());
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(LoadPolicy::DISALLOW,
+              filter.GetLoadPolicy(GURL(kTestAlphaURL), kImageType));
+    EXPECT_EQ(LoadPolicy::ALLOW,
+              filter.GetLoadPolicy(GURL(kTestBetaURL), kImageType));
+  }
+  EXPECT_EQ(6, filter.statistics().num_loads_evaluated);
+  EXPECT_EQ(3, filter.statistics().num_loads_disallowed);
+
+  activation_state.generic_blocking_rules_disabled = true;
+  filter.set_activation_state(activation_state);
+  EXPECT_EQ(LoadPolicy::ALLOW,
+            filter.GetLoadPolicy(GURL(kTestAlphaURL), kImageType));
+
+  activation_state.generic_blocking_rules_disabled = false;
+  activation_state.activation_level = kDryRun;
+  filter.set_activation_state(activation_state);
+  EXPECT_EQ(LoadPolicy::WOULD_DISALLOW,
+            filter.GetLoadPolicy(GURL(kTestAlphaURL), kImageType));
+}
+
+// A URL whose spec hash collides with a cached URL is still evaluated.
+TEST_F(DocumentSubresourceFilterTest, MatchCacheHashCollision) {
+  mojom::ActivationState activation_state;
+  activation_state.activation_level = kEnabled;
+  DocumentSubresourceFilter filter(url::Origin(), activation_state, ruleset());
+  filter.SetSpecHashFunctionForTesting(
+      [](const std::string& spec) -> uint32_t { return 0; });
+
+  EXPECT_EQ(LoadPolicy::ALLOW,
+            filter.GetLoadPolicy(GURL(kTestBetaURL), kImageType));
+  EXPECT_EQ(LoadPolicy::DISALLOW,
+            filter.GetLoadPolicy(GURL(kTestAlphaURL), kImageType));
+  EXPECT_EQ(LoadPolicy::ALLOW,
+            filter.GetLoadPolicy(GURL(kTestBetaURL), kImageType));
+  EXPECT_EQ(1, filter.statistics().num_loads_disallowed);
+}
+
 }  // namespace subresource_filter
@@ -102,6 +102,22 @@ int RulesetIndexer::GetChecksum() const {
   return LocalGetChecksum(data(), size());
 }
 
+// IndexedRulesetFallbackLiterals ----------------------------------------------
+
+IndexedRulesetFallbackLiterals::IndexedRulesetFallbackLiterals(
+    const uint8_t* buffer,
+    size_t size) {
+  const flat::IndexedRuleset* root = flat::GetIndexedRuleset(buffer);
+  blacklist_ =
+      url_pattern_index::FallbackRuleLiterals::Create(root->blacklist_index());
+  whitelist_ =
+      url_pattern_index::FallbackRuleLiterals::Create(root->whitelist_index());
+  deactivation_ = url_pattern_index::FallbackRuleLiterals::Create(
+      root->deactivation_index());
+}
+
+IndexedRulesetFallbackLiterals::~IndexedRulesetFallbackLiterals() = default;
+
 // IndexedRulesetMatcher -------------------------------------------------------
 
 // static
@@ -128,6 +144,18 @@ IndexedRulesetMatcher::IndexedRulesetMatcher(const uint8_t* buffer, size_t size)
       whitelist_(root_->whitelist_index()),
       deactivation_(root_->deactivation_index()) {}
 
+IndexedRulesetMatcher::IndexedRulesetMatcher(
+    const uint8_t* buffer,
+    size_t size,
+    const IndexedRulesetFallbackLiterals* fallback_literals)
+    : root_(flat::GetIndexedRuleset(buffer)),
+      blacklist_(root_->blacklist_index(),
+                 fallback_literals->blacklist_.get()),
+      whitelist_(root_->whitelist_index(),
+                 fallback_literals->whitelist_.get()),
+      deactivation_(root_->deactivation_index(),
+                    fallback_literals->deactivation_.get()) {}
+
 bool IndexedRulesetMatcher::ShouldDisableFilteringForDocument(
     const GURL& document_url,
     const url::Origin& parent_document_origin,
@@ -8,6 +8,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
+
 #include "base/macros.h"
 #include "base/numerics/safe_conversions.h"
 #include "components/subresource_filter/core/common/flat/indexed_ruleset_generated.h"
@@ -92,6 +94,29 @@ class RulesetIndexer {
   DISALLOW_COPY_AND_ASSIGN(RulesetIndexer);
 };
 
+// The url_pattern_index::FallbackRuleLiterals of each index of an indexed
+// ruleset. Building them takes time linear in the size of the fallback rules
+// of the ruleset, so they are built once per ruleset, and shared by all the
+// IndexedRulesetMatchers over it.
+class IndexedRulesetFallbackLiterals {
+ public:
+  // Builds the literals of the flat::IndexedRuleset provided as the root object
+  // of serialized data in the |buffer| of the given |size|. The instance
+  // doesn't reference |buffer| afterwards.
+  IndexedRulesetFallbackLiterals(const uint8_t* buffer, size_t size);
+  ~IndexedRulesetFallbackLiterals();
+
+ private:
+  friend class IndexedRulesetMatcher;
+
+  // Each of these is nullptr if the index has too few fallback rules.
+  std::unique_ptr<url_pattern_index::FallbackRuleLiterals> blacklist_;
+  std::unique_ptr<url_pattern_index::FallbackRuleLiterals> whitelist_;
+  std::unique_ptr<url_pattern_index::FallbackRuleLiterals> deactivation_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedRulesetFallbackLiterals);
+};
+
 // Matches URLs against the FlatBuffer representation of an indexed ruleset.
 class IndexedRulesetMatcher {
  public:
@@ -101,9 +126,18 @@ class IndexedRulesetMatcher {
 
   // Creates an instance that matches URLs against the flat::IndexedRuleset
   // provided as the root object of serialized data in the |buffer| of the given
-  // |size|.
+  // |size|. This builds the fallback literals of the ruleset, so callers that
+  // create several matchers over the same ruleset should use the constructor
+  // below instead.
   IndexedRulesetMatcher(const uint8_t* buffer, size_t size);
 
+  // Like above, but uses |fallback_literals|, which must have been built from
+  // the same ruleset and must outlive this instance.
+  IndexedRulesetMatcher(
+      const uint8_t* buffer,
+      size_t size,
+      const IndexedRulesetFallbackLiterals* fallback_literals);
+
   // Returns whether the subset of subresource filtering rules specified by the
   // |activation_type| should be disabled for the |document| loaded from
   // |parent_document_origin|. Always returns false if |activation_type| ==
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
 
 namespace subresource_filter {
 
@@ -32,6 +33,15 @@ void MemoryMappedRuleset::SetMemoryMapFailuresForTesting(bool fail) {
   g_fail_memory_map_initialization_for_testing = fail;
 }
 
+const IndexedRulesetFallbackLiterals*
+MemoryMappedRuleset::GetFallbackLiterals() const {
+  if (!fallback_literals_) {
+    fallback_literals_ =
+        std::make_unique<IndexedRulesetFallbackLiterals>(data(), length());
+  }
+  return fallback_literals_.get();
+}
+
 MemoryMappedRuleset::MemoryMappedRuleset() = default;
 MemoryMappedRuleset::~MemoryMappedRuleset() = default;
 
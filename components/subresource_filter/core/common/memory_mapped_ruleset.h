@@ -8,6 +8,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
+
 #include "base/files/file.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/macros.h"
@@ -17,6 +19,8 @@
 
 namespace subresource_filter {
 
+class IndexedRulesetFallbackLiterals;
+
 // A reference-counted wrapper around base::MemoryMappedFile. The |ruleset_file|
 // supplied in the constructor is kept memory-mapped and is safe to access until
 // the last reference to this instance is dropped.
@@ -32,6 +36,11 @@ class MemoryMappedRuleset : public base::RefCounted<MemoryMappedRuleset>,
   const uint8_t* data() const { return ruleset_.data(); }
   size_t length() const { return base::strict_cast<size_t>(ruleset_.length()); }
 
+  // Returns the fallback literals of the indexed ruleset, which are built the
+  // first time this is called and shared by all the IndexedRulesetMatchers
+  // created over this ruleset. The ruleset must have been verified.
+  const IndexedRulesetFallbackLiterals* GetFallbackLiterals() const;
+
  private:
   friend class base::RefCounted<MemoryMappedRuleset>;
   MemoryMappedRuleset();
@@ -39,6 +48,9 @@ class MemoryMappedRuleset : public base::RefCounted<MemoryMappedRuleset>,
 
   base::MemoryMappedFile ruleset_;
 
+  // Built lazily, since only rulesets that are matched against need them.
+  mutable std::unique_ptr<IndexedRulesetFallbackLiterals> fallback_literals_;
+
   DISALLOW_COPY_AND_ASSIGN(MemoryMappedRuleset);
 };
 
@@ -4,26 +4,39 @@
 
 #include <algorithm>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/path_service.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "components/subresource_filter/core/common/document_subresource_filter.h"
+#include "components/subresource_filter/core/common/first_party_origin.h"
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
 #include "components/subresource_filter/tools/filter_tool.h"
 #include "components/subresource_filter/tools/indexing_tool.h"
+#include "components/url_pattern_index/proto/rules.pb.h"
+#include "components/url_pattern_index/url_pattern.h"
+#include "components/url_pattern_index/url_rule_test_support.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+#include "url/origin.h"
 
 namespace subresource_filter {
 
@@ -58,13 +71,17 @@ class IndexedRulesetPerftest : public testing::Test {
     base::File indexed_file =
         base::File(indexed_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
     ASSERT_TRUE(indexed_file.IsValid());
-    auto ruleset = subresource_filter::MemoryMappedRuleset::CreateAndInitialize(
+    ruleset_ = subresource_filter::MemoryMappedRuleset::CreateAndInitialize(
         std::move(indexed_file));
-    filter_tool_ = std::make_unique<FilterTool>(std::move(ruleset), &output_);
+    filter_tool_ = std::make_unique<FilterTool>(ruleset_, &output_);
   }
 
   FilterTool* filter_tool() { return filter_tool_.get(); }
 
+  const scoped_refptr<const MemoryMappedRuleset>& ruleset() const {
+    return ruleset_;
+  }
+
   const std::string& requests() const { return requests_; }
 
   const base::FilePath& unindexed_path() const { return unindexed_path_; }
@@ -75,6 +92,8 @@ class IndexedRulesetPerftest : public testing::Test {
 
   std::string requests_;
 
+  scoped_refptr<const MemoryMappedRuleset> ruleset_;
+
   // Use an unopened output stream as a sort of null stream. All writes will
   // fail so things should be a bit faster than writing to a string.
   std::ofstream output_;
@@ -110,4 +129,203 @@ TEST_F(IndexedRulesetPerftest, MatchAll) {
                          true /* important */);
 }
 
+namespace {
+
+// The subresource loads of one recorded page.
+struct RecordedPage {
+  url::Origin origin;
+  std::vector<std::pair<GURL, url_pattern_index::proto::ElementType>> loads;
+};
+
+url_pattern_index::proto::ElementType ParseElementType(
+    base::StringPiece type) {
+  namespace proto = url_pattern_index::proto;
+  if (type == "script")
+    return proto::ELEMENT_TYPE_SCRIPT;
+  if (type == "image")
+    return proto::ELEMENT_TYPE_IMAGE;
+  if (type == "stylesheet")
+    return proto::ELEMENT_TYPE_STYLESHEET;
+  if (type == "xmlhttprequest")
+    return proto::ELEMENT_TYPE_XMLHTTPREQUEST;
+  if (type == "subdocument")
+    return proto::ELEMENT_TYPE_SUBDOCUMENT;
+  if (type == "font")
+    return proto::ELEMENT_TYPE_FONT;
+  if (type == "media")
+    return proto::ELEMENT_TYPE_MEDIA;
+  return proto::ELEMENT_TYPE_OTHER;
+}
+
+// Groups the recorded |requests|, one JSON dictionary per line, into pages by
+// their document origin.
+std::vector<RecordedPage> ParseRecordedPages(const std::string& requests) {
+  std::vector<RecordedPage> pages;
+  std::map<std::string, size_t> page_index_by_origin;
+  std::istringstream request_stream(requests);
+  std::string line;
+  while (std::getline(request_stream, line)) {
+    std::unique_ptr<base::Value> request =
+        base::JSONReader::ReadDeprecated(line);
+    if (!request || !request->is_dict())
+      continue;
+    const std::string* origin = request->FindStringKey("origin");
+    const std::string* url = request->FindStringKey("request_url");
+    const std::string* type = request->FindStringKey("request_type");
+    if (!origin || !url || !type)
+      continue;
+
+    auto it = page_index_by_origin.emplace(*origin, pages.size()).first;
+    if (it->second == pages.size()) {
+      pages.emplace_back();
+      pages.back().origin = url::Origin::Create(GURL(*origin));
+    }
+    pages[it->second].loads.emplace_back(GURL(*url), ParseElementType(*type));
+  }
+  return pages;
+}
+
+}  // namespace
+
+// Measures the cost of filtering all the subresources of a recorded page,
+// including the creation of its DocumentSubresourceFilter.
+TEST_F(IndexedRulesetPerftest, FilterRecordedPages) {
+  const std::vector<RecordedPage> pages = ParseRecordedPages(requests());
+  ASSERT_FALSE(pages.empty());
+
+  mojom::ActivationState activation_state;
+  activation_state.activation_level = mojom::ActivationLevel::kEnabled;
+
+  std::vector<int64_t> results;
+  std::vector<int64_t> batch_results;
+  for (int i = 0; i < 5; ++i) {
+    base::ElapsedTimer timer;
+    for (const RecordedPage& page : pages) {
+      DocumentSubresourceFilter filter(page.origin, activation_state,
+                                       ruleset());
+      for (const auto& load : page.loads)
+        filter.GetLoadPolicy(load.first, load.second);
+    }
+    results.push_back(timer.Elapsed().InMicroseconds());
+
+    // Filter each page again, in batches of loads of the same type.
+    base::ElapsedTimer batch_timer;
+    for (const RecordedPage& page : pages) {
+      DocumentSubresourceFilter filter(page.origin, activation_state,
+                                       ruleset());
+      std::map<url_pattern_index::proto::ElementType, std::vector<GURL>>
+          urls_by_type;
+      for (const auto& load : page.loads)
+        urls_by_type[load.second].push_back(load.first);
+      for (const auto& type_and_urls : urls_by_type)
+        filter.GetLoadPolicies(type_and_urls.second, type_and_urls.first);
+    }
+    batch_results.push_back(batch_timer.Elapsed().InMicroseconds());
+  }
+  std::sort(results.begin(), results.end());
+  std::sort(batch_results.begin(), batch_results.end());
+  perf_test::PrintResult("median_page_filter_time", "", "",
+                         static_cast<size_t>(results[2] / pages.size()),
+                         "microseconds", true /* important */);
+  perf_test::PrintResult("median_page_filter_time", "_batched", "",
+                         static_cast<size_t>(batch_results[2] / pages.size()),
+                         "microseconds", true /* important */);
+}
+
+// Matches requests against a large synthetic ruleset shaped like EasyList:
+// mostly host and path rules that are indexed by N-gram, plus thousands of
+// short generic rules that are not and so are checked against every request.
+TEST(IndexedRulesetSyntheticPerftest, MatchLargeRuleset) {
+  namespace proto = url_pattern_index::proto;
+  namespace testing = url_pattern_index::testing;
+  using url_pattern_index::UrlPattern;
+
+  constexpr int kNumHostRules = 20000;
+  constexpr int kNumPathRules = 5000;
+  constexpr int kNumShortRules = 2000;
+  constexpr int kNumWhitelistRules = 1000;
+  constexpr int kNumRequests = 5000;
+  constexpr int kNumIterations = 5;
+
+  RulesetIndexer indexer;
+  for (int i = 0; i < kNumHostRules; ++i) {
+    // ||adhost<i>.example^
+    ASSERT_TRUE(indexer.AddUrlRule(testing::MakeUrlRule(
+        UrlPattern(base::StringPrintf("adhost%d.example^", i),
+                   testing::kSubdomain, testing::kAnchorNone))));
+  }
+  for (int i = 0; i < kNumPathRules; ++i) {
+    ASSERT_TRUE(indexer.AddUrlRule(testing::MakeUrlRule(UrlPattern(
+        base::StringPrintf("/banners/%d/", i), testing::kSubstring))));
+  }
+  for (int i = 0; i < kNumShortRules; ++i) {
+    // Too short for an N-gram, like /ad*123^ and -123*/pop^.
+    const std::string pattern = i % 2 ? base::StringPrintf("/ad*%d^", i)
+                                      : base::StringPrintf("-%d*/pop^", i);
+    ASSERT_TRUE(indexer.AddUrlRule(testing::MakeUrlRule(UrlPattern(pattern))));
+  }
+  for (int i = 0; i < kNumWhitelistRules; ++i) {
+    // @@||cdn<i>.example^
+    auto rule = testing::MakeUrlRule(
+        UrlPattern(base::StringPrintf("cdn%d.example^", i), testing::kSubdomain,
+                   testing::kAnchorNone));
+    rule.set_semantics(proto::RULE_SEMANTICS_WHITELIST);
+    ASSERT_TRUE(indexer.AddUrlRule(rule));
+  }
+  indexer.Finish();
+
+  base::ElapsedTimer creation_timer;
+  IndexedRulesetMatcher matcher(indexer.data(), indexer.size());
+  perf_test::PrintResult(
+      "synthetic_matcher_creation_time", "", "",
+      static_cast<size_t>(creation_timer.Elapsed().InMicroseconds()),
+      "microseconds", true /* important */);
+
+  // Most requests match no rule, as on a typical page.
+  std::vector<GURL> requests;
+  for (int i = 0; i < kNumRequests; ++i) {
+    switch (i % 8) {
+      case 0:
+        requests.emplace_back(base::StringPrintf(
+            "https://adhost%d.example/track?id=%d", i * 7, i));
+        break;
+      case 1:
+        requests.emplace_back(base::StringPrintf(
+            "https://cdn%d.example/banners/%d/x.gif", i % 1500, i));
+        break;
+      case 2:
+        requests.emplace_back(
+            base::StringPrintf("https://www.site.com/ad/%d/x.gif", i));
+        break;
+      default:
+        requests.emplace_back(base::StringPrintf(
+            "https://static%d.site.com/assets/js/app.%d.js?v=%d&lang=en",
+            i % 50, i, i * 31));
+        break;
+    }
+  }
+  const FirstPartyOrigin first_party(
+      url::Origin::Create(GURL("https://www.site.com/")));
+
+  std::vector<int64_t> results;
+  size_t disallowed = 0;
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    base::ElapsedTimer timer;
+    for (const GURL& request : requests) {
+      disallowed += matcher.ShouldDisallowResourceLoad(
+          request, first_party, testing::kScript,
+          false /* disable_generic_rules */);
+    }
+    results.push_back(timer.Elapsed().InMicroseconds());
+  }
+  EXPECT_GT(disallowed, 0u);
+
+  std::sort(results.begin(), results.end());
+  const int64_t median_us = std::max<int64_t>(results[kNumIterations / 2], 1);
+  perf_test::PrintResult(
+      "synthetic_match_rate", "", "",
+      static_cast<size_t>(int64_t{kNumRequests} * 1000000 / median_us),
+      "matches/s", true /* important */);
+}
+
 }  // namespace subresource_filter
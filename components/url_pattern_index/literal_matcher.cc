@@ -0,0 +1,158 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/url_pattern_index/literal_matcher.h"
+
+#include <algorithm>
+
+#include "base/containers/circular_deque.h"
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+
+namespace url_pattern_index {
+
+namespace {
+
+// The root of the trie.
+constexpr uint32_t kRoot = 0;
+
+// Nodes with at most this many edges are searched linearly.
+constexpr uint32_t kMaxLinearSearchEdges = 8;
+
+}  // namespace
+
+LiteralMatcher::LiteralMatcher()
+    : nodes_(1), building_edges_(1), building_ids_(1) {}
+
+LiteralMatcher::~LiteralMatcher() = default;
+
+void LiteralMatcher::AddLiteral(base::StringPiece literal, LiteralId id) {
+  DCHECK(!built_);
+  DCHECK(!literal.empty());
+
+  uint32_t node = kRoot;
+  for (char c : literal) {
+    const uint8_t byte = static_cast<uint8_t>(base::ToLowerASCII(c));
+    std::vector<Edge>& edges = building_edges_[node];
+    auto it = std::find_if(edges.begin(), edges.end(),
+                           [byte](const Edge& edge) {
+                             return edge.byte == byte;
+                           });
+    if (it != edges.end()) {
+      node = it->target;
+      continue;
+    }
+
+    const uint32_t child = static_cast<uint32_t>(nodes_.size());
+    edges.push_back({byte, child});
+    nodes_.emplace_back();
+    building_edges_.emplace_back();
+    building_ids_.emplace_back();
+    node = child;
+  }
+  building_ids_[node].push_back(id);
+}
+
+void LiteralMatcher::Build() {
+  DCHECK(!built_);
+  built_ = true;
+
+  // Flatten the trie.
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    std::vector<Edge>& edges = building_edges_[i];
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge& lhs, const Edge& rhs) {
+                return lhs.byte < rhs.byte;
+              });
+    nodes_[i].edges_begin = static_cast<uint32_t>(edges_.size());
+    nodes_[i].edges_count = static_cast<uint32_t>(edges.size());
+    edges_.insert(edges_.end(), edges.begin(), edges.end());
+
+    const std::vector<LiteralId>& ids = building_ids_[i];
+    nodes_[i].ids_begin = static_cast<uint32_t>(ids_.size());
+    nodes_[i].ids_count = static_cast<uint32_t>(ids.size());
+    ids_.insert(ids_.end(), ids.begin(), ids.end());
+  }
+  building_edges_.clear();
+  building_edges_.shrink_to_fit();
+  building_ids_.clear();
+  building_ids_.shrink_to_fit();
+
+  for (int byte = 0; byte < 256; ++byte) {
+    const uint32_t child = GetChild(kRoot, static_cast<uint8_t>(byte));
+    root_next_[byte] = child == kNoNode ? kRoot : child;
+  }
+
+  // Compute the failure and output links in breadth-first order, so that the
+  // links of the shallower nodes they point to are already known.
+  base::circular_deque<uint32_t> queue;
+  queue.push_back(kRoot);
+  while (!queue.empty()) {
+    const uint32_t node = queue.front();
+    queue.pop_front();
+
+    const Node& parent = nodes_[node];
+    for (uint32_t i = 0; i < parent.edges_count; ++i) {
+      const Edge& edge = edges_[parent.edges_begin + i];
+      Node& child = nodes_[edge.target];
+      child.failure =
+          node == kRoot ? kRoot : Next(nodes_[node].failure, edge.byte);
+
+      const Node& failure = nodes_[child.failure];
+      child.output = failure.ids_count ? child.failure : failure.output;
+      queue.push_back(edge.target);
+    }
+  }
+}
+
+void LiteralMatcher::FindAll(base::StringPiece text,
+                             std::vector<bool>* found) const {
+  DCHECK(built_);
+  DCHECK(found);
+
+  uint32_t node = kRoot;
+  for (char c : text) {
+    node = Next(node, static_cast<uint8_t>(base::ToLowerASCII(c)));
+    for (uint32_t match = node; match != kNoNode;
+         match = nodes_[match].output) {
+      const Node& match_node = nodes_[match];
+      for (uint32_t i = 0; i < match_node.ids_count; ++i) {
+        const LiteralId id = ids_[match_node.ids_begin + i];
+        DCHECK_LT(id, found->size());
+        (*found)[id] = true;
+      }
+    }
+  }
+}
+
+uint32_t LiteralMatcher::GetChild(uint32_t node, uint8_t byte) const {
+  const Node& parent = nodes_[node];
+  const Edge* begin = edges_.data() + parent.edges_begin;
+  const Edge* end = begin + parent.edges_count;
+  if (parent.edges_count <= kMaxLinearSearchEdges) {
+    for (const Edge* edge = begin; edge != end; ++edge) {
+      if (edge->byte == byte)
+        return edge->target;
+    }
+    return kNoNode;
+  }
+
+  const Edge* edge =
+      std::lower_bound(begin, end, byte, [](const Edge& edge, uint8_t byte) {
+        return edge.byte < byte;
+      });
+  return edge != end && edge->byte == byte ? edge->target : kNoNode;
+}
+
+uint32_t LiteralMatcher::Next(uint32_t node, uint8_t byte) const {
+  while (node != kRoot) {
+    const uint32_t child = GetChild(node, byte);
+    if (child != kNoNode)
+      return child;
+    node = nodes_[node].failure;
+  }
+  return root_next_[byte];
+}
+
+}  // namespace url_pattern_index
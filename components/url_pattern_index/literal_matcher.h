@@ -0,0 +1,112 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_URL_PATTERN_INDEX_LITERAL_MATCHER_H_
+#define COMPONENTS_URL_PATTERN_INDEX_LITERAL_MATCHER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace url_pattern_index {
+
+// Finds which of a set of literals occur in a text, scanning the text once
+// regardless of the number of literals. Implemented as an Aho-Corasick
+// automaton: a trie of the literals whose nodes have failure links to the node
+// of their longest proper suffix that is also in the trie, and output links to
+// the nearest node on that failure chain which ends a literal.
+//
+// Matching is ASCII case-insensitive.
+//
+// Usage:
+//   LiteralMatcher matcher;
+//   matcher.AddLiteral("ad", 0);
+//   matcher.AddLiteral("banner", 1);
+//   matcher.Build();
+//
+//   std::vector<bool> found(2);
+//   matcher.FindAll("https://example.com/Banner.png", &found);
+//   // |found| is now {false, true}.
+class LiteralMatcher {
+ public:
+  using LiteralId = uint32_t;
+
+  LiteralMatcher();
+  ~LiteralMatcher();
+
+  // Adds a non-empty |literal| to the set, to be reported as |id|. Several
+  // literals can share an |id|, and one literal can be added with several ids.
+  // Must not be called after Build().
+  void AddLiteral(base::StringPiece literal, LiteralId id);
+
+  // Computes the failure and output links. Must be called once all literals
+  // have been added, and before FindAll().
+  void Build();
+
+  // Sets (*found)[id] to true for the |id| of each literal that occurs in
+  // |text|. Leaves the other elements of |found| untouched. |found| must be
+  // large enough to be indexed by every id.
+  void FindAll(base::StringPiece text, std::vector<bool>* found) const;
+
+  // Returns the number of trie nodes, including the root.
+  size_t node_count() const { return nodes_.size(); }
+
+ private:
+  static constexpr uint32_t kNoNode = static_cast<uint32_t>(-1);
+
+  struct Edge {
+    uint8_t byte;
+    uint32_t target;
+  };
+
+  struct Node {
+    // The outgoing trie edges of this node are |edges_[edges_begin]| to
+    // |edges_[edges_begin + edges_count - 1]|, sorted by byte. Only valid after
+    // Build().
+    uint32_t edges_begin = 0;
+    uint32_t edges_count = 0;
+
+    uint32_t failure = 0;
+
+    // The nearest node on the failure chain, excluding this node, which ends
+    // one or more literals, or kNoNode.
+    uint32_t output = kNoNode;
+
+    // The ids of the literals ending at this node are |ids_[ids_begin]| to
+    // |ids_[ids_begin + ids_count - 1]|. Only valid after Build().
+    uint32_t ids_begin = 0;
+    uint32_t ids_count = 0;
+  };
+
+  // Returns the trie child of |node| for |byte|, or kNoNode.
+  uint32_t GetChild(uint32_t node, uint8_t byte) const;
+
+  // Returns the state the automaton moves to from |node| when reading |byte|.
+  uint32_t Next(uint32_t node, uint8_t byte) const;
+
+  std::vector<Node> nodes_;
+  std::vector<Edge> edges_;
+  std::vector<LiteralId> ids_;
+
+  // The transitions out of the root for each byte, which most of the bytes of
+  // a typical text take.
+  uint32_t root_next_[256];
+
+  // The trie edges and the ids of each node while literals are being added.
+  // Flattened into |edges_| and |ids_| by Build().
+  std::vector<std::vector<Edge>> building_edges_;
+  std::vector<std::vector<LiteralId>> building_ids_;
+
+  bool built_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(LiteralMatcher);
+};
+
+}  // namespace url_pattern_index
+
+#endif  // COMPONENTS_URL_PATTERN_INDEX_LITERAL_MATCHER_H_
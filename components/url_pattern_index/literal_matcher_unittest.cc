@@ -0,0 +1,140 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/url_pattern_index/literal_matcher.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace url_pattern_index {
+
+namespace {
+
+std::vector<bool> FindAll(const LiteralMatcher& matcher,
+                          size_t id_count,
+                          base::StringPiece text) {
+  std::vector<bool> found(id_count);
+  matcher.FindAll(text, &found);
+  return found;
+}
+
+}  // namespace
+
+TEST(LiteralMatcherTest, NoLiterals) {
+  LiteralMatcher matcher;
+  matcher.Build();
+  EXPECT_EQ(1u, matcher.node_count());
+
+  std::vector<bool> found;
+  matcher.FindAll("http://example.com", &found);
+  EXPECT_TRUE(found.empty());
+}
+
+TEST(LiteralMatcherTest, FindsLiterals) {
+  LiteralMatcher matcher;
+  matcher.AddLiteral("he", 0);
+  matcher.AddLiteral("she", 1);
+  matcher.AddLiteral("his", 2);
+  matcher.AddLiteral("hers", 3);
+  matcher.Build();
+
+  const struct {
+    const char* text;
+    std::vector<bool> expected_found;
+  } kTestCases[] = {
+      {"", {false, false, false, false}},
+      {"h", {false, false, false, false}},
+      {"he", {true, false, false, false}},
+      {"ushers", {true, true, false, true}},
+      {"ahishers", {true, true, true, true}},
+      {"hhis", {false, false, true, false}},
+      {"sh*e", {false, false, false, false}},
+  };
+
+  for (const auto& test_case : kTestCases) {
+    SCOPED_TRACE(::testing::Message() << "Text: " << test_case.text);
+    EXPECT_EQ(test_case.expected_found, FindAll(matcher, 4, test_case.text));
+  }
+}
+
+TEST(LiteralMatcherTest, IgnoresCase) {
+  LiteralMatcher matcher;
+  matcher.AddLiteral("AdServer", 0);
+  matcher.AddLiteral("/banner.", 1);
+  matcher.Build();
+
+  EXPECT_EQ(std::vector<bool>({true, true}),
+            FindAll(matcher, 2, "http://ADSERVER.com/Banner.gif"));
+  EXPECT_EQ(std::vector<bool>({true, false}),
+            FindAll(matcher, 2, "http://adserver.com/banner"));
+}
+
+TEST(LiteralMatcherTest, SharedIdsAndLiterals) {
+  LiteralMatcher matcher;
+  matcher.AddLiteral("ad", 0);
+  matcher.AddLiteral("track", 0);
+  matcher.AddLiteral("ad", 1);
+  matcher.AddLiteral("pixel", 2);
+  matcher.Build();
+
+  EXPECT_EQ(std::vector<bool>({true, true, false}),
+            FindAll(matcher, 3, "http://ad.com"));
+  EXPECT_EQ(std::vector<bool>({true, false, true}),
+            FindAll(matcher, 3, "http://track.com/pixel"));
+}
+
+TEST(LiteralMatcherTest, LeavesFoundIdsSet) {
+  LiteralMatcher matcher;
+  matcher.AddLiteral("ad", 0);
+  matcher.AddLiteral("pixel", 1);
+  matcher.Build();
+
+  std::vector<bool> found = {false, true, true};
+  matcher.FindAll("http://ad.com", &found);
+  EXPECT_EQ(std::vector<bool>({true, true, true}), found);
+}
+
+// Compares the matcher against a naive search for all literals over many
+// overlapping literals built from a small alphabet.
+TEST(LiteralMatcherTest, MatchesNaiveSearch) {
+  std::vector<std::string> literals;
+  for (int length = 1; length <= 4; ++length) {
+    for (int i = 0; i < 40; ++i) {
+      std::string literal;
+      for (int j = 0; j < length; ++j)
+        literal += "abAB/"[(i * 7 + j * 3 + length) % 5];
+      literals.push_back(literal);
+    }
+  }
+
+  LiteralMatcher matcher;
+  for (size_t i = 0; i < literals.size(); ++i)
+    matcher.AddLiteral(literals[i], i);
+  matcher.Build();
+
+  const std::string kTexts[] = {
+      "",
+      "a",
+      "abab/ABAB/aabb",
+      "/b/a/b/a",
+      "bbbbbbbbbbbbbb",
+      "http://ab.com/ba",
+  };
+  for (const std::string& text : kTexts) {
+    SCOPED_TRACE(::testing::Message() << "Text: " << text);
+    const std::string lower_text = base::ToLowerASCII(text);
+
+    std::vector<bool> expected_found(literals.size());
+    for (size_t i = 0; i < literals.size(); ++i) {
+      expected_found[i] = lower_text.find(base::ToLowerASCII(literals[i])) !=
+                          std::string::npos;
+    }
+    EXPECT_EQ(expected_found, FindAll(matcher, literals.size(), text));
+  }
+}
+
+}  // namespace url_pattern_index
@@ -8,6 +8,7 @@
 #include <limits>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/logging.h"
@@ -636,9 +637,11 @@ bool DoesRuleFlagsMatch(const flat::UrlRule& rule,
 
 // |sorted_candidates| is sorted in descending order by priority. This returns
 // the first matching rule i.e. the rule with the highest priority in
-// |sorted_candidates| or null if no rule matches.
+// |sorted_candidates| or null if no rule matches. If |candidate_mask| is not
+// null, only the rules it is true for are considered.
 const flat::UrlRule* FindMatchAmongCandidates(
     const FlatUrlRuleList* sorted_candidates,
+    const std::vector<bool>* candidate_mask,
     const UrlPattern::UrlInfo& url,
     const url::Origin& document_origin,
     flat::ElementType element_type,
@@ -650,8 +653,14 @@ const flat::UrlRule* FindMatchAmongCandidates(
 
   DCHECK(std::is_sorted(sorted_candidates->begin(), sorted_candidates->end(),
                         &UrlRuleDescendingPriorityComparator));
+  DCHECK(!candidate_mask ||
+         candidate_mask->size() == sorted_candidates->size());
 
-  for (const flat::UrlRule* rule : *sorted_candidates) {
+  for (flatbuffers::uoffset_t i = 0, size = sorted_candidates->size();
+       i != size; ++i) {
+    if (candidate_mask && !(*candidate_mask)[i])
+      continue;
+    const flat::UrlRule* rule = sorted_candidates->Get(i);
     DCHECK_NE(rule, nullptr);
     DCHECK_NE(rule->url_pattern_type(), flat::UrlPatternType_REGEXP);
     if (!DoesRuleFlagsMatch(*rule, element_type, activation_type,
@@ -672,9 +681,11 @@ const flat::UrlRule* FindMatchAmongCandidates(
 
 // Returns whether the network request matches a UrlPattern |index| represented
 // in its FlatBuffers format. |is_third_party| should reflect the relation
-// between |url| and |document_origin|.
+// between |url| and |document_origin|. If |fallback_rule_literals| is not null,
+// it is used to narrow down the fallback rules to verify.
 const flat::UrlRule* FindMatchInFlatUrlPatternIndex(
     const flat::UrlPatternIndex& index,
+    const FallbackRuleLiterals* fallback_rule_literals,
     const UrlPattern::UrlInfo& url,
     const url::Origin& document_origin,
     flat::ElementType element_type,
@@ -720,8 +731,9 @@ const flat::UrlRule* FindMatchInFlatUrlPatternIndex(
     if (entry == empty_slot)
       continue;
     const flat::UrlRule* rule = FindMatchAmongCandidates(
-        entry->rule_list(), url, document_origin, element_type, activation_type,
-        is_third_party, disable_generic_rules);
+        entry->rule_list(), nullptr /* candidate_mask */, url,
+        document_origin, element_type, activation_type, is_third_party,
+        disable_generic_rules);
     if (!rule)
       continue;
 
@@ -736,9 +748,16 @@ const flat::UrlRule* FindMatchInFlatUrlPatternIndex(
     }
   }
 
+  // Find the fallback rules whose literal occurs in the URL with a single scan
+  // of the URL, and only verify those.
+  std::vector<bool> fallback_candidates;
+  if (fallback_rule_literals)
+    fallback_candidates = fallback_rule_literals->FindCandidates(url.spec());
   const flat::UrlRule* rule = FindMatchAmongCandidates(
-      index.fallback_rules(), url, document_origin, element_type,
-      activation_type, is_third_party, disable_generic_rules);
+      index.fallback_rules(),
+      fallback_rule_literals ? &fallback_candidates : nullptr, url,
+      document_origin, element_type, activation_type, is_third_party,
+      disable_generic_rules);
 
   switch (strategy) {
     case FindRuleStrategy::kAny:
@@ -751,12 +770,79 @@ const flat::UrlRule* FindMatchInFlatUrlPatternIndex(
   return nullptr;
 }
 
+// Returns the longest substring of |pattern| without wildcards or separator
+// placeholders. Every URL that |pattern| matches contains it, ignoring case.
+base::StringPiece GetLongestLiteral(base::StringPiece pattern) {
+  base::StringPiece longest;
+  size_t begin = 0;
+  while (begin < pattern.size()) {
+    size_t end = pattern.find_first_of("*^", begin);
+    if (end == base::StringPiece::npos)
+      end = pattern.size();
+    if (end - begin > longest.size())
+      longest = pattern.substr(begin, end - begin);
+    begin = end + 1;
+  }
+  return longest;
+}
+
+// Fallback lists shorter than this are cheap enough to verify rule by rule.
+constexpr flatbuffers::uoffset_t kMinFallbackRulesForLiteralMatcher = 32;
+
 }  // namespace
 
+// static
+std::unique_ptr<FallbackRuleLiterals> FallbackRuleLiterals::Create(
+    const flat::UrlPatternIndex* flat_index) {
+  const FlatUrlRuleList* fallback_rules =
+      flat_index ? flat_index->fallback_rules() : nullptr;
+  if (!fallback_rules ||
+      fallback_rules->size() < kMinFallbackRulesForLiteralMatcher) {
+    return nullptr;
+  }
+
+  // Private constructor.
+  std::unique_ptr<FallbackRuleLiterals> literals(new FallbackRuleLiterals);
+  literals->rules_without_literal_.resize(fallback_rules->size());
+  for (flatbuffers::uoffset_t i = 0, size = fallback_rules->size(); i != size;
+       ++i) {
+    const flatbuffers::String* url_pattern =
+        fallback_rules->Get(i)->url_pattern();
+    const base::StringPiece literal =
+        url_pattern ? GetLongestLiteral(ToStringPiece(url_pattern))
+                    : base::StringPiece();
+    if (literal.empty())
+      literals->rules_without_literal_[i] = true;
+    else
+      literals->literal_matcher_.AddLiteral(literal, i);
+  }
+  literals->literal_matcher_.Build();
+  return literals;
+}
+
+FallbackRuleLiterals::FallbackRuleLiterals() = default;
+FallbackRuleLiterals::~FallbackRuleLiterals() = default;
+
+std::vector<bool> FallbackRuleLiterals::FindCandidates(
+    base::StringPiece url_spec) const {
+  std::vector<bool> candidates = rules_without_literal_;
+  literal_matcher_.FindAll(url_spec, &candidates);
+  return candidates;
+}
+
 UrlPatternIndexMatcher::UrlPatternIndexMatcher(
     const flat::UrlPatternIndex* flat_index)
-    : flat_index_(flat_index) {
+    : UrlPatternIndexMatcher(flat_index, nullptr) {
+  owned_fallback_rule_literals_ = FallbackRuleLiterals::Create(flat_index);
+  fallback_rule_literals_ = owned_fallback_rule_literals_.get();
+}
+
+UrlPatternIndexMatcher::UrlPatternIndexMatcher(
+    const flat::UrlPatternIndex* flat_index,
+    const FallbackRuleLiterals* fallback_rule_literals)
+    : flat_index_(flat_index), fallback_rule_literals_(fallback_rule_literals) {
   DCHECK(!flat_index || flat_index->n() == kNGramSize);
+  DCHECK(flat_index || !fallback_rule_literals);
 }
 
 UrlPatternIndexMatcher::~UrlPatternIndexMatcher() = default;
@@ -796,8 +882,9 @@ const flat::UrlRule* UrlPatternIndexMatcher::FindMatch(
   }
 
   auto* rule = FindMatchInFlatUrlPatternIndex(
-      *flat_index_, UrlPattern::UrlInfo(url), first_party_origin, element_type,
-      activation_type, is_third_party, disable_generic_rules, strategy);
+      *flat_index_, fallback_rule_literals_, UrlPattern::UrlInfo(url),
+      first_party_origin, element_type, activation_type, is_third_party,
+      disable_generic_rules, strategy);
   if (rule) {
     TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("loading"),
                  "UrlPatternIndexMatcher::FindMatch", "pattern",
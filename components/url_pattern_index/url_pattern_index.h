@@ -9,12 +9,14 @@
 #include <stdint.h>
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "base/macros.h"
 #include "base/strings/string_piece_forward.h"
 #include "components/url_pattern_index/closed_hash_map.h"
 #include "components/url_pattern_index/flat/url_pattern_index_generated.h"
+#include "components/url_pattern_index/literal_matcher.h"
 #include "components/url_pattern_index/proto/rules.pb.h"
 #include "components/url_pattern_index/uint64_hasher.h"
 #include "third_party/flatbuffers/src/include/flatbuffers/flatbuffers.h"
@@ -128,6 +130,40 @@ class UrlPatternIndexBuilder {
   DISALLOW_COPY_AND_ASSIGN(UrlPatternIndexBuilder);
 };
 
+// The longest literals of the fallback rules of a flat::UrlPatternIndex, i.e.
+// the rules with no acceptable N-gram, which are verified against every
+// request. They let UrlPatternIndexMatcher find the few fallback rules that can
+// match a URL with a single scan of the URL.
+//
+// Building an instance takes time linear in the total length of the literals,
+// so it should be built once per index, and shared by all the matchers over
+// that index.
+class FallbackRuleLiterals {
+ public:
+  // Returns nullptr if |flat_index| is nullptr, or has too few fallback rules
+  // for this to pay off.
+  static std::unique_ptr<FallbackRuleLiterals> Create(
+      const flat::UrlPatternIndex* flat_index);
+
+  ~FallbackRuleLiterals();
+
+  // Returns a mask over the fallback rules of the index this was created from,
+  // which is true for the rules whose literal occurs in |url_spec|, and for
+  // the rules with no literal at all.
+  std::vector<bool> FindCandidates(base::StringPiece url_spec) const;
+
+ private:
+  FallbackRuleLiterals();
+
+  LiteralMatcher literal_matcher_;
+
+  // Whether each fallback rule has no literal at all, and so always needs to be
+  // verified.
+  std::vector<bool> rules_without_literal_;
+
+  DISALLOW_COPY_AND_ASSIGN(FallbackRuleLiterals);
+};
+
 // Encapsulates a read-only index built over the URL patterns of a set of URL
 // rules, and provides fast matching of network requests against these rules.
 class UrlPatternIndexMatcher {
@@ -143,7 +179,17 @@ class UrlPatternIndexMatcher {
 
   // Creates an instance to access the given |flat_index|. If |flat_index| is
   // nullptr, then all requests return no match.
+  //
+  // This builds the FallbackRuleLiterals of |flat_index|. Owners of indices
+  // that are matched by several short-lived matchers should build those once
+  // and use the constructor below instead.
   explicit UrlPatternIndexMatcher(const flat::UrlPatternIndex* flat_index);
+
+  // Like above, but uses |fallback_rule_literals|, which must have been created
+  // from |flat_index| and must outlive this instance. If it is nullptr, every
+  // fallback rule is verified against every request.
+  UrlPatternIndexMatcher(const flat::UrlPatternIndex* flat_index,
+                         const FallbackRuleLiterals* fallback_rule_literals);
   ~UrlPatternIndexMatcher();
 
   // If the index contains one or more UrlRules that match the request, returns
@@ -191,6 +237,12 @@ class UrlPatternIndexMatcher {
   // Must outlive this instance.
   const flat::UrlPatternIndex* flat_index_;
 
+  // Set if this instance built its own |fallback_rule_literals_|.
+  std::unique_ptr<FallbackRuleLiterals> owned_fallback_rule_literals_;
+
+  // May be nullptr. Must outlive this instance.
+  const FallbackRuleLiterals* fallback_rule_literals_;
+
   DISALLOW_COPY_AND_ASSIGN(UrlPatternIndexMatcher);
 };
 
@@ -61,6 +61,23 @@ class UrlPatternIndexTest : public ::testing::Test {
     index_matcher_.reset(new UrlPatternIndexMatcher(flat_index));
   }
 
+  // Like Finish(), but builds the FallbackRuleLiterals of the index separately
+  // and gives them to the matcher, as owners of shared indices do.
+  void FinishWithSharedFallbackRuleLiterals() {
+    const auto index_offset = index_builder_->Finish();
+    flat_builder_->Finish(index_offset);
+
+    const flat::UrlPatternIndex* flat_index =
+        flat::GetUrlPatternIndex(flat_builder_->GetBufferPointer());
+    fallback_rule_literals_ = FallbackRuleLiterals::Create(flat_index);
+    index_matcher_.reset(
+        new UrlPatternIndexMatcher(flat_index, fallback_rule_literals_.get()));
+  }
+
+  const FallbackRuleLiterals* fallback_rule_literals() const {
+    return fallback_rule_literals_.get();
+  }
+
   const flat::UrlRule* FindMatch(
       base::StringPiece url_string,
       base::StringPiece document_origin_string = base::StringPiece(),
@@ -95,6 +112,7 @@ class UrlPatternIndexTest : public ::testing::Test {
 
   void Reset() {
     index_matcher_.reset();
+    fallback_rule_literals_.reset();
     index_builder_.reset();
     flat_builder_.reset(new flatbuffers::FlatBufferBuilder());
     index_builder_.reset(new UrlPatternIndexBuilder(flat_builder_.get()));
@@ -104,6 +122,7 @@ class UrlPatternIndexTest : public ::testing::Test {
  private:
   std::unique_ptr<flatbuffers::FlatBufferBuilder> flat_builder_;
   std::unique_ptr<UrlPatternIndexBuilder> index_builder_;
+  std::unique_ptr<FallbackRuleLiterals> fallback_rule_literals_;
   std::unique_ptr<UrlPatternIndexMatcher> index_matcher_;
 
   FlatDomainMap domain_map_;
@@ -810,6 +829,67 @@ TEST_F(UrlPatternIndexTest, FindMatchHighestPriority) {
       FindHighestPriorityMatch(pattern_for_number(kNumPatternTypes + 1)));
 }
 
+// Tests that FindMatch works when there are enough rules without an N-gram
+// for their literals to be matched all at once.
+TEST_F(UrlPatternIndexTest, ManyFallbackRules) {
+  constexpr size_t kNumOfRules = 256;
+
+  // Each pattern has fragments too short to be indexed by N-gram.
+  for (size_t i = 0; i < kNumOfRules; ++i) {
+    ASSERT_TRUE(AddUrlRule(
+        MakeUrlRule(UrlPattern("ad*/" + std::to_string(i) + "^"))))
+        << "Rule #" << i;
+  }
+  // A rule with no literal at all.
+  auto font_rule = MakeUrlRule(UrlPattern("", kSubstring));
+  font_rule.set_element_types(kFont);
+  ASSERT_TRUE(AddUrlRule(font_rule));
+  // Rules whose literal is matched case-insensitively.
+  ASSERT_TRUE(AddUrlRule(MakeUrlRule(UrlPattern("pop*Up"))));
+  ASSERT_TRUE(AddUrlRule(MakeUrlRule(UrlPattern("x^q=1"))));
+  Finish();
+
+  for (size_t i = 0; i < kNumOfRules; i += 17) {
+    const std::string number = std::to_string(i);
+    SCOPED_TRACE(::testing::Message() << "Rule #" << number);
+    EXPECT_TRUE(FindMatch("http://ads.com/" + number + "/x.png"));
+    EXPECT_TRUE(FindMatch("http://ads.com/" + number));
+    EXPECT_FALSE(FindMatch("http://example.com/" + number + "/x.png"));
+    EXPECT_FALSE(FindMatch("http://ads.com/" + number + "0" + number));
+  }
+  EXPECT_FALSE(FindMatch("http://ads.com/" + std::to_string(kNumOfRules)));
+
+  EXPECT_TRUE(FindMatch("http://example.com/f.woff", nullptr, kFont));
+  EXPECT_FALSE(FindMatch("http://example.com/f.woff", nullptr, kOther));
+  EXPECT_TRUE(FindMatch("http://example.com/POP/up"));
+  EXPECT_TRUE(FindMatch("http://example.com/X?Q=1"));
+  EXPECT_FALSE(FindMatch("http://example.com/pop"));
+  EXPECT_FALSE(FindMatch("http://example.com/xq=1"));
+}
+
+// Tests that a matcher gives the same results with FallbackRuleLiterals built
+// outside of it, and without any when there are too few fallback rules.
+TEST_F(UrlPatternIndexTest, SharedFallbackRuleLiterals) {
+  for (size_t i = 0; i < 64; ++i) {
+    ASSERT_TRUE(AddUrlRule(
+        MakeUrlRule(UrlPattern("ad*/" + std::to_string(i) + "^"))))
+        << "Rule #" << i;
+  }
+  FinishWithSharedFallbackRuleLiterals();
+  EXPECT_TRUE(fallback_rule_literals());
+  EXPECT_TRUE(FindMatch("http://ads.com/7/x.png"));
+  EXPECT_TRUE(FindMatch("http://ads.com/63"));
+  EXPECT_FALSE(FindMatch("http://example.com/7/x.png"));
+  EXPECT_FALSE(FindMatch("http://ads.com/64"));
+
+  Reset();
+  ASSERT_TRUE(AddUrlRule(MakeUrlRule(UrlPattern("ad*/7^"))));
+  FinishWithSharedFallbackRuleLiterals();
+  EXPECT_FALSE(fallback_rule_literals());
+  EXPECT_TRUE(FindMatch("http://ads.com/7/x.png"));
+  EXPECT_FALSE(FindMatch("http://example.com/7/x.png"));
+}
+
 TEST_F(UrlPatternIndexTest, LongUrl_NoMatch) {
   std::string pattern = "http://example.com";
   ASSERT_TRUE(AddUrlRule(MakeUrlRule(UrlPattern(pattern, kSubstring))));
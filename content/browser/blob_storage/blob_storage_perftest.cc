@@ -0,0 +1,223 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/macros.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/post_task.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/time/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "storage/browser/blob/blob_data_builder.h"
+#include "storage/browser/blob/blob_data_handle.h"
+#include "storage/browser/blob/blob_memory_controller.h"
+#include "storage/browser/blob/blob_reader.h"
+#include "storage/browser/blob/blob_storage_context.h"
+#include "storage/browser/blob/upload_blob_element_reader.h"
+#include "storage/common/blob_storage/blob_storage_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace content {
+namespace {
+
+using storage::BlobDataBuilder;
+using storage::BlobDataHandle;
+using storage::BlobStatus;
+
+const size_t kMegabyte = 1024 * 1024;
+const int kNumBlobs = 4;
+const size_t kReadBufferSize = kMegabyte;
+
+class BlobStoragePerfTest : public testing::Test {
+ protected:
+  BlobStoragePerfTest() = default;
+
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  // Creates a context that keeps at most |max_memory_size| bytes of blob data
+  // in memory. A |max_memory_size| of zero disables paging to disk.
+  void CreateContext(size_t max_memory_size,
+                     size_t max_concurrent_page_file_writes) {
+    storage::BlobStorageLimits limits;
+    if (max_memory_size == 0) {
+      context_ = std::make_unique<storage::BlobStorageContext>();
+      limits.max_blob_in_memory_space = kNumBlobs * 100 * kMegabyte;
+    } else {
+      context_ = std::make_unique<storage::BlobStorageContext>(
+          temp_dir_.GetPath(),
+          base::CreateTaskRunnerWithTraits({base::MayBlock()}));
+      limits.max_blob_in_memory_space = max_memory_size;
+      limits.desired_max_disk_space = kNumBlobs * 100 * kMegabyte;
+      limits.effective_max_disk_space = limits.desired_max_disk_space;
+      limits.max_concurrent_page_file_writes = max_concurrent_page_file_writes;
+    }
+    context_->set_limits_for_testing(limits);
+    source_.assign(limits.max_bytes_data_item_size, 'b');
+  }
+
+  // Builds a blob of |size| bytes the way the transport strategies do: the
+  // bytes items are appended as future data and populated once the memory
+  // controller grants quota for them.
+  std::unique_ptr<BlobDataHandle> BuildBlob(const std::string& uuid,
+                                            size_t size) {
+    auto builder = std::make_unique<BlobDataBuilder>(uuid);
+    std::vector<BlobDataBuilder::FutureData> future_data;
+    std::vector<size_t> item_sizes;
+    for (size_t offset = 0; offset < size; offset += source_.size()) {
+      item_sizes.push_back(std::min(size - offset, source_.size()));
+      future_data.push_back(builder->AppendFutureData(item_sizes.back()));
+    }
+
+    base::RunLoop run_loop;
+    BlobStatus status = BlobStatus::PENDING_QUOTA;
+    std::unique_ptr<BlobDataHandle> handle = context_->BuildBlob(
+        std::move(builder),
+        base::BindOnce(
+            [](base::OnceClosure quit_closure, BlobStatus* status_out,
+               BlobStatus status,
+               std::vector<storage::BlobMemoryController::FileCreationInfo>) {
+              *status_out = status;
+              std::move(quit_closure).Run();
+            },
+            run_loop.QuitClosure(), &status));
+    if (status == BlobStatus::PENDING_QUOTA)
+      run_loop.Run();
+    EXPECT_EQ(BlobStatus::PENDING_TRANSPORT, status);
+
+    for (size_t i = 0; i < future_data.size(); ++i) {
+      base::span<char> target =
+          future_data[i].GetDataToPopulate(0, item_sizes[i]);
+      std::memcpy(target.data(), source_.data(), target.size());
+    }
+    context_->NotifyTransportComplete(uuid);
+    EXPECT_EQ(BlobStatus::DONE, handle->GetBlobStatus());
+    return handle;
+  }
+
+  // Reads |handle| back through a BlobReader and returns the number of bytes
+  // read.
+  uint64_t ReadBlob(const BlobDataHandle& handle) {
+    std::unique_ptr<storage::BlobReader> reader = handle.CreateReader();
+    net::TestCompletionCallback size_callback;
+    if (reader->CalculateSize(size_callback.callback()) ==
+        storage::BlobReader::Status::IO_PENDING) {
+      EXPECT_EQ(net::OK, size_callback.WaitForResult());
+    }
+
+    auto buffer = base::MakeRefCounted<net::IOBufferWithSize>(kReadBufferSize);
+    uint64_t total_bytes_read = 0;
+    while (true) {
+      int bytes_read = 0;
+      net::TestCompletionCallback read_callback;
+      storage::BlobReader::Status status = reader->Read(
+          buffer.get(), kReadBufferSize, &bytes_read, read_callback.callback());
+      if (status == storage::BlobReader::Status::IO_PENDING)
+        bytes_read = read_callback.WaitForResult();
+      else
+        EXPECT_EQ(storage::BlobReader::Status::DONE, status);
+      EXPECT_GE(bytes_read, 0);
+      if (bytes_read <= 0)
+        break;
+      total_bytes_read += bytes_read;
+    }
+    return total_bytes_read;
+  }
+
+  // Reads |handle| as a request body and returns the number of bytes read.
+  uint64_t UploadBlob(const BlobDataHandle& handle) {
+    storage::UploadBlobElementReader reader(
+        std::make_unique<BlobDataHandle>(handle));
+    net::TestCompletionCallback init_callback;
+    EXPECT_EQ(net::OK,
+              init_callback.GetResult(reader.Init(init_callback.callback())));
+
+    auto buffer = base::MakeRefCounted<net::IOBufferWithSize>(kReadBufferSize);
+    uint64_t total_bytes_read = 0;
+    while (reader.BytesRemaining() > 0) {
+      net::TestCompletionCallback read_callback;
+      int result = read_callback.GetResult(reader.Read(
+          buffer.get(), kReadBufferSize, read_callback.callback()));
+      EXPECT_GT(result, 0);
+      if (result <= 0)
+        break;
+      total_bytes_read += result;
+    }
+    return total_bytes_read;
+  }
+
+  void RunBuildReadUpload(const std::string& trace, size_t blob_size) {
+    std::vector<std::unique_ptr<BlobDataHandle>> handles;
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kNumBlobs; ++i)
+      handles.push_back(BuildBlob(base::StringPrintf("blob-%d", i), blob_size));
+    base::TimeDelta build_time = base::TimeTicks::Now() - start;
+
+    start = base::TimeTicks::Now();
+    for (const auto& handle : handles)
+      EXPECT_EQ(blob_size, ReadBlob(*handle));
+    base::TimeDelta read_time = base::TimeTicks::Now() - start;
+
+    start = base::TimeTicks::Now();
+    for (const auto& handle : handles)
+      EXPECT_EQ(blob_size, UploadBlob(*handle));
+    base::TimeDelta upload_time = base::TimeTicks::Now() - start;
+
+    double total_megabytes =
+        static_cast<double>(kNumBlobs) * blob_size / kMegabyte;
+    perf_test::PrintResult("blob_build", "", trace,
+                           total_megabytes / build_time.InSecondsF(), "MB/s",
+                           true);
+    perf_test::PrintResult("blob_read_back", "", trace,
+                           total_megabytes / read_time.InSecondsF(), "MB/s",
+                           true);
+    perf_test::PrintResult("blob_upload", "", trace,
+                           total_megabytes / upload_time.InSecondsF(), "MB/s",
+                           true);
+
+    handles.clear();
+    scoped_task_environment_.RunUntilIdle();
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<storage::BlobStorageContext> context_;
+  std::string source_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(BlobStoragePerfTest);
+};
+
+TEST_F(BlobStoragePerfTest, InMemory) {
+  for (size_t blob_size : {10 * kMegabyte, 100 * kMegabyte}) {
+    CreateContext(0, 1);
+    RunBuildReadUpload(
+        base::StringPrintf("in_memory_%zuMB", blob_size / kMegabyte),
+        blob_size);
+  }
+}
+
+// Builds more data than fits in memory, so later blobs wait for earlier ones
+// to be paged to disk.
+TEST_F(BlobStoragePerfTest, PagedToDisk) {
+  for (size_t max_concurrent_page_file_writes : {1u, 4u}) {
+    CreateContext(200 * kMegabyte, max_concurrent_page_file_writes);
+    RunBuildReadUpload(base::StringPrintf("paged_100MB_%zu_concurrent_writes",
+                                          max_concurrent_page_file_writes),
+                       100 * kMegabyte);
+  }
+}
+
+}  // namespace
+}  // namespace content
@@ -30,6 +30,7 @@
 #include "content/browser/indexed_db/indexed_db_context_impl.h"
 #include "content/browser/indexed_db/indexed_db_data_format_version.h"
 #include "content/browser/indexed_db/indexed_db_database_error.h"
+#include "content/browser/indexed_db/indexed_db_group_commit_queue.h"
 #include "content/browser/indexed_db/indexed_db_leveldb_coding.h"
 #include "content/browser/indexed_db/indexed_db_leveldb_operations.h"
 #include "content/browser/indexed_db/indexed_db_metadata_coding.h"
@@ -40,6 +41,7 @@
 #include "content/browser/indexed_db/leveldb/leveldb_database.h"
 #include "content/browser/indexed_db/leveldb/leveldb_iterator.h"
 #include "content/browser/indexed_db/leveldb/leveldb_transaction.h"
+#include "content/browser/indexed_db/leveldb/leveldb_write_batch.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/common/content_features.h"
@@ -527,6 +529,10 @@ IndexedDBBackingStore::IndexedDBBackingStore(
       active_blob_registry_(this),
       committing_transaction_count_(0) {
   DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  if (db_ && base::FeatureList::IsEnabled(features::kIndexedDBGroupCommit)) {
+    group_commit_queue_ =
+        std::make_unique<IndexedDBGroupCommitQueue>(db_.get(), task_runner_);
+  }
 }
 
 IndexedDBBackingStore::~IndexedDBBackingStore() {
@@ -2810,6 +2816,11 @@ void IndexedDBBackingStore::ForceRunBlobCleanup() {
   journal_cleaning_timer_.FireNow();
 }
 
+void IndexedDBBackingStore::FlushGroupCommit() {
+  if (group_commit_queue_)
+    group_commit_queue_->Flush();
+}
+
 IndexedDBBackingStore::Transaction::Transaction(
     IndexedDBBackingStore* backing_store)
     : backing_store_(backing_store),
@@ -3081,6 +3092,37 @@ Status IndexedDBBackingStore::Transaction::CommitPhaseTwo() {
   return s;
 }
 
+bool IndexedDBBackingStore::Transaction::CanGroupCommit() const {
+  return backing_store_->group_commit_queue_ && blob_change_map_.empty() &&
+         transaction_ && transaction_->HasPendingWrites();
+}
+
+void IndexedDBBackingStore::Transaction::CommitPhaseTwoGrouped(
+    base::OnceCallback<void(leveldb::Status)> callback) {
+  IDB_TRACE("IndexedDBBackingStore::Transaction::CommitPhaseTwoGrouped");
+  DCHECK(CanGroupCommit());
+  DCHECK(committing_);
+  committing_ = false;
+
+  backing_store_->DidCommitTransaction();
+
+  // Without blob changes there are no journal updates or blob files to clean
+  // up after the write, so all that is left is the write itself.
+  std::unique_ptr<LevelDBWriteBatch> write_batch = LevelDBWriteBatch::Create();
+  transaction_->CommitToWriteBatch(write_batch.get());
+  transaction_ = nullptr;
+
+  backing_store_->group_commit_queue_->Enqueue(
+      std::move(write_batch),
+      base::BindOnce(
+          [](base::OnceCallback<void(leveldb::Status)> callback,
+             leveldb::Status s) {
+            if (!s.ok())
+              INTERNAL_WRITE_ERROR(TRANSACTION_COMMIT_METHOD);
+            std::move(callback).Run(s);
+          },
+          std::move(callback)));
+}
 
 class IndexedDBBackingStore::Transaction::BlobWriteCallbackWrapper
     : public IndexedDBBackingStore::BlobWriteCallback {
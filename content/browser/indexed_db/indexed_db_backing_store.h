@@ -15,6 +15,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
@@ -54,6 +55,7 @@ class FileWriterDelegate;
 namespace content {
 
 class IndexedDBFactory;
+class IndexedDBGroupCommitQueue;
 class LevelDBComparator;
 class LevelDBDatabase;
 struct IndexedDBValue;
@@ -157,6 +159,21 @@ class CONTENT_EXPORT IndexedDBBackingStore
     // by the transaction and not referenced by running scripts.
     virtual leveldb::Status CommitPhaseTwo();
 
+    // Returns true if this transaction can finish its commit through
+    // CommitPhaseTwoGrouped(). This requires group commit to be enabled on the
+    // backing store and the transaction to have no blob changes, since blob
+    // journal updates must stay ordered with the blob file writes. Read-only
+    // and empty transactions have nothing to write, so they take the direct
+    // path rather than waiting for a group.
+    bool CanGroupCommit() const;
+
+    // Alternative to CommitPhaseTwo() for transactions where CanGroupCommit()
+    // is true. Hands the transaction's writes to the backing store's group
+    // commit queue; |callback| is run with the write status once the group
+    // containing them has been written.
+    void CommitPhaseTwoGrouped(
+        base::OnceCallback<void(leveldb::Status)> callback);
+
     virtual void Rollback();
     void Reset() {
       backing_store_ = NULL;
@@ -559,6 +576,10 @@ class CONTENT_EXPORT IndexedDBBackingStore
   // Stops the journal_cleaning_timer_ and runs its pending task.
   void ForceRunBlobCleanup();
 
+  // Writes any transactions waiting in the group commit queue and runs their
+  // completion callbacks. Does nothing if group commit is disabled.
+  void FlushGroupCommit();
+
   // HasV2SchemaCorruption() returns whether the backing store is v2 and
   // has blob references.
   V2SchemaCorruptionStatus HasV2SchemaCorruption();
@@ -655,6 +676,9 @@ class CONTENT_EXPORT IndexedDBBackingStore
 #endif
 
   std::unique_ptr<LevelDBDatabase> db_;
+  // Only created when features::kIndexedDBGroupCommit is enabled. Declared
+  // after |db_| so that pending groups are written before |db_| is closed.
+  std::unique_ptr<IndexedDBGroupCommitQueue> group_commit_queue_;
   // Whenever blobs are registered in active_blob_registry_,
   // indexed_db_factory_ will hold a reference to this backing store.
   IndexedDBActiveBlobRegistry active_blob_registry_;
@@ -4,8 +4,11 @@
 
 #include "content/browser/indexed_db/indexed_db_fake_backing_store.h"
 
+#include <utility>
+
 #include "base/files/file_path.h"
 #include "base/threading/sequenced_task_runner_handle.h"
+#include "content/browser/indexed_db/leveldb/leveldb_database.h"
 
 namespace content {
 namespace {
@@ -29,6 +32,13 @@ IndexedDBFakeBackingStore::IndexedDBFakeBackingStore(
                             base::FilePath(),
                             std::unique_ptr<LevelDBDatabase>(),
                             task_runner) {}
+IndexedDBFakeBackingStore::IndexedDBFakeBackingStore(
+    std::unique_ptr<LevelDBDatabase> db)
+    : IndexedDBBackingStore(nullptr /* indexed_db_factory */,
+                            url::Origin::Create(GURL("http://localhost:81")),
+                            base::FilePath(),
+                            std::move(db),
+                            base::SequencedTaskRunnerHandle::Get().get()) {}
 IndexedDBFakeBackingStore::~IndexedDBFakeBackingStore() {}
 
 leveldb::Status IndexedDBFakeBackingStore::DeleteDatabase(
@@ -31,6 +31,9 @@ class IndexedDBFakeBackingStore : public IndexedDBBackingStore {
   IndexedDBFakeBackingStore();
   IndexedDBFakeBackingStore(IndexedDBFactory* factory,
                             base::SequencedTaskRunner* task_runner);
+  // Backs the store with |db|, so that IndexedDBBackingStore::Transaction
+  // can commit to it.
+  explicit IndexedDBFakeBackingStore(std::unique_ptr<LevelDBDatabase> db);
   leveldb::Status DeleteDatabase(const base::string16& name) override;
 
   leveldb::Status PutRecord(IndexedDBBackingStore::Transaction* transaction,
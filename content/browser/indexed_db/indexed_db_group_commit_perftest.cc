@@ -0,0 +1,87 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/indexed_db/indexed_db_group_commit_queue.h"
+
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/time/time.h"
+#include "content/browser/indexed_db/leveldb/leveldb_comparator.h"
+#include "content/browser/indexed_db/leveldb/leveldb_database.h"
+#include "content/browser/indexed_db/leveldb/leveldb_env.h"
+#include "content/browser/indexed_db/leveldb/leveldb_write_batch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/leveldatabase/src/include/leveldb/comparator.h"
+
+namespace content {
+namespace {
+
+const size_t kMaxOpenIterators = 3;
+const int kTransactions = 2000;
+const int kPutsPerTransaction = 4;
+const size_t kValueSize = 128;
+
+// Measures the throughput of small readwrite transaction commits, where
+// |group_size| transactions become ready to commit at the same time. A group
+// size of 1 matches committing every transaction with its own synced write.
+void RunCommitThroughput(int group_size) {
+  base::test::ScopedTaskEnvironment task_environment;
+  base::ScopedTempDir temp_directory;
+  ASSERT_TRUE(temp_directory.CreateUniqueTempDir());
+
+  scoped_refptr<LevelDBState> ldb_state;
+  leveldb::Status status;
+  std::tie(ldb_state, status, std::ignore) =
+      indexed_db::GetDefaultLevelDBFactory()->OpenLevelDB(
+          temp_directory.GetPath(), LevelDBComparator::BytewiseComparator(),
+          leveldb::BytewiseComparator());
+  ASSERT_TRUE(status.ok());
+  LevelDBDatabase db(std::move(ldb_state), nullptr, kMaxOpenIterators);
+  IndexedDBGroupCommitQueue queue(&db, base::SequencedTaskRunnerHandle::Get());
+
+  const std::string value(kValueSize, 'v');
+  int committed = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int txn = 0; txn < kTransactions;) {
+    for (int i = 0; i < group_size && txn < kTransactions; ++i, ++txn) {
+      std::unique_ptr<LevelDBWriteBatch> batch = LevelDBWriteBatch::Create();
+      for (int put = 0; put < kPutsPerTransaction; ++put)
+        batch->Put(base::StringPrintf("key-%08d-%d", txn, put), value);
+      queue.Enqueue(std::move(batch),
+                    base::BindOnce(
+                        [](int* committed, leveldb::Status s) {
+                          EXPECT_TRUE(s.ok());
+                          ++*committed;
+                        },
+                        &committed));
+    }
+    base::RunLoop().RunUntilIdle();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  EXPECT_EQ(kTransactions, committed);
+
+  std::string trace = base::StringPrintf("group_size_%d", group_size);
+  perf_test::PrintResult("idb_small_transaction_commit", "", trace,
+                         kTransactions / elapsed.InSecondsF(), "commits/s",
+                         true);
+  perf_test::PrintResult("idb_small_transaction_commit_syncs", "", trace,
+                         queue.num_groups_written(), "syncs", true);
+}
+
+TEST(IndexedDBGroupCommitPerfTest, SmallTransactionCommitThroughput) {
+  for (int group_size : {1, 4, 16, 64})
+    RunCommitThroughput(group_size);
+}
+
+}  // namespace
+}  // namespace content
@@ -0,0 +1,77 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/indexed_db/indexed_db_group_commit_queue.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/sequenced_task_runner.h"
+#include "content/browser/indexed_db/indexed_db_tracing.h"
+#include "content/browser/indexed_db/leveldb/leveldb_database.h"
+#include "content/browser/indexed_db/leveldb/leveldb_write_batch.h"
+
+namespace content {
+
+IndexedDBGroupCommitQueue::IndexedDBGroupCommitQueue(
+    LevelDBDatabase* db,
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : db_(db), task_runner_(std::move(task_runner)), weak_factory_(this) {
+  DCHECK(db_);
+}
+
+IndexedDBGroupCommitQueue::~IndexedDBGroupCommitQueue() {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  Flush();
+}
+
+void IndexedDBGroupCommitQueue::Enqueue(
+    std::unique_ptr<LevelDBWriteBatch> write_batch,
+    CommitCallback callback) {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  DCHECK(write_batch);
+  if (!pending_batch_)
+    pending_batch_ = std::move(write_batch);
+  else
+    pending_batch_->Append(*write_batch);
+  pending_callbacks_.push_back(std::move(callback));
+
+  if (flush_scheduled_)
+    return;
+  flush_scheduled_ = true;
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&IndexedDBGroupCommitQueue::OnFlushTask,
+                                        weak_factory_.GetWeakPtr()));
+}
+
+void IndexedDBGroupCommitQueue::Flush() {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  if (pending_callbacks_.empty())
+    return;
+  IDB_TRACE1("IndexedDBGroupCommitQueue::Flush", "transactions",
+             pending_callbacks_.size());
+
+  // Callbacks can enqueue further commits, or even destroy this object, so
+  // detach the group from |this| before writing it.
+  std::unique_ptr<LevelDBWriteBatch> batch = std::move(pending_batch_);
+  std::vector<CommitCallback> callbacks = std::move(pending_callbacks_);
+  pending_callbacks_.clear();
+
+  LOCAL_HISTOGRAM_COUNTS_100("Storage.IndexedDB.GroupCommit.Transactions",
+                             callbacks.size());
+  leveldb::Status s = db_->Write(*batch);
+  ++num_groups_written_;
+
+  for (auto& callback : callbacks)
+    std::move(callback).Run(s);
+}
+
+void IndexedDBGroupCommitQueue::OnFlushTask() {
+  flush_scheduled_ = false;
+  Flush();
+}
+
+}  // namespace content
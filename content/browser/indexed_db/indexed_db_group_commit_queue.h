@@ -0,0 +1,81 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_INDEXED_DB_INDEXED_DB_GROUP_COMMIT_QUEUE_H_
+#define CONTENT_BROWSER_INDEXED_DB_INDEXED_DB_GROUP_COMMIT_QUEUE_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "content/common/content_export.h"
+#include "third_party/leveldatabase/src/include/leveldb/status.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace content {
+class LevelDBDatabase;
+class LevelDBWriteBatch;
+
+// Merges the writes of transactions that commit close together into a single
+// LevelDB write, so a burst of small transactions costs one log sync instead
+// of one per transaction.
+//
+// Write batches are appended to the pending group in the order they are
+// enqueued, and the group is written by a task posted to |task_runner| when
+// the first batch arrives. Every callback in a group runs after the group's
+// write completes and receives its status, so a transaction is never reported
+// as committed before its data is durable. IndexedDB transactions with
+// overlapping scopes hold their locks until their commit callback runs, which
+// means only non-conflicting transactions can ever share a group.
+//
+// All calls must be made on |task_runner|.
+class CONTENT_EXPORT IndexedDBGroupCommitQueue {
+ public:
+  using CommitCallback = base::OnceCallback<void(leveldb::Status)>;
+
+  // |db| must outlive this object.
+  IndexedDBGroupCommitQueue(
+      LevelDBDatabase* db,
+      scoped_refptr<base::SequencedTaskRunner> task_runner);
+  // Writes any pending group before returning.
+  ~IndexedDBGroupCommitQueue();
+
+  // Adds |write_batch| to the pending group. |callback| is never run
+  // synchronously.
+  void Enqueue(std::unique_ptr<LevelDBWriteBatch> write_batch,
+               CommitCallback callback);
+
+  // Writes the pending group, if any, and runs its callbacks.
+  void Flush();
+
+  size_t pending_count() const { return pending_callbacks_.size(); }
+  size_t num_groups_written() const { return num_groups_written_; }
+
+ private:
+  void OnFlushTask();
+
+  LevelDBDatabase* const db_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  std::unique_ptr<LevelDBWriteBatch> pending_batch_;
+  std::vector<CommitCallback> pending_callbacks_;
+  bool flush_scheduled_ = false;
+  size_t num_groups_written_ = 0;
+
+  base::WeakPtrFactory<IndexedDBGroupCommitQueue> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedDBGroupCommitQueue);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_INDEXED_DB_INDEXED_DB_GROUP_COMMIT_QUEUE_H_
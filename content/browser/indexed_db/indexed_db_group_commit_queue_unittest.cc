@@ -0,0 +1,158 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/indexed_db/indexed_db_group_commit_queue.h"
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "content/browser/indexed_db/leveldb/leveldb_comparator.h"
+#include "content/browser/indexed_db/leveldb/leveldb_database.h"
+#include "content/browser/indexed_db/leveldb/leveldb_env.h"
+#include "content/browser/indexed_db/leveldb/leveldb_write_batch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/leveldatabase/src/include/leveldb/comparator.h"
+
+namespace content {
+
+namespace {
+
+const size_t kTestingMaxOpenCursors = 3;
+
+class IndexedDBGroupCommitQueueTest : public testing::Test {
+ public:
+  IndexedDBGroupCommitQueueTest() {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_directory_.CreateUniqueTempDir());
+    scoped_refptr<LevelDBState> ldb_state;
+    leveldb::Status status;
+    std::tie(ldb_state, status, std::ignore) =
+        indexed_db::GetDefaultLevelDBFactory()->OpenLevelDB(
+            temp_directory_.GetPath(), LevelDBComparator::BytewiseComparator(),
+            leveldb::BytewiseComparator());
+    ASSERT_TRUE(status.ok());
+    leveldb_ = std::make_unique<LevelDBDatabase>(std::move(ldb_state), nullptr,
+                                                 kTestingMaxOpenCursors);
+    queue_ = std::make_unique<IndexedDBGroupCommitQueue>(
+        leveldb_.get(), base::SequencedTaskRunnerHandle::Get());
+  }
+
+  void TearDown() override {
+    queue_.reset();
+    leveldb_.reset();
+  }
+
+ protected:
+  std::unique_ptr<LevelDBWriteBatch> MakeBatch(const std::string& key,
+                                               const std::string& value) {
+    std::unique_ptr<LevelDBWriteBatch> batch = LevelDBWriteBatch::Create();
+    batch->Put(key, value);
+    return batch;
+  }
+
+  std::string Get(const std::string& key) {
+    std::string value;
+    bool found = false;
+    EXPECT_TRUE(leveldb_->Get(key, &value, &found).ok());
+    return found ? value : std::string();
+  }
+
+  base::test::ScopedTaskEnvironment task_environment_;
+  base::ScopedTempDir temp_directory_;
+  std::unique_ptr<LevelDBDatabase> leveldb_;
+  std::unique_ptr<IndexedDBGroupCommitQueue> queue_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(IndexedDBGroupCommitQueueTest);
+};
+
+}  // namespace
+
+TEST_F(IndexedDBGroupCommitQueueTest, MergesBatchesIntoOneWrite) {
+  std::vector<int> completed;
+  for (int i = 0; i < 3; ++i) {
+    queue_->Enqueue(MakeBatch("key" + std::to_string(i), "value"),
+                    base::BindOnce(
+                        [](std::vector<int>* completed, int i,
+                           leveldb::Status s) {
+                          EXPECT_TRUE(s.ok());
+                          completed->push_back(i);
+                        },
+                        &completed, i));
+  }
+
+  // Nothing is written or reported synchronously.
+  EXPECT_TRUE(completed.empty());
+  EXPECT_EQ(3u, queue_->pending_count());
+  EXPECT_EQ("", Get("key0"));
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), completed);
+  EXPECT_EQ(0u, queue_->pending_count());
+  EXPECT_EQ(1u, queue_->num_groups_written());
+  EXPECT_EQ("value", Get("key0"));
+  EXPECT_EQ("value", Get("key1"));
+  EXPECT_EQ("value", Get("key2"));
+}
+
+TEST_F(IndexedDBGroupCommitQueueTest, PreservesWriteOrder) {
+  queue_->Enqueue(MakeBatch("key", "first"), base::DoNothing());
+  queue_->Enqueue(MakeBatch("key", "second"), base::DoNothing());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ("second", Get("key"));
+}
+
+TEST_F(IndexedDBGroupCommitQueueTest, CallbackCanEnqueue) {
+  bool second_done = false;
+  queue_->Enqueue(
+      MakeBatch("key1", "value"),
+      base::BindOnce(
+          [](IndexedDBGroupCommitQueue* queue, bool* second_done,
+             std::unique_ptr<LevelDBWriteBatch> batch, leveldb::Status s) {
+            queue->Enqueue(std::move(batch),
+                           base::BindOnce(
+                               [](bool* second_done, leveldb::Status s) {
+                                 *second_done = true;
+                               },
+                               second_done));
+          },
+          queue_.get(), &second_done, MakeBatch("key2", "value")));
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(second_done);
+  EXPECT_EQ(2u, queue_->num_groups_written());
+  EXPECT_EQ("value", Get("key2"));
+}
+
+TEST_F(IndexedDBGroupCommitQueueTest, FlushWritesImmediately) {
+  bool done = false;
+  queue_->Enqueue(
+      MakeBatch("key", "value"),
+      base::BindOnce([](bool* done, leveldb::Status s) { *done = true; },
+                     &done));
+  queue_->Flush();
+  EXPECT_TRUE(done);
+  EXPECT_EQ("value", Get("key"));
+
+  // The already-posted flush task finds nothing to write.
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1u, queue_->num_groups_written());
+}
+
+TEST_F(IndexedDBGroupCommitQueueTest, DestructionWritesPendingGroup) {
+  queue_->Enqueue(MakeBatch("key", "value"), base::DoNothing());
+  queue_.reset();
+  EXPECT_EQ("value", Get("key"));
+}
+
+}  // namespace content
@@ -180,8 +180,14 @@ void IndexedDBTransaction::RunTasksIfStarted() {
 void IndexedDBTransaction::ForcePendingCommit() {
   IDB_TRACE1("IndexedDBTransaction::ForceCommit", "txn.id", id());
   DCHECK(is_commit_pending_);
-  if (state_ == FINISHED)
+  if (state_ == FINISHED) {
+    // The commit may still be waiting in the backing store's group commit
+    // queue; write it now so its outcome is reported before the connection
+    // lets go of this transaction.
+    if (group_commit_pending_)
+      database_->backing_store()->FlushGroupCommit();
     return;
+  }
 
   should_process_queue_ = true;
   state_ = STARTED;
@@ -394,10 +400,7 @@ leveldb::Status IndexedDBTransaction::CommitPhaseTwo() {
   state_ = FINISHED;
 
   leveldb::Status s;
-  bool committed;
-  if (!used_) {
-    committed = true;
-  } else {
+  if (used_) {
     base::TimeDelta active_time = base::Time::Now() - diagnostics_.start_time;
     uint64_t size_kb = transaction_->GetTransactionSize() / 1024;
     // All histograms record 1KB to 1GB.
@@ -426,10 +429,37 @@ leveldb::Status IndexedDBTransaction::CommitPhaseTwo() {
         NOTREACHED();
     }
 
+    if (transaction_->CanGroupCommit()) {
+      // The outcome is reported from GroupCommitComplete(), once the group
+      // containing this transaction has been written.
+      group_commit_pending_ = true;
+      transaction_->CommitPhaseTwoGrouped(
+          base::BindOnce(&IndexedDBTransaction::GroupCommitComplete,
+                         ptr_factory_.GetWeakPtr()));
+      return leveldb::Status::OK();
+    }
+
     s = transaction_->CommitPhaseTwo();
-    committed = s.ok();
   }
 
+  return FinishCommitPhaseTwo(s);
+}
+
+void IndexedDBTransaction::GroupCommitComplete(leveldb::Status status) {
+  IDB_TRACE1("IndexedDBTransaction::GroupCommitComplete", "txn.id", id());
+  DCHECK_EQ(state_, FINISHED);
+  DCHECK(group_commit_pending_);
+  group_commit_pending_ = false;
+  // Save the database as |this| can be destroyed in the next line.
+  scoped_refptr<IndexedDBDatabase> database = database_;
+  leveldb::Status s = FinishCommitPhaseTwo(status);
+  if (!s.ok())
+    database->ReportError(s);
+}
+
+leveldb::Status IndexedDBTransaction::FinishCommitPhaseTwo(leveldb::Status s) {
+  bool committed = s.ok();
+
   // Backing store resources (held via cursors) must be released
   // before script callbacks are fired, as the script callbacks may
   // release references and allow the backing store itself to be
@@ -180,6 +180,9 @@ class CONTENT_EXPORT IndexedDBTransaction {
   FRIEND_TEST_ALL_PREFIXES(
       indexed_db_transaction_unittest::IndexedDBTransactionTest,
       IndexedDBObserver);
+  FRIEND_TEST_ALL_PREFIXES(
+      indexed_db_transaction_unittest::IndexedDBTransactionGroupCommitTest,
+      WritesCompleteWithTheirGroup);
 
   void RunTasksIfStarted();
 
@@ -191,6 +194,11 @@ class CONTENT_EXPORT IndexedDBTransaction {
   void ProcessTaskQueue();
   void CloseOpenCursors();
   leveldb::Status CommitPhaseTwo();
+  // Called once the backing store's group commit queue has written this
+  // transaction's data.
+  void GroupCommitComplete(leveldb::Status status);
+  // Releases resources and notifies the front-end of the commit outcome.
+  leveldb::Status FinishCommitPhaseTwo(leveldb::Status status);
   void Timeout();
 
   const int64_t id_;
@@ -201,6 +209,9 @@ class CONTENT_EXPORT IndexedDBTransaction {
   State state_ = CREATED;
   std::vector<ScopeLock> locks_;
   bool is_commit_pending_ = false;
+  // True while this transaction's writes wait in the backing store's group
+  // commit queue.
+  bool group_commit_pending_ = false;
   // We are owned by the connection object, but during force closes sometimes
   // there are issues if there is a pending OpenRequest. So use a WeakPtr.
   base::WeakPtr<IndexedDBConnection> connection_;
@@ -6,12 +6,16 @@
 
 #include <stdint.h>
 #include <memory>
+#include <string>
+#include <tuple>
 
 #include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/run_loop.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/test/scoped_feature_list.h"
 #include "content/browser/indexed_db/fake_indexed_db_metadata_coding.h"
 #include "content/browser/indexed_db/indexed_db_connection.h"
 #include "content/browser/indexed_db/indexed_db_database_error.h"
@@ -19,12 +23,18 @@
 #include "content/browser/indexed_db/indexed_db_leveldb_coding.h"
 #include "content/browser/indexed_db/indexed_db_metadata_coding.h"
 #include "content/browser/indexed_db/indexed_db_observer.h"
+#include "content/browser/indexed_db/leveldb/leveldb_comparator.h"
+#include "content/browser/indexed_db/leveldb/leveldb_database.h"
+#include "content/browser/indexed_db/leveldb/leveldb_env.h"
+#include "content/browser/indexed_db/leveldb/leveldb_transaction.h"
 #include "content/browser/indexed_db/mock_indexed_db_database_callbacks.h"
 #include "content/browser/indexed_db/mock_indexed_db_factory.h"
 #include "content/browser/indexed_db/scopes/disjoint_range_lock_manager.h"
+#include "content/public/common/content_features.h"
 #include "content/public/test/test_browser_thread_bundle.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/blink/public/platform/modules/indexeddb/web_idb_database_exception.h"
+#include "third_party/leveldatabase/src/include/leveldb/comparator.h"
 
 namespace content {
 namespace indexed_db_transaction_unittest {
@@ -502,6 +512,154 @@ TEST_F(IndexedDBTransactionTest, IndexedDBObserver) {
   EXPECT_EQ(0UL, connection->active_observers().size());
 }
 
+// Runs transactions against a real LevelDB database, with group commit
+// enabled.
+class IndexedDBTransactionGroupCommitTest : public testing::Test {
+ public:
+  IndexedDBTransactionGroupCommitTest()
+      : factory_(new MockIndexedDBFactory()),
+        lock_manager_(kIndexedDBLockLevelCount) {
+    feature_list_.InitAndEnableFeature(features::kIndexedDBGroupCommit);
+  }
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_directory_.CreateUniqueTempDir());
+    scoped_refptr<LevelDBState> ldb_state;
+    leveldb::Status s;
+    std::tie(ldb_state, s, std::ignore) =
+        indexed_db::GetDefaultLevelDBFactory()->OpenLevelDB(
+            temp_directory_.GetPath(), LevelDBComparator::BytewiseComparator(),
+            leveldb::BytewiseComparator());
+    ASSERT_TRUE(s.ok());
+    backing_store_ = new IndexedDBFakeBackingStore(
+        std::make_unique<LevelDBDatabase>(std::move(ldb_state), nullptr,
+                                          kTestingMaxOpenCursors));
+    std::tie(db_, s) = IndexedDBDatabase::Create(
+        base::ASCIIToUTF16("db"), backing_store_.get(), factory_.get(),
+        std::make_unique<FakeIndexedDBMetadataCoding>(),
+        IndexedDBDatabase::Identifier(), &lock_manager_);
+    ASSERT_TRUE(s.ok());
+  }
+
+  // Registers and starts a transaction owned by |connection|.
+  base::WeakPtr<IndexedDBTransaction> CreateTransaction(
+      IndexedDBConnection* connection,
+      blink::mojom::IDBTransactionMode mode) {
+    base::WeakPtr<IndexedDBTransaction> transaction =
+        connection->AddTransactionForTesting(
+            std::unique_ptr<IndexedDBTransaction>(new IndexedDBTransaction(
+                next_transaction_id_++, connection, std::set<int64_t>(), mode,
+                new IndexedDBBackingStore::Transaction(
+                    backing_store_.get()))));
+    db_->RegisterAndScheduleTransaction(transaction.get());
+    return transaction;
+  }
+
+  leveldb::Status PutOperation(const std::string& key,
+                               const std::string& value,
+                               IndexedDBTransaction* transaction) {
+    std::string value_copy = value;
+    transaction->BackingStoreTransaction()->transaction()->Put(key,
+                                                               &value_copy);
+    return leveldb::Status::OK();
+  }
+
+  leveldb::Status GetOperation(const std::string& key,
+                               IndexedDBTransaction* transaction) {
+    std::string value;
+    bool found = false;
+    return transaction->BackingStoreTransaction()->transaction()->Get(
+        key, &value, &found);
+  }
+
+  std::string Read(const std::string& key) {
+    std::string value;
+    bool found = false;
+    EXPECT_TRUE(backing_store_->db()->Get(key, &value, &found).ok());
+    return found ? value : std::string();
+  }
+
+ protected:
+  static const size_t kTestingMaxOpenCursors = 3;
+
+  TestBrowserThreadBundle thread_bundle_;
+  base::test::ScopedFeatureList feature_list_;
+  base::ScopedTempDir temp_directory_;
+  scoped_refptr<IndexedDBFakeBackingStore> backing_store_;
+  scoped_refptr<IndexedDBDatabase> db_;
+  scoped_refptr<MockIndexedDBFactory> factory_;
+
+ private:
+  DisjointRangeLockManager lock_manager_;
+  int64_t next_transaction_id_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedDBTransactionGroupCommitTest);
+};
+
+TEST_F(IndexedDBTransactionGroupCommitTest, WritesCompleteWithTheirGroup) {
+  std::unique_ptr<IndexedDBConnection> connection(
+      std::make_unique<IndexedDBConnection>(
+          kFakeProcessId, db_, new MockIndexedDBDatabaseCallbacks()));
+  base::WeakPtr<IndexedDBTransaction> first = CreateTransaction(
+      connection.get(), blink::mojom::IDBTransactionMode::ReadWrite);
+  base::WeakPtr<IndexedDBTransaction> second = CreateTransaction(
+      connection.get(), blink::mojom::IDBTransactionMode::ReadWrite);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+
+  first->ScheduleTask(base::BindOnce(
+      &IndexedDBTransactionGroupCommitTest::PutOperation,
+      base::Unretained(this), std::string("first"), std::string("1")));
+  second->ScheduleTask(base::BindOnce(
+      &IndexedDBTransactionGroupCommitTest::PutOperation,
+      base::Unretained(this), std::string("second"), std::string("2")));
+  base::RunLoop().RunUntilIdle();
+
+  // Both commits wait in the queue: neither is reported, nor written, until
+  // the group is.
+  first->Commit();
+  second->Commit();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  EXPECT_EQ(IndexedDBTransaction::FINISHED, first->state());
+  EXPECT_TRUE(first->group_commit_pending_);
+  EXPECT_TRUE(second->group_commit_pending_);
+  EXPECT_EQ("", Read("first"));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(first);
+  EXPECT_FALSE(second);
+  EXPECT_EQ("1", Read("first"));
+  EXPECT_EQ("2", Read("second"));
+}
+
+TEST_F(IndexedDBTransactionGroupCommitTest, TransactionsWithoutWritesBypass) {
+  std::unique_ptr<IndexedDBConnection> connection(
+      std::make_unique<IndexedDBConnection>(
+          kFakeProcessId, db_, new MockIndexedDBDatabaseCallbacks()));
+  base::WeakPtr<IndexedDBTransaction> read_only = CreateTransaction(
+      connection.get(), blink::mojom::IDBTransactionMode::ReadOnly);
+  base::WeakPtr<IndexedDBTransaction> read_write = CreateTransaction(
+      connection.get(), blink::mojom::IDBTransactionMode::ReadWrite);
+  ASSERT_TRUE(read_only);
+  ASSERT_TRUE(read_write);
+
+  read_only->ScheduleTask(base::BindOnce(
+      &IndexedDBTransactionGroupCommitTest::GetOperation,
+      base::Unretained(this), std::string("key")));
+  read_write->ScheduleTask(base::BindOnce(
+      &IndexedDBTransactionGroupCommitTest::GetOperation,
+      base::Unretained(this), std::string("key")));
+  base::RunLoop().RunUntilIdle();
+
+  // Neither transaction has anything to write, so both complete right away
+  // instead of waiting for a group.
+  read_only->Commit();
+  EXPECT_FALSE(read_only);
+  read_write->Commit();
+  EXPECT_FALSE(read_write);
+}
+
 static const blink::mojom::IDBTransactionMode kTestModes[] = {
     blink::mojom::IDBTransactionMode::ReadOnly,
     blink::mojom::IDBTransactionMode::ReadWrite,
@@ -126,7 +126,22 @@ leveldb::Status LevelDBTransaction::Commit() {
   }
 
   std::unique_ptr<LevelDBWriteBatch> write_batch = LevelDBWriteBatch::Create();
+  MoveDataToWriteBatch(write_batch.get());
 
+  leveldb::Status s = db_->Write(*write_batch);
+  if (s.ok())
+    finished_ = true;
+  return s;
+}
+
+void LevelDBTransaction::CommitToWriteBatch(LevelDBWriteBatch* write_batch) {
+  DCHECK(!finished_);
+  IDB_TRACE("LevelDBTransaction::CommitToWriteBatch");
+  MoveDataToWriteBatch(write_batch);
+  finished_ = true;
+}
+
+void LevelDBTransaction::MoveDataToWriteBatch(LevelDBWriteBatch* write_batch) {
   auto it = data_.begin();
   while (it != data_.end()) {
     if (!it->second->deleted)
@@ -137,11 +152,6 @@ leveldb::Status LevelDBTransaction::Commit() {
   }
 
   DCHECK(data_.empty());
-
-  leveldb::Status s = db_->Write(*write_batch);
-  if (s.ok())
-    finished_ = true;
-  return s;
 }
 
 void LevelDBTransaction::Rollback() {
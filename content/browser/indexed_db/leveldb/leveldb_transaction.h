@@ -38,10 +38,18 @@ class CONTENT_EXPORT LevelDBTransaction
   virtual leveldb::Status Commit();
   void Rollback();
 
+  // Moves all pending writes into |write_batch| and marks the transaction as
+  // finished without writing to the database. The caller becomes responsible
+  // for writing the batch, e.g. as part of a group commit.
+  void CommitToWriteBatch(LevelDBWriteBatch* write_batch);
+
   std::unique_ptr<LevelDBIterator> CreateIterator();
 
   uint64_t GetTransactionSize() const { return size_; }
 
+  // Returns true if Commit() would write anything to the database.
+  bool HasPendingWrites() const { return !data_.empty(); }
+
  protected:
   virtual ~LevelDBTransaction();
   explicit LevelDBTransaction(LevelDBDatabase* db);
@@ -64,6 +72,9 @@ class CONTENT_EXPORT LevelDBTransaction
   };
   static constexpr uint64_t SizeOfRecordInMap(size_t key_size);
 
+  // Drains |data_| into |write_batch|.
+  void MoveDataToWriteBatch(LevelDBWriteBatch* write_batch);
+
   class Comparator {
    public:
     explicit Comparator(const LevelDBComparator* comparator)
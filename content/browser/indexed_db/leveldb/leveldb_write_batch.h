@@ -28,6 +28,9 @@ class CONTENT_EXPORT LevelDBWriteBatch {
                                               // batch.
   void Clear();
 
+  // Appends all operations in |other| to this batch, preserving their order.
+  void Append(const LevelDBWriteBatch& other);
+
  private:
   friend class LevelDBDatabase;
   LevelDBWriteBatch();
@@ -210,6 +210,11 @@ const base::Feature kHistoryManipulationIntervention{
 const base::Feature kImageCaptureAPI{"ImageCaptureAPI",
                                      base::FEATURE_ENABLED_BY_DEFAULT};
 
+// Merges the LevelDB writes of IndexedDB transactions that commit close
+// together into a single synced write.
+const base::Feature kIndexedDBGroupCommit{"IndexedDBGroupCommit",
+                                          base::FEATURE_DISABLED_BY_DEFAULT};
+
 // This flag is used to set field parameters to choose predictor we use when
 // kResamplingInputEvents is disabled. It's used for gatherig accuracy metrics
 // on finch and also for choosing predictor type for predictedEvents API without
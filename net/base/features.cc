@@ -31,5 +31,20 @@ const base::Feature kTLS13KeyUpdate{"TLS13KeyUpdate",
 const base::Feature kPostQuantumCECPQ2{"PostQuantumCECPQ2",
                                        base::FEATURE_DISABLED_BY_DEFAULT};
 
+const base::Feature kQuicBatchedPacketReads{"QuicBatchedPacketReads",
+                                            base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kQuicUdpSegmentationOffload{
+    "QuicUdpSegmentationOffload", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kQuicZeroCopyRequestBody{"QuicZeroCopyRequestBody",
+                                             base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kHttpCacheBatchDoneHeadersQueue{
+    "HttpCacheBatchDoneHeadersQueue", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kSpdyHeadersToHttpResponseUseBuilder{
+    "SpdyHeadersToHttpResponseUseBuilder", base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace features
 }  // namespace net
@@ -36,6 +36,30 @@ NET_EXPORT extern const base::Feature kTLS13KeyUpdate;
 // Enables CECPQ2, a post-quantum key-agreement, in TLS 1.3 connections.
 NET_EXPORT extern const base::Feature kPostQuantumCECPQ2;
 
+// Makes QuicChromiumPacketReader receive packets in batches with
+// DatagramClientSocket::ReadMultiple(), which uses recvmmsg() where available.
+NET_EXPORT extern const base::Feature kQuicBatchedPacketReads;
+
+// Makes QuicChromiumPacketWriter batch consecutive packets and send them with
+// UDP segmentation offload (GSO), and, together with kQuicBatchedPacketReads,
+// makes QuicChromiumPacketReader receive coalesced packets (GRO). Both fall
+// back to per-packet I/O when the kernel lacks support.
+NET_EXPORT extern const base::Feature kQuicUdpSegmentationOffload;
+
+// Makes QuicHttpStream hand request body buffers to the QUIC send buffer by
+// reference instead of copying them.
+NET_EXPORT extern const base::Feature kQuicZeroCopyRequestBody;
+
+// Lets HttpCache move every transaction waiting in an entry's done headers
+// queue that can join the current writers, or read the completed response,
+// in one pass instead of one transaction per posted task.
+NET_EXPORT extern const base::Feature kHttpCacheBatchDoneHeadersQueue;
+
+// Converts HTTP/2 and QUIC response header blocks with
+// HttpResponseHeaders::Builder, which references the decoded header block,
+// instead of formatting them into a raw header string and parsing it again.
+NET_EXPORT extern const base::Feature kSpdyHeadersToHttpResponseUseBuilder;
+
 }  // namespace features
 }  // namespace net
 
@@ -8,8 +8,11 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/logging.h"
+#include "base/macros.h"
 #include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 #include "crypto/sha2.h"
 #include "net/base/net_errors.h"
 #include "net/cert/cert_net_fetcher.h"
@@ -25,6 +28,7 @@
 #include "net/cert/internal/parsed_certificate.h"
 #include "net/cert/internal/path_builder.h"
 #include "net/cert/internal/revocation_checker.h"
+#include "net/cert/internal/signature_verify_cache.h"
 #include "net/cert/internal/simple_path_builder_delegate.h"
 #include "net/cert/internal/system_trust_store.h"
 #include "net/cert/known_roots.h"
@@ -38,6 +42,11 @@ namespace {
 
 DEFINE_CERT_ERROR_ID(kPathLacksEVPolicy, "Path does not have an EV policy");
 
+// The number of signature check results and parsed intermediates kept across
+// verifications.
+const size_t kMaxCachedSignatures = 256;
+const size_t kMaxCachedIntermediates = 64;
+
 RevocationPolicy NoRevocationChecking() {
   RevocationPolicy policy;
   policy.check_revocation = false;
@@ -97,6 +106,7 @@ class PathBuilderDelegateImpl : public SimplePathBuilderDelegate {
                           const SystemTrustStore* ssl_trust_store,
                           base::StringPiece stapled_leaf_ocsp_response,
                           const EVRootCAMetadata* ev_metadata,
+                          SignatureVerifyCache* verify_cache,
                           bool* checked_revocation_for_some_path)
       : SimplePathBuilderDelegate(1024, digest_policy),
         crl_set_(crl_set),
@@ -106,8 +116,11 @@ class PathBuilderDelegateImpl : public SimplePathBuilderDelegate {
         ssl_trust_store_(ssl_trust_store),
         stapled_leaf_ocsp_response_(stapled_leaf_ocsp_response),
         ev_metadata_(ev_metadata),
+        verify_cache_(verify_cache),
         checked_revocation_for_some_path_(checked_revocation_for_some_path) {}
 
+  SignatureVerifyCache* GetVerifyCache() override { return verify_cache_; }
+
   // This is called for each built chain, including ones which failed. It is
   // responsible for adding errors to the built chain if it is not acceptable.
   void CheckPathAfterVerification(CertPathBuilderResultPath* path) override {
@@ -255,9 +268,34 @@ class PathBuilderDelegateImpl : public SimplePathBuilderDelegate {
   const SystemTrustStore* ssl_trust_store_;
   const base::StringPiece stapled_leaf_ocsp_response_;
   const EVRootCAMetadata* ev_metadata_;
+  SignatureVerifyCache* verify_cache_;
   bool* checked_revocation_for_some_path_;
 };
 
+// Keeps the ParsedCertificates of recently seen intermediates, which are
+// mostly the same few certificates across connections. Identical certificates
+// share a CRYPTO_BUFFER through x509_util's buffer pool, so the buffer pointer
+// identifies the certificate. Each entry holds a reference to its buffer, so
+// the pointer cannot be reused for another certificate while it is cached.
+//
+// This class is thread-safe.
+class ParsedIntermediateCache {
+ public:
+  ParsedIntermediateCache() : entries_(kMaxCachedIntermediates) {}
+
+  // Returns the cached ParsedCertificate for |cert_handle|, parsing and
+  // caching it if there is none. Parsing errors are added to |errors|.
+  scoped_refptr<ParsedCertificate> GetOrParse(CRYPTO_BUFFER* cert_handle,
+                                              CertErrors* errors);
+
+ private:
+  base::Lock lock_;
+  base::HashingMRUCache<const CRYPTO_BUFFER*, scoped_refptr<ParsedCertificate>>
+      entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParsedIntermediateCache);
+};
+
 class CertVerifyProcBuiltin : public CertVerifyProc {
  public:
   CertVerifyProcBuiltin();
@@ -275,9 +313,14 @@ class CertVerifyProcBuiltin : public CertVerifyProc {
                      CRLSet* crl_set,
                      const CertificateList& additional_trust_anchors,
                      CertVerifyResult* verify_result) override;
+
+  // Shared by all verifications, which may run concurrently.
+  SignatureVerifyCache verify_cache_;
+  ParsedIntermediateCache intermediate_cache_;
 };
 
-CertVerifyProcBuiltin::CertVerifyProcBuiltin() = default;
+CertVerifyProcBuiltin::CertVerifyProcBuiltin()
+    : verify_cache_(kMaxCachedSignatures) {}
 
 CertVerifyProcBuiltin::~CertVerifyProcBuiltin() = default;
 
@@ -293,12 +336,32 @@ scoped_refptr<ParsedCertificate> ParseCertificateFromBuffer(
                                    errors);
 }
 
+scoped_refptr<ParsedCertificate> ParsedIntermediateCache::GetOrParse(
+    CRYPTO_BUFFER* cert_handle,
+    CertErrors* errors) {
+  {
+    base::AutoLock lock(lock_);
+    auto it = entries_.Get(cert_handle);
+    if (it != entries_.end())
+      return it->second;
+  }
+
+  scoped_refptr<ParsedCertificate> cert =
+      ParseCertificateFromBuffer(cert_handle, errors);
+  if (cert) {
+    base::AutoLock lock(lock_);
+    entries_.Put(cert_handle, cert);
+  }
+  return cert;
+}
+
 void AddIntermediatesToIssuerSource(X509Certificate* x509_cert,
+                                    ParsedIntermediateCache* cache,
                                     CertIssuerSourceStatic* intermediates) {
   CertErrors errors;
   for (const auto& intermediate : x509_cert->intermediate_buffers()) {
     scoped_refptr<ParsedCertificate> cert =
-        ParseCertificateFromBuffer(intermediate.get(), &errors);
+        cache->GetOrParse(intermediate.get(), &errors);
     if (cert)
       intermediates->AddCert(std::move(cert));
     // TODO(crbug.com/634443): Surface these parsing errors?
@@ -417,6 +480,7 @@ void TryBuildPath(const scoped_refptr<ParsedCertificate>& target,
                   const CRLSet* crl_set,
                   CertNetFetcher* net_fetcher,
                   const EVRootCAMetadata* ev_metadata,
+                  SignatureVerifyCache* verify_cache,
                   CertPathBuilder::Result* result,
                   bool* checked_revocation) {
   der::GeneralizedTime der_verification_time;
@@ -439,7 +503,8 @@ void TryBuildPath(const scoped_refptr<ParsedCertificate>& target,
 
   PathBuilderDelegateImpl path_builder_delegate(
       crl_set, net_fetcher, verification_type, digest_policy, flags,
-      ssl_trust_store, ocsp_response, ev_metadata, checked_revocation);
+      ssl_trust_store, ocsp_response, ev_metadata, verify_cache,
+      checked_revocation);
 
   // Initialize the path builder.
   CertPathBuilder path_builder(
@@ -581,7 +646,8 @@ int CertVerifyProcBuiltin::VerifyInternal(
 
   // Parse the provided intermediates.
   CertIssuerSourceStatic intermediates;
-  AddIntermediatesToIssuerSource(input_cert, &intermediates);
+  AddIntermediatesToIssuerSource(input_cert, &intermediate_cache_,
+                                 &intermediates);
 
   // Parse the additional trust anchors and setup trust store.
   std::unique_ptr<SystemTrustStore> ssl_trust_store =
@@ -633,7 +699,7 @@ int CertVerifyProcBuiltin::VerifyInternal(
     TryBuildPath(target, &intermediates, ssl_trust_store.get(),
                  verification_time, cur_attempt.verification_type,
                  cur_attempt.digest_policy, flags, ocsp_response, crl_set,
-                 net_fetcher, ev_metadata, &result,
+                 net_fetcher, ev_metadata, &verify_cache_, &result,
                  &checked_revocation_for_some_path);
 
     if (result.HasValidPath())
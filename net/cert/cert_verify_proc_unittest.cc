@@ -537,7 +537,7 @@ class CertBuilder {
     ASSERT_TRUE(tbs_certificate.ReadOptionalTag(
         der::ContextSpecificConstructed(3), &extensions_tlv, &has_extensions));
     if (has_extensions) {
-      std::map<der::Input, ParsedExtension> parsed_extensions;
+      ParsedExtensionMap parsed_extensions;
       ASSERT_TRUE(ParseExtensions(extensions_tlv, &parsed_extensions));
 
       for (const auto& parsed_extension : parsed_extensions) {
@@ -5,6 +5,7 @@
 #include "net/cert/internal/parse_certificate.h"
 
 #include <utility>
+#include <vector>
 
 #include "base/strings/string_util.h"
 #include "net/cert/internal/cert_error_params.h"
@@ -764,23 +765,34 @@ der::Input CrlDistributionPointsOid() {
   return der::Input(oid);
 }
 
-NET_EXPORT bool ParseExtensions(
-    const der::Input& extensions_tlv,
-    std::map<der::Input, ParsedExtension>* extensions) {
+NET_EXPORT bool ParseExtensions(const der::Input& extensions_tlv,
+                                ParsedExtensionMap* extensions) {
   der::Parser parser(extensions_tlv);
 
   //    Extensions  ::=  SEQUENCE SIZE (1..MAX) OF Extension
-  der::Parser extensions_parser;
-  if (!parser.ReadSequence(&extensions_parser))
+  der::Input extensions_value;
+  if (!parser.ReadTag(der::kSequence, &extensions_value))
     return false;
+  der::Parser extensions_parser(extensions_value);
 
   // The Extensions SEQUENCE must contains at least 1 element (otherwise it
   // should have been omitted).
   if (!extensions_parser.HasMore())
     return false;
 
-  extensions->clear();
+  // Count the extensions first so that they can be collected with a single
+  // allocation.
+  size_t num_extensions = 0;
+  der::Parser counting_parser(extensions_value);
+  while (counting_parser.HasMore()) {
+    der::Input extension_tlv;
+    if (!counting_parser.ReadRawTLV(&extension_tlv))
+      return false;
+    ++num_extensions;
+  }
 
+  std::vector<std::pair<der::Input, ParsedExtension>> parsed_extensions;
+  parsed_extensions.reserve(num_extensions);
   while (extensions_parser.HasMore()) {
     ParsedExtension extension;
 
@@ -791,14 +803,16 @@ NET_EXPORT bool ParseExtensions(
     if (!ParseExtension(extension_tlv, &extension))
       return false;
 
-    bool is_duplicate =
-        !extensions->insert(std::make_pair(extension.oid, extension)).second;
-
-    // RFC 5280 says that an extension should not appear more than once.
-    if (is_duplicate)
-      return false;
+    parsed_extensions.emplace_back(extension.oid, extension);
   }
 
+  *extensions = ParsedExtensionMap(std::move(parsed_extensions),
+                                   base::KEEP_FIRST_OF_DUPES);
+
+  // RFC 5280 says that an extension should not appear more than once.
+  if (extensions->size() != num_extensions)
+    return false;
+
   // By definition the input was a single Extensions sequence, so there
   // shouldn't be unconsumed data.
   if (parser.HasMore())
@@ -809,7 +823,7 @@ NET_EXPORT bool ParseExtensions(
 
 NET_EXPORT bool ConsumeExtension(
     const der::Input& oid,
-    std::map<der::Input, ParsedExtension>* unconsumed_extensions,
+    ParsedExtensionMap* unconsumed_extensions,
     ParsedExtension* extension) {
   auto it = unconsumed_extensions->find(oid);
   if (it == unconsumed_extensions->end())
@@ -7,11 +7,11 @@
 
 #include <stdint.h>
 
-#include <map>
 #include <memory>
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/containers/flat_map.h"
 #include "net/base/net_export.h"
 #include "net/der/input.h"
 #include "net/der/parse_values.h"
@@ -371,6 +371,11 @@ NET_EXPORT der::Input AdOcspOid();
 // In dotted notation: 2.5.29.31
 NET_EXPORT der::Input CrlDistributionPointsOid();
 
+// Map from OID to ParsedExtension. Certificates carry a handful of extensions,
+// so this is a sorted vector rather than a node-based map: building it takes
+// a single allocation and lookups stay within one block of memory.
+using ParsedExtensionMap = base::flat_map<der::Input, ParsedExtension>;
+
 // Parses the Extensions sequence as defined by RFC 5280. Extensions are added
 // to the map |extensions| keyed by the OID. Parsing guarantees that each OID
 // is unique. Note that certificate verification must consume each extension
@@ -381,14 +386,14 @@ NET_EXPORT der::Input CrlDistributionPointsOid();
 // On failure |extensions| may be partially written to and should not be used.
 NET_EXPORT bool ParseExtensions(
     const der::Input& extensions_tlv,
-    std::map<der::Input, ParsedExtension>* extensions) WARN_UNUSED_RESULT;
+    ParsedExtensionMap* extensions) WARN_UNUSED_RESULT;
 
 // Removes the extension with OID |oid| from |unconsumed_extensions| and fills
 // |extension| with the matching extension value. If there was no extension
 // matching |oid| then returns |false|.
 NET_EXPORT bool ConsumeExtension(
     const der::Input& oid,
-    std::map<der::Input, ParsedExtension>* unconsumed_extensions,
+    ParsedExtensionMap* unconsumed_extensions,
     ParsedExtension* extension) WARN_UNUSED_RESULT;
 
 struct ParsedBasicConstraints {
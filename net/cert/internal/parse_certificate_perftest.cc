@@ -0,0 +1,130 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/parse_certificate.h"
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/cert/internal/parsed_certificate.h"
+#include "net/cert/internal/test_helpers.h"
+#include "net/cert/x509_util.h"
+#include "net/der/input.h"
+#include "net/der/parser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/boringssl/src/include/openssl/pool.h"
+
+namespace net {
+
+namespace {
+
+// Chains whose certificates make up the corpus: RSA and ECDSA keys, long
+// chains, and certificates with many names, policies and constraints.
+const char* const kCorpus[] = {
+    "target-and-intermediate/main.test",
+    "target-signed-using-ecdsa/main.test",
+    "key-rollover/longrolloverchain.test",
+    "many-names/ok-all-types.test",
+    "unknown-non-critical-policy-qualifier/main.test",
+    "intermediate-basic-constraints-ca-false/main.test",
+    "target-has-keycertsign-but-not-ca/main.test",
+};
+
+const int kNumRounds = 2000;
+
+// Reads every TLV in |input|, descending into constructed values, and returns
+// the number of TLVs read. This is the access pattern of the certificate
+// parser without any of the per-field work.
+size_t WalkDer(const der::Input& input) {
+  der::Parser parser(input);
+  size_t num_tlvs = 0;
+  while (parser.HasMore()) {
+    der::Tag tag;
+    der::Input value;
+    if (!parser.ReadTagAndValue(&tag, &value))
+      return 0;
+    ++num_tlvs;
+    if (der::IsConstructed(tag))
+      num_tlvs += WalkDer(value);
+  }
+  return num_tlvs;
+}
+
+class ParseCertificatePerfTest : public testing::Test {
+ protected:
+  ParseCertificatePerfTest() = default;
+
+  void SetUp() override {
+    for (const char* test_file : kCorpus) {
+      VerifyCertChainTest test;
+      ASSERT_TRUE(ReadVerifyCertChainTestFromFile(
+          std::string("net/data/verify_certificate_chain_unittest/") +
+              test_file,
+          &test));
+      for (const auto& cert : test.chain) {
+        certs_.push_back(cert->der_cert().AsString());
+        corpus_bytes_ += certs_.back().size();
+      }
+    }
+  }
+
+  std::vector<std::string> certs_;
+  size_t corpus_bytes_ = 0;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ParseCertificatePerfTest);
+};
+
+// Measures the throughput of the DER reader alone.
+TEST_F(ParseCertificatePerfTest, WalkDer) {
+  size_t num_tlvs = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (const std::string& cert : certs_)
+      num_tlvs += WalkDer(der::Input(&cert));
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  ASSERT_GT(num_tlvs, 0u);
+
+  perf_test::PrintResult(
+      "der_walk", "", "throughput",
+      kNumRounds * corpus_bytes_ / elapsed.InSecondsF() / (1024 * 1024),
+      "MB/s", true);
+  perf_test::PrintResult("der_walk", "", "tlvs",
+                         num_tlvs / elapsed.InSecondsF(), "tlvs/s", false);
+}
+
+// Measures creating a ParsedCertificate, which includes parsing the standard
+// extensions.
+TEST_F(ParseCertificatePerfTest, CreateParsedCertificate) {
+  std::vector<bssl::UniquePtr<CRYPTO_BUFFER>> buffers;
+  for (const std::string& cert : certs_)
+    buffers.push_back(x509_util::CreateCryptoBuffer(cert));
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (const auto& buffer : buffers) {
+      scoped_refptr<ParsedCertificate> cert = ParsedCertificate::Create(
+          bssl::UpRef(buffer.get()),
+          x509_util::DefaultParseCertificateOptions(), nullptr);
+      ASSERT_TRUE(cert);
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  perf_test::PrintResult(
+      "parsed_certificate", "", "create",
+      kNumRounds * buffers.size() / elapsed.InSecondsF(), "certs/s", true);
+  perf_test::PrintResult(
+      "parsed_certificate", "", "throughput",
+      kNumRounds * corpus_bytes_ / elapsed.InSecondsF() / (1024 * 1024),
+      "MB/s", false);
+}
+
+}  // namespace
+
+}  // namespace net
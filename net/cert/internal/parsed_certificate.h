@@ -5,7 +5,6 @@
 #ifndef NET_CERT_INTERNAL_PARSED_CERTIFICATE_H_
 #define NET_CERT_INTERNAL_PARSED_CERTIFICATE_H_
 
-#include <map>
 #include <memory>
 #include <vector>
 
@@ -38,7 +37,7 @@ class NET_EXPORT ParsedCertificate
     : public base::RefCountedThreadSafe<ParsedCertificate> {
  public:
   // Map from OID to ParsedExtension.
-  using ExtensionsMap = std::map<der::Input, ParsedExtension>;
+  using ExtensionsMap = ParsedExtensionMap;
 
   // Creates a ParsedCertificate given a DER-encoded Certificate. Returns
   // nullptr on failure. Failure will occur if the standard certificate fields
@@ -0,0 +1,132 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/path_builder.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/cert/internal/cert_issuer_source_static.h"
+#include "net/cert/internal/signature_verify_cache.h"
+#include "net/cert/internal/simple_path_builder_delegate.h"
+#include "net/cert/internal/test_helpers.h"
+#include "net/cert/internal/trust_store_in_memory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace net {
+
+namespace {
+
+// Chains that verify successfully, covering RSA and ECDSA signatures, a long
+// chain and a certificate with many names.
+const char* const kCorpus[] = {
+    "target-and-intermediate/main.test",
+    "target-signed-using-ecdsa/main.test",
+    "key-rollover/longrolloverchain.test",
+    "many-names/ok-all-types.test",
+};
+
+const int kNumRounds = 200;
+
+class VerifyCachePathBuilderDelegate : public SimplePathBuilderDelegate {
+ public:
+  explicit VerifyCachePathBuilderDelegate(SignatureVerifyCache* verify_cache)
+      : SimplePathBuilderDelegate(
+            1024,
+            SimplePathBuilderDelegate::DigestPolicy::kWeakAllowSha1),
+        verify_cache_(verify_cache) {}
+
+  SignatureVerifyCache* GetVerifyCache() override { return verify_cache_; }
+
+ private:
+  SignatureVerifyCache* verify_cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(VerifyCachePathBuilderDelegate);
+};
+
+class PathBuilderPerfTest : public testing::Test {
+ protected:
+  PathBuilderPerfTest() = default;
+
+  void SetUp() override {
+    for (const char* test_file : kCorpus) {
+      VerifyCertChainTest test;
+      ASSERT_TRUE(ReadVerifyCertChainTestFromFile(
+          std::string("net/data/verify_certificate_chain_unittest/") +
+              test_file,
+          &test));
+      ASSERT_FALSE(test.HasHighSeverityErrors());
+      tests_.push_back(std::move(test));
+    }
+  }
+
+  // Builds a path for every chain in the corpus |kNumRounds| times, each time
+  // with a new CertPathBuilder as a new connection would, and reports
+  // verifications per second. |verify_cache|, if not null, is shared by all of
+  // them.
+  //
+  // The corpus repeats the same targets, so with a cache even the targets'
+  // signatures are only checked once. Across real hosts only the
+  // intermediates repeat, which makes the cached result an upper bound.
+  void RunVerifications(const std::string& trace,
+                        SignatureVerifyCache* verify_cache) {
+    VerifyCachePathBuilderDelegate delegate(verify_cache);
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int round = 0; round < kNumRounds; ++round) {
+      for (const VerifyCertChainTest& test : tests_) {
+        TrustStoreInMemory trust_store;
+        trust_store.AddTrustAnchor(test.chain.back());
+        CertIssuerSourceStatic intermediates;
+        for (size_t i = 1; i < test.chain.size(); ++i)
+          intermediates.AddCert(test.chain[i]);
+
+        CertPathBuilder::Result result;
+        CertPathBuilder path_builder(
+            test.chain.front(), &trust_store, &delegate, test.time,
+            test.key_purpose, test.initial_explicit_policy,
+            test.user_initial_policy_set, test.initial_policy_mapping_inhibit,
+            test.initial_any_policy_inhibit, &result);
+        path_builder.AddCertIssuerSource(&intermediates);
+        path_builder.Run();
+        ASSERT_TRUE(result.HasValidPath());
+      }
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PrintResult(
+        "verifications", "", trace,
+        kNumRounds * tests_.size() / elapsed.InSecondsF(), "verifications/s",
+        true);
+    if (verify_cache) {
+      perf_test::PrintResult("signature_cache_hits", "", trace,
+                             verify_cache->hits(), "count", false);
+      perf_test::PrintResult("signature_cache_misses", "", trace,
+                             verify_cache->misses(), "count", false);
+    }
+  }
+
+  std::vector<VerifyCertChainTest> tests_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PathBuilderPerfTest);
+};
+
+TEST_F(PathBuilderPerfTest, Verify) {
+  RunVerifications("no_cache", nullptr);
+}
+
+TEST_F(PathBuilderPerfTest, VerifyWithSignatureCache) {
+  SignatureVerifyCache verify_cache(256);
+  RunVerifications("signature_cache", &verify_cache);
+}
+
+}  // namespace
+
+}  // namespace net
@@ -0,0 +1,79 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/signature_verify_cache.h"
+
+#include <stdint.h>
+
+#include "net/der/input.h"
+#include "net/der/parse_values.h"
+#include "third_party/boringssl/src/include/openssl/sha.h"
+
+namespace net {
+
+namespace {
+
+// Hashes the length of |input| ahead of its contents, so that moving bytes
+// between adjacent fields changes the digest.
+void UpdateWithInput(SHA256_CTX* ctx, const der::Input& input) {
+  uint64_t length = input.Length();
+  SHA256_Update(ctx, &length, sizeof(length));
+  SHA256_Update(ctx, input.UnsafeData(), input.Length());
+}
+
+}  // namespace
+
+SignatureVerifyCache::SignatureVerifyCache(size_t max_entries)
+    : entries_(max_entries) {}
+
+SignatureVerifyCache::~SignatureVerifyCache() = default;
+
+// static
+std::string SignatureVerifyCache::ComputeKey(
+    const der::Input& signature_algorithm_tlv,
+    const der::Input& signed_data,
+    const der::BitString& signature_value,
+    const der::Input& public_key_spki) {
+  SHA256_CTX ctx;
+  SHA256_Init(&ctx);
+  UpdateWithInput(&ctx, signature_algorithm_tlv);
+  UpdateWithInput(&ctx, signed_data);
+  uint8_t unused_bits = signature_value.unused_bits();
+  SHA256_Update(&ctx, &unused_bits, sizeof(unused_bits));
+  UpdateWithInput(&ctx, signature_value.bytes());
+  UpdateWithInput(&ctx, public_key_spki);
+
+  std::string key(SHA256_DIGEST_LENGTH, '\0');
+  SHA256_Final(reinterpret_cast<uint8_t*>(&key[0]), &ctx);
+  return key;
+}
+
+bool SignatureVerifyCache::Lookup(const std::string& key, bool* verified) {
+  base::AutoLock lock(lock_);
+  auto it = entries_.Get(key);
+  if (it == entries_.end()) {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  *verified = it->second;
+  return true;
+}
+
+void SignatureVerifyCache::Store(const std::string& key, bool verified) {
+  base::AutoLock lock(lock_);
+  entries_.Put(key, verified);
+}
+
+size_t SignatureVerifyCache::hits() const {
+  base::AutoLock lock(lock_);
+  return hits_;
+}
+
+size_t SignatureVerifyCache::misses() const {
+  base::AutoLock lock(lock_);
+  return misses_;
+}
+
+}  // namespace net
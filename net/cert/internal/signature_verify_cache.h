@@ -0,0 +1,69 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_CERT_INTERNAL_SIGNATURE_VERIFY_CACHE_H_
+#define NET_CERT_INTERNAL_SIGNATURE_VERIFY_CACHE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+namespace der {
+class BitString;
+class Input;
+}  // namespace der
+
+// Remembers the outcome of certificate signature checks, so that a signature
+// seen by many verifications is only checked once. In practice these are the
+// links between intermediates and roots shared by many servers, which make up
+// most of the signature checks done when connecting to many hosts.
+//
+// Entries are keyed by a SHA-256 digest of the signature algorithm, the signed
+// data, the signature and the issuer's SubjectPublicKeyInfo, so a hit means
+// the exact same signature was checked against the exact same key.
+//
+// This class is thread-safe.
+class NET_EXPORT SignatureVerifyCache {
+ public:
+  // Keeps at most |max_entries| results, evicting the least recently used.
+  explicit SignatureVerifyCache(size_t max_entries);
+  ~SignatureVerifyCache();
+
+  // Returns the key for verifying |signature_value| over |signed_data| with
+  // the algorithm in |signature_algorithm_tlv| and the key in
+  // |public_key_spki|.
+  static std::string ComputeKey(const der::Input& signature_algorithm_tlv,
+                                const der::Input& signed_data,
+                                const der::BitString& signature_value,
+                                const der::Input& public_key_spki);
+
+  // Returns true and sets |*verified| to the stored result if there is an
+  // entry for |key|.
+  bool Lookup(const std::string& key, bool* verified);
+
+  // Stores the result of verifying the signature for |key|.
+  void Store(const std::string& key, bool verified);
+
+  size_t hits() const;
+  size_t misses() const;
+
+ private:
+  mutable base::Lock lock_;
+  base::HashingMRUCache<std::string, bool> entries_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SignatureVerifyCache);
+};
+
+}  // namespace net
+
+#endif  // NET_CERT_INTERNAL_SIGNATURE_VERIFY_CACHE_H_
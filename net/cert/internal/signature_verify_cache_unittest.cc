@@ -0,0 +1,78 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/signature_verify_cache.h"
+
+#include <stdint.h>
+
+#include "net/der/input.h"
+#include "net/der/parse_values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const uint8_t kAlgorithm[] = {0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86,
+                              0x48, 0xce, 0x3d, 0x04, 0x03, 0x02};
+const uint8_t kSignedData[] = {'d', 'a', 't', 'a'};
+const uint8_t kSignature[] = {0x01, 0x02, 0x03, 0x04};
+const uint8_t kSpki[] = {'s', 'p', 'k', 'i'};
+
+TEST(SignatureVerifyCacheTest, ComputeKey) {
+  der::BitString signature(der::Input(kSignature), 0);
+  std::string key =
+      SignatureVerifyCache::ComputeKey(der::Input(kAlgorithm),
+                                       der::Input(kSignedData), signature,
+                                       der::Input(kSpki));
+  EXPECT_EQ(key, SignatureVerifyCache::ComputeKey(
+                     der::Input(kAlgorithm), der::Input(kSignedData),
+                     signature, der::Input(kSpki)));
+
+  // Every input is part of the key.
+  EXPECT_NE(key, SignatureVerifyCache::ComputeKey(
+                     der::Input(kAlgorithm), der::Input(kSpki), signature,
+                     der::Input(kSignedData)));
+  EXPECT_NE(key, SignatureVerifyCache::ComputeKey(
+                     der::Input(kAlgorithm), der::Input(kSignedData),
+                     der::BitString(der::Input(kSignature), 1),
+                     der::Input(kSpki)));
+  EXPECT_NE(key, SignatureVerifyCache::ComputeKey(
+                     der::Input(kAlgorithm, 2), der::Input(kSignedData),
+                     signature, der::Input(kSpki)));
+
+  // Moving bytes from one input to the next changes the key.
+  EXPECT_NE(SignatureVerifyCache::ComputeKey(
+                der::Input(kSignedData, 2), der::Input(kSignedData + 2, 2),
+                signature, der::Input(kSpki)),
+            SignatureVerifyCache::ComputeKey(
+                der::Input(kSignedData, 3), der::Input(kSignedData + 3, 1),
+                signature, der::Input(kSpki)));
+}
+
+TEST(SignatureVerifyCacheTest, LookupAndStore) {
+  SignatureVerifyCache cache(2);
+  bool verified = false;
+
+  EXPECT_FALSE(cache.Lookup("a", &verified));
+  cache.Store("a", true);
+  cache.Store("b", false);
+  EXPECT_TRUE(cache.Lookup("a", &verified));
+  EXPECT_TRUE(verified);
+  EXPECT_TRUE(cache.Lookup("b", &verified));
+  EXPECT_FALSE(verified);
+
+  // "a" is the least recently used entry, so it is evicted.
+  cache.Store("c", true);
+  EXPECT_FALSE(cache.Lookup("a", &verified));
+  EXPECT_TRUE(cache.Lookup("b", &verified));
+  EXPECT_TRUE(cache.Lookup("c", &verified));
+
+  EXPECT_EQ(4u, cache.hits());
+  EXPECT_EQ(2u, cache.misses());
+}
+
+}  // namespace
+
+}  // namespace net
@@ -5,6 +5,7 @@
 #include "net/cert/internal/verify_certificate_chain.h"
 
 #include <algorithm>
+#include <string>
 
 #include "base/logging.h"
 #include "net/cert/internal/cert_error_params.h"
@@ -14,6 +15,7 @@
 #include "net/cert/internal/name_constraints.h"
 #include "net/cert/internal/parse_certificate.h"
 #include "net/cert/internal/signature_algorithm.h"
+#include "net/cert/internal/signature_verify_cache.h"
 #include "net/cert/internal/trust_store.h"
 #include "net/cert/internal/verify_signed_data.h"
 #include "net/der/input.h"
@@ -490,6 +492,10 @@ class PathVerifier {
   bssl::UniquePtr<EVP_PKEY> ParseAndCheckPublicKey(const der::Input& spki,
                                                    CertErrors* errors);
 
+  // Returns true if |cert| is signed by |working_public_key_|, consulting the
+  // delegate's SignatureVerifyCache if it has one.
+  bool VerifyCertificateSignature(const ParsedCertificate& cert);
+
   ValidPolicyTree valid_policy_tree_;
 
   // Will contain a NameConstraints for each previous cert in the chain which
@@ -557,6 +563,9 @@ class PathVerifier {
   //    signature of a certificate.
   bssl::UniquePtr<EVP_PKEY> working_public_key_;
 
+  // The SubjectPublicKeyInfo that |working_public_key_| was parsed from.
+  der::Input working_public_key_spki_;
+
   // |working_normalized_issuer_name_| is the normalized value of the
   // working_issuer_name variable in RFC 5280 section 6.1.2:
   //
@@ -802,9 +811,7 @@ void PathVerifier::BasicCertificateProcessing(
   if (working_public_key_) {
     // Verify the digital signature using the previous certificate's key (RFC
     // 5280 section 6.1.3 step a.1).
-    if (!VerifySignedData(cert.signature_algorithm(),
-                          cert.tbs_certificate_tlv(), cert.signature_value(),
-                          working_public_key_.get())) {
+    if (!VerifyCertificateSignature(cert)) {
       *shortcircuit_chain_validation = true;
       errors->AddError(cert_errors::kVerifySignedDataFailed);
     }
@@ -859,6 +866,7 @@ void PathVerifier::PrepareForNextCertificate(const ParsedCertificate& cert,
   //
   //    Assign the certificate subjectPublicKey to working_public_key.
   working_public_key_ = ParseAndCheckPublicKey(cert.tbs().spki_tlv, errors);
+  working_public_key_spki_ = cert.tbs().spki_tlv;
 
   // Note that steps e and f are omitted as they are handled by
   // the assignment to |working_spki| above. See the definition
@@ -1143,6 +1151,7 @@ void PathVerifier::ProcessRootCertificate(const ParsedCertificate& cert,
 
   // Use the certificate's SPKI and subject when verifying the next certificate.
   working_public_key_ = ParseAndCheckPublicKey(cert.tbs().spki_tlv, errors);
+  working_public_key_spki_ = cert.tbs().spki_tlv;
   working_normalized_issuer_name_ = cert.normalized_subject();
 }
 
@@ -1163,6 +1172,27 @@ bssl::UniquePtr<EVP_PKEY> PathVerifier::ParseAndCheckPublicKey(
   return pkey;
 }
 
+bool PathVerifier::VerifyCertificateSignature(const ParsedCertificate& cert) {
+  SignatureVerifyCache* cache = delegate_->GetVerifyCache();
+  if (!cache) {
+    return VerifySignedData(cert.signature_algorithm(),
+                            cert.tbs_certificate_tlv(), cert.signature_value(),
+                            working_public_key_.get());
+  }
+
+  std::string key = SignatureVerifyCache::ComputeKey(
+      cert.signature_algorithm_tlv(), cert.tbs_certificate_tlv(),
+      cert.signature_value(), working_public_key_spki_);
+  bool verified;
+  if (cache->Lookup(key, &verified))
+    return verified;
+  verified =
+      VerifySignedData(cert.signature_algorithm(), cert.tbs_certificate_tlv(),
+                       cert.signature_value(), working_public_key_.get());
+  cache->Store(key, verified);
+  return verified;
+}
+
 void PathVerifier::Run(
     const ParsedCertificateList& certs,
     const CertificateTrust& last_cert_trust,
@@ -1306,6 +1336,10 @@ void PathVerifier::Run(
 
 }  // namespace
 
+SignatureVerifyCache* VerifyCertificateChainDelegate::GetVerifyCache() {
+  return nullptr;
+}
+
 VerifyCertificateChainDelegate::~VerifyCertificateChainDelegate() = default;
 
 void VerifyCertificateChain(
@@ -22,6 +22,7 @@ struct GeneralizedTime;
 }
 
 struct CertificateTrust;
+class SignatureVerifyCache;
 
 // The key purpose (extended key usage) to check for during verification.
 enum class KeyPurpose {
@@ -66,6 +67,11 @@ class NET_EXPORT VerifyCertificateChainDelegate {
   virtual bool IsPublicKeyAcceptable(EVP_PKEY* public_key,
                                      CertErrors* errors) = 0;
 
+  // Implementations can return a cache for the results of signature checks,
+  // which must outlive the verification. The default implementation returns
+  // nullptr, checking every signature.
+  virtual SignatureVerifyCache* GetVerifyCache();
+
   virtual ~VerifyCertificateChainDelegate();
 };
 
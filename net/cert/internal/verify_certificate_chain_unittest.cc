@@ -4,6 +4,7 @@
 
 #include "net/cert/internal/verify_certificate_chain.h"
 
+#include "net/cert/internal/signature_verify_cache.h"
 #include "net/cert/internal/simple_path_builder_delegate.h"
 #include "net/cert/internal/test_helpers.h"
 #include "net/cert/internal/trust_store.h"
@@ -33,10 +34,53 @@ class VerifyCertificateChainTestDelegate {
   }
 };
 
+class CachingPathBuilderDelegate : public SimplePathBuilderDelegate {
+ public:
+  explicit CachingPathBuilderDelegate(SignatureVerifyCache* verify_cache)
+      : SimplePathBuilderDelegate(
+            1024,
+            SimplePathBuilderDelegate::DigestPolicy::kWeakAllowSha1),
+        verify_cache_(verify_cache) {}
+
+  SignatureVerifyCache* GetVerifyCache() override { return verify_cache_; }
+
+ private:
+  SignatureVerifyCache* verify_cache_;
+};
+
+// Verifies each chain twice with a SignatureVerifyCache. The second time the
+// signature checks are answered by the cache, and the errors must not change.
+class VerifyCertificateChainWithVerifyCacheTestDelegate {
+ public:
+  static void Verify(const VerifyCertChainTest& test,
+                     const std::string& test_file_path) {
+    SignatureVerifyCache verify_cache(16);
+    CachingPathBuilderDelegate delegate(&verify_cache);
+
+    for (int i = 0; i < 2; ++i) {
+      CertPathErrors errors;
+      VerifyCertificateChain(
+          test.chain, test.last_cert_trust, &delegate, test.time,
+          test.key_purpose, test.initial_explicit_policy,
+          test.user_initial_policy_set, test.initial_policy_mapping_inhibit,
+          test.initial_any_policy_inhibit,
+          nullptr /*user_constrained_policy_set*/, &errors);
+      VerifyCertPathErrors(test.expected_errors, errors, test.chain,
+                           test_file_path);
+    }
+    EXPECT_EQ(verify_cache.misses(), verify_cache.hits());
+  }
+};
+
 }  // namespace
 
 INSTANTIATE_TYPED_TEST_SUITE_P(VerifyCertificateChain,
                                VerifyCertificateChainSingleRootTest,
                                VerifyCertificateChainTestDelegate);
 
+INSTANTIATE_TYPED_TEST_SUITE_P(
+    VerifyCertificateChainWithVerifyCache,
+    VerifyCertificateChainSingleRootTest,
+    VerifyCertificateChainWithVerifyCacheTestDelegate);
+
 }  // namespace net
@@ -399,7 +399,7 @@ bool X509Certificate::GetSubjectAltName(
   if (!tbs.has_extensions)
     return false;
 
-  std::map<der::Input, ParsedExtension> extensions;
+  ParsedExtensionMap extensions;
   if (!ParseExtensions(tbs.extensions_tlv, &extensions))
     return false;
 
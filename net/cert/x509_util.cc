@@ -5,7 +5,6 @@
 #include "net/cert/x509_util.h"
 
 #include <string.h>
-#include <map>
 #include <memory>
 
 #include "base/lazy_instance.h"
@@ -415,7 +414,7 @@ bool SignatureVerifierInitWithCertificate(
 
   // The key usage extension, if present, must assert the digitalSignature bit.
   if (tbs.has_extensions) {
-    std::map<der::Input, ParsedExtension> extensions;
+    ParsedExtensionMap extensions;
     if (!ParseExtensions(tbs.extensions_tlv, &extensions)) {
       return false;
     }
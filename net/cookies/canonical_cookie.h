@@ -31,10 +31,10 @@ class NET_EXPORT CanonicalCookie {
   // the resulting CanonicalCookies should not be relied on to be canonical
   // unless the caller has done appropriate validation and canonicalization
   // themselves.
-  CanonicalCookie(const std::string& name,
-                  const std::string& value,
-                  const std::string& domain,
-                  const std::string& path,
+  CanonicalCookie(std::string name,
+                  std::string value,
+                  std::string domain,
+                  std::string path,
                   const base::Time& creation,
                   const base::Time& expiration,
                   const base::Time& last_access,
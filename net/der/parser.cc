@@ -11,6 +11,57 @@ namespace net {
 
 namespace der {
 
+namespace {
+
+// Reads the header of the TLV at the start of |cbs| without consuming it, for
+// the forms that make up nearly all of a certificate: a single-octet tag with
+// a tag number other than 0, and a length of at most two octets. Returns false
+// if the header is in any other form, or if the element does not fit in |cbs|,
+// in which case the caller falls back to CBS_get_any_asn1_element() to either
+// parse or reject it. Returning false is therefore not a parse error.
+//
+// On success, |*tag| is set in the CBS representation and |*header_len| and
+// |*value_len| to the lengths of the header and the value.
+bool PeekShortFormHeader(const CBS* cbs,
+                         Tag* tag,
+                         size_t* header_len,
+                         size_t* value_len) {
+  const uint8_t* data = CBS_data(cbs);
+  size_t len = CBS_len(cbs);
+  if (len < 2)
+    return false;
+
+  uint8_t tag_byte = data[0];
+  uint8_t tag_number = tag_byte & 0x1f;
+  if (tag_number == 0 || tag_number == 0x1f)
+    return false;
+
+  uint8_t length_byte = data[1];
+  if (length_byte < 0x80) {
+    *header_len = 2;
+    *value_len = length_byte;
+  } else if (length_byte == 0x81 && len >= 3 && data[2] >= 0x80) {
+    *header_len = 3;
+    *value_len = data[2];
+  } else if (length_byte == 0x82 && len >= 4 && data[2] != 0) {
+    *header_len = 4;
+    *value_len = (static_cast<size_t>(data[2]) << 8) | data[3];
+  } else {
+    // Longer and non-minimal lengths, indefinite lengths and truncated
+    // headers.
+    return false;
+  }
+
+  if (*value_len > len - *header_len)
+    return false;
+
+  *tag = (static_cast<Tag>(tag_byte & 0xe0) << CBS_ASN1_TAG_SHIFT) |
+         tag_number;
+  return true;
+}
+
+}  // namespace
+
 Parser::Parser() : advance_len_(0) {
   CBS_init(&cbs_, nullptr, 0);
 }
@@ -20,6 +71,14 @@ Parser::Parser(const Input& input) : advance_len_(0) {
 }
 
 bool Parser::PeekTagAndValue(Tag* tag, Input* out) {
+  size_t header_len;
+  size_t value_len;
+  if (PeekShortFormHeader(&cbs_, tag, &header_len, &value_len)) {
+    advance_len_ = header_len + value_len;
+    *out = Input(CBS_data(&cbs_) + header_len, value_len);
+    return true;
+  }
+
   CBS peeker = cbs_;
   CBS tmp_out;
   size_t header_len;
@@ -47,6 +106,14 @@ bool Parser::HasMore() {
 }
 
 bool Parser::ReadRawTLV(Input* out) {
+  Tag tag;
+  size_t header_len;
+  size_t value_len;
+  if (PeekShortFormHeader(&cbs_, &tag, &header_len, &value_len)) {
+    *out = Input(CBS_data(&cbs_), header_len + value_len);
+    return !!CBS_skip(&cbs_, header_len + value_len);
+  }
+
   CBS tmp_out;
   if (!CBS_get_any_asn1_element(&cbs_, &tmp_out, nullptr, nullptr))
     return false;
@@ -226,6 +226,60 @@ TEST(ParserTest, LengthMustNotHaveLeadingZeroes) {
   ASSERT_TRUE(parser.HasMore());
 }
 
+TEST(ParserTest, TwoOctetLength) {
+  // Tag: octet string; length: 2 bytes of length encoding a value of 256.
+  uint8_t der[4 + 256] = {0x04, 0x82, 0x01, 0x00};
+  Parser parser((Input(der)));
+
+  Tag tag;
+  Input value;
+  ASSERT_TRUE(parser.ReadTagAndValue(&tag, &value));
+  EXPECT_EQ(kOctetString, tag);
+  EXPECT_EQ(256u, value.Length());
+  EXPECT_EQ(der + 4, value.UnsafeData());
+  EXPECT_FALSE(parser.HasMore());
+}
+
+TEST(ParserTest, TwoOctetLengthMustNotHaveLeadingZero) {
+  // Tag: octet string; length: 2 bytes of length encoding a value of 128
+  // (it should be encoded in only 1 byte).
+  uint8_t der[4 + 128] = {0x04, 0x82, 0x00, 0x80};
+  Parser parser((Input(der)));
+
+  Tag tag;
+  Input value;
+  ASSERT_FALSE(parser.ReadTagAndValue(&tag, &value));
+  ASSERT_TRUE(parser.HasMore());
+  Input tlv;
+  ASSERT_FALSE(parser.ReadRawTLV(&tlv));
+  ASSERT_TRUE(parser.HasMore());
+}
+
+TEST(ParserTest, ReadRawTLVWithLongFormLength) {
+  uint8_t der[3 + 200 + 3] = {0x30, 0x81, 0xc8};
+  der[3 + 200] = 0x02;
+  der[3 + 200 + 1] = 0x01;
+  der[3 + 200 + 2] = 0x01;
+  Parser parser((Input(der)));
+
+  Input tlv;
+  ASSERT_TRUE(parser.ReadRawTLV(&tlv));
+  EXPECT_EQ(Input(der, 3 + 200), tlv);
+  uint64_t int_value;
+  ASSERT_TRUE(parser.ReadUint64(&int_value));
+  EXPECT_EQ(1u, int_value);
+  EXPECT_FALSE(parser.HasMore());
+}
+
+TEST(ParserTest, ReadRawTLVValueShorterThanLength) {
+  const uint8_t der[] = {0x04, 0x02, 0x84};
+  Parser parser((Input(der)));
+
+  Input tlv;
+  ASSERT_FALSE(parser.ReadRawTLV(&tlv));
+  ASSERT_TRUE(parser.HasMore());
+}
+
 TEST(ParserTest, ReadConstructedFailsForNonConstructedTags) {
   // Tag number is for SEQUENCE, but the constructed bit isn't set.
   const uint8_t der[] = {0x10, 0x00};
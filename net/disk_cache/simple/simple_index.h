@@ -9,11 +9,11 @@
 
 #include <list>
 #include <memory>
-#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/containers/hash_map.h"
 #include "base/feature_list.h"
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
@@ -171,7 +171,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   bool UpdateEntrySize(uint64_t entry_hash,
                        base::StrictNumeric<uint32_t> entry_size);
 
-  using EntrySet = std::unordered_map<uint64_t, EntryMetadata>;
+  using EntrySet = base::HashMap<uint64_t, EntryMetadata>;
 
   // Insert an entry in the given set if there is not already entry present.
   // Returns true if the set was modified.
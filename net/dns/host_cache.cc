@@ -5,8 +5,10 @@
 #include "net/dns/host_cache.h"
 
 #include <algorithm>
+#include <tuple>
 
 #include "base/bind.h"
+#include "base/hash.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/numerics/safe_conversions.h"
@@ -124,6 +126,16 @@ HostCache::Key::Key(const std::string& hostname,
 HostCache::Key::Key()
     : Key("", DnsQueryType::UNSPECIFIED, 0, HostResolverSource::ANY) {}
 
+size_t HostCache::KeyHash::operator()(const Key& key) const {
+  const uint32_t type_and_source =
+      static_cast<uint32_t>(key.dns_query_type) << 8 |
+      static_cast<uint32_t>(key.host_resolver_source);
+  return base::HashInts(
+      base::Hash(key.hostname),
+      base::HashInts32(type_and_source,
+                       static_cast<uint32_t>(key.host_resolver_flags)));
+}
+
 HostCache::Entry::Entry(int error, Source source, base::TimeDelta ttl)
     : error_(error), source_(source), ttl_(ttl) {
   DCHECK_GE(ttl_, base::TimeDelta());
@@ -717,11 +729,16 @@ std::unique_ptr<HostCache> HostCache::CreateDefaultCache() {
 void HostCache::EvictOneEntry(base::TimeTicks now) {
   DCHECK_LT(0u, entries_.size());
 
+  // Evicts the stale entry that expires first or, if none is stale, the entry
+  // that expires first. Ties go to the smallest key, so that the choice
+  // doesn't depend on the iteration order of |entries_|.
   auto oldest_it = entries_.begin();
   for (auto it = entries_.begin(); it != entries_.end(); ++it) {
-    if ((it->second.expires() < oldest_it->second.expires()) &&
-        (it->second.IsStale(now, network_changes_) ||
-         !oldest_it->second.IsStale(now, network_changes_))) {
+    if (std::forward_as_tuple(!it->second.IsStale(now, network_changes_),
+                              it->second.expires(), it->first) <
+        std::forward_as_tuple(
+            !oldest_it->second.IsStale(now, network_changes_),
+            oldest_it->second.expires(), oldest_it->first)) {
       oldest_it = it;
     }
   }
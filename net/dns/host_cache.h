@@ -8,13 +8,13 @@
 #include <stddef.h>
 
 #include <functional>
-#include <map>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "base/containers/hash_map.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/macros.h"
@@ -64,12 +64,23 @@ class NET_EXPORT HostCache {
                       other.hostname, other.host_resolver_source);
     }
 
+    bool operator==(const Key& other) const {
+      return std::tie(dns_query_type, host_resolver_flags, hostname,
+                      host_resolver_source) ==
+             std::tie(other.dns_query_type, other.host_resolver_flags,
+                      other.hostname, other.host_resolver_source);
+    }
+
     std::string hostname;
     DnsQueryType dns_query_type;
     HostResolverFlags host_resolver_flags;
     HostResolverSource host_resolver_source;
   };
 
+  struct NET_EXPORT KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
   struct NET_EXPORT EntryStaleness {
     // Time since the entry's TTL has expired. Negative if not expired.
     base::TimeDelta expired_by;
@@ -236,7 +247,8 @@ class NET_EXPORT HostCache {
     virtual void ScheduleWrite() = 0;
   };
 
-  using EntryMap = std::map<Key, Entry>;
+  // Iteration order is unspecified.
+  using EntryMap = base::HashMap<Key, Entry, KeyHash>;
 
   // A HostCache::EntryStaleness representing a non-stale (fresh) cache entry.
   static const HostCache::EntryStaleness kNotStale;
@@ -528,7 +528,36 @@ TEST(HostCacheTest, EvictStale) {
   EXPECT_FALSE(cache.LookupStale(key3, now, &stale));
 }
 
-// Tests the less than and equal operators for HostCache::Key work.
+// Stale entries are evicted first, even if they would expire later than a
+// fresh one.
+TEST(HostCacheTest, EvictStaleBeforeFresh) {
+  HostCache cache(2);
+
+  base::TimeTicks now;
+  HostCache::EntryStaleness stale;
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Key key2 = Key("foobar2.com");
+  HostCache::Key key3 = Key("foobar3.com");
+  HostCache::Entry entry =
+      HostCache::Entry(OK, AddressList(), HostCache::Entry::SOURCE_UNKNOWN);
+
+  // |key2| expires in 20 seconds, but goes stale on a network change.
+  cache.Set(key2, entry, now, base::TimeDelta::FromSeconds(20));
+  cache.OnNetworkChange();
+  // |key1| expires in 5 seconds.
+  cache.Set(key1, entry, now, base::TimeDelta::FromSeconds(5));
+  EXPECT_EQ(2u, cache.size());
+
+  // |key2| should be chosen for eviction, since it is stale.
+  cache.Set(key3, entry, now, base::TimeDelta::FromSeconds(10));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.Lookup(key1, now));
+  EXPECT_FALSE(cache.LookupStale(key2, now, &stale));
+  EXPECT_TRUE(cache.Lookup(key3, now));
+}
+
+// Tests the less than and equal operators and the hash for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
     // Inputs.
@@ -594,14 +623,18 @@ TEST(HostCacheTest, KeyComparators) {
       case -1:
         EXPECT_TRUE(key1 < key2);
         EXPECT_FALSE(key2 < key1);
+        EXPECT_FALSE(key1 == key2);
         break;
       case 0:
         EXPECT_FALSE(key1 < key2);
         EXPECT_FALSE(key2 < key1);
+        EXPECT_TRUE(key1 == key2);
+        EXPECT_EQ(HostCache::KeyHash()(key1), HostCache::KeyHash()(key2));
         break;
       case 1:
         EXPECT_FALSE(key1 < key2);
         EXPECT_TRUE(key2 < key1);
+        EXPECT_FALSE(key1 == key2);
         break;
       default:
         FAIL() << "Invalid expectation. Can be only -1, 0, 1";
@@ -8,6 +8,8 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback.h"
@@ -110,6 +112,11 @@ const int kLoadDelayMilliseconds = 0;
 const int kLoadDelayMilliseconds = 0;
 #endif
 
+// The number of cookies the full load reads in each background task before
+// yielding, so that a priority load queued behind it waits for at most one
+// batch. Domain keys are never split across batches.
+const int kLoadBatchSize = 512;
+
 // A little helper to help us log (on client thread) if the background runner
 // gets stuck.
 class TimeoutTracker : public base::RefCountedThreadSafe<TimeoutTracker> {
@@ -156,10 +163,11 @@ base::TaskPriority GetCookieStoreBackgroundSequencePriority() {
 // SQLitePersistentCookieStore::Load is called to load all cookies.  It
 // delegates to Backend::Load, which posts a Backend::LoadAndNotifyOnDBThread
 // task to the background runner.  This task calls Backend::ChainLoadCookies(),
-// which repeatedly posts itself to the BG runner to load each eTLD+1's cookies
-// in separate tasks.  When this is complete, Backend::CompleteLoadOnIOThread is
-// posted to the client runner, which notifies the caller of
-// SQLitePersistentCookieStore::Load that the load is complete.
+// which repeatedly posts itself to the BG runner to load batches of eTLD+1s'
+// cookies in separate tasks.  When this is complete,
+// Backend::CompleteLoadOnIOThread is posted to the client runner, which
+// notifies the caller of SQLitePersistentCookieStore::Load that the load is
+// complete.
 //
 // If a priority load request is invoked via SQLitePersistentCookieStore::
 // LoadCookiesForKey, it is delegated to Backend::LoadCookiesForKey, which posts
@@ -305,9 +313,9 @@ class SQLitePersistentCookieStore::Backend
   // Initialize the data base.
   bool InitializeDatabase();
 
-  // Loads cookies for the next domain key from the DB, then either reschedules
-  // itself or schedules the provided callback to run on the client runner (if
-  // all domains are loaded).
+  // Loads cookies for the next domain keys from the DB, up to about
+  // kLoadBatchSize cookies, then either reschedules itself or schedules the
+  // provided callback to run on the client runner (if all domains are loaded).
   void ChainLoadCookies(const LoadedCallback& loaded_callback);
 
   // Load all cookies for a set of domains/hosts. The error recovery code
@@ -626,7 +634,10 @@ void SQLitePersistentCookieStore::Backend::LoadAndNotifyInBackground(
     PostClientTask(FROM_HERE, base::Bind(&Backend::CompleteLoadInForeground,
                                          this, loaded_callback, false));
   } else {
-    ChainLoadCookies(loaded_callback);
+    // Yield before the first batch, so that priority loads requested while the
+    // database was opening are served first.
+    PostBackgroundTask(FROM_HERE, base::BindOnce(&Backend::ChainLoadCookies,
+                                                 this, loaded_callback));
   }
 }
 
@@ -853,11 +864,16 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
   if (!db_) {
     // Close() has been called on this store.
     load_success = false;
-  } else if (keys_to_load_.size() > 0) {
-    // Load cookies for the first domain key.
-    auto it = keys_to_load_.begin();
-    load_success = LoadCookiesForDomains(it->second);
-    keys_to_load_.erase(it);
+  } else {
+    // Load cookies for the first domain keys. Loading a key at a time costs a
+    // task per key, which dominates for profiles with many small domains.
+    int batch_start = num_cookies_read_;
+    while (load_success && !keys_to_load_.empty() &&
+           num_cookies_read_ - batch_start < kLoadBatchSize) {
+      auto it = keys_to_load_.begin();
+      load_success = LoadCookiesForDomains(it->second);
+      keys_to_load_.erase(it);
+    }
   }
 
   // If load is successful and there are more domain keys to be loaded,
@@ -945,37 +961,75 @@ bool SQLitePersistentCookieStore::Backend::MakeCookiesFromSQLStatement(
   DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
   sql::Statement& smt = *statement;
   bool ok = true;
+
+  // All rows are read before any value is decrypted, so that a single timeout
+  // tracker covers the decryptions of the statement without also timing the
+  // SQL stepping.
+  struct CookieRow {
+    std::string name;
+    std::string value;
+    std::string encrypted_value;
+    std::string domain;
+    std::string path;
+    Time creation_utc;
+    Time expires_utc;
+    Time last_access_utc;
+    bool secure;
+    bool http_only;
+    CookieSameSite same_site;
+    CookiePriority priority;
+    bool decryption_failed = false;
+  };
+  std::vector<CookieRow> rows;
+  bool needs_decryption = false;
   while (smt.Step()) {
     ++num_cookies_read_;
-    std::string value;
+    CookieRow row;
+    row.name = smt.ColumnString(2);
     std::string encrypted_value = smt.ColumnString(4);
     if (!encrypted_value.empty() && crypto_) {
-      scoped_refptr<TimeoutTracker> timeout_tracker =
-          TimeoutTracker::Begin(client_task_runner_);
-      bool decrypt_ok = crypto_->DecryptString(encrypted_value, &value);
-      timeout_tracker->End();
-      if (!decrypt_ok) {
+      row.encrypted_value = std::move(encrypted_value);
+      needs_decryption = true;
+    } else {
+      row.value = smt.ColumnString(3);
+    }
+    row.domain = smt.ColumnString(1);
+    row.path = smt.ColumnString(5);
+    row.creation_utc = Time::FromInternalValue(smt.ColumnInt64(0));
+    row.expires_utc = Time::FromInternalValue(smt.ColumnInt64(6));
+    row.last_access_utc = Time::FromInternalValue(smt.ColumnInt64(10));
+    row.secure = smt.ColumnInt(7) != 0;
+    row.http_only = smt.ColumnInt(8) != 0;
+    row.same_site = DBCookieSameSiteToCookieSameSite(
+        static_cast<DBCookieSameSite>(smt.ColumnInt(9)));
+    row.priority = DBCookiePriorityToCookiePriority(
+        static_cast<DBCookiePriority>(smt.ColumnInt(13)));
+    rows.push_back(std::move(row));
+  }
+
+  if (needs_decryption) {
+    scoped_refptr<TimeoutTracker> timeout_tracker =
+        TimeoutTracker::Begin(client_task_runner_);
+    for (CookieRow& row : rows) {
+      if (row.encrypted_value.empty())
+        continue;
+      if (!crypto_->DecryptString(row.encrypted_value, &row.value)) {
         RecordCookieLoadProblem(COOKIE_LOAD_PROBLEM_DECRYPT_FAILED);
         ok = false;
-        continue;
+        row.decryption_failed = true;
       }
-    } else {
-      value = smt.ColumnString(3);
     }
+    timeout_tracker->End();
+  }
+
+  for (CookieRow& row : rows) {
+    if (row.decryption_failed)
+      continue;
     std::unique_ptr<CanonicalCookie> cc(std::make_unique<CanonicalCookie>(
-        smt.ColumnString(2),                           // name
-        value,                                         // value
-        smt.ColumnString(1),                           // domain
-        smt.ColumnString(5),                           // path
-        Time::FromInternalValue(smt.ColumnInt64(0)),   // creation_utc
-        Time::FromInternalValue(smt.ColumnInt64(6)),   // expires_utc
-        Time::FromInternalValue(smt.ColumnInt64(10)),  // last_access_utc
-        smt.ColumnInt(7) != 0,                         // secure
-        smt.ColumnInt(8) != 0,                         // http_only
-        DBCookieSameSiteToCookieSameSite(
-            static_cast<DBCookieSameSite>(smt.ColumnInt(9))),  // samesite
-        DBCookiePriorityToCookiePriority(
-            static_cast<DBCookiePriority>(smt.ColumnInt(13)))));  // priority
+        std::move(row.name), std::move(row.value), std::move(row.domain),
+        std::move(row.path), row.creation_utc, row.expires_utc,
+        row.last_access_utc, row.secure, row.http_only, row.same_site,
+        row.priority));
     DLOG_IF(WARNING, cc->CreationDate() > Time::Now())
         << L"CreationDate too recent";
     if (cc->IsCanonical()) {
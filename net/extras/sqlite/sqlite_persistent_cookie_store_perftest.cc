@@ -129,7 +129,8 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
     perf_measurement_start_ = base::Time::Now();
   }
 
-  void EndPerfMeasurement() {
+  // Reports the time since StartPerfMeasurement(), and returns it.
+  base::TimeDelta EndPerfMeasurement() {
     DCHECK(!perf_measurement_start_.is_null());
     base::TimeDelta elapsed = base::Time::Now() - perf_measurement_start_;
     perf_measurement_start_ = base::Time();
@@ -138,6 +139,7 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
     perf_test::PrintResult(
         test_info->test_case_name(), std::string(".") + test_info->name(),
         "time", static_cast<double>(elapsed.InMilliseconds()), "ms", true);
+    return elapsed;
   }
 
  protected:
@@ -173,13 +175,32 @@ TEST_F(SQLitePersistentCookieStorePerfTest, TestLoadForKeyPerformance) {
   }
 }
 
+// Test the time until the cookies for the first domain key are available,
+// which is what the first request on a fresh profile waits for. This includes
+// opening the database.
+TEST_F(SQLitePersistentCookieStorePerfTest, TestTimeToFirstCookie) {
+  StartPerfMeasurement();
+  store_->LoadCookiesForKey(
+      "domain_0.com",
+      base::Bind(&SQLitePersistentCookieStorePerfTest::OnKeyLoaded,
+                 base::Unretained(this)));
+  key_loaded_event_.Wait();
+  EndPerfMeasurement();
+
+  ASSERT_EQ(static_cast<size_t>(kCookiesPerDomain), cookies_.size());
+}
+
 // Test the performance of load
 TEST_F(SQLitePersistentCookieStorePerfTest, TestLoadPerformance) {
   StartPerfMeasurement();
   Load();
-  EndPerfMeasurement();
+  base::TimeDelta elapsed = EndPerfMeasurement();
 
   ASSERT_EQ(kNumDomains * kCookiesPerDomain, static_cast<int>(cookies_.size()));
+  perf_test::PrintResult("SQLitePersistentCookieStorePerfTest",
+                         ".TestLoadPerformance", "throughput",
+                         cookies_.size() / elapsed.InSecondsF(), "cookies/s",
+                         false);
 }
 
 // Test deletion performance.
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 
 #include "base/bind.h"
@@ -404,7 +405,7 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
   // (active:)
   // 1. Wait (on db_event)
   // (pending:)
-  // 2. "Init And Chain-Load First Domain"
+  // 2. "Init", which queues the chain-load behind the other tasks
   // 3. Priority Load (aaa.com)
   // 4. Wait (on db_event)
   db_thread_event_.Signal();
@@ -466,6 +467,91 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
                              NetLogEventPhase::NONE);
 }
 
+// Tests that the full load delivers every cookie exactly once when it takes
+// several batches, including for a domain key with more cookies than a batch.
+TEST_F(SQLitePersistentCookieStoreTest, TestLoadInBatches) {
+  const int kNumDomains = 1000;
+  const int kNumCookiesOnLargeDomain = 600;
+  InitializeStore(false, false);
+  base::Time t = base::Time::Now();
+  for (int i = 0; i < kNumDomains; ++i) {
+    t += base::TimeDelta::FromMicroseconds(10);
+    AddCookie("A", "B", base::StringPrintf("www.domain%04d.com", i), "/", t);
+  }
+  for (int i = 0; i < kNumCookiesOnLargeDomain; ++i) {
+    t += base::TimeDelta::FromMicroseconds(10);
+    AddCookie(base::StringPrintf("A%d", i), "B", "www.large.com", "/", t);
+  }
+  DestroyStore();
+
+  CanonicalCookieVector cookies;
+  CreateAndLoad(false, false, &cookies);
+  std::set<std::pair<std::string, std::string>> loaded;
+  for (const auto& cookie : cookies)
+    loaded.insert(std::make_pair(cookie->Domain(), cookie->Name()));
+  EXPECT_EQ(static_cast<size_t>(kNumDomains + kNumCookiesOnLargeDomain),
+            cookies.size());
+  EXPECT_EQ(cookies.size(), loaded.size());
+}
+
+// Tests that a priority load requested once the full load has started is
+// served between its batches, rather than after all of them.
+TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKeyYieldsBatches) {
+  const int kNumDomains = 1500;
+  InitializeStore(false, false);
+  base::Time t = base::Time::Now();
+  for (int i = 0; i < kNumDomains; ++i) {
+    t += base::TimeDelta::FromMicroseconds(10);
+    AddCookie("A", "B", base::StringPrintf("www.domain%04d.com", i), "/", t);
+  }
+  // Sorts after every other domain key, so the full load reaches it last.
+  t += base::TimeDelta::FromMicroseconds(10);
+  AddCookie("A", "B", "www.zzz.com", "/", t);
+  DestroyStore();
+
+  // As in TestLoadCookiesForKey, client tasks run on the current thread so
+  // that blocking the background runner doesn't block them.
+  Create(false /* crypt_cookies */, false /* restore_old_session_cookies */,
+         true /* use_current_thread */);
+
+  // Block the background runner until the first batch of the full load has
+  // been queued behind a second blocking task.
+  background_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                                base::Unretained(this)));
+  store_->Load(base::Bind(&SQLitePersistentCookieStoreTest::OnLoaded,
+                          base::Unretained(this)),
+               net_log_.bound());
+  base::WaitableEvent blocked(base::WaitableEvent::ResetPolicy::AUTOMATIC,
+                              base::WaitableEvent::InitialState::NOT_SIGNALED);
+  background_task_runner_->PostTask(
+      FROM_HERE, base::BindLambdaForTesting([&]() {
+        blocked.Signal();
+        WaitOnDBEvent();
+      }));
+  db_thread_event_.Signal();
+  blocked.Wait();
+
+  // The background runner now runs the first batch, then the priority load.
+  base::RunLoop run_loop;
+  store_->LoadCookiesForKey(
+      "zzz.com", base::Bind(&SQLitePersistentCookieStoreTest::OnKeyLoaded,
+                            base::Unretained(this), run_loop.QuitClosure()));
+  db_thread_event_.Signal();
+  run_loop.Run();
+  EXPECT_FALSE(loaded_event_.IsSignaled());
+  ASSERT_EQ(1u, cookies_.size());
+  EXPECT_EQ("www.zzz.com", cookies_[0]->Domain());
+  cookies_.clear();
+
+  RunUntilIdle();
+  EXPECT_TRUE(loaded_event_.IsSignaled());
+  EXPECT_EQ(static_cast<size_t>(kNumDomains), cookies_.size());
+  for (const auto& cookie : cookies_)
+    EXPECT_NE("www.zzz.com", cookie->Domain());
+  cookies_.clear();
+}
+
 TEST_F(SQLitePersistentCookieStoreTest, TestBeforeFlushCallback) {
   InitializeStore(false, false);
 
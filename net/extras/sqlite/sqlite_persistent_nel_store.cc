@@ -0,0 +1,492 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/extras/sqlite/sqlite_persistent_nel_store.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/optional.h"
+#include "base/sequenced_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
+#include "net/base/ip_address.h"
+#include "sql/database.h"
+#include "sql/error_delegate_util.h"
+#include "sql/meta_table.h"
+#include "sql/statement.h"
+#include "sql/transaction.h"
+#include "url/origin.h"
+
+namespace net {
+
+namespace {
+
+// Version number of the database.
+const int kCurrentVersionNumber = 1;
+const int kCompatibleVersionNumber = 1;
+
+// Commit every 30 seconds, or as soon as 512 operations are outstanding. The
+// policies are not security-sensitive, so they use the cookie store's
+// thresholds rather than the channel ID store's.
+const int kCommitIntervalSeconds = 30;
+const size_t kCommitAfterBatchSize = 512;
+
+// Used in the NetworkErrorLogging.DBLoadStatus histogram. Do not change or
+// re-use values.
+enum DbLoadStatus {
+  // The path for the directory containing the db doesn't exist and couldn't be
+  // created.
+  PATH_DOES_NOT_EXIST = 0,
+  // Unable to open the database.
+  FAILED_TO_OPEN = 1,
+  // Failed to migrate the db to the current version.
+  MIGRATION_FAILED = 2,
+  // Unable to execute SELECT statement to load contents from db.
+  INVALID_SELECT_STATEMENT = 3,
+  // New database successfully created.
+  NEW_DB = 4,
+  // Database successfully loaded.
+  LOADED = 5,
+  // Database loaded, but one or more policies were skipped.
+  LOADED_WITH_ERRORS = 6,
+  DB_LOAD_STATUS_MAX
+};
+
+void RecordDbLoadStatus(DbLoadStatus status) {
+  UMA_HISTOGRAM_ENUMERATION("NetworkErrorLogging.DBLoadStatus", status,
+                            DB_LOAD_STATUS_MAX);
+}
+
+}  // namespace
+
+// This class is designed to be shared between the client sequence and the
+// background task runner. It batches operations and commits them on a timer.
+class SQLitePersistentNelStore::Backend
+    : public base::RefCountedThreadSafe<SQLitePersistentNelStore::Backend> {
+ public:
+  Backend(
+      const base::FilePath& path,
+      const scoped_refptr<base::SequencedTaskRunner>& background_task_runner)
+      : path_(path),
+        num_pending_(0),
+        background_task_runner_(background_task_runner),
+        corruption_detected_(false) {}
+
+  // Creates or loads the SQLite database.
+  void Load(NelPoliciesLoadedCallback loaded_callback);
+
+  // Batch a policy addition or deletion.
+  void AddNelPolicy(const NetworkErrorLoggingService::NelPolicy& policy);
+  void DeleteNelPolicy(const NetworkErrorLoggingService::NelPolicy& policy);
+
+  // Commit any pending operations and close the database. This must be called
+  // before the object is destructed.
+  void Close();
+
+  // Posts a task to flush pending operations to the database.
+  void Flush();
+
+ private:
+  friend class base::RefCountedThreadSafe<SQLitePersistentNelStore::Backend>;
+
+  struct PendingOperation {
+    enum Type { NEL_POLICY_ADD, NEL_POLICY_DELETE };
+
+    PendingOperation(Type type,
+                     const NetworkErrorLoggingService::NelPolicy& policy)
+        : type(type), policy(policy) {}
+
+    Type type;
+    NetworkErrorLoggingService::NelPolicy policy;
+  };
+
+  using PendingOperationsList = std::vector<PendingOperation>;
+
+  // You should call Close() before destructing this object.
+  ~Backend() {
+    DCHECK(!db_.get()) << "Close should have already been called.";
+    DCHECK_EQ(0u, num_pending_);
+    DCHECK(pending_.empty());
+  }
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> LoadInBackground();
+
+  // Database upgrade statements.
+  bool EnsureDatabaseVersion();
+
+  void BatchOperation(PendingOperation::Type type,
+                      const NetworkErrorLoggingService::NelPolicy& policy);
+  // Commit our pending operations to the database.
+  void Commit();
+  // Close() executed on the background task runner.
+  void InternalBackgroundClose();
+
+  void DatabaseErrorCallback(int error, sql::Statement* stmt);
+  void KillDatabase();
+
+  const base::FilePath path_;
+  std::unique_ptr<sql::Database> db_;
+  sql::MetaTable meta_table_;
+
+  PendingOperationsList pending_;
+  PendingOperationsList::size_type num_pending_;
+  // Guard |pending_| and |num_pending_|.
+  base::Lock lock_;
+
+  scoped_refptr<base::SequencedTaskRunner> background_task_runner_;
+
+  // Indicates if the kill-database callback has been scheduled.
+  bool corruption_detected_;
+
+  DISALLOW_COPY_AND_ASSIGN(Backend);
+};
+
+void SQLitePersistentNelStore::Backend::Load(
+    NelPoliciesLoadedCallback loaded_callback) {
+  // This function should be called only once per instance.
+  DCHECK(!db_.get());
+  base::PostTaskAndReplyWithResult(
+      background_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&Backend::LoadInBackground, this),
+      std::move(loaded_callback));
+}
+
+std::vector<NetworkErrorLoggingService::NelPolicy>
+SQLitePersistentNelStore::Backend::LoadInBackground() {
+  DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
+
+  // This method should be called only once per instance.
+  DCHECK(!db_.get());
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> policies;
+
+  // Ensure the parent directory for storing policies is created before reading
+  // from it.
+  const base::FilePath dir = path_.DirName();
+  if (!base::PathExists(dir) && !base::CreateDirectory(dir)) {
+    RecordDbLoadStatus(PATH_DOES_NOT_EXIST);
+    return policies;
+  }
+
+  db_.reset(new sql::Database);
+  db_->set_histogram_tag("NetworkErrorLogging");
+
+  // Unretained to avoid a ref loop with db_.
+  db_->set_error_callback(
+      base::Bind(&SQLitePersistentNelStore::Backend::DatabaseErrorCallback,
+                 base::Unretained(this)));
+
+  DbLoadStatus load_result = LOADED;
+  if (!base::PathExists(path_))
+    load_result = NEW_DB;
+
+  if (!db_->Open(path_)) {
+    NOTREACHED() << "Unable to open NEL DB.";
+    if (corruption_detected_)
+      KillDatabase();
+    db_.reset();
+    RecordDbLoadStatus(FAILED_TO_OPEN);
+    return policies;
+  }
+
+  if (!EnsureDatabaseVersion()) {
+    NOTREACHED() << "Unable to open NEL DB.";
+    if (corruption_detected_)
+      KillDatabase();
+    meta_table_.Reset();
+    db_.reset();
+    RecordDbLoadStatus(MIGRATION_FAILED);
+    return policies;
+  }
+
+  db_->Preload();
+
+  sql::Statement count_smt(
+      db_->GetUniqueStatement("SELECT COUNT(*) FROM nel_policies"));
+  if (count_smt.Step())
+    policies.reserve(static_cast<size_t>(count_smt.ColumnInt64(0)));
+
+  sql::Statement smt(db_->GetUniqueStatement(
+      "SELECT origin_scheme, origin_host, origin_port, received_ip_address, "
+      "report_to, expires, success_fraction, failure_fraction, "
+      "include_subdomains FROM nel_policies"));
+  if (!smt.is_valid()) {
+    if (corruption_detected_)
+      KillDatabase();
+    meta_table_.Reset();
+    db_.reset();
+    RecordDbLoadStatus(INVALID_SELECT_STATEMENT);
+    return policies;
+  }
+
+  while (smt.Step()) {
+    // The stored tuple came from a valid origin, so it does not need to be
+    // canonicalized again; this only rejects rows that were tampered with.
+    base::Optional<url::Origin> origin =
+        url::Origin::UnsafelyCreateTupleOriginWithoutNormalization(
+            smt.ColumnString(0), smt.ColumnString(1),
+            static_cast<uint16_t>(smt.ColumnInt(2)));
+    if (!origin) {
+      load_result = LOADED_WITH_ERRORS;
+      continue;
+    }
+
+    NetworkErrorLoggingService::NelPolicy policy;
+    policy.origin = std::move(*origin);
+    std::string received_ip_address = smt.ColumnString(3);
+    if (!received_ip_address.empty() &&
+        !policy.received_ip_address.AssignFromIPLiteral(received_ip_address)) {
+      load_result = LOADED_WITH_ERRORS;
+      continue;
+    }
+    policy.report_to = smt.ColumnString(4);
+    policy.expires = base::Time::FromDeltaSinceWindowsEpoch(
+        base::TimeDelta::FromMicroseconds(smt.ColumnInt64(5)));
+    policy.success_fraction = smt.ColumnDouble(6);
+    policy.failure_fraction = smt.ColumnDouble(7);
+    policy.include_subdomains = smt.ColumnBool(8);
+    policies.push_back(std::move(policy));
+  }
+
+  RecordDbLoadStatus(load_result);
+  return policies;
+}
+
+bool SQLitePersistentNelStore::Backend::EnsureDatabaseVersion() {
+  // Version check.
+  if (!meta_table_.Init(db_.get(), kCurrentVersionNumber,
+                        kCompatibleVersionNumber)) {
+    return false;
+  }
+
+  if (meta_table_.GetCompatibleVersionNumber() > kCurrentVersionNumber) {
+    LOG(WARNING) << "NEL database is too new.";
+    return false;
+  }
+
+  sql::Transaction transaction(db_.get());
+  if (!transaction.Begin())
+    return false;
+
+  // Create new table if it doesn't already exist. The origin is stored as its
+  // tuple so that loading it does not need to parse a URL.
+  if (!db_->DoesTableExist("nel_policies")) {
+    if (!db_->Execute("CREATE TABLE nel_policies ("
+                      "origin_scheme TEXT NOT NULL,"
+                      "origin_host TEXT NOT NULL,"
+                      "origin_port INTEGER NOT NULL,"
+                      "received_ip_address TEXT NOT NULL,"
+                      "report_to TEXT NOT NULL,"
+                      "expires INTEGER NOT NULL,"
+                      "success_fraction REAL NOT NULL,"
+                      "failure_fraction REAL NOT NULL,"
+                      "include_subdomains INTEGER NOT NULL,"
+                      "PRIMARY KEY (origin_scheme, origin_host, origin_port))"
+                      " WITHOUT ROWID")) {
+      return false;
+    }
+  }
+
+  // Put future migration cases here.
+
+  return transaction.Commit();
+}
+
+void SQLitePersistentNelStore::Backend::DatabaseErrorCallback(
+    int error,
+    sql::Statement* stmt) {
+  DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
+
+  if (!sql::IsErrorCatastrophic(error))
+    return;
+
+  if (corruption_detected_)
+    return;
+
+  corruption_detected_ = true;
+
+  // db_ may not be safe to reset at this point, so kill it from a new task.
+  background_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Backend::KillDatabase, this));
+}
+
+void SQLitePersistentNelStore::Backend::KillDatabase() {
+  DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
+
+  if (db_) {
+    // This Backend will now be in-memory only. In a future run the database
+    // will be recreated.
+    bool success = db_->RazeAndClose();
+    UMA_HISTOGRAM_BOOLEAN("NetworkErrorLogging.KillDatabaseResult", success);
+    meta_table_.Reset();
+    db_.reset();
+  }
+}
+
+void SQLitePersistentNelStore::Backend::AddNelPolicy(
+    const NetworkErrorLoggingService::NelPolicy& policy) {
+  BatchOperation(PendingOperation::NEL_POLICY_ADD, policy);
+}
+
+void SQLitePersistentNelStore::Backend::DeleteNelPolicy(
+    const NetworkErrorLoggingService::NelPolicy& policy) {
+  BatchOperation(PendingOperation::NEL_POLICY_DELETE, policy);
+}
+
+void SQLitePersistentNelStore::Backend::BatchOperation(
+    PendingOperation::Type type,
+    const NetworkErrorLoggingService::NelPolicy& policy) {
+  PendingOperationsList::size_type num_pending;
+  {
+    base::AutoLock locked(lock_);
+    pending_.emplace_back(type, policy);
+    num_pending = ++num_pending_;
+  }
+
+  if (num_pending == 1) {
+    // We've gotten our first entry for this batch, fire off the timer.
+    background_task_runner_->PostDelayedTask(
+        FROM_HERE, base::BindOnce(&Backend::Commit, this),
+        base::TimeDelta::FromSeconds(kCommitIntervalSeconds));
+  } else if (num_pending == kCommitAfterBatchSize) {
+    // We've reached a big enough batch, fire off a commit now.
+    background_task_runner_->PostTask(FROM_HERE,
+                                      base::BindOnce(&Backend::Commit, this));
+  }
+}
+
+void SQLitePersistentNelStore::Backend::Flush() {
+  if (background_task_runner_->RunsTasksInCurrentSequence()) {
+    Commit();
+  } else {
+    background_task_runner_->PostTask(FROM_HERE,
+                                      base::BindOnce(&Backend::Commit, this));
+  }
+}
+
+void SQLitePersistentNelStore::Backend::Commit() {
+  DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
+
+  PendingOperationsList ops;
+  {
+    base::AutoLock locked(lock_);
+    pending_.swap(ops);
+    num_pending_ = 0;
+  }
+
+  // Maybe an old timer fired or we are already Close()'ed.
+  if (!db_.get() || ops.empty())
+    return;
+
+  // The primary key makes an add replace any stored policy for the origin.
+  sql::Statement add_statement(db_->GetCachedStatement(
+      SQL_FROM_HERE,
+      "INSERT OR REPLACE INTO nel_policies (origin_scheme, origin_host, "
+      "origin_port, received_ip_address, report_to, expires, "
+      "success_fraction, failure_fraction, include_subdomains) "
+      "VALUES (?,?,?,?,?,?,?,?,?)"));
+  if (!add_statement.is_valid())
+    return;
+
+  sql::Statement del_statement(db_->GetCachedStatement(
+      SQL_FROM_HERE,
+      "DELETE FROM nel_policies WHERE "
+      "origin_scheme=? AND origin_host=? AND origin_port=?"));
+  if (!del_statement.is_valid())
+    return;
+
+  sql::Transaction transaction(db_.get());
+  if (!transaction.Begin())
+    return;
+
+  for (const PendingOperation& op : ops) {
+    const NetworkErrorLoggingService::NelPolicy& policy = op.policy;
+    switch (op.type) {
+      case PendingOperation::NEL_POLICY_ADD:
+        add_statement.Reset(true);
+        add_statement.BindString(0, policy.origin.scheme());
+        add_statement.BindString(1, policy.origin.host());
+        add_statement.BindInt(2, policy.origin.port());
+        add_statement.BindString(3, policy.received_ip_address.IsValid()
+                                        ? policy.received_ip_address.ToString()
+                                        : std::string());
+        add_statement.BindString(4, policy.report_to);
+        add_statement.BindInt64(
+            5, policy.expires.ToDeltaSinceWindowsEpoch().InMicroseconds());
+        add_statement.BindDouble(6, policy.success_fraction);
+        add_statement.BindDouble(7, policy.failure_fraction);
+        add_statement.BindBool(8, policy.include_subdomains);
+        if (!add_statement.Run())
+          NOTREACHED() << "Could not add a NEL policy to the DB.";
+        break;
+
+      case PendingOperation::NEL_POLICY_DELETE:
+        del_statement.Reset(true);
+        del_statement.BindString(0, policy.origin.scheme());
+        del_statement.BindString(1, policy.origin.host());
+        del_statement.BindInt(2, policy.origin.port());
+        if (!del_statement.Run())
+          NOTREACHED() << "Could not delete a NEL policy from the DB.";
+        break;
+    }
+  }
+  transaction.Commit();
+}
+
+// Fire off a close message to the background task runner. We could still have
+// a pending commit timer that will be holding a reference on us, but if/when
+// this fires we will already have been cleaned up and it will be ignored.
+void SQLitePersistentNelStore::Backend::Close() {
+  // Must close the backend on the background task runner.
+  background_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Backend::InternalBackgroundClose, this));
+}
+
+void SQLitePersistentNelStore::Backend::InternalBackgroundClose() {
+  DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
+  // Commit any pending operations
+  Commit();
+  db_.reset();
+}
+
+SQLitePersistentNelStore::SQLitePersistentNelStore(
+    const base::FilePath& path,
+    const scoped_refptr<base::SequencedTaskRunner>& background_task_runner)
+    : backend_(new Backend(path, background_task_runner)) {}
+
+SQLitePersistentNelStore::~SQLitePersistentNelStore() {
+  backend_->Close();
+  // We release our reference to the Backend, though it will probably still
+  // have a reference if the background task runner has not run Close() yet.
+}
+
+void SQLitePersistentNelStore::LoadNelPolicies(
+    NelPoliciesLoadedCallback loaded_callback) {
+  backend_->Load(std::move(loaded_callback));
+}
+
+void SQLitePersistentNelStore::AddNelPolicy(
+    const NetworkErrorLoggingService::NelPolicy& policy) {
+  backend_->AddNelPolicy(policy);
+}
+
+void SQLitePersistentNelStore::DeleteNelPolicy(
+    const NetworkErrorLoggingService::NelPolicy& policy) {
+  backend_->DeleteNelPolicy(policy);
+}
+
+void SQLitePersistentNelStore::Flush() {
+  backend_->Flush();
+}
+
+}  // namespace net
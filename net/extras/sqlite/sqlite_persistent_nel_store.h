@@ -0,0 +1,54 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_EXTRAS_SQLITE_SQLITE_PERSISTENT_NEL_STORE_H_
+#define NET_EXTRAS_SQLITE_SQLITE_PERSISTENT_NEL_STORE_H_
+
+#include "base/component_export.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "net/network_error_logging/network_error_logging_service.h"
+
+namespace base {
+class FilePath;
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace net {
+
+// Implements the NetworkErrorLoggingService::PersistentNelStore interface in
+// terms of a SQLite database. Policies are keyed by the scheme, host and port
+// of their origin. All I/O happens on the background task runner; changes are
+// batched and committed on a timer, or when Flush() is called.
+class COMPONENT_EXPORT(NET_EXTRAS) SQLitePersistentNelStore
+    : public NetworkErrorLoggingService::PersistentNelStore {
+ public:
+  // Create or open persistent store in file |path|. All I/O tasks are performed
+  // in background using |background_task_runner|. Callbacks are run on the
+  // sequence the store is created on.
+  SQLitePersistentNelStore(
+      const base::FilePath& path,
+      const scoped_refptr<base::SequencedTaskRunner>& background_task_runner);
+
+  ~SQLitePersistentNelStore() override;
+
+  // NetworkErrorLoggingService::PersistentNelStore:
+  void LoadNelPolicies(NelPoliciesLoadedCallback loaded_callback) override;
+  void AddNelPolicy(
+      const NetworkErrorLoggingService::NelPolicy& policy) override;
+  void DeleteNelPolicy(
+      const NetworkErrorLoggingService::NelPolicy& policy) override;
+  void Flush() override;
+
+ private:
+  class Backend;
+
+  scoped_refptr<Backend> backend_;
+
+  DISALLOW_COPY_AND_ASSIGN(SQLitePersistentNelStore);
+};
+
+}  // namespace net
+
+#endif  // NET_EXTRAS_SQLITE_SQLITE_PERSISTENT_NEL_STORE_H_
@@ -0,0 +1,218 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/extras/sqlite/sqlite_persistent_nel_store.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/macros.h"
+#include "base/run_loop.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/post_task.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/test/simple_test_clock.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "base/time/time.h"
+#include "net/base/ip_address.h"
+#include "net/base/net_errors.h"
+#include "net/network_error_logging/network_error_logging_delegate.h"
+#include "net/reporting/reporting_cache.h"
+#include "net/reporting/reporting_client.h"
+#include "net/reporting/reporting_policy.h"
+#include "net/reporting/reporting_service.h"
+#include "net/reporting/reporting_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace net {
+
+namespace {
+
+const base::FilePath::CharType kNelFilename[] =
+    FILE_PATH_LITERAL("NetworkErrorLogging");
+
+const int kNumOrigins = 100000;
+const int kNumRequests = 100000;
+
+// Prime number noticeably larger than kNumOrigins, so that multiplying it by
+// an incrementing index modulo kNumOrigins visits the origins in a
+// reproducible but scattered order.
+const int kRandomSeed = 1000003;
+static_assert(kRandomSeed > 10 * kNumOrigins,
+              "kRandomSeed not high enough for number of origins");
+
+const char kGroup[] = "group";
+
+GURL UrlForIndex(int i) {
+  return GURL(base::StringPrintf("https://origin%d.test/", i));
+}
+
+class SQLitePersistentNelStorePerfTest : public testing::Test {
+ protected:
+  SQLitePersistentNelStorePerfTest() = default;
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    CreateStore();
+    ASSERT_TRUE(Load().empty());
+    for (int i = 0; i < kNumOrigins; ++i) {
+      NetworkErrorLoggingService::NelPolicy policy;
+      policy.origin = url::Origin::Create(UrlForIndex(i));
+      policy.received_ip_address = IPAddress(192, 168, 0, 1);
+      policy.report_to = kGroup;
+      policy.expires = base::Time::Now() + base::TimeDelta::FromDays(1);
+      store_->AddNelPolicy(policy);
+    }
+    // Destroy the store, forcing it to write its data to disk, and reopen it.
+    store_.reset();
+    scoped_task_environment_.RunUntilIdle();
+    CreateStore();
+  }
+
+  void TearDown() override {
+    store_.reset();
+    scoped_task_environment_.RunUntilIdle();
+  }
+
+  void CreateStore() {
+    store_ = std::make_unique<SQLitePersistentNelStore>(
+        temp_dir_.GetPath().Append(kNelFilename), background_task_runner_);
+  }
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> Load() {
+    std::vector<NetworkErrorLoggingService::NelPolicy> policies;
+    base::RunLoop run_loop;
+    store_->LoadNelPolicies(base::BindOnce(
+        [](base::RunLoop* run_loop,
+           std::vector<NetworkErrorLoggingService::NelPolicy>* out,
+           std::vector<NetworkErrorLoggingService::NelPolicy> policies) {
+          *out = std::move(policies);
+          run_loop->Quit();
+        },
+        &run_loop, &policies));
+    run_loop.Run();
+    return policies;
+  }
+
+  // Returns an index into the stored origins. The sequence is scattered but
+  // the same on each run, for reproducibility.
+  int NextIndex() {
+    return static_cast<int>((++seed_multiple_ * kRandomSeed) % kNumOrigins);
+  }
+
+  void PrintResult(const std::string& measurement,
+                   const std::string& trace,
+                   double value,
+                   const std::string& units) {
+    perf_test::PrintResult(measurement, "", trace, value, units, true);
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  const scoped_refptr<base::SequencedTaskRunner> background_task_runner_ =
+      base::CreateSequencedTaskRunnerWithTraits({base::MayBlock()});
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<SQLitePersistentNelStore> store_;
+  int64_t seed_multiple_ = 0;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SQLitePersistentNelStorePerfTest);
+};
+
+// Measures loading every stored policy from disk.
+TEST_F(SQLitePersistentNelStorePerfTest, Load) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::vector<NetworkErrorLoggingService::NelPolicy> policies = Load();
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_EQ(static_cast<size_t>(kNumOrigins), policies.size());
+  PrintResult("nel_store_load", "time", elapsed.InMillisecondsF(), "ms");
+}
+
+// Measures the per-request work with every policy loaded: the NEL policy
+// lookup and queueing the report, then selecting the endpoint the report would
+// be delivered to.
+TEST_F(SQLitePersistentNelStorePerfTest, RequestsAndEndpointSelection) {
+  base::SimpleTestClock clock;
+  clock.SetNow(base::Time::Now());
+  base::SimpleTestTickClock tick_clock;
+  ReportingPolicy policy;
+  policy.max_report_count = kNumRequests;
+  policy.max_client_count = kNumOrigins;
+  auto context =
+      std::make_unique<TestReportingContext>(&clock, &tick_clock, policy);
+  ReportingCache* cache = context->cache();
+  for (int i = 0; i < kNumOrigins; ++i) {
+    GURL url = UrlForIndex(i);
+    cache->SetClient(url::Origin::Create(url), url.Resolve("/upload"),
+                     ReportingClient::Subdomains::EXCLUDE, kGroup,
+                     tick_clock.NowTicks() + base::TimeDelta::FromDays(1),
+                     ReportingClient::kDefaultPriority,
+                     ReportingClient::kDefaultWeight);
+  }
+  std::unique_ptr<ReportingService> reporting_service =
+      ReportingService::CreateForTesting(std::move(context));
+
+  std::unique_ptr<NetworkErrorLoggingService> service =
+      NetworkErrorLoggingService::Create(NetworkErrorLoggingDelegate::Create(),
+                                         store_.get());
+  service->SetReportingService(reporting_service.get());
+
+  // The first call loads the policies.
+  base::TimeTicks start = base::TimeTicks::Now();
+  service->RemoveBrowsingData(
+      base::BindRepeating([](const GURL& url) { return false; }));
+  scoped_task_environment_.RunUntilIdle();
+  ASSERT_EQ(static_cast<size_t>(kNumOrigins),
+            service->GetPolicyOriginsForTesting().size());
+  PrintResult("nel_service_load", "time",
+              (base::TimeTicks::Now() - start).InMillisecondsF(), "ms");
+
+  NetworkErrorLoggingService::RequestDetails details;
+  details.server_ip = IPAddress(192, 168, 0, 1);
+  details.protocol = "h2";
+  details.method = "GET";
+  details.status_code = 0;
+  details.elapsed_time = base::TimeDelta::FromMilliseconds(100);
+  details.type = ERR_CONNECTION_RESET;
+  details.reporting_upload_depth = 0;
+
+  std::vector<GURL> urls;
+  urls.reserve(kNumRequests);
+  for (int i = 0; i < kNumRequests; ++i)
+    urls.push_back(UrlForIndex(NextIndex()));
+
+  start = base::TimeTicks::Now();
+  for (const GURL& url : urls) {
+    details.uri = url;
+    service->OnRequest(details);
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  PrintResult("nel_report_enqueue", "throughput",
+              kNumRequests / elapsed.InSecondsF(), "reports/s");
+
+  std::vector<const ReportingClient*> clients;
+  start = base::TimeTicks::Now();
+  for (const GURL& url : urls) {
+    cache->GetClientsForOriginAndGroup(url::Origin::Create(url), kGroup,
+                                       &clients);
+    ASSERT_EQ(1u, clients.size());
+  }
+  elapsed = base::TimeTicks::Now() - start;
+  PrintResult("reporting_endpoint_selection", "throughput",
+              kNumRequests / elapsed.InSecondsF(), "lookups/s");
+}
+
+}  // namespace
+
+}  // namespace net
@@ -0,0 +1,139 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/extras/sqlite/sqlite_persistent_nel_store.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "net/base/ip_address.h"
+#include "net/test/test_with_scoped_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace net {
+
+namespace {
+
+const base::FilePath::CharType kNelFilename[] =
+    FILE_PATH_LITERAL("NetworkErrorLogging");
+
+class SQLitePersistentNelStoreTest : public TestWithScopedTaskEnvironment {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    CreateStore();
+  }
+
+  void CreateStore() {
+    store_ = std::make_unique<SQLitePersistentNelStore>(
+        temp_dir_.GetPath().Append(kNelFilename),
+        base::ThreadTaskRunnerHandle::Get());
+  }
+
+  // Destroys the store, which commits any pending operations, and opens it
+  // again.
+  void ReopenStore() {
+    store_.reset();
+    RunUntilIdle();
+    CreateStore();
+  }
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> Load() {
+    std::vector<NetworkErrorLoggingService::NelPolicy> policies;
+    base::RunLoop run_loop;
+    store_->LoadNelPolicies(base::BindOnce(
+        [](base::RunLoop* run_loop,
+           std::vector<NetworkErrorLoggingService::NelPolicy>* out,
+           std::vector<NetworkErrorLoggingService::NelPolicy> policies) {
+          *out = std::move(policies);
+          run_loop->Quit();
+        },
+        &run_loop, &policies));
+    run_loop.Run();
+    return policies;
+  }
+
+  NetworkErrorLoggingService::NelPolicy MakePolicy(const std::string& url) {
+    NetworkErrorLoggingService::NelPolicy policy;
+    policy.origin = url::Origin::Create(GURL(url));
+    policy.received_ip_address = IPAddress(192, 168, 0, 1);
+    policy.report_to = "group";
+    policy.expires = base::Time::Now() + base::TimeDelta::FromDays(1);
+    policy.success_fraction = 0.25;
+    policy.failure_fraction = 0.75;
+    policy.include_subdomains = true;
+    return policy;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<SQLitePersistentNelStore> store_;
+};
+
+TEST_F(SQLitePersistentNelStoreTest, CreateAndLoadEmpty) {
+  EXPECT_TRUE(Load().empty());
+}
+
+TEST_F(SQLitePersistentNelStoreTest, AddAndReload) {
+  EXPECT_TRUE(Load().empty());
+  NetworkErrorLoggingService::NelPolicy policy =
+      MakePolicy("https://example.test:4433");
+  store_->AddNelPolicy(policy);
+  ReopenStore();
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> policies = Load();
+  ASSERT_EQ(1u, policies.size());
+  EXPECT_EQ(policy.origin, policies[0].origin);
+  EXPECT_EQ(policy.received_ip_address, policies[0].received_ip_address);
+  EXPECT_EQ(policy.report_to, policies[0].report_to);
+  EXPECT_EQ(policy.expires, policies[0].expires);
+  EXPECT_EQ(policy.success_fraction, policies[0].success_fraction);
+  EXPECT_EQ(policy.failure_fraction, policies[0].failure_fraction);
+  EXPECT_EQ(policy.include_subdomains, policies[0].include_subdomains);
+}
+
+// Adding a policy for an origin that already has one replaces it.
+TEST_F(SQLitePersistentNelStoreTest, AddReplaces) {
+  EXPECT_TRUE(Load().empty());
+  NetworkErrorLoggingService::NelPolicy policy =
+      MakePolicy("https://example.test");
+  store_->AddNelPolicy(policy);
+  policy.report_to = "other-group";
+  store_->AddNelPolicy(policy);
+  ReopenStore();
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> policies = Load();
+  ASSERT_EQ(1u, policies.size());
+  EXPECT_EQ("other-group", policies[0].report_to);
+}
+
+TEST_F(SQLitePersistentNelStoreTest, Delete) {
+  EXPECT_TRUE(Load().empty());
+  NetworkErrorLoggingService::NelPolicy policy1 =
+      MakePolicy("https://example1.test");
+  NetworkErrorLoggingService::NelPolicy policy2 =
+      MakePolicy("https://example2.test");
+  store_->AddNelPolicy(policy1);
+  store_->AddNelPolicy(policy2);
+  store_->Flush();
+  RunUntilIdle();
+  store_->DeleteNelPolicy(policy1);
+  ReopenStore();
+
+  std::vector<NetworkErrorLoggingService::NelPolicy> policies = Load();
+  ASSERT_EQ(1u, policies.size());
+  EXPECT_EQ(policy2.origin, policies[0].origin);
+}
+
+}  // namespace
+
+}  // namespace net
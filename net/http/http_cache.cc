@@ -11,6 +11,7 @@
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/format_macros.h"
 #include "base/location.h"
@@ -1124,7 +1125,40 @@ void HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
   DCHECK(!entry->done_headers_queue.empty());
 
   Transaction* transaction = entry->done_headers_queue.front();
+  if (!MoveDoneHeadersTransaction(entry, transaction))
+    return;
+
+  // Post another task to give a chance to more transactions to either join
+  // readers or another transaction to start parallel validation.
+  ProcessQueuedTransactions(entry);
+
+  entry->done_headers_queue.erase(entry->done_headers_queue.begin());
+
+  // Transactions queued behind |transaction| would each wait for another
+  // posted task before moving, which adds up when many requests for the same
+  // resource are waiting on a busy thread. Move every one of them that can
+  // proceed now. Their callbacks are posted rather than run since running
+  // |transaction|'s callback may destroy the cache or the entry.
+  if (base::FeatureList::IsEnabled(features::kHttpCacheBatchDoneHeadersQueue)) {
+    while (!entry->done_headers_queue.empty() &&
+           (!entry->writers ||
+            entry->writers->CanAddWriters(&writers_pattern))) {
+      Transaction* next = entry->done_headers_queue.front();
+      if (!MoveDoneHeadersTransaction(entry, next))
+        break;
+      entry->done_headers_queue.erase(entry->done_headers_queue.begin());
+      next->OnDoneHeadersQueueWaitComplete();
+      base::ThreadTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(next->io_callback(), OK));
+    }
+  }
 
+  transaction->OnDoneHeadersQueueWaitComplete();
+  transaction->io_callback().Run(OK);
+}
+
+bool HttpCache::MoveDoneHeadersTransaction(ActiveEntry* entry,
+                                           Transaction* transaction) {
   ParallelWritingPattern parallel_writing_pattern =
       CanTransactionJoinExistingWriters(transaction);
   if (IsWritingInProgress(entry)) {
@@ -1137,7 +1171,7 @@ void HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
       // the ordering is not important but that would be optimizing a rare
       // scenario where write mode transactions are insterspersed with read-only
       // transactions.
-      return;
+      return false;
     }
     AddTransactionToWriters(entry, transaction, parallel_writing_pattern);
   } else {  // no writing in progress
@@ -1146,7 +1180,7 @@ void HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
         if (entry->readers.empty())
           AddTransactionToWriters(entry, transaction, parallel_writing_pattern);
         else
-          return;
+          return false;
       } else {
         // Add the transaction to readers since the response body should have
         // already been written. (If it was the first writer about to start
@@ -1166,13 +1200,7 @@ void HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
           PARALLEL_WRITING_NONE_CACHE_READ);
     }
   }
-
-  // Post another task to give a chance to more transactions to either join
-  // readers or another transaction to start parallel validation.
-  ProcessQueuedTransactions(entry);
-
-  entry->done_headers_queue.erase(entry->done_headers_queue.begin());
-  transaction->io_callback().Run(OK);
+  return true;
 }
 
 void HttpCache::AddTransactionToWriters(
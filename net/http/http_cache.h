@@ -537,10 +537,16 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
 
   // Invoked when a transaction that has already completed the response headers
   // phase can resume reading/writing the response body. It will invoke the IO
-  // callback of the transaction. This is a helper function for
-  // OnProcessQueuedTransactions.
+  // callback of the transaction, and with kHttpCacheBatchDoneHeadersQueue
+  // enabled, post the callbacks of the queued transactions behind it that can
+  // resume as well. This is a helper function for OnProcessQueuedTransactions.
   void ProcessDoneHeadersQueue(ActiveEntry* entry);
 
+  // Adds |transaction|, which must be at the front of the done headers queue,
+  // to writers or readers. Returns false if it has to keep waiting. Does not
+  // remove it from the queue or invoke its callback.
+  bool MoveDoneHeadersTransaction(ActiveEntry* entry, Transaction* transaction);
+
   // Adds a transaction to writers.
   void AddTransactionToWriters(ActiveEntry* entry,
                                Transaction* transaction,
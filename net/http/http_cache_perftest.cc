@@ -0,0 +1,159 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "net/base/features.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/http/http_transaction_test_util.h"
+#include "net/http/mock_http_cache.h"
+#include "net/log/net_log_with_source.h"
+#include "net/test/gtest_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using net::test::IsOk;
+
+namespace net {
+
+namespace {
+
+const int kNumIterations = 20;
+
+// How long each task run by BusyThread takes. Every time the cache posts a
+// task, it runs after roughly one of these.
+const base::TimeDelta kBusyTaskDuration =
+    base::TimeDelta::FromMicroseconds(200);
+
+struct Context {
+  int result = ERR_IO_PENDING;
+  TestCompletionCallback callback;
+  std::unique_ptr<HttpTransaction> trans;
+};
+
+// Keeps the current thread's task queue busy with unrelated work, the way the
+// network thread is while many requests are in flight.
+class BusyThread {
+ public:
+  BusyThread() : weak_factory_(this) { PostBusyTask(); }
+  ~BusyThread() = default;
+
+ private:
+  void PostBusyTask() {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&BusyThread::RunBusyTask, weak_factory_.GetWeakPtr()));
+  }
+
+  void RunBusyTask() {
+    base::PlatformThread::Sleep(kBusyTaskDuration);
+    PostBusyTask();
+  }
+
+  base::WeakPtrFactory<BusyThread> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(BusyThread);
+};
+
+class HttpCachePerfTest : public testing::Test {
+ protected:
+  HttpCachePerfTest() = default;
+
+  // Starts |num_requests| identical GETs against an empty cache at once and
+  // reports how long it takes for all of them to finish the headers phase,
+  // which includes waiting in the entry's queues, and to read the body. If
+  // |busy| is true, the headers phase competes with a busy thread.
+  void RunConcurrentRequests(int num_requests, bool busy, bool batch) {
+    base::test::ScopedFeatureList feature_list;
+    if (batch) {
+      feature_list.InitAndEnableFeature(
+          features::kHttpCacheBatchDoneHeadersQueue);
+    } else {
+      feature_list.InitAndDisableFeature(
+          features::kHttpCacheBatchDoneHeadersQueue);
+    }
+
+    base::TimeDelta headers_time;
+    base::TimeDelta total_time;
+    for (int i = 0; i < kNumIterations; ++i) {
+      MockHttpCache cache;
+      MockHttpRequest request(kSimpleGET_Transaction);
+      std::unique_ptr<BusyThread> busy_thread;
+      if (busy)
+        busy_thread = std::make_unique<BusyThread>();
+
+      base::TimeTicks start = base::TimeTicks::Now();
+      std::vector<std::unique_ptr<Context>> contexts;
+      for (int j = 0; j < num_requests; ++j) {
+        contexts.push_back(std::make_unique<Context>());
+        Context* c = contexts.back().get();
+        ASSERT_THAT(cache.CreateTransaction(&c->trans), IsOk());
+        c->result = c->trans->Start(&request, c->callback.callback(),
+                                    NetLogWithSource());
+      }
+      for (auto& c : contexts) {
+        c->result = c->callback.GetResult(c->result);
+        ASSERT_THAT(c->result, IsOk());
+      }
+      headers_time += base::TimeTicks::Now() - start;
+      // ReadTransaction() runs the loop until idle, which a busy thread never
+      // is.
+      busy_thread.reset();
+
+      for (auto& c : contexts) {
+        std::string data;
+        ASSERT_THAT(ReadTransaction(c->trans.get(), &data), IsOk());
+        EXPECT_EQ(kSimpleGET_Transaction.data, data);
+      }
+      total_time += base::TimeTicks::Now() - start;
+
+      EXPECT_EQ(1, cache.network_layer()->transaction_count());
+    }
+
+    std::string trace = base::StringPrintf(
+        "%d_requests%s%s", num_requests, busy ? "_busy_thread" : "",
+        batch ? "_batched" : "");
+    perf_test::PrintResult("headers_done", "", trace,
+                           headers_time.InMillisecondsF() / kNumIterations,
+                           "ms", true);
+    perf_test::PrintResult("all_done", "", trace,
+                           total_time.InMillisecondsF() / kNumIterations, "ms",
+                           true);
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HttpCachePerfTest);
+};
+
+TEST_F(HttpCachePerfTest, ConcurrentIdenticalRequests) {
+  for (int num_requests : {10, 50}) {
+    for (bool batch : {false, true})
+      RunConcurrentRequests(num_requests, false, batch);
+  }
+}
+
+TEST_F(HttpCachePerfTest, ConcurrentIdenticalRequestsBusyThread) {
+  for (int num_requests : {10, 50}) {
+    for (bool batch : {false, true})
+      RunConcurrentRequests(num_requests, true, batch);
+  }
+}
+
+}  // namespace
+
+}  // namespace net
@@ -697,6 +697,15 @@ void HttpCache::Transaction::MaybeSetParallelWritingPatternForMetrics(
     parallel_writing_pattern_ = pattern;
 }
 
+void HttpCache::Transaction::OnDoneHeadersQueueWaitComplete() {
+  DCHECK_EQ(STATE_FINISH_HEADERS_COMPLETE, next_state_);
+  if (entry_lock_waiting_since_.is_null())
+    return;
+  UMA_HISTOGRAM_TIMES("HttpCache.DoneHeadersQueueWait",
+                      TimeTicks::Now() - entry_lock_waiting_since_);
+  entry_lock_waiting_since_ = TimeTicks();
+}
+
 //-----------------------------------------------------------------------------
 
 // A few common patterns: (Foo* means Foo -> FooComplete)
@@ -201,6 +201,11 @@ class NET_EXPORT_PRIVATE HttpCache::Transaction : public HttpTransaction {
   // value has been set to something other than PARALLEL_WRITING_NONE.
   void MaybeSetParallelWritingPatternForMetrics(ParallelWritingPattern pattern);
 
+  // Invoked when HttpCache takes this transaction out of the done headers
+  // queue, before its IO callback is run or posted. Records how long it was
+  // queued and disarms the cache lock timeout.
+  void OnDoneHeadersQueueWaitComplete();
+
  private:
   static const size_t kNumValidationHeaders = 2;
   // Helper struct to pair a header name with its value, for
@@ -25,6 +25,7 @@
 #include "base/test/metrics/histogram_tester.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/simple_test_clock.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "base/trace_event/memory_allocator_dump.h"
 #include "base/trace_event/memory_dump_request_args.h"
 #include "base/trace_event/process_memory_dump.h"
@@ -3386,6 +3387,86 @@ TEST_F(HttpCacheTest, SimpleGET_ParallelWritingSuccess) {
       static_cast<int>(HttpCache::PARALLEL_WRITING_NOT_JOIN_READ_ONLY), 1);
 }
 
+// Tests that once a response is complete, every validated transaction waiting
+// in the done headers queue becomes a reader in the same task when the queue
+// is processed in batches, and only the first one does otherwise.
+TEST_F(HttpCacheTest, SimplePOST_BatchedDoneHeadersQueue) {
+  for (bool batch : {false, true}) {
+    SCOPED_TRACE(batch);
+    base::test::ScopedFeatureList feature_list;
+    feature_list.InitWithFeatureState(
+        features::kHttpCacheBatchDoneHeadersQueue, batch);
+    base::HistogramTester histograms;
+    MockHttpCache cache;
+
+    MockTransaction transaction(kSimplePOST_Transaction);
+
+    const int64_t kUploadId = 1;  // Just a dummy value.
+
+    std::vector<std::unique_ptr<UploadElementReader>> element_readers;
+    element_readers.push_back(
+        std::make_unique<UploadBytesElementReader>("hello", 5));
+    ElementsUploadDataStream upload_data_stream(std::move(element_readers),
+                                                kUploadId);
+
+    // POST transactions cannot write in parallel, so the first one writes the
+    // response alone while the others queue up behind it.
+    transaction.load_flags = LOAD_SKIP_CACHE_VALIDATION;
+    MockHttpRequest request(transaction);
+    request.upload_data_stream = &upload_data_stream;
+
+    const int kNumTransactions = 4;
+    std::vector<std::unique_ptr<Context>> context_list;
+
+    for (int i = 0; i < kNumTransactions; ++i) {
+      context_list.push_back(std::make_unique<Context>());
+      auto& c = context_list[i];
+
+      c->result = cache.CreateTransaction(&c->trans);
+      ASSERT_THAT(c->result, IsOk());
+
+      c->result =
+          c->trans->Start(&request, c->callback.callback(), NetLogWithSource());
+    }
+
+    base::RunLoop().RunUntilIdle();
+
+    std::string cache_key =
+        base::StringPrintf("1/%s", kSimplePOST_Transaction.url);
+
+    EXPECT_EQ(1, cache.GetCountWriterTransactions(cache_key));
+    EXPECT_EQ(kNumTransactions - 1, cache.GetCountDoneHeadersQueue(cache_key));
+
+    // Completing the response posts a single task to process the queue.
+    ReadAndVerifyTransaction(context_list[0]->trans.get(),
+                             kSimplePOST_Transaction);
+    EXPECT_EQ(kNumTransactions - 1, cache.GetCountDoneHeadersQueue(cache_key));
+
+    // Run only the tasks that are already posted.
+    base::RunLoop run_loop;
+    base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                                  run_loop.QuitClosure());
+    run_loop.Run();
+
+    int moved = batch ? kNumTransactions - 1 : 1;
+    EXPECT_EQ(moved, cache.GetCountReaders(cache_key));
+    EXPECT_EQ(kNumTransactions - 1 - moved,
+              cache.GetCountDoneHeadersQueue(cache_key));
+    histograms.ExpectTotalCount("HttpCache.DoneHeadersQueueWait", moved);
+
+    for (int i = 1; i < kNumTransactions; ++i) {
+      auto& c = context_list[i];
+      ASSERT_THAT(c->callback.GetResult(c->result), IsOk());
+      ReadAndVerifyTransaction(c->trans.get(), kSimplePOST_Transaction);
+    }
+
+    EXPECT_EQ(1, cache.network_layer()->transaction_count());
+    EXPECT_EQ(1, cache.disk_cache()->create_count());
+    histograms.ExpectTotalCount("HttpCache.DoneHeadersQueueWait",
+                                kNumTransactions - 1);
+  }
+}
+
 // Tests the case when parallel writing involves things bigger than what cache
 // can store. In this case, the best we can do is re-fetch it.
 TEST_F(HttpCacheTest, SimpleGET_ParallelWritingHuge) {
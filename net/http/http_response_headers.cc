@@ -142,6 +142,37 @@ void CheckDoesNotHaveEmbeddedNulls(base::StringPiece str) {
   CHECK(!HasEmbeddedNulls(str));
 }
 
+// Returns a hash of |name| that ignores ASCII case, used to skip most of the
+// case-insensitive comparisons when looking for a header.
+uint32_t HashHeaderName(StringPiece name) {
+  // 32-bit FNV-1a.
+  uint32_t hash = 2166136261u;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(base::ToLowerASCII(c));
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Ends a chain of ParsedHeader::next_same_hash links.
+const uint32_t kNoNextHeader = std::numeric_limits<uint32_t>::max();
+
+// Sets |*out| to |name| in lower case, reusing its buffer.
+void AssignLowerCaseASCII(StringPiece name, std::string* out) {
+  out->resize(name.size());
+  std::transform(name.begin(), name.end(), out->begin(),
+                 [](char c) { return base::ToLowerASCII(c); });
+}
+
+void RecordResponseCode(int response_code) {
+  UMA_HISTOGRAM_CUSTOM_ENUMERATION(
+      "Net.HttpResponseCode",
+      HttpUtil::MapStatusCodeForHistogram(response_code),
+      // Note the third argument is only evaluated once, see macro definition
+      // for details.
+      HttpUtil::GetStatusCodesForHistogram());
+}
+
 }  // namespace
 
 const char HttpResponseHeaders::kContentRange[] = "Content-Range";
@@ -151,6 +182,11 @@ struct HttpResponseHeaders::ParsedHeader {
   // preceding header.  (Header values are comma separated.)
   bool is_continuation() const { return name_begin == name_end; }
 
+  // HashHeaderName() of the name, or 0 for continuations.
+  uint32_t name_hash;
+  // Index in parsed_ of the next header whose name has the same hash, or
+  // kNoNextHeader.
+  uint32_t next_same_hash;
   std::string::const_iterator name_begin;
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
@@ -173,13 +209,54 @@ HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
   // that would actually create a double call between the original
   // HttpResponseHeader that was serialized, and initialization of the
   // new object from that pickle.
-  UMA_HISTOGRAM_CUSTOM_ENUMERATION("Net.HttpResponseCode",
-                                   HttpUtil::MapStatusCodeForHistogram(
-                                       response_code_),
-                                   // Note the third argument is only
-                                   // evaluated once, see macro
-                                   // definition for details.
-                                   HttpUtil::GetStatusCodesForHistogram());
+  RecordResponseCode(response_code_);
+}
+
+HttpResponseHeaders::HttpResponseHeaders(
+    HttpVersion version,
+    StringPiece status,
+    const std::vector<std::pair<StringPiece, StringPiece>>& headers)
+    : response_code_(-1) {
+  std::string status_line = base::StringPrintf(
+      "HTTP/%d.%d ", version.major_value(), version.minor_value());
+  status.AppendToString(&status_line);
+  ParseStatusLine(status_line.begin(), status_line.end(), !headers.empty());
+  raw_headers_.push_back('\0');  // Terminate status line with a null.
+
+  // Lay out the header lines the way Parse() would find them in raw_headers_,
+  // sizing it first so that the iterators taken below stay valid.
+  size_t headers_offset = raw_headers_.size();
+  size_t raw_headers_size = headers_offset + 1;
+  for (const auto& header : headers)
+    raw_headers_size += header.first.size() + header.second.size() + 2;
+  raw_headers_.reserve(raw_headers_size);
+  for (const auto& header : headers) {
+    DCHECK(HttpUtil::IsToken(header.first));
+    CheckDoesNotHaveEmbeddedNulls(header.second);
+    header.first.AppendToString(&raw_headers_);
+    raw_headers_.push_back(':');
+    header.second.AppendToString(&raw_headers_);
+    raw_headers_.push_back('\0');
+  }
+  raw_headers_.push_back('\0');  // Ensure the headers end with a double null.
+  DCHECK_EQ(raw_headers_size, raw_headers_.size());
+
+  parsed_.reserve(headers.size());
+  name_index_.reserve(headers.size());
+  std::string::const_iterator line_begin =
+      raw_headers_.cbegin() + headers_offset;
+  for (const auto& header : headers) {
+    std::string::const_iterator name_end = line_begin + header.first.size();
+    std::string::const_iterator value_begin = name_end + 1;
+    std::string::const_iterator value_end =
+        value_begin + header.second.size();
+    std::string::const_iterator name_begin = line_begin;
+    line_begin = value_end + 1;
+    HttpUtil::TrimLWS(&value_begin, &value_end);
+    AddHeader(name_begin, name_end, value_begin, value_end);
+  }
+
+  RecordResponseCode(response_code_);
 }
 
 HttpResponseHeaders::HttpResponseHeaders(base::PickleIterator* iter)
@@ -189,6 +266,23 @@ HttpResponseHeaders::HttpResponseHeaders(base::PickleIterator* iter)
     Parse(raw_input);
 }
 
+HttpResponseHeaders::Builder::Builder(HttpVersion version, StringPiece status)
+    : version_(version), status_(status) {}
+
+HttpResponseHeaders::Builder::~Builder() = default;
+
+HttpResponseHeaders::Builder& HttpResponseHeaders::Builder::AddHeader(
+    StringPiece name,
+    StringPiece value) {
+  headers_.emplace_back(name, value);
+  return *this;
+}
+
+scoped_refptr<HttpResponseHeaders> HttpResponseHeaders::Builder::Build() {
+  return base::WrapRefCounted(
+      new HttpResponseHeaders(version_, status_, headers_));
+}
+
 scoped_refptr<HttpResponseHeaders> HttpResponseHeaders::TryToCreate(
     base::StringPiece headers) {
   // Reject strings with nulls.
@@ -237,6 +331,7 @@ void HttpResponseHeaders::Persist(base::Pickle* pickle,
   // so this just copies the first header line.
   blob.assign(raw_headers_.c_str(), strlen(raw_headers_.c_str()) + 1);
 
+  std::string header_name;
   for (size_t i = 0; i < parsed_.size(); ++i) {
     DCHECK(!parsed_[i].is_continuation());
 
@@ -245,9 +340,13 @@ void HttpResponseHeaders::Persist(base::Pickle* pickle,
     while (++k < parsed_.size() && parsed_[k].is_continuation()) {}
     --k;
 
-    std::string header_name = base::ToLowerASCII(
-        base::StringPiece(parsed_[i].name_begin, parsed_[i].name_end));
-    if (filter_headers.find(header_name) == filter_headers.end()) {
+    if (!filter_headers.empty()) {
+      AssignLowerCaseASCII(
+          StringPiece(parsed_[i].name_begin, parsed_[i].name_end),
+          &header_name);
+    }
+    if (filter_headers.empty() ||
+        filter_headers.find(header_name) == filter_headers.end()) {
       // Make sure there is a null after the value.
       blob.append(parsed_[i].name_begin, parsed_[k].value_end);
       blob.push_back('\0');
@@ -267,6 +366,10 @@ void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
   // Copy up to the null byte.  This just copies the status line.
   std::string new_raw_headers(raw_headers_.c_str());
   new_raw_headers.push_back('\0');
+  // Room for the merged headers, so that neither this nor MergeWithHeaders()
+  // has to grow the string.
+  new_raw_headers.reserve(raw_headers_.size() +
+                          new_headers.raw_headers_.size());
 
   HeaderSet updated_headers;
 
@@ -274,6 +377,7 @@ void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
   // order should not matter.
 
   // Figure out which headers we want to take from new_headers:
+  std::string name_lower;
   for (size_t i = 0; i < new_headers.parsed_.size(); ++i) {
     const HeaderList& new_parsed = new_headers.parsed_;
 
@@ -286,7 +390,7 @@ void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
 
     base::StringPiece name(new_parsed[i].name_begin, new_parsed[i].name_end);
     if (ShouldUpdateHeader(name)) {
-      std::string name_lower = base::ToLowerASCII(name);
+      AssignLowerCaseASCII(name, &name_lower);
       updated_headers.insert(name_lower);
 
       // Preserve this header line in the merged result, making sure there is
@@ -299,12 +403,14 @@ void HttpResponseHeaders::Update(const HttpResponseHeaders& new_headers) {
   }
 
   // Now, build the new raw headers.
-  MergeWithHeaders(new_raw_headers, updated_headers);
+  MergeWithHeaders(std::move(new_raw_headers), updated_headers);
 }
 
-void HttpResponseHeaders::MergeWithHeaders(const std::string& raw_headers,
+void HttpResponseHeaders::MergeWithHeaders(std::string raw_headers,
                                            const HeaderSet& headers_to_remove) {
-  std::string new_raw_headers(raw_headers);
+  std::string new_raw_headers = std::move(raw_headers);
+  new_raw_headers.reserve(new_raw_headers.size() + raw_headers_.size());
+  std::string name;
   for (size_t i = 0; i < parsed_.size(); ++i) {
     DCHECK(!parsed_[i].is_continuation());
 
@@ -313,9 +419,12 @@ void HttpResponseHeaders::MergeWithHeaders(const std::string& raw_headers,
     while (++k < parsed_.size() && parsed_[k].is_continuation()) {}
     --k;
 
-    std::string name = base::ToLowerASCII(
-        base::StringPiece(parsed_[i].name_begin, parsed_[i].name_end));
-    if (headers_to_remove.find(name) == headers_to_remove.end()) {
+    if (!headers_to_remove.empty()) {
+      AssignLowerCaseASCII(
+          StringPiece(parsed_[i].name_begin, parsed_[i].name_end), &name);
+    }
+    if (headers_to_remove.empty() ||
+        headers_to_remove.find(name) == headers_to_remove.end()) {
       // It's ok to preserve this header in the final result.
       new_raw_headers.append(parsed_[i].name_begin, parsed_[k].value_end);
       new_raw_headers.push_back('\0');
@@ -328,6 +437,7 @@ void HttpResponseHeaders::MergeWithHeaders(const std::string& raw_headers,
   // Make this object hold the new data.
   raw_headers_.clear();
   parsed_.clear();
+  name_index_.clear();
   Parse(new_raw_headers);
 }
 
@@ -339,7 +449,7 @@ void HttpResponseHeaders::RemoveHeader(const std::string& name) {
   std::string lowercase_name = base::ToLowerASCII(name);
   HeaderSet to_remove;
   to_remove.insert(lowercase_name);
-  MergeWithHeaders(new_raw_headers, to_remove);
+  MergeWithHeaders(std::move(new_raw_headers), to_remove);
 }
 
 void HttpResponseHeaders::RemoveHeaders(
@@ -352,7 +462,7 @@ void HttpResponseHeaders::RemoveHeaders(
   for (const auto& header_name : header_names) {
     to_remove.insert(base::ToLowerASCII(header_name));
   }
-  MergeWithHeaders(new_raw_headers, to_remove);
+  MergeWithHeaders(std::move(new_raw_headers), to_remove);
 }
 
 void HttpResponseHeaders::RemoveHeaderLine(const std::string& name,
@@ -384,6 +494,7 @@ void HttpResponseHeaders::RemoveHeaderLine(const std::string& name,
   // Make this object hold the new data.
   raw_headers_.clear();
   parsed_.clear();
+  name_index_.clear();
   Parse(new_raw_headers);
 }
 
@@ -400,6 +511,7 @@ void HttpResponseHeaders::AddHeader(const std::string& header) {
   // Make this object hold the new data.
   raw_headers_.clear();
   parsed_.clear();
+  name_index_.clear();
   Parse(new_raw_headers);
 }
 
@@ -414,7 +526,7 @@ void HttpResponseHeaders::ReplaceStatusLine(const std::string& new_status) {
   new_raw_headers.push_back('\0');
 
   HeaderSet empty_to_remove;
-  MergeWithHeaders(new_raw_headers, empty_to_remove);
+  MergeWithHeaders(std::move(new_raw_headers), empty_to_remove);
 }
 
 void HttpResponseHeaders::UpdateWithNewRange(const HttpByteRange& byte_range,
@@ -482,6 +594,12 @@ void HttpResponseHeaders::Parse(const std::string& raw_input) {
   // Adjust to point at the null byte following the status line
   line_end = raw_headers_.begin() + status_line_len - 1;
 
+  // Most headers have a single value, so there are about as many entries in
+  // parsed_ as there are lines.
+  size_t line_count = std::count(line_end + 1, raw_headers_.cend(), '\0');
+  parsed_.reserve(line_count);
+  name_index_.reserve(line_count);
+
   HttpUtil::HeadersIterator headers(line_end + 1, raw_headers_.end(),
                                     std::string(1, '\0'));
   while (headers.GetNext()) {
@@ -736,8 +854,13 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const base::StringPiece& search) const {
-  for (size_t i = from; i < parsed_.size(); ++i) {
-    if (parsed_[i].is_continuation())
+  auto it = name_index_.find(HashHeaderName(search));
+  if (it == name_index_.end())
+    return std::string::npos;
+
+  for (uint32_t i = it->second.first; i != kNoNextHeader;
+       i = parsed_[i].next_same_hash) {
+    if (i < from)
       continue;
     base::StringPiece name(parsed_[i].name_begin, parsed_[i].name_end);
     if (base::EqualsCaseInsensitiveASCII(search, name))
@@ -796,11 +919,25 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
                                       std::string::const_iterator value_begin,
                                       std::string::const_iterator value_end) {
   ParsedHeader header;
+  header.name_hash = name_begin == name_end
+                         ? 0
+                         : HashHeaderName(StringPiece(name_begin, name_end));
   header.name_begin = name_begin;
   header.name_end = name_end;
+  header.next_same_hash = kNoNextHeader;
   header.value_begin = value_begin;
   header.value_end = value_end;
   parsed_.push_back(header);
+  if (header.is_continuation())
+    return;
+
+  uint32_t index = static_cast<uint32_t>(parsed_.size() - 1);
+  auto result =
+      name_index_.try_emplace(header.name_hash, NameIndexEntry{index, index});
+  if (!result.second) {
+    parsed_[result.first->second.last].next_same_hash = index;
+    result.first->second.last = index;
+  }
 }
 
 void HttpResponseHeaders::AddNonCacheableHeaders(HeaderSet* result) const {
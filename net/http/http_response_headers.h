@@ -10,8 +10,10 @@
 
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "base/containers/hash_map.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/strings/string_piece.h"
@@ -63,6 +65,32 @@ class NET_EXPORT HttpResponseHeaders
 
   static const char kContentRange[];
 
+  // Builds HttpResponseHeaders from a status and header lines that have
+  // already been split into names and values, as in HTTP/2 and QUIC
+  // responses. This skips formatting them into a raw header string only to
+  // parse it again. The result is the same as parsing the raw headers the
+  // lines would format to.
+  class NET_EXPORT Builder {
+   public:
+    // |status| is the status code, optionally followed by a reason phrase.
+    Builder(HttpVersion version, base::StringPiece status);
+    ~Builder();
+
+    // Adds a header line. |name| must be a valid token and |value| must not
+    // contain '\0'. Neither is copied until Build(), so both must outlive the
+    // Builder.
+    Builder& AddHeader(base::StringPiece name, base::StringPiece value);
+
+    scoped_refptr<HttpResponseHeaders> Build();
+
+   private:
+    const HttpVersion version_;
+    const base::StringPiece status_;
+    std::vector<std::pair<base::StringPiece, base::StringPiece>> headers_;
+
+    DISALLOW_COPY_AND_ASSIGN(Builder);
+  };
+
   HttpResponseHeaders() = delete;
 
   // Parses the given raw_headers.  raw_headers should be formatted thus:
@@ -319,6 +347,20 @@ class NET_EXPORT HttpResponseHeaders
   struct ParsedHeader;
   typedef std::vector<ParsedHeader> HeaderList;
 
+  // The first and last entries of parsed_ whose names have a given hash. The
+  // entries in between are linked through ParsedHeader::next_same_hash.
+  struct NameIndexEntry {
+    uint32_t first;
+    uint32_t last;
+  };
+
+  // Used by Builder.
+  HttpResponseHeaders(
+      HttpVersion version,
+      base::StringPiece status,
+      const std::vector<std::pair<base::StringPiece, base::StringPiece>>&
+          headers);
+
   ~HttpResponseHeaders();
 
   // Initializes from the given raw headers.
@@ -369,7 +411,7 @@ class NET_EXPORT HttpResponseHeaders
   // the current headers without the headers in |headers_to_remove|. Note that
   // |headers_to_remove| are removed from the current headers (before the
   // merge), not after the merge.
-  void MergeWithHeaders(const std::string& raw_headers,
+  void MergeWithHeaders(std::string raw_headers,
                         const HeaderSet& headers_to_remove);
 
   // Adds the values from any 'cache-control: no-cache="foo,bar"' headers.
@@ -397,6 +439,10 @@ class NET_EXPORT HttpResponseHeaders
   // header-value pairs within raw_headers_.
   HeaderList parsed_;
 
+  // Maps the case-insensitive hash of each header name in parsed_ to the
+  // entries with that name, so that FindHeader() doesn't scan the list.
+  base::HashMap<uint32_t, NameIndexEntry> name_index_;
+
   // The raw_headers_ consists of the normalized status line (terminated with a
   // null byte) and then followed by the raw null-terminated headers from the
   // input that was passed to our constructor.  We preserve the input [*] to
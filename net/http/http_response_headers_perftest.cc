@@ -0,0 +1,153 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_response_headers.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/macros.h"
+#include "base/pickle.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace net {
+
+namespace {
+
+const int kNumIterations = 20000;
+
+// A cacheable response with the headers commonly served by CDNs.
+const char kResponse[] =
+    "HTTP/1.1 200 OK\n"
+    "Date: Tue, 05 Mar 2019 18:12:24 GMT\n"
+    "Server: Apache\n"
+    "Last-Modified: Mon, 04 Mar 2019 10:00:00 GMT\n"
+    "ETag: \"5c7d3e40-bc55\"\n"
+    "Accept-Ranges: bytes\n"
+    "Content-Length: 48213\n"
+    "Content-Type: text/html; charset=utf-8\n"
+    "Cache-Control: public, max-age=600, stale-while-revalidate=60\n"
+    "Expires: Tue, 05 Mar 2019 18:22:24 GMT\n"
+    "Vary: Accept-Encoding\n"
+    "Strict-Transport-Security: max-age=31536000; includeSubDomains\n"
+    "X-Content-Type-Options: nosniff\n"
+    "X-Frame-Options: SAMEORIGIN\n"
+    "Access-Control-Allow-Origin: *\n"
+    "Timing-Allow-Origin: *\n"
+    "Set-Cookie: a=1; path=/\n"
+    "Set-Cookie: b=2; path=/\n"
+    "Connection: keep-alive\n";
+
+// The response to revalidating it.
+const char kNotModified[] =
+    "HTTP/1.1 304 Not Modified\n"
+    "Date: Tue, 05 Mar 2019 18:32:24 GMT\n"
+    "Server: Apache\n"
+    "ETag: \"5c7d3e40-bc55\"\n"
+    "Cache-Control: public, max-age=600, stale-while-revalidate=60\n"
+    "Expires: Tue, 05 Mar 2019 18:42:24 GMT\n"
+    "Vary: Accept-Encoding\n"
+    "Connection: keep-alive\n";
+
+// Transforms |headers| into the format HttpResponseHeaders expects.
+std::string ToRaw(const char* headers) {
+  std::string raw(headers);
+  std::replace(raw.begin(), raw.end(), '\n', '\0');
+  raw.push_back('\0');
+  return raw;
+}
+
+class HttpResponseHeadersPerfTest : public testing::Test {
+ protected:
+  HttpResponseHeadersPerfTest()
+      : response_(ToRaw(kResponse)), not_modified_(ToRaw(kNotModified)) {}
+
+  void PrintResult(const std::string& trace, base::TimeDelta elapsed) {
+    perf_test::PrintResult("http_response_headers", "", trace,
+                           kNumIterations / elapsed.InSecondsF(), "runs/s",
+                           true);
+  }
+
+  const std::string response_;
+  const std::string not_modified_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HttpResponseHeadersPerfTest);
+};
+
+TEST_F(HttpResponseHeadersPerfTest, Parse) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    scoped_refptr<HttpResponseHeaders> headers =
+        base::MakeRefCounted<HttpResponseHeaders>(response_);
+    ASSERT_EQ(200, headers->response_code());
+  }
+  PrintResult("parse", base::TimeTicks::Now() - start);
+}
+
+// Looks up the headers the cache and the loading stack consult for every
+// response.
+TEST_F(HttpResponseHeadersPerfTest, Lookup) {
+  scoped_refptr<HttpResponseHeaders> headers =
+      base::MakeRefCounted<HttpResponseHeaders>(response_);
+  base::Time request_time;
+  ASSERT_TRUE(headers->GetDateValue(&request_time));
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    std::string value;
+    ASSERT_TRUE(headers->GetNormalizedHeader("content-type", &value));
+    ASSERT_TRUE(headers->HasHeaderValue("vary", "accept-encoding"));
+    ASSERT_FALSE(headers->HasHeader("content-encoding"));
+    ASSERT_EQ(48213, headers->GetContentLength());
+    ASSERT_TRUE(headers->HasStrongValidators());
+    ASSERT_EQ(VALIDATION_NONE,
+              headers->RequiresValidation(request_time, request_time,
+                                          request_time));
+  }
+  PrintResult("lookup", base::TimeTicks::Now() - start);
+}
+
+// Merges a 304 into the cached headers, as every successful revalidation
+// does.
+TEST_F(HttpResponseHeadersPerfTest, Update) {
+  scoped_refptr<HttpResponseHeaders> not_modified =
+      base::MakeRefCounted<HttpResponseHeaders>(not_modified_);
+
+  base::TimeDelta elapsed;
+  for (int i = 0; i < kNumIterations; ++i) {
+    scoped_refptr<HttpResponseHeaders> headers =
+        base::MakeRefCounted<HttpResponseHeaders>(response_);
+    base::TimeTicks start = base::TimeTicks::Now();
+    headers->Update(*not_modified);
+    elapsed += base::TimeTicks::Now() - start;
+    ASSERT_TRUE(headers->HasHeader("content-length"));
+  }
+  PrintResult("update", elapsed);
+}
+
+// Persists the headers the way the HTTP cache writes them to an entry.
+TEST_F(HttpResponseHeadersPerfTest, Persist) {
+  scoped_refptr<HttpResponseHeaders> headers =
+      base::MakeRefCounted<HttpResponseHeaders>(response_);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    base::Pickle pickle;
+    headers->Persist(&pickle,
+                     HttpResponseHeaders::PERSIST_SANS_COOKIES |
+                         HttpResponseHeaders::PERSIST_SANS_CHALLENGES |
+                         HttpResponseHeaders::PERSIST_SANS_HOP_BY_HOP |
+                         HttpResponseHeaders::PERSIST_SANS_NON_CACHEABLE |
+                         HttpResponseHeaders::PERSIST_SANS_RANGES);
+    ASSERT_GT(pickle.size(), 0u);
+  }
+  PrintResult("persist", base::TimeTicks::Now() - start);
+}
+
+}  // namespace
+
+}  // namespace net
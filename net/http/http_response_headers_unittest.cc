@@ -529,6 +529,116 @@ TEST(HttpResponseHeadersTest, EnumerateHeader_Coalesced) {
   EXPECT_FALSE(parsed->EnumerateHeader(&iter, "cache-control", &value));
 }
 
+TEST(HttpResponseHeadersTest, Builder) {
+  std::string raw =
+      "HTTP/1.1 200 OK\n"
+      "Cache-control:,,private , no-cache=\"set-cookie,server\",\n"
+      "WWW-Authenticate:Digest realm=foobar, nonce=x, domain=y\n"
+      "Set-Cookie: a=1\n"
+      "Set-Cookie:b=2 \n"
+      "Empty:\n";
+  HeadersToRaw(&raw);
+  scoped_refptr<HttpResponseHeaders> parsed =
+      base::MakeRefCounted<HttpResponseHeaders>(raw);
+
+  scoped_refptr<HttpResponseHeaders> built =
+      HttpResponseHeaders::Builder(HttpVersion(1, 1), "200 OK")
+          .AddHeader("Cache-control",
+                     ",,private , no-cache=\"set-cookie,server\",")
+          .AddHeader("WWW-Authenticate",
+                     "Digest realm=foobar, nonce=x, domain=y")
+          .AddHeader("Set-Cookie", " a=1")
+          .AddHeader("Set-Cookie", "b=2 ")
+          .AddHeader("Empty", "")
+          .Build();
+
+  EXPECT_EQ(parsed->raw_headers(), built->raw_headers());
+  EXPECT_EQ(parsed->response_code(), built->response_code());
+  EXPECT_EQ(parsed->GetHttpVersion(), built->GetHttpVersion());
+  EXPECT_EQ(parsed->GetStatusLine(), built->GetStatusLine());
+
+  size_t parsed_iter = 0;
+  size_t built_iter = 0;
+  std::string parsed_name, parsed_value, built_name, built_value;
+  while (parsed->EnumerateHeaderLines(&parsed_iter, &parsed_name,
+                                      &parsed_value)) {
+    ASSERT_TRUE(
+        built->EnumerateHeaderLines(&built_iter, &built_name, &built_value));
+    EXPECT_EQ(parsed_name, built_name);
+    EXPECT_EQ(parsed_value, built_value);
+  }
+  EXPECT_FALSE(
+      built->EnumerateHeaderLines(&built_iter, &built_name, &built_value));
+
+  for (const char* name : {"cache-control", "set-cookie", "www-authenticate"}) {
+    parsed_iter = 0;
+    built_iter = 0;
+    while (parsed->EnumerateHeader(&parsed_iter, name, &parsed_value)) {
+      ASSERT_TRUE(built->EnumerateHeader(&built_iter, name, &built_value));
+      EXPECT_EQ(parsed_value, built_value);
+    }
+    EXPECT_FALSE(built->EnumerateHeader(&built_iter, name, &built_value));
+  }
+}
+
+TEST(HttpResponseHeadersTest, BuilderStatusLine) {
+  scoped_refptr<HttpResponseHeaders> built =
+      HttpResponseHeaders::Builder(HttpVersion(2, 0), "404").Build();
+  EXPECT_EQ("HTTP/2.0 404", built->GetStatusLine());
+  EXPECT_EQ(404, built->response_code());
+  EXPECT_EQ(std::string("HTTP/2.0 404\0\0", 14), built->raw_headers());
+}
+
+TEST(HttpResponseHeadersTest, LookupIgnoresCase) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Content-TYPE: text/html\n"
+      "x-custom-header: 1\n"
+      "X-Custom-Header: 2\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<HttpResponseHeaders> parsed(new HttpResponseHeaders(headers));
+
+  EXPECT_TRUE(parsed->HasHeader("content-type"));
+  EXPECT_TRUE(parsed->HasHeader("CONTENT-type"));
+  EXPECT_FALSE(parsed->HasHeader("content-typ"));
+  EXPECT_FALSE(parsed->HasHeader("content-types"));
+
+  std::string value;
+  EXPECT_TRUE(parsed->GetNormalizedHeader("X-CUSTOM-HEADER", &value));
+  EXPECT_EQ("1, 2", value);
+}
+
+// Tests that repeated headers are found in order when other headers come
+// between them, and that the lookups follow edits of the headers.
+TEST(HttpResponseHeadersTest, LookupRepeatedHeaders) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Set-Cookie: a\n"
+      "Vary: x, y\n"
+      "set-cookie: b\n"
+      "Vary: z\n"
+      "SET-COOKIE: c\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<HttpResponseHeaders> parsed(new HttpResponseHeaders(headers));
+
+  size_t iter = 0;
+  std::string value;
+  std::vector<std::string> values;
+  while (parsed->EnumerateHeader(&iter, "vary", &value))
+    values.push_back(value);
+  EXPECT_EQ(std::vector<std::string>({"x", "y", "z"}), values);
+  EXPECT_TRUE(parsed->GetNormalizedHeader("Set-Cookie", &value));
+  EXPECT_EQ("a, b, c", value);
+
+  parsed->RemoveHeader("vary");
+  EXPECT_FALSE(parsed->HasHeader("Vary"));
+  parsed->AddHeader("Vary: w");
+  EXPECT_TRUE(parsed->GetNormalizedHeader("vary", &value));
+  EXPECT_EQ("w", value);
+  EXPECT_TRUE(parsed->GetNormalizedHeader("set-cookie", &value));
+  EXPECT_EQ("a, b, c", value);
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_Challenge) {
   // Even though WWW-Authenticate has commas, it should not be treated as
   // coalesced values.
@@ -9,8 +9,10 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
+#include "base/memory/weak_ptr.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/rand_util.h"
 #include "base/stl_util.h"
@@ -174,13 +176,21 @@ void RecordRequestOutcome(NetworkErrorLoggingService::RequestOutcome outcome) {
 
 class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
  public:
-  explicit NetworkErrorLoggingServiceImpl(
-      std::unique_ptr<NetworkErrorLoggingDelegate> delegate)
-      : delegate_(std::move(delegate)) {
+  NetworkErrorLoggingServiceImpl(
+      std::unique_ptr<NetworkErrorLoggingDelegate> delegate,
+      PersistentNelStore* store)
+      : delegate_(std::move(delegate)),
+        store_(store),
+        initialized_(!store),
+        started_loading_(false),
+        weak_factory_(this) {
     DCHECK(delegate_);
   }
 
-  ~NetworkErrorLoggingServiceImpl() override = default;
+  ~NetworkErrorLoggingServiceImpl() override {
+    if (store_ && initialized_)
+      store_->Flush();
+  }
 
   // NetworkErrorLoggingService implementation:
 
@@ -194,7 +204,140 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
       return;
     }
 
-    OriginPolicy policy;
+    if (initialized_) {
+      DoOnHeader(origin, received_ip_address, value);
+      return;
+    }
+    BacklogTask(base::BindOnce(&NetworkErrorLoggingServiceImpl::DoOnHeader,
+                               weak_factory_.GetWeakPtr(), origin,
+                               received_ip_address, value));
+  }
+
+  void OnRequest(RequestDetails details) override {
+    if (!reporting_service_) {
+      RecordRequestOutcome(RequestOutcome::DISCARDED_NO_REPORTING_SERVICE);
+      return;
+    }
+
+    // This method is only called on secure requests.
+    DCHECK(details.uri.SchemeIsCryptographic());
+
+    if (initialized_) {
+      DoOnRequest(std::move(details));
+      return;
+    }
+    BacklogTask(base::BindOnce(&NetworkErrorLoggingServiceImpl::DoOnRequest,
+                               weak_factory_.GetWeakPtr(), std::move(details)));
+  }
+
+  void RemoveBrowsingData(const base::RepeatingCallback<bool(const GURL&)>&
+                              origin_filter) override {
+    if (initialized_) {
+      DoRemoveBrowsingData(origin_filter);
+      return;
+    }
+    BacklogTask(
+        base::BindOnce(&NetworkErrorLoggingServiceImpl::DoRemoveBrowsingData,
+                       weak_factory_.GetWeakPtr(), origin_filter));
+  }
+
+  void RemoveAllBrowsingData() override {
+    if (initialized_) {
+      DoRemoveAllBrowsingData();
+      return;
+    }
+    BacklogTask(
+        base::BindOnce(&NetworkErrorLoggingServiceImpl::DoRemoveAllBrowsingData,
+                       weak_factory_.GetWeakPtr()));
+  }
+
+  bool HasLoadedPolicies() const override { return initialized_; }
+
+  base::Value StatusAsValue() const override {
+    base::Value dict(base::Value::Type::DICTIONARY);
+    std::vector<base::Value> policy_list;
+    // We wanted sorted (or at least reproducible) output; luckily, policies_ is
+    // a std::map, and therefore already sorted.
+    for (const auto& origin_and_policy : policies_) {
+      const auto& origin = origin_and_policy.first;
+      const auto& policy = origin_and_policy.second;
+      base::Value policy_dict(base::Value::Type::DICTIONARY);
+      policy_dict.SetKey("origin", base::Value(origin.Serialize()));
+      policy_dict.SetKey("includeSubdomains",
+                         base::Value(policy.include_subdomains));
+      policy_dict.SetKey("reportTo", base::Value(policy.report_to));
+      policy_dict.SetKey("expires",
+                         base::Value(NetLog::TimeToString(policy.expires)));
+      policy_dict.SetKey("successFraction",
+                         base::Value(policy.success_fraction));
+      policy_dict.SetKey("failureFraction",
+                         base::Value(policy.failure_fraction));
+      policy_list.push_back(std::move(policy_dict));
+    }
+    dict.SetKey("originPolicies", base::Value(std::move(policy_list)));
+    return dict;
+  }
+
+  std::set<url::Origin> GetPolicyOriginsForTesting() override {
+    std::set<url::Origin> origins;
+    for (const auto& entry : policies_) {
+      origins.insert(entry.first);
+    }
+    return origins;
+  }
+
+ private:
+  // Queues |task| until the policies are loaded, and starts loading them.
+  // Callers run their task directly once the policies are loaded, which is
+  // always the case without a store, so that the common path doesn't bind a
+  // callback per request.
+  void BacklogTask(base::OnceClosure task) {
+    DCHECK(!initialized_);
+    task_backlog_.push_back(std::move(task));
+    if (started_loading_)
+      return;
+
+    started_loading_ = true;
+    store_->LoadNelPolicies(
+        base::BindOnce(&NetworkErrorLoggingServiceImpl::OnPoliciesLoaded,
+                       weak_factory_.GetWeakPtr()));
+  }
+
+  void OnPoliciesLoaded(std::vector<NelPolicy> loaded_policies) {
+    DCHECK(!initialized_);
+
+    // Expired policies are only dropped here; lookups skip any that expire
+    // later.
+    base::Time now = clock_->Now();
+    for (NelPolicy& policy : loaded_policies) {
+      if (policy.expires <= now ||
+          (discard_stored_policy_filter_ &&
+           discard_stored_policy_filter_.Run(policy.origin.GetURL()))) {
+        store_->DeleteNelPolicy(policy);
+        continue;
+      }
+      if (policies_.find(policy.origin) == policies_.end())
+        AddPolicy(std::move(policy));
+    }
+
+    initialized_ = true;
+    std::vector<base::OnceClosure> backlog;
+    backlog.swap(task_backlog_);
+    for (base::OnceClosure& task : backlog)
+      std::move(task).Run();
+  }
+
+  void AddPolicy(NelPolicy policy) {
+    url::Origin origin = policy.origin;
+    auto inserted = policies_.insert(std::make_pair(origin, std::move(policy)));
+    DCHECK(inserted.second);
+    MaybeAddWildcardPolicy(origin, &inserted.first->second);
+  }
+
+  void DoOnHeader(const url::Origin& origin,
+                  const IPAddress& received_ip_address,
+                  const std::string& value) {
+    NelPolicy policy;
     policy.origin = origin;
     policy.received_ip_address = received_ip_address;
     HeaderOutcome outcome = ParseHeader(value, clock_->Now(), &policy);
@@ -204,6 +347,8 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
 
     auto it = policies_.find(origin);
     if (it != policies_.end()) {
+      if (store_)
+        store_->DeleteNelPolicy(it->second);
       MaybeRemoveWildcardPolicy(origin, &it->second);
       policies_.erase(it);
     }
@@ -212,22 +357,21 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
       return;
 
     DVLOG(1) << "Received NEL policy for " << origin;
-    auto inserted = policies_.insert(std::make_pair(origin, policy));
-    DCHECK(inserted.second);
-    MaybeAddWildcardPolicy(origin, &inserted.first->second);
+    if (store_)
+      store_->AddNelPolicy(policy);
+    AddPolicy(std::move(policy));
   }
 
-  void OnRequest(RequestDetails details) override {
+  void DoOnRequest(RequestDetails details) {
+    // The ReportingService may have been removed while the policies were
+    // loading.
     if (!reporting_service_) {
       RecordRequestOutcome(RequestOutcome::DISCARDED_NO_REPORTING_SERVICE);
       return;
     }
 
-    // This method is only called on secure requests.
-    DCHECK(details.uri.SchemeIsCryptographic());
-
     auto report_origin = url::Origin::Create(details.uri);
-    const OriginPolicy* policy = FindPolicyForOrigin(report_origin);
+    const NelPolicy* policy = FindPolicyForOrigin(report_origin);
     if (!policy) {
       RecordRequestOutcome(RequestOutcome::DISCARDED_NO_ORIGIN_POLICY);
       return;
@@ -302,8 +446,8 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
     RecordRequestOutcome(RequestOutcome::QUEUED);
   }
 
-  void RemoveBrowsingData(const base::RepeatingCallback<bool(const GURL&)>&
-                              origin_filter) override {
+  void DoRemoveBrowsingData(
+      const base::RepeatingCallback<bool(const GURL&)>& origin_filter) {
     std::vector<url::Origin> origins_to_remove;
 
     for (auto it = policies_.begin(); it != policies_.end(); ++it) {
@@ -313,68 +457,30 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
 
     for (auto it = origins_to_remove.begin(); it != origins_to_remove.end();
          ++it) {
+      if (store_)
+        store_->DeleteNelPolicy(policies_[*it]);
       MaybeRemoveWildcardPolicy(*it, &policies_[*it]);
       policies_.erase(*it);
     }
-  }
 
-  void RemoveAllBrowsingData() override {
-    wildcard_policies_.clear();
-    policies_.clear();
+    if (store_)
+      store_->Flush();
   }
 
-  base::Value StatusAsValue() const override {
-    base::Value dict(base::Value::Type::DICTIONARY);
-    std::vector<base::Value> policy_list;
-    // We wanted sorted (or at least reproducible) output; luckily, policies_ is
-    // a std::map, and therefore already sorted.
-    for (const auto& origin_and_policy : policies_) {
-      const auto& origin = origin_and_policy.first;
-      const auto& policy = origin_and_policy.second;
-      base::Value policy_dict(base::Value::Type::DICTIONARY);
-      policy_dict.SetKey("origin", base::Value(origin.Serialize()));
-      policy_dict.SetKey("includeSubdomains",
-                         base::Value(policy.include_subdomains));
-      policy_dict.SetKey("reportTo", base::Value(policy.report_to));
-      policy_dict.SetKey("expires",
-                         base::Value(NetLog::TimeToString(policy.expires)));
-      policy_dict.SetKey("successFraction",
-                         base::Value(policy.success_fraction));
-      policy_dict.SetKey("failureFraction",
-                         base::Value(policy.failure_fraction));
-      policy_list.push_back(std::move(policy_dict));
+  void DoRemoveAllBrowsingData() {
+    if (store_) {
+      for (const auto& origin_and_policy : policies_)
+        store_->DeleteNelPolicy(origin_and_policy.second);
+      store_->Flush();
     }
-    dict.SetKey("originPolicies", base::Value(std::move(policy_list)));
-    return dict;
-  }
 
-  std::set<url::Origin> GetPolicyOriginsForTesting() override {
-    std::set<url::Origin> origins;
-    for (const auto& entry : policies_) {
-      origins.insert(entry.first);
-    }
-    return origins;
+    wildcard_policies_.clear();
+    policies_.clear();
   }
 
- private:
-  // NEL Policy set by an origin.
-  struct OriginPolicy {
-    url::Origin origin;
-    IPAddress received_ip_address;
-
-    // Reporting API endpoint group to which reports should be sent.
-    std::string report_to;
-
-    base::Time expires;
-
-    double success_fraction;
-    double failure_fraction;
-    bool include_subdomains;
-  };
-
   // Map from origin to origin's (owned) policy.
   // Would be unordered_map, but url::Origin has no hash.
-  using PolicyMap = std::map<url::Origin, OriginPolicy>;
+  using PolicyMap = std::map<url::Origin, NelPolicy>;
 
   // Wildcard policies are policies for which the include_subdomains flag is
   // set.
@@ -388,16 +494,29 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
   // Policies in the map are unowned; they are pointers to the original in the
   // PolicyMap.
   using WildcardPolicyMap =
-      std::map<std::string, std::set<const OriginPolicy*>>;
+      std::map<std::string, std::set<const NelPolicy*>>;
 
   std::unique_ptr<NetworkErrorLoggingDelegate> delegate_;
 
+  // Unowned. May be null, in which case policies are not persisted.
+  PersistentNelStore* const store_;
+
   PolicyMap policies_;
   WildcardPolicyMap wildcard_policies_;
 
+  // Whether the policies have been loaded from |store_|. Always true if there
+  // is no store.
+  bool initialized_;
+  bool started_loading_;
+
+  // Calls made before the policies were loaded, run in order once they are.
+  std::vector<base::OnceClosure> task_backlog_;
+
+  base::WeakPtrFactory<NetworkErrorLoggingServiceImpl> weak_factory_;
+
   HeaderOutcome ParseHeader(const std::string& json_value,
                             base::Time now,
-                            OriginPolicy* policy_out) const {
+                            NelPolicy* policy_out) const {
     DCHECK(policy_out);
 
     if (json_value.size() > kMaxJsonSize)
@@ -456,14 +575,14 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
     }
   }
 
-  const OriginPolicy* FindPolicyForOrigin(const url::Origin& origin) const {
+  const NelPolicy* FindPolicyForOrigin(const url::Origin& origin) const {
     // TODO(juliatuttle): Clean out expired policies sometime/somewhere.
     auto it = policies_.find(origin);
     if (it != policies_.end() && clock_->Now() < it->second.expires)
       return &it->second;
 
     std::string domain = origin.host();
-    const OriginPolicy* wildcard_policy = nullptr;
+    const NelPolicy* wildcard_policy = nullptr;
     while (!wildcard_policy && !domain.empty()) {
       wildcard_policy = FindWildcardPolicyForDomain(domain);
       domain = GetSuperdomain(domain);
@@ -472,7 +591,7 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
     return wildcard_policy;
   }
 
-  const OriginPolicy* FindWildcardPolicyForDomain(
+  const NelPolicy* FindWildcardPolicyForDomain(
       const std::string& domain) const {
     DCHECK(!domain.empty());
 
@@ -498,7 +617,7 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
   }
 
   void MaybeAddWildcardPolicy(const url::Origin& origin,
-                              const OriginPolicy* policy) {
+                              const NelPolicy* policy) {
     DCHECK(policy);
     DCHECK_EQ(policy, &policies_[origin]);
 
@@ -510,7 +629,7 @@ class NetworkErrorLoggingServiceImpl : public NetworkErrorLoggingService {
   }
 
   void MaybeRemoveWildcardPolicy(const url::Origin& origin,
-                                 const OriginPolicy* policy) {
+                                 const NelPolicy* policy) {
     DCHECK(policy);
     DCHECK_EQ(policy, &policies_[origin]);
 
@@ -556,6 +675,13 @@ NetworkErrorLoggingService::RequestDetails::RequestDetails(
 
 NetworkErrorLoggingService::RequestDetails::~RequestDetails() = default;
 
+NetworkErrorLoggingService::NelPolicy::NelPolicy() = default;
+
+NetworkErrorLoggingService::NelPolicy::NelPolicy(const NelPolicy& other) =
+    default;
+
+NetworkErrorLoggingService::NelPolicy::~NelPolicy() = default;
+
 const char NetworkErrorLoggingService::kHeaderName[] = "NEL";
 
 const char NetworkErrorLoggingService::kReportType[] = "network-error";
@@ -623,7 +749,15 @@ void NetworkErrorLoggingService::RecordRequestDiscardedForInsecureOrigin() {
 // static
 std::unique_ptr<NetworkErrorLoggingService> NetworkErrorLoggingService::Create(
     std::unique_ptr<NetworkErrorLoggingDelegate> delegate) {
-  return std::make_unique<NetworkErrorLoggingServiceImpl>(std::move(delegate));
+  return Create(std::move(delegate), nullptr);
+}
+
+// static
+std::unique_ptr<NetworkErrorLoggingService> NetworkErrorLoggingService::Create(
+    std::unique_ptr<NetworkErrorLoggingDelegate> delegate,
+    PersistentNelStore* store) {
+  return std::make_unique<NetworkErrorLoggingServiceImpl>(std::move(delegate),
+                                                          store);
 }
 
 NetworkErrorLoggingService::~NetworkErrorLoggingService() = default;
@@ -633,10 +767,19 @@ void NetworkErrorLoggingService::SetReportingService(
   reporting_service_ = reporting_service;
 }
 
+void NetworkErrorLoggingService::SetDiscardStoredPolicyFilter(
+    const base::RepeatingCallback<bool(const GURL&)>& origin_filter) {
+  discard_stored_policy_filter_ = origin_filter;
+}
+
 void NetworkErrorLoggingService::SetClockForTesting(const base::Clock* clock) {
   clock_ = clock;
 }
 
+bool NetworkErrorLoggingService::HasLoadedPolicies() const {
+  return true;
+}
+
 base::Value NetworkErrorLoggingService::StatusAsValue() const {
   NOTIMPLEMENTED();
   return base::Value();
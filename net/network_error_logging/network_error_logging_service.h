@@ -9,7 +9,9 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "base/callback.h"
 #include "base/feature_list.h"
 #include "base/macros.h"
 #include "base/time/clock.h"
@@ -71,6 +73,52 @@ class NET_EXPORT NetworkErrorLoggingService {
     int reporting_upload_depth;
   };
 
+  // NEL policy set by an origin.
+  struct NET_EXPORT NelPolicy {
+    NelPolicy();
+    NelPolicy(const NelPolicy& other);
+    ~NelPolicy();
+
+    url::Origin origin;
+    IPAddress received_ip_address;
+
+    // Reporting API endpoint group to which reports should be sent.
+    std::string report_to;
+
+    base::Time expires;
+
+    double success_fraction = 0.0;
+    double failure_fraction = 1.0;
+    bool include_subdomains = false;
+  };
+
+  // Stores NEL policies across restarts. The service loads the stored policies
+  // the first time it is used, and queues any calls made before the load
+  // completes.
+  class NET_EXPORT PersistentNelStore {
+   public:
+    using NelPoliciesLoadedCallback =
+        base::OnceCallback<void(std::vector<NelPolicy>)>;
+
+    PersistentNelStore() = default;
+    virtual ~PersistentNelStore() = default;
+
+    // Initializes the store and retrieves all stored policies. This is called
+    // at most once, and |loaded_callback| is invoked on the calling sequence.
+    virtual void LoadNelPolicies(NelPoliciesLoadedCallback loaded_callback) = 0;
+
+    // Adds or deletes the policy for |policy.origin|. Changes may be batched
+    // and written to disk later.
+    virtual void AddNelPolicy(const NelPolicy& policy) = 0;
+    virtual void DeleteNelPolicy(const NelPolicy& policy) = 0;
+
+    // Writes any batched changes to disk.
+    virtual void Flush() = 0;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(PersistentNelStore);
+  };
+
   static const char kHeaderName[];
 
   static const char kReportType[];
@@ -146,6 +194,12 @@ class NET_EXPORT NetworkErrorLoggingService {
   static std::unique_ptr<NetworkErrorLoggingService> Create(
       std::unique_ptr<NetworkErrorLoggingDelegate> delegate);
 
+  // Like Create(), but backs the policies with |store|, which must outlive the
+  // NetworkErrorLoggingService. |store| may be nullptr.
+  static std::unique_ptr<NetworkErrorLoggingService> Create(
+      std::unique_ptr<NetworkErrorLoggingDelegate> delegate,
+      PersistentNelStore* store);
+
   virtual ~NetworkErrorLoggingService();
 
   // Ingests a "NEL:" header received for |origin| from |received_ip_address|
@@ -177,11 +231,23 @@ class NET_EXPORT NetworkErrorLoggingService {
   // optimization over passing an always-true filter to RemoveBrowsingData.
   virtual void RemoveAllBrowsingData() = 0;
 
+  // Returns whether the policies are in memory. A service backed by a
+  // PersistentNelStore loads them when it is first used, so until then
+  // removing browsing data starts a load of the whole store.
+  virtual bool HasLoadedPolicies() const;
+
   // Sets the ReportingService that will be used to queue network error reports.
   // If |nullptr| is passed, reports will be queued locally or discarded.
   // |reporting_service| must outlive the NetworkErrorLoggingService.
   void SetReportingService(ReportingService* reporting_service);
 
+  // Sets a filter for origins whose stored policies are deleted instead of
+  // used when the policies are loaded from the PersistentNelStore, such as
+  // origins whose data must not outlive the session that stored it. Policies
+  // set later are not affected.
+  void SetDiscardStoredPolicyFilter(
+      const base::RepeatingCallback<bool(const GURL&)>& origin_filter);
+
   // Sets a base::Clock (used to track policy expiration) for tests.
   // |clock| must outlive the NetworkErrorLoggingService, and cannot be
   // nullptr.
@@ -201,6 +267,9 @@ class NET_EXPORT NetworkErrorLoggingService {
   const base::Clock* clock_;
   ReportingService* reporting_service_;
 
+  // May be null.
+  base::RepeatingCallback<bool(const GURL&)> discard_stored_policy_filter_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(NetworkErrorLoggingService);
 };
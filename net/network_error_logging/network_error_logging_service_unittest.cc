@@ -2,8 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/bind.h"
@@ -108,6 +110,52 @@ class TestReportingService : public ReportingService {
   DISALLOW_COPY_AND_ASSIGN(TestReportingService);
 };
 
+// A PersistentNelStore that keeps the policies in memory and completes loads
+// only when FinishLoading() is called.
+class TestPersistentNelStore
+    : public NetworkErrorLoggingService::PersistentNelStore {
+ public:
+  TestPersistentNelStore() = default;
+  ~TestPersistentNelStore() override = default;
+
+  void LoadNelPolicies(NelPoliciesLoadedCallback loaded_callback) override {
+    ++load_count_;
+    loaded_callback_ = std::move(loaded_callback);
+  }
+
+  void AddNelPolicy(
+      const NetworkErrorLoggingService::NelPolicy& policy) override {
+    policies_[policy.origin] = policy;
+  }
+
+  void DeleteNelPolicy(
+      const NetworkErrorLoggingService::NelPolicy& policy) override {
+    policies_.erase(policy.origin);
+  }
+
+  void Flush() override {}
+
+  void FinishLoading() {
+    std::vector<NetworkErrorLoggingService::NelPolicy> policies;
+    for (const auto& origin_and_policy : policies_)
+      policies.push_back(origin_and_policy.second);
+    std::move(loaded_callback_).Run(std::move(policies));
+  }
+
+  const std::map<url::Origin, NetworkErrorLoggingService::NelPolicy>&
+  policies() const {
+    return policies_;
+  }
+  int load_count() const { return load_count_; }
+
+ private:
+  std::map<url::Origin, NetworkErrorLoggingService::NelPolicy> policies_;
+  NelPoliciesLoadedCallback loaded_callback_;
+  int load_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TestPersistentNelStore);
+};
+
 class NetworkErrorLoggingServiceTest : public ::testing::Test {
  protected:
   NetworkErrorLoggingServiceTest() {
@@ -151,6 +199,15 @@ class NetworkErrorLoggingServiceTest : public ::testing::Test {
     return details;
   }
 
+  // Replaces the service with one backed by store().
+  void CreateServiceWithStore() {
+    service_ = NetworkErrorLoggingService::Create(
+        NetworkErrorLoggingDelegate::Create(), &store_);
+    service_->SetReportingService(reporting_service_.get());
+  }
+
+  TestPersistentNelStore& store() { return store_; }
+
   NetworkErrorLoggingService* service() { return service_.get(); }
   const std::vector<TestReportingService::Report>& reports() {
     return reporting_service_->reports();
@@ -189,6 +246,8 @@ class NetworkErrorLoggingServiceTest : public ::testing::Test {
   const GURL kReferrer_ = GURL("https://referrer.com/");
 
  private:
+  // Declared before |service_|, which flushes it on destruction.
+  TestPersistentNelStore store_;
   std::unique_ptr<NetworkErrorLoggingService> service_;
   std::unique_ptr<TestReportingService> reporting_service_;
 };
@@ -780,6 +839,84 @@ TEST_F(NetworkErrorLoggingServiceTest, RemoveSomeBrowsingData) {
   ASSERT_EQ(1u, reports().size());
 }
 
+TEST_F(NetworkErrorLoggingServiceTest, PersistsPolicies) {
+  CreateServiceWithStore();
+  service()->OnHeader(kOrigin_, kServerIP_, kHeader_);
+  service()->OnHeader(kOriginDifferentHost_, kServerIP_, kHeader_);
+
+  // Nothing is applied until the stored policies are loaded.
+  EXPECT_EQ(1, store().load_count());
+  EXPECT_TRUE(store().policies().empty());
+  EXPECT_FALSE(service()->HasLoadedPolicies());
+  store().FinishLoading();
+  EXPECT_TRUE(service()->HasLoadedPolicies());
+  EXPECT_EQ(2u, store().policies().size());
+
+  service()->OnHeader(kOriginDifferentHost_, kServerIP_, kHeaderMaxAge0_);
+  EXPECT_EQ(1u, store().policies().count(kOrigin_));
+  EXPECT_EQ(0u, store().policies().count(kOriginDifferentHost_));
+
+  service()->RemoveAllBrowsingData();
+  EXPECT_TRUE(store().policies().empty());
+}
+
+TEST_F(NetworkErrorLoggingServiceTest, LoadsPoliciesBeforeFirstRequest) {
+  NetworkErrorLoggingService::NelPolicy policy;
+  policy.origin = kOrigin_;
+  policy.received_ip_address = kServerIP_;
+  policy.report_to = kGroup_;
+  policy.expires = base::Time::Now() + base::TimeDelta::FromDays(1);
+  store().AddNelPolicy(policy);
+
+  // An expired policy is dropped from the store when it is loaded.
+  policy.origin = kOriginDifferentHost_;
+  policy.expires = base::Time::Now() - base::TimeDelta::FromDays(1);
+  store().AddNelPolicy(policy);
+
+  CreateServiceWithStore();
+  service()->OnRequest(MakeRequestDetails(kUrl_, ERR_CONNECTION_REFUSED));
+  service()->OnRequest(
+      MakeRequestDetails(kUrlDifferentHost_, ERR_CONNECTION_REFUSED));
+  EXPECT_TRUE(reports().empty());
+
+  store().FinishLoading();
+  ASSERT_EQ(1u, reports().size());
+  EXPECT_EQ(kUrl_, reports()[0].url);
+  EXPECT_EQ(1u, store().policies().size());
+  EXPECT_EQ(1, store().load_count());
+}
+
+// Policies stored in a session that never loaded them are still dropped if
+// their origin must not keep data across sessions.
+TEST_F(NetworkErrorLoggingServiceTest, DiscardsFilteredStoredPolicies) {
+  NetworkErrorLoggingService::NelPolicy policy;
+  policy.origin = kOrigin_;
+  policy.received_ip_address = kServerIP_;
+  policy.report_to = kGroup_;
+  policy.expires = base::Time::Now() + base::TimeDelta::FromDays(1);
+  store().AddNelPolicy(policy);
+  policy.origin = kOriginDifferentHost_;
+  store().AddNelPolicy(policy);
+
+  CreateServiceWithStore();
+  const url::Origin discarded_origin = kOrigin_;
+  service()->SetDiscardStoredPolicyFilter(base::BindRepeating(
+      [](const url::Origin& discarded_origin, const GURL& url) {
+        return url::Origin::Create(url) == discarded_origin;
+      },
+      discarded_origin));
+  service()->OnRequest(MakeRequestDetails(kUrl_, ERR_CONNECTION_REFUSED));
+  store().FinishLoading();
+
+  EXPECT_TRUE(reports().empty());
+  EXPECT_EQ(0u, store().policies().count(kOrigin_));
+  EXPECT_EQ(1u, store().policies().count(kOriginDifferentHost_));
+
+  // Policies set after the load are kept.
+  service()->OnHeader(kOrigin_, kServerIP_, kHeader_);
+  EXPECT_EQ(1u, store().policies().count(kOrigin_));
+}
+
 TEST_F(NetworkErrorLoggingServiceTest, Nested) {
   service()->OnHeader(kOrigin_, kServerIP_, kHeader_);
 
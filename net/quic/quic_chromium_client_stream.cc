@@ -21,6 +21,7 @@
 #include "net/third_party/quic/core/http/spdy_utils.h"
 #include "net/third_party/quic/core/quic_utils.h"
 #include "net/third_party/quic/core/quic_write_blocked_list.h"
+#include "net/third_party/quic/platform/api/quic_mem_slice_span.h"
 
 namespace net {
 namespace {
@@ -239,6 +240,22 @@ int QuicChromiumClientStream::Handle::WritevStreamData(
   return ERR_IO_PENDING;
 }
 
+int QuicChromiumClientStream::Handle::WritevStreamDataNoCopy(
+    const std::vector<scoped_refptr<IOBuffer>>& buffers,
+    const std::vector<int>& lengths,
+    bool fin,
+    CompletionOnceCallback callback) {
+  ScopedBoolSaver saver(&may_invoke_callbacks_, false);
+  if (!stream_)
+    return net_error_;
+
+  if (stream_->WritevStreamDataNoCopy(buffers, lengths, fin))
+    return HandleIOComplete(OK);
+
+  SetCallback(std::move(callback), &write_callback_);
+  return ERR_IO_PENDING;
+}
+
 int QuicChromiumClientStream::Handle::Read(IOBuffer* buf, int buf_len) {
   if (!stream_)
     return net_error_;
@@ -575,6 +592,23 @@ bool QuicChromiumClientStream::WritevStreamData(
   return !HasBufferedData();  // Was all data written?
 }
 
+bool QuicChromiumClientStream::WritevStreamDataNoCopy(
+    const std::vector<scoped_refptr<IOBuffer>>& buffers,
+    const std::vector<int>& lengths,
+    bool fin) {
+  // Must not be called when data is buffered.
+  DCHECK(!HasBufferedData());
+  DCHECK_EQ(buffers.size(), lengths.size());
+  quic::QuicMemSliceSpan span(quic::QuicMemSliceSpanImpl(
+      buffers.data(), lengths.data(), buffers.size()));
+  // Slices are only saved if the send buffer is below its limit, which it is
+  // when nothing is buffered. Otherwise fall back to copying the data.
+  quic::QuicConsumedData consumed = WriteBodySlices(span, fin);
+  if (consumed.bytes_consumed == 0 && !span.empty())
+    return WritevStreamData(buffers, lengths, fin);
+  return !HasBufferedData();  // Was all data written?
+}
+
 std::unique_ptr<QuicChromiumClientStream::Handle>
 QuicChromiumClientStream::CreateHandle() {
   DCHECK(!handle_);
@@ -96,6 +96,15 @@ class NET_EXPORT_PRIVATE QuicChromiumClientStream
                          bool fin,
                          CompletionOnceCallback callback);
 
+    // Same as WritevStreamData except the stream keeps references to
+    // |buffers| until their data is acked instead of copying it, so the
+    // caller must not modify them afterwards.
+    int WritevStreamDataNoCopy(
+        const std::vector<scoped_refptr<IOBuffer>>& buffers,
+        const std::vector<int>& lengths,
+        bool fin,
+        CompletionOnceCallback callback);
+
     // Reads at most |buf_len| bytes into |buf|. Returns the number of bytes
     // read.
     int Read(IOBuffer* buf, int buf_len);
@@ -246,6 +255,13 @@ class NET_EXPORT_PRIVATE QuicChromiumClientStream
   bool WritevStreamData(const std::vector<scoped_refptr<IOBuffer>>& buffers,
                         const std::vector<int>& lengths,
                         bool fin);
+  // Same as WritevStreamData except |buffers| are saved in the send buffer as
+  // reference counted slices rather than copied. They must not be modified
+  // afterwards.
+  bool WritevStreamDataNoCopy(
+      const std::vector<scoped_refptr<IOBuffer>>& buffers,
+      const std::vector<int>& lengths,
+      bool fin);
 
   // Creates a new Handle for this stream. Must only be called once.
   std::unique_ptr<QuicChromiumClientStream::Handle> CreateHandle();
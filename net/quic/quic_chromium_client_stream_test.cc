@@ -22,6 +22,7 @@
 #include "net/third_party/quic/core/http/spdy_utils.h"
 #include "net/third_party/quic/core/quic_utils.h"
 #include "net/third_party/quic/core/tls_client_handshaker.h"
+#include "net/third_party/quic/platform/api/quic_flags.h"
 #include "net/third_party/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quic/test_tools/crypto_test_utils.h"
 #include "net/third_party/quic/test_tools/quic_spdy_session_peer.h"
@@ -838,6 +839,81 @@ TEST_P(QuicChromiumClientStreamTest, WritevStreamDataAsync) {
   EXPECT_THAT(callback.WaitForResult(), IsOk());
 }
 
+TEST_P(QuicChromiumClientStreamTest, WritevStreamDataNoCopy) {
+  testing::InSequence seq;
+  scoped_refptr<StringIOBuffer> buf1 =
+      base::MakeRefCounted<StringIOBuffer>("hello world!");
+  scoped_refptr<StringIOBuffer> buf2 =
+      base::MakeRefCounted<StringIOBuffer>("Just a small payload");
+
+  // Both buffers are saved before anything is written, so they are written
+  // together.
+  if (GetParam() == quic::QUIC_VERSION_99) {
+    quic::QuicString header =
+        ConstructDataHeader(buf1->size() + buf2->size());
+    EXPECT_CALL(session_, WritevData(stream_, stream_->id(), _, _, _))
+        .WillOnce(Return(quic::QuicConsumedData(header.length(), false)));
+  }
+  EXPECT_CALL(session_, WritevData(stream_, stream_->id(), _, _, _))
+      .WillOnce(
+          Return(quic::QuicConsumedData(buf1->size() + buf2->size(), true)));
+  TestCompletionCallback callback;
+  EXPECT_EQ(OK, handle_->WritevStreamDataNoCopy(
+                    {buf1, buf2}, {buf1->size(), buf2->size()}, true,
+                    callback.callback()));
+
+  // The send buffer references the data until it is acked.
+  EXPECT_FALSE(buf1->HasOneRef());
+  EXPECT_FALSE(buf2->HasOneRef());
+}
+
+// Tests that WritevStreamDataNoCopy() copies the data when the stream won't
+// take the slices, and that the data is only written once.
+TEST_P(QuicChromiumClientStreamTest, WritevStreamDataNoCopyFallback) {
+  // With no room in the send buffer, WriteBodySlices() consumes nothing even
+  // though nothing is buffered.
+  const uint32_t buffered_data_threshold =
+      GetQuicFlag(FLAGS_quic_buffered_data_threshold);
+  SetQuicFlag(&FLAGS_quic_buffered_data_threshold, 0);
+  QuicChromiumClientStream* stream2 = new QuicChromiumClientStream(
+      GetNthClientInitiatedBidirectionalStreamId(1), &session_,
+      quic::BIDIRECTIONAL, NetLogWithSource(), TRAFFIC_ANNOTATION_FOR_TESTS);
+  SetQuicFlag(&FLAGS_quic_buffered_data_threshold, buffered_data_threshold);
+  session_.ActivateStream(base::WrapUnique(stream2));
+  handle2_ = stream2->CreateHandle();
+
+  testing::InSequence seq;
+  scoped_refptr<StringIOBuffer> buf1 =
+      base::MakeRefCounted<StringIOBuffer>("hello world!");
+  scoped_refptr<StringIOBuffer> buf2 =
+      base::MakeRefCounted<StringIOBuffer>("Just a small payload");
+
+  // Each buffer is written once, in its own DATA frame.
+  if (GetParam() == quic::QUIC_VERSION_99) {
+    quic::QuicString header = ConstructDataHeader(buf1->size());
+    EXPECT_CALL(session_, WritevData(stream2, stream2->id(), _, _, _))
+        .WillOnce(Return(quic::QuicConsumedData(header.length(), false)));
+  }
+  EXPECT_CALL(session_, WritevData(stream2, stream2->id(), _, _, _))
+      .WillOnce(Return(quic::QuicConsumedData(buf1->size(), false)));
+  if (GetParam() == quic::QUIC_VERSION_99) {
+    quic::QuicString header = ConstructDataHeader(buf2->size());
+    EXPECT_CALL(session_, WritevData(stream2, stream2->id(), _, _, _))
+        .WillOnce(Return(quic::QuicConsumedData(header.length(), false)));
+  }
+  EXPECT_CALL(session_, WritevData(stream2, stream2->id(), _, _, _))
+      .WillOnce(Return(quic::QuicConsumedData(buf2->size(), true)));
+  TestCompletionCallback callback;
+  EXPECT_EQ(OK, handle2_->WritevStreamDataNoCopy(
+                    {buf1, buf2}, {buf1->size(), buf2->size()}, true,
+                    callback.callback()));
+
+  // The data was copied, so the buffers aren't referenced by the stream.
+  EXPECT_TRUE(buf1->HasOneRef());
+  EXPECT_TRUE(buf2->HasOneRef());
+  EXPECT_TRUE(handle2_->fin_sent());
+}
+
 TEST_P(QuicChromiumClientStreamTest, HeadersBeforeHandle) {
   // We don't use stream_ because we want an incoming server push
   // stream.
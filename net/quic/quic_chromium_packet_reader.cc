@@ -5,10 +5,12 @@
 #include "net/quic/quic_chromium_packet_reader.h"
 
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/location.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/single_thread_task_runner.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "net/base/features.h"
 #include "net/base/net_errors.h"
 #include "net/third_party/quic/platform/api/quic_clock.h"
 
@@ -29,10 +31,22 @@ QuicChromiumPacketReader::QuicChromiumPacketReader(
       yield_after_packets_(yield_after_packets),
       yield_after_duration_(yield_after_duration),
       yield_after_(quic::QuicTime::Infinite()),
-      read_buffer_(base::MakeRefCounted<IOBufferWithSize>(
-          static_cast<size_t>(quic::kMaxPacketSize))),
       net_log_(net_log),
-      weak_factory_(this) {}
+      weak_factory_(this) {
+  size_t num_buffers =
+      base::FeatureList::IsEnabled(features::kQuicBatchedPacketReads)
+          ? kQuicPacketReadBatchSize
+          : 1;
+  for (size_t i = 0; i < num_buffers; ++i) {
+    read_buffers_.push_back(base::MakeRefCounted<IOBufferWithSize>(
+        static_cast<size_t>(quic::kMaxPacketSize)));
+  }
+  // Coalesced packets are only split up again by ReadMultiple().
+  if (batched_reads() &&
+      base::FeatureList::IsEnabled(features::kQuicUdpSegmentationOffload)) {
+    socket_->EnableCoalescedReads();
+  }
+}
 
 QuicChromiumPacketReader::~QuicChromiumPacketReader() {}
 
@@ -46,17 +60,15 @@ void QuicChromiumPacketReader::StartReading() {
 
     DCHECK(socket_);
     read_pending_ = true;
-    int rv =
-        socket_->Read(read_buffer_.get(), read_buffer_->size(),
-                      base::BindOnce(&QuicChromiumPacketReader::OnReadComplete,
-                                     weak_factory_.GetWeakPtr()));
+    int rv = Read();
     UMA_HISTOGRAM_BOOLEAN("Net.QuicSession.AsyncRead", rv == ERR_IO_PENDING);
     if (rv == ERR_IO_PENDING) {
       num_packets_read_ = 0;
       return;
     }
 
-    if (++num_packets_read_ > yield_after_packets_ ||
+    num_packets_read_ += batched_reads() && rv > 0 ? rv : 1;
+    if (num_packets_read_ > yield_after_packets_ ||
         clock_->Now() > yield_after_) {
       num_packets_read_ = 0;
       // Data was read, process it.
@@ -74,29 +86,77 @@ void QuicChromiumPacketReader::StartReading() {
 }
 
 size_t QuicChromiumPacketReader::EstimateMemoryUsage() const {
-  // Return the size of |read_buffer_|.
-  return quic::kMaxPacketSize;
+  // Return the size of |read_buffers_|.
+  return read_buffers_.size() * quic::kMaxPacketSize;
+}
+
+int QuicChromiumPacketReader::Read() {
+  if (batched_reads()) {
+    int rv = socket_->ReadMultiple(
+        read_buffers_, &read_lengths_,
+        base::BindOnce(&QuicChromiumPacketReader::OnReadComplete,
+                       weak_factory_.GetWeakPtr()));
+    if (rv != ERR_NOT_IMPLEMENTED)
+      return rv;
+    // The socket can't read batches, so read one packet at a time from now on.
+    read_buffers_.resize(1);
+    read_lengths_.clear();
+  }
+  IOBufferWithSize* read_buffer = read_buffers_.front().get();
+  return socket_->Read(read_buffer, read_buffer->size(),
+                       base::BindOnce(&QuicChromiumPacketReader::OnReadComplete,
+                                      weak_factory_.GetWeakPtr()));
 }
 
 bool QuicChromiumPacketReader::ProcessReadResult(int result) {
   read_pending_ = false;
-  if (result == 0)
-    result = ERR_CONNECTION_CLOSED;
-
   if (result < 0) {
     visitor_->OnReadError(result, socket_);
     return false;
   }
 
-  quic::QuicReceivedPacket packet(read_buffer_->data(), result, clock_->Now());
+  quic::QuicTime receipt_time = clock_->Now();
   IPEndPoint local_address;
   IPEndPoint peer_address;
   socket_->GetLocalAddress(&local_address);
   socket_->GetPeerAddress(&peer_address);
-  return visitor_->OnPacket(
-      packet,
-      quic::QuicSocketAddress(quic::QuicSocketAddressImpl(local_address)),
-      quic::QuicSocketAddress(quic::QuicSocketAddressImpl(peer_address)));
+  quic::QuicSocketAddress quic_local_address(
+      quic::QuicSocketAddressImpl(local_address));
+  quic::QuicSocketAddress quic_peer_address(
+      quic::QuicSocketAddressImpl(peer_address));
+  if (!batched_reads()) {
+    return ProcessPacket(read_buffers_.front()->data(), result, receipt_time,
+                         quic_local_address, quic_peer_address);
+  }
+
+  // All packets of a batch were received by the same system call, so they
+  // share a receipt time.
+  DCHECK_LE(static_cast<size_t>(result), read_lengths_.size());
+  for (int i = 0; i < result; ++i) {
+    if (!ProcessPacket(read_buffers_[i]->data(), read_lengths_[i],
+                       receipt_time, quic_local_address, quic_peer_address)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool QuicChromiumPacketReader::ProcessPacket(
+    const char* data,
+    int result,
+    quic::QuicTime receipt_time,
+    const quic::QuicSocketAddress& local_address,
+    const quic::QuicSocketAddress& peer_address) {
+  if (result == 0)
+    result = ERR_CONNECTION_CLOSED;
+
+  if (result < 0) {
+    visitor_->OnReadError(result, socket_);
+    return false;
+  }
+
+  quic::QuicReceivedPacket packet(data, result, receipt_time);
+  return visitor_->OnPacket(packet, local_address, peer_address);
 }
 
 void QuicChromiumPacketReader::OnReadComplete(int result) {
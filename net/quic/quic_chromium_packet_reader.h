@@ -6,6 +6,8 @@
 #ifndef NET_QUIC_QUIC_CHROMIUM_PACKET_READER_H_
 #define NET_QUIC_QUIC_CHROMIUM_PACKET_READER_H_
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/io_buffer.h"
@@ -26,6 +28,10 @@ namespace net {
 const int kQuicYieldAfterPacketsRead = 32;
 const int kQuicYieldAfterDurationMilliseconds = 2;
 
+// With the QuicBatchedPacketReads feature enabled, this many packets are read
+// from the socket with each DatagramClientSocket::ReadMultiple() call.
+const int kQuicPacketReadBatchSize = 16;
+
 class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
  public:
   class NET_EXPORT_PRIVATE Visitor {
@@ -54,10 +60,24 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
   size_t EstimateMemoryUsage() const;
 
  private:
-  // A completion callback invoked when a read completes.
+  bool batched_reads() const { return read_buffers_.size() > 1; }
+
+  // Starts reading a single packet, or a batch of packets in batched mode.
+  // Returns the socket's result.
+  int Read();
+  // A completion callback invoked when a read completes. In batched mode
+  // |result| is the number of packets read, otherwise it is the size of the
+  // packet read.
   void OnReadComplete(int result);
   // Return true if reading should continue.
   bool ProcessReadResult(int result);
+  // Passes one packet, or its read error, to |visitor_|. Returns true if
+  // reading should continue.
+  bool ProcessPacket(const char* data,
+                     int result,
+                     quic::QuicTime receipt_time,
+                     const quic::QuicSocketAddress& local_address,
+                     const quic::QuicSocketAddress& peer_address);
 
   DatagramClientSocket* socket_;
   Visitor* visitor_;
@@ -67,7 +87,11 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
   int yield_after_packets_;
   quic::QuicTime::Delta yield_after_duration_;
   quic::QuicTime yield_after_;
-  scoped_refptr<IOBufferWithSize> read_buffer_;
+  // Holds a single buffer, or kQuicPacketReadBatchSize buffers in batched
+  // mode.
+  std::vector<scoped_refptr<IOBufferWithSize>> read_buffers_;
+  // The result for each packet of the last batch read.
+  std::vector<int> read_lengths_;
   NetLogWithSource net_log_;
 
   base::WeakPtrFactory<QuicChromiumPacketReader> weak_factory_;
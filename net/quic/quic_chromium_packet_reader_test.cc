@@ -0,0 +1,208 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/quic_chromium_packet_reader.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/test/scoped_feature_list.h"
+#include "build/build_config.h"
+#include "net/base/features.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/log/net_log_source.h"
+#include "net/log/net_log_with_source.h"
+#include "net/socket/udp_client_socket.h"
+#include "net/socket/udp_server_socket.h"
+#include "net/test/gtest_util.h"
+#include "net/test/test_with_scoped_task_environment.h"
+#include "net/third_party/quic/test_tools/mock_clock.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::ElementsAre;
+
+namespace net {
+namespace test {
+namespace {
+
+// A UDPClientSocket that counts the reads made on it, and can pretend not to
+// support ReadMultiple().
+class CountingUDPClientSocket : public UDPClientSocket {
+ public:
+  explicit CountingUDPClientSocket(bool supports_read_multiple)
+      : UDPClientSocket(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource()),
+        supports_read_multiple_(supports_read_multiple) {}
+
+  int Read(IOBuffer* buf,
+           int buf_len,
+           CompletionOnceCallback callback) override {
+    ++num_reads_;
+    return UDPClientSocket::Read(buf, buf_len, std::move(callback));
+  }
+
+  int ReadMultiple(const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+                   std::vector<int>* lengths,
+                   CompletionOnceCallback callback) override {
+    ++num_read_multiple_calls_;
+    if (!supports_read_multiple_)
+      return ERR_NOT_IMPLEMENTED;
+    return UDPClientSocket::ReadMultiple(buffers, lengths, std::move(callback));
+  }
+
+  int num_reads() const { return num_reads_; }
+  int num_read_multiple_calls() const { return num_read_multiple_calls_; }
+
+ private:
+  const bool supports_read_multiple_;
+  int num_reads_ = 0;
+  int num_read_multiple_calls_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingUDPClientSocket);
+};
+
+class PacketRecorder : public QuicChromiumPacketReader::Visitor {
+ public:
+  PacketRecorder() {}
+
+  void OnReadError(int result, const DatagramClientSocket* socket) override {
+    errors_.push_back(result);
+  }
+
+  bool OnPacket(const quic::QuicReceivedPacket& packet,
+                const quic::QuicSocketAddress& local_address,
+                const quic::QuicSocketAddress& peer_address) override {
+    packets_.push_back(std::string(packet.data(), packet.length()));
+    return true;
+  }
+
+  const std::vector<std::string>& packets() const { return packets_; }
+  const std::vector<int>& errors() const { return errors_; }
+
+ private:
+  std::vector<std::string> packets_;
+  std::vector<int> errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(PacketRecorder);
+};
+
+class QuicChromiumPacketReaderTest : public TestWithScopedTaskEnvironment {
+ protected:
+  QuicChromiumPacketReaderTest()
+      : server_(nullptr, NetLogSource()),
+        yield_after_duration_(quic::QuicTime::Delta::FromMilliseconds(
+            kQuicYieldAfterDurationMilliseconds)) {}
+
+  void Connect(CountingUDPClientSocket* socket) {
+    IPEndPoint server_address(IPAddress::IPv4Localhost(), 0);
+    ASSERT_THAT(server_.Listen(server_address), IsOk());
+    ASSERT_THAT(server_.GetLocalAddress(&server_address), IsOk());
+    ASSERT_THAT(socket->Connect(server_address), IsOk());
+    ASSERT_THAT(socket->GetLocalAddress(&client_address_), IsOk());
+  }
+
+  // Loopback datagrams are queued by the time SendTo() returns, so the reader
+  // finds all of them on its first read.
+  void SendPackets(const std::vector<std::string>& packets) {
+    for (const std::string& packet : packets) {
+      scoped_refptr<StringIOBuffer> buffer =
+          base::MakeRefCounted<StringIOBuffer>(packet);
+      TestCompletionCallback callback;
+      ASSERT_EQ(buffer->size(),
+                callback.GetResult(server_.SendTo(buffer.get(), buffer->size(),
+                                                  client_address_,
+                                                  callback.callback())));
+    }
+  }
+
+  UDPServerSocket server_;
+  IPEndPoint client_address_;
+  quic::MockClock clock_;
+  const quic::QuicTime::Delta yield_after_duration_;
+  PacketRecorder visitor_;
+};
+
+TEST_F(QuicChromiumPacketReaderTest, BatchedReads) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitWithFeatures({features::kQuicBatchedPacketReads},
+                                {features::kQuicUdpSegmentationOffload});
+  CountingUDPClientSocket socket(/*supports_read_multiple=*/true);
+  Connect(&socket);
+  SendPackets({"first", "second", "third"});
+
+  QuicChromiumPacketReader reader(&socket, &clock_, &visitor_,
+                                  kQuicYieldAfterPacketsRead,
+                                  yield_after_duration_, NetLogWithSource());
+  reader.StartReading();
+  EXPECT_THAT(visitor_.packets(), ElementsAre("first", "second", "third"));
+  EXPECT_TRUE(visitor_.errors().empty());
+  EXPECT_EQ(0, socket.num_reads());
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // recvmmsg() returns all three packets at once, and the next call finds the
+  // socket empty.
+  EXPECT_EQ(2, socket.num_read_multiple_calls());
+#endif
+
+  // Packets arriving later complete the pending read.
+  SendPackets({"fourth"});
+  RunUntilIdle();
+  EXPECT_THAT(visitor_.packets(),
+              ElementsAre("first", "second", "third", "fourth"));
+}
+
+// Tests that every packet of a batch counts towards the yield threshold.
+TEST_F(QuicChromiumPacketReaderTest, BatchedReadsYield) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitWithFeatures({features::kQuicBatchedPacketReads},
+                                {features::kQuicUdpSegmentationOffload});
+  CountingUDPClientSocket socket(/*supports_read_multiple=*/true);
+  Connect(&socket);
+  SendPackets({"first", "second", "third"});
+
+  QuicChromiumPacketReader reader(&socket, &clock_, &visitor_,
+                                  /*yield_after_packets=*/2,
+                                  yield_after_duration_, NetLogWithSource());
+  reader.StartReading();
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // The first batch already holds more packets than the threshold, so it is
+  // processed in a posted task.
+  EXPECT_TRUE(visitor_.packets().empty());
+#endif
+  RunUntilIdle();
+  EXPECT_THAT(visitor_.packets(), ElementsAre("first", "second", "third"));
+  EXPECT_TRUE(visitor_.errors().empty());
+}
+
+// Tests that the reader reads one packet at a time from sockets that don't
+// support ReadMultiple().
+TEST_F(QuicChromiumPacketReaderTest, FallBackToRead) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(features::kQuicBatchedPacketReads);
+  CountingUDPClientSocket socket(/*supports_read_multiple=*/false);
+  Connect(&socket);
+  SendPackets({"first", "second"});
+
+  QuicChromiumPacketReader reader(&socket, &clock_, &visitor_,
+                                  kQuicYieldAfterPacketsRead,
+                                  yield_after_duration_, NetLogWithSource());
+  reader.StartReading();
+  EXPECT_THAT(visitor_.packets(), ElementsAre("first", "second"));
+  EXPECT_TRUE(visitor_.errors().empty());
+  // ReadMultiple() is only tried once. Two reads returned packets, and the
+  // last one is pending.
+  EXPECT_EQ(1, socket.num_read_multiple_calls());
+  EXPECT_EQ(3, socket.num_reads());
+  EXPECT_EQ(quic::kMaxPacketSize, reader.EstimateMemoryUsage());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -4,14 +4,17 @@
 
 #include "net/quic/quic_chromium_packet_writer.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/sparse_histogram.h"
+#include "net/base/features.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/quic/quic_chromium_client_session.h"
@@ -30,6 +33,10 @@ enum NotReusableReason {
 
 const int kMaxRetries = 12;  // 2^12 = 4 seconds, which should be a LOT.
 
+// Don't send more packets than this in one segmented write. The kernel allows
+// 64, but ~64KB total means at most 45 full-sized packets over IPv6.
+const size_t kMaxSegmentedWritePackets = 45;
+
 void RecordNotReusableReason(NotReusableReason reason) {
   UMA_HISTOGRAM_ENUMERATION("Net.QuicSession.WritePacketNotReusable", reason,
                             NUM_NOT_REUSABLE_REASONS);
@@ -69,7 +76,11 @@ const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
 }  // namespace
 
 QuicChromiumPacketWriter::ReusableIOBuffer::ReusableIOBuffer(size_t capacity)
-    : IOBuffer(capacity), capacity_(capacity), size_(0) {}
+    : IOBuffer(capacity),
+      capacity_(capacity),
+      size_(0),
+      num_segments_(0),
+      segment_size_(0) {}
 
 QuicChromiumPacketWriter::ReusableIOBuffer::~ReusableIOBuffer() {}
 
@@ -78,9 +89,31 @@ void QuicChromiumPacketWriter::ReusableIOBuffer::Set(const char* buffer,
   CHECK_LE(buf_len, capacity_);
   CHECK(HasOneRef());
   size_ = buf_len;
+  num_segments_ = 1;
+  segment_size_ = buf_len;
   std::memcpy(data(), buffer, buf_len);
 }
 
+void QuicChromiumPacketWriter::ReusableIOBuffer::Append(const char* buffer,
+                                                        size_t buf_len) {
+  if (num_segments_ == 0) {
+    Set(buffer, buf_len);
+    return;
+  }
+  CHECK_LE(size_ + buf_len, capacity_);
+  CHECK(HasOneRef());
+  DCHECK_LE(buf_len, segment_size_);
+  std::memcpy(data() + size_, buffer, buf_len);
+  size_ += buf_len;
+  num_segments_++;
+}
+
+void QuicChromiumPacketWriter::ReusableIOBuffer::Clear() {
+  size_ = 0;
+  num_segments_ = 0;
+  segment_size_ = 0;
+}
+
 QuicChromiumPacketWriter::QuicChromiumPacketWriter() : weak_factory_(this) {}
 
 QuicChromiumPacketWriter::QuicChromiumPacketWriter(
@@ -94,6 +127,11 @@ QuicChromiumPacketWriter::QuicChromiumPacketWriter(
       retry_count_(0),
       weak_factory_(this) {
   retry_timer_.SetTaskRunner(task_runner);
+  if (base::FeatureList::IsEnabled(features::kQuicUdpSegmentationOffload) &&
+      socket_->EnableSegmentedWrites() == OK) {
+    batch_mode_ = true;
+    packet_ = base::MakeRefCounted<ReusableIOBuffer>(quic::kMaxGsoPacketSize);
+  }
   write_callback_ = base::BindRepeating(
       &QuicChromiumPacketWriter::OnWriteComplete, weak_factory_.GetWeakPtr());
 }
@@ -123,6 +161,25 @@ void QuicChromiumPacketWriter::SetPacket(const char* buffer, size_t buf_len) {
     RecordNotReusableReason(NOT_REUSABLE_REF_COUNT);
   }
   packet_->Set(buffer, buf_len);
+  next_segment_ = 0;
+}
+
+bool QuicChromiumPacketWriter::CanAppendPacket(size_t buf_len) const {
+  if (!packet_ || packet_->num_segments() == 0)
+    return true;
+  return packet_->num_segments() < kMaxSegmentedWritePackets &&
+         buf_len <= packet_->segment_size() &&
+         packet_->size() + buf_len <= packet_->capacity();
+}
+
+void QuicChromiumPacketWriter::AppendPacket(const char* buffer,
+                                            size_t buf_len) {
+  if (UNLIKELY(!packet_ || !packet_->HasOneRef())) {
+    DCHECK(!packet_ || packet_->num_segments() == 0);
+    packet_ = base::MakeRefCounted<ReusableIOBuffer>(
+        std::max(buf_len, static_cast<size_t>(quic::kMaxGsoPacketSize)));
+  }
+  packet_->Append(buffer, buf_len);
 }
 
 quic::WriteResult QuicChromiumPacketWriter::WritePacket(
@@ -132,14 +189,40 @@ quic::WriteResult QuicChromiumPacketWriter::WritePacket(
     const quic::QuicSocketAddress& peer_address,
     quic::PerPacketOptions* /*options*/) {
   DCHECK(!IsWriteBlocked());
-  SetPacket(buffer, buf_len);
-  return WritePacketToSocketImpl();
+  if (!batch_mode_) {
+    SetPacket(buffer, buf_len);
+    return WritePacketToSocketImpl();
+  }
+
+  if (!CanAppendPacket(buf_len)) {
+    // This packet is not buffered if the flush blocks, so the connection
+    // queues it until the flushed packets are written.
+    quic::WriteResult result = Flush();
+    if (result.status != quic::WRITE_STATUS_OK)
+      return result;
+    // The flush may have found that the platform can't do segmented writes.
+    if (!batch_mode_) {
+      SetPacket(buffer, buf_len);
+      return WritePacketToSocketImpl();
+    }
+  }
+  AppendPacket(buffer, buf_len);
+
+  // Only the last packet of a segmented write may be shorter than the others,
+  // so send the batch as soon as it ends or is full.
+  if (buf_len < packet_->segment_size() ||
+      packet_->num_segments() == kMaxSegmentedWritePackets ||
+      packet_->size() + packet_->segment_size() > packet_->capacity()) {
+    return FlushBufferedPackets();
+  }
+  return quic::WriteResult(quic::WRITE_STATUS_OK, 0);
 }
 
 void QuicChromiumPacketWriter::WritePacketToSocket(
     scoped_refptr<ReusableIOBuffer> packet) {
   DCHECK(!force_write_blocked_);
   packet_ = std::move(packet);
+  next_segment_ = 0;
   quic::WriteResult result = WritePacketToSocketImpl();
   if (result.error_code != ERR_IO_PENDING)
     OnWriteComplete(result.error_code);
@@ -148,8 +231,23 @@ void QuicChromiumPacketWriter::WritePacketToSocket(
 quic::WriteResult QuicChromiumPacketWriter::WritePacketToSocketImpl() {
   base::TimeTicks now = base::TimeTicks::Now();
 
-  int rv = socket_->Write(packet_.get(), packet_->size(), write_callback_,
-                          kTrafficAnnotation);
+  int rv;
+  if (packet_->num_segments() > 1 && !batch_mode_) {
+    rv = WriteSegmentsIndividually();
+  } else if (packet_->num_segments() > 1) {
+    rv = socket_->WriteSegmented(packet_.get(), packet_->size(),
+                                 packet_->segment_size(), write_callback_,
+                                 kTrafficAnnotation);
+    if (rv == ERR_NOT_IMPLEMENTED) {
+      DisableBatchMode();
+      rv = WriteSegmentsIndividually();
+    }
+  } else {
+    rv = socket_->Write(packet_.get(), packet_->size(), write_callback_,
+                        kTrafficAnnotation);
+  }
+  if (batch_mode_ && rv >= 0)
+    packet_->Clear();
 
   if (MaybeRetryAfterWriteError(rv))
     return quic::WriteResult(quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED,
@@ -183,6 +281,35 @@ quic::WriteResult QuicChromiumPacketWriter::WritePacketToSocketImpl() {
   return quic::WriteResult(status, rv);
 }
 
+int QuicChromiumPacketWriter::WriteSegmentsIndividually() {
+  DCHECK(!batch_mode_);
+  while (next_segment_ < packet_->num_segments()) {
+    size_t offset = next_segment_ * packet_->segment_size();
+    size_t length = std::min(packet_->segment_size(), packet_->size() - offset);
+    // |packet_| is kept alive until the write completes.
+    int rv = socket_->Write(
+        base::MakeRefCounted<WrappedIOBuffer>(packet_->data() + offset).get(),
+        length, write_callback_, kTrafficAnnotation);
+    if (rv < 0 && rv != ERR_IO_PENDING)
+      return rv;
+    next_segment_++;
+    if (rv == ERR_IO_PENDING)
+      return rv;
+  }
+  return packet_->size();
+}
+
+void QuicChromiumPacketWriter::DisableBatchMode() {
+  DCHECK(batch_mode_);
+  batch_mode_ = false;
+  next_segment_ = 0;
+}
+
+bool QuicChromiumPacketWriter::HasUnwrittenSegments() const {
+  return !batch_mode_ && packet_ && next_segment_ > 0 &&
+         next_segment_ < packet_->num_segments();
+}
+
 void QuicChromiumPacketWriter::RetryPacketAfterNoBuffers() {
   DCHECK_GT(retry_count_, 0);
   quic::WriteResult result = WritePacketToSocketImpl();
@@ -201,6 +328,23 @@ void QuicChromiumPacketWriter::SetWritable() {
 void QuicChromiumPacketWriter::OnWriteComplete(int rv) {
   DCHECK_NE(rv, ERR_IO_PENDING);
   write_in_progress_ = false;
+  if (batch_mode_ && rv >= 0 && packet_)
+    packet_->Clear();
+  if (rv == ERR_NOT_IMPLEMENTED && batch_mode_ && packet_ &&
+      packet_->num_segments() > 1) {
+    // The platform rejected the segmented write.
+    DisableBatchMode();
+    quic::WriteResult result = WritePacketToSocketImpl();
+    if (result.error_code != ERR_IO_PENDING)
+      OnWriteComplete(result.error_code);
+    return;
+  }
+  if (rv >= 0 && HasUnwrittenSegments()) {
+    quic::WriteResult result = WritePacketToSocketImpl();
+    if (result.error_code != ERR_IO_PENDING)
+      OnWriteComplete(result.error_code);
+    return;
+  }
   if (delegate_ == nullptr)
     return;
 
@@ -260,17 +404,34 @@ bool QuicChromiumPacketWriter::SupportsReleaseTime() const {
 }
 
 bool QuicChromiumPacketWriter::IsBatchMode() const {
-  return false;
+  return batch_mode_;
 }
 
 char* QuicChromiumPacketWriter::GetNextWriteLocation(
     const quic::QuicIpAddress& self_address,
     const quic::QuicSocketAddress& peer_address) {
+  // Packets are always copied into |packet_|, even in batch mode: a packet
+  // serialized in place would be lost if WritePacket() had to report it as
+  // blocked.
   return nullptr;
 }
 
 quic::WriteResult QuicChromiumPacketWriter::Flush() {
-  return quic::WriteResult(quic::WRITE_STATUS_OK, 0);
+  quic::WriteResult result = FlushBufferedPackets();
+  // None of the flushed packets is the caller's, so a pending write is plain
+  // blockage, as quic::QuicConnection::FlushPackets() expects. The connection
+  // only accepts ERR_IO_PENDING alongside WRITE_STATUS_BLOCKED_DATA_BUFFERED.
+  if (result.status == quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED)
+    return quic::WriteResult(quic::WRITE_STATUS_BLOCKED, 0);
+  return result;
+}
+
+quic::WriteResult QuicChromiumPacketWriter::FlushBufferedPackets() {
+  if (!batch_mode_ || !packet_ || packet_->num_segments() == 0)
+    return quic::WriteResult(quic::WRITE_STATUS_OK, 0);
+  if (IsWriteBlocked())
+    return quic::WriteResult(quic::WRITE_STATUS_BLOCKED, 0);
+  return WritePacketToSocketImpl();
 }
 
 }  // namespace net
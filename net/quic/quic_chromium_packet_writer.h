@@ -36,15 +36,29 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter
 
     size_t capacity() const { return capacity_; }
     size_t size() const { return size_; }
+    // The number of packets held, and the size of each but the last, which
+    // may be shorter.
+    size_t num_segments() const { return num_segments_; }
+    size_t segment_size() const { return segment_size_; }
 
     // Does memcpy from |buffer| into this->data(). |buf_len <=
     // capacity()| must be true, |HasOneRef()| must be true.
     void Set(const char* buffer, size_t buf_len);
 
+    // Does memcpy from |buffer| to just past the current contents, adding
+    // another packet for a segmented write. |size() + buf_len <= capacity()|,
+    // |buf_len <= segment_size()| and |HasOneRef()| must be true.
+    void Append(const char* buffer, size_t buf_len);
+
+    // Drops the current contents.
+    void Clear();
+
    private:
     ~ReusableIOBuffer() override;
     size_t capacity_;
     size_t size_;
+    size_t num_segments_;
+    size_t segment_size_;
   };
   // Delegate interface which receives notifications on socket write events.
   class NET_EXPORT_PRIVATE Delegate {
@@ -103,15 +117,44 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter
 
  private:
   void SetPacket(const char* buffer, size_t buf_len);
+  // Batch mode: returns true if a packet of |buf_len| bytes can be sent in the
+  // same segmented write as the packets already in |packet_|.
+  bool CanAppendPacket(size_t buf_len) const;
+  void AppendPacket(const char* buffer, size_t buf_len);
+  // Batch mode: writes the packets buffered in |packet_|. Unlike Flush(),
+  // reports a pending write as WRITE_STATUS_BLOCKED_DATA_BUFFERED.
+  quic::WriteResult FlushBufferedPackets();
+  // Writes the packets in |packet_| one at a time, starting with
+  // |next_segment_|. Returns |packet_->size()| once all have been written, or
+  // the error or ERR_IO_PENDING of the first write that didn't complete.
+  int WriteSegmentsIndividually();
+  // Stops buffering packets after the platform rejected a segmented write, as
+  // happens on devices without UDP checksum offload. The packets of
+  // |packet_| are then written by WriteSegmentsIndividually().
+  void DisableBatchMode();
+  // Returns true if a write of |packet_| by WriteSegmentsIndividually()
+  // completed, but later packets still have to be written.
+  bool HasUnwrittenSegments() const;
   bool MaybeRetryAfterWriteError(int rv);
   void RetryPacketAfterNoBuffers();
   quic::WriteResult WritePacketToSocketImpl();
   DatagramClientSocket* socket_;  // Unowned.
   Delegate* delegate_;            // Unowned.
   // Reused for every packet write for the lifetime of the writer.  Is
-  // moved to the delegate in the case of a write error.
+  // moved to the delegate in the case of a write error.  In batch mode,
+  // holds the packets buffered until the next Flush().
   scoped_refptr<ReusableIOBuffer> packet_;
 
+  // Whether consecutive packets are buffered and sent together with a single
+  // segmented write, see DatagramClientSocket::WriteSegmented().
+  bool batch_mode_ = false;
+
+  // Outside batch mode, |packet_| only holds several packets when it was
+  // buffered by a batch-mode writer and handed over by the delegate after a
+  // write error, typically to the socket of a new network that doesn't
+  // support segmented writes. The index of the next packet to write then.
+  size_t next_segment_ = 0;
+
   // Whether a write is currently in progress: true if an asynchronous write is
   // in flight, or a retry of a previous write is in progress, or session is
   // handling write error of a previous write.
@@ -0,0 +1,365 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/quic_chromium_packet_writer.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/circular_deque.h"
+#include "base/macros.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "net/base/features.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/log/net_log_source.h"
+#include "net/socket/udp_client_socket.h"
+#include "net/test/test_with_scoped_task_environment.h"
+#include "net/third_party/quic/core/quic_constants.h"
+#include "net/third_party/quic/platform/api/quic_ip_address.h"
+#include "net/third_party/quic/platform/api/quic_socket_address.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+namespace net {
+namespace test {
+namespace {
+
+// An unconnected UDPClientSocket whose writes are recorded instead of sent.
+// Each write returns the next queued result, or succeeds if there is none.
+class FakeWriteSocket : public UDPClientSocket {
+ public:
+  explicit FakeWriteSocket(bool supports_segmented_writes)
+      : UDPClientSocket(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource()),
+        supports_segmented_writes_(supports_segmented_writes) {}
+
+  int Write(IOBuffer* buf,
+            int buf_len,
+            CompletionOnceCallback callback,
+            const NetworkTrafficAnnotationTag& traffic_annotation) override {
+    return RecordWrite(buf, buf_len, buf_len, std::move(callback));
+  }
+
+  int EnableSegmentedWrites() override {
+    return supports_segmented_writes_ ? OK : ERR_NOT_IMPLEMENTED;
+  }
+
+  int WriteSegmented(
+      IOBuffer* buf,
+      int buf_len,
+      int segment_size,
+      CompletionOnceCallback callback,
+      const NetworkTrafficAnnotationTag& traffic_annotation) override {
+    if (!supports_segmented_writes_)
+      return ERR_NOT_IMPLEMENTED;
+    return RecordWrite(buf, buf_len, segment_size, std::move(callback));
+  }
+
+  void QueueResult(int result) { results_.push_back(result); }
+
+  // Completes the pending write with |result|.
+  void CompletePendingWrite(int result) {
+    ASSERT_FALSE(pending_callback_.is_null());
+    std::move(pending_callback_).Run(result);
+  }
+
+  // The packets of every write, one vector per write.
+  const std::vector<std::vector<std::string>>& writes() const {
+    return writes_;
+  }
+
+ private:
+  int RecordWrite(IOBuffer* buf,
+                  int buf_len,
+                  int segment_size,
+                  CompletionOnceCallback callback) {
+    std::vector<std::string> packets;
+    for (int offset = 0; offset < buf_len; offset += segment_size) {
+      packets.push_back(std::string(
+          buf->data() + offset, std::min(segment_size, buf_len - offset)));
+    }
+    writes_.push_back(std::move(packets));
+
+    if (results_.empty())
+      return buf_len;
+    int result = results_.front();
+    results_.pop_front();
+    if (result == ERR_IO_PENDING)
+      pending_callback_ = std::move(callback);
+    return result;
+  }
+
+  const bool supports_segmented_writes_;
+  base::circular_deque<int> results_;
+  CompletionOnceCallback pending_callback_;
+  std::vector<std::vector<std::string>> writes_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeWriteSocket);
+};
+
+class MockDelegate : public QuicChromiumPacketWriter::Delegate {
+ public:
+  MockDelegate() {}
+
+  MOCK_METHOD2(HandleWriteError,
+               int(int error_code,
+                   scoped_refptr<QuicChromiumPacketWriter::ReusableIOBuffer>
+                       last_packet));
+  MOCK_METHOD1(OnWriteError, void(int error_code));
+  MOCK_METHOD0(OnWriteUnblocked, void());
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(MockDelegate);
+};
+
+class QuicChromiumPacketWriterTest : public TestWithScopedTaskEnvironment {
+ protected:
+  QuicChromiumPacketWriterTest() {
+    feature_list_.InitAndEnableFeature(features::kQuicUdpSegmentationOffload);
+  }
+
+  std::unique_ptr<QuicChromiumPacketWriter> CreateWriter(
+      FakeWriteSocket* socket) {
+    auto writer = std::make_unique<QuicChromiumPacketWriter>(
+        socket, base::ThreadTaskRunnerHandle::Get().get());
+    writer->set_delegate(&delegate_);
+    return writer;
+  }
+
+  quic::WriteResult WritePacket(QuicChromiumPacketWriter* writer,
+                                const std::string& packet) {
+    return writer->WritePacket(packet.data(), packet.size(),
+                               quic::QuicIpAddress(),
+                               quic::QuicSocketAddress(), nullptr);
+  }
+
+  // Returns a full-sized packet filled with |c|.
+  static std::string FullPacket(char c) {
+    return std::string(quic::kMaxPacketSize, c);
+  }
+
+  base::test::ScopedFeatureList feature_list_;
+  testing::StrictMock<MockDelegate> delegate_;
+};
+
+TEST_F(QuicChromiumPacketWriterTest, BuffersPacketsUntilFlush) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+  ASSERT_TRUE(writer->IsBatchMode());
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('a')).status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('b')).status);
+  EXPECT_TRUE(socket.writes().empty());
+
+  quic::WriteResult result = writer->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(static_cast<int>(2 * quic::kMaxPacketSize), result.bytes_written);
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(FullPacket('a'), FullPacket('b'))));
+
+  // Nothing is left to flush.
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer->Flush().status);
+  EXPECT_EQ(1u, socket.writes().size());
+}
+
+// A shorter packet can only be the last of a segmented write, so it sends the
+// batch right away.
+TEST_F(QuicChromiumPacketWriterTest, ShortPacketFlushes) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('a')).status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, WritePacket(writer.get(), "short").status);
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(FullPacket('a'), "short")));
+}
+
+// A packet larger than the buffered ones can't share their segmented write,
+// so they are flushed first.
+TEST_F(QuicChromiumPacketWriterTest, LargerPacketFlushesEarlierPackets) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  std::string small(100, 'a');
+  std::string large(200, 'b');
+  // The first packet sets the segment size of the batch, so it is buffered.
+  EXPECT_EQ(quic::WRITE_STATUS_OK, WritePacket(writer.get(), small).status);
+  EXPECT_TRUE(socket.writes().empty());
+  EXPECT_EQ(quic::WRITE_STATUS_OK, WritePacket(writer.get(), large).status);
+  EXPECT_THAT(socket.writes(), ElementsAre(ElementsAre(small)));
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer->Flush().status);
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(small), ElementsAre(large)));
+}
+
+// Tests that Flush() reports an asynchronous write as WRITE_STATUS_BLOCKED,
+// which is what quic::QuicConnection::FlushPackets() expects.
+TEST_F(QuicChromiumPacketWriterTest, FlushBlocked) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('a')).status);
+  socket.QueueResult(ERR_IO_PENDING);
+  quic::WriteResult result = writer->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, result.status);
+  EXPECT_NE(ERR_IO_PENDING, result.error_code);
+  EXPECT_TRUE(writer->IsWriteBlocked());
+  result = writer->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, result.status);
+  EXPECT_NE(ERR_IO_PENDING, result.error_code);
+
+  EXPECT_CALL(delegate_, OnWriteUnblocked());
+  socket.CompletePendingWrite(quic::kMaxPacketSize);
+  EXPECT_FALSE(writer->IsWriteBlocked());
+  EXPECT_EQ(1u, socket.writes().size());
+
+  // The written packets were dropped from the buffer.
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writer->Flush().status);
+  EXPECT_EQ(1u, socket.writes().size());
+}
+
+// Tests the results of WritePacket() when it has to flush and the write is
+// asynchronous: a packet that was buffered is reported as such, but one that
+// wasn't is reported as blocked for the connection to queue.
+TEST_F(QuicChromiumPacketWriterTest, WritePacketBlocked) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('a')).status);
+  socket.QueueResult(ERR_IO_PENDING);
+  quic::WriteResult result = WritePacket(writer.get(), "short");
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED, result.status);
+  EXPECT_EQ(ERR_IO_PENDING, result.error_code);
+  EXPECT_TRUE(writer->IsWriteBlocked());
+  EXPECT_CALL(delegate_, OnWriteUnblocked());
+  socket.CompletePendingWrite(quic::kMaxPacketSize + 5);
+
+  std::string small(100, 'b');
+  EXPECT_EQ(quic::WRITE_STATUS_OK, WritePacket(writer.get(), small).status);
+  socket.QueueResult(ERR_IO_PENDING);
+  // quic::QuicConnection expects ERR_IO_PENDING only with buffered data.
+  result = WritePacket(writer.get(), FullPacket('c'));
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, result.status);
+  EXPECT_NE(ERR_IO_PENDING, result.error_code);
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(FullPacket('a'), "short"),
+                          ElementsAre(small)));
+}
+
+// Tests that the writer leaves batch mode and writes the buffered packets one
+// at a time when the platform rejects a segmented write, as it does on devices
+// without UDP checksum offload.
+TEST_F(QuicChromiumPacketWriterTest, SegmentedWriteNotImplemented) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('a')).status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('b')).status);
+  socket.QueueResult(ERR_NOT_IMPLEMENTED);
+  quic::WriteResult result = writer->Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(static_cast<int>(2 * quic::kMaxPacketSize), result.bytes_written);
+  EXPECT_FALSE(writer->IsBatchMode());
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(FullPacket('a'), FullPacket('b')),
+                          ElementsAre(FullPacket('a')),
+                          ElementsAre(FullPacket('b'))));
+
+  // Later packets are written right away.
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('c')).status);
+  EXPECT_EQ(4u, socket.writes().size());
+}
+
+// Tests that the packets of a segmented write the platform rejects
+// asynchronously are written one at a time.
+TEST_F(QuicChromiumPacketWriterTest, SegmentedWriteNotImplementedAsync) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/true);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  EXPECT_EQ(quic::WRITE_STATUS_OK,
+            WritePacket(writer.get(), FullPacket('a')).status);
+  socket.QueueResult(ERR_IO_PENDING);
+  quic::WriteResult result = WritePacket(writer.get(), "short");
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED, result.status);
+  EXPECT_EQ(ERR_IO_PENDING, result.error_code);
+
+  EXPECT_CALL(delegate_, OnWriteUnblocked());
+  socket.CompletePendingWrite(ERR_NOT_IMPLEMENTED);
+  EXPECT_FALSE(writer->IsWriteBlocked());
+  EXPECT_FALSE(writer->IsBatchMode());
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(FullPacket('a'), "short"),
+                          ElementsAre(FullPacket('a')), ElementsAre("short")));
+}
+
+// Tests that a batch of packets handed to a writer whose socket can't do
+// segmented writes, as happens when migrating after a write error, is sent
+// one packet at a time.
+TEST_F(QuicChromiumPacketWriterTest, WriteSegmentsIndividually) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/false);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+  ASSERT_FALSE(writer->IsBatchMode());
+
+  auto packet =
+      base::MakeRefCounted<QuicChromiumPacketWriter::ReusableIOBuffer>(
+          quic::kMaxGsoPacketSize);
+  packet->Append(FullPacket('a').data(), quic::kMaxPacketSize);
+  packet->Append(FullPacket('b').data(), quic::kMaxPacketSize);
+  packet->Append("short", 5);
+
+  // The second write completes asynchronously, and the third follows it.
+  socket.QueueResult(quic::kMaxPacketSize);
+  socket.QueueResult(ERR_IO_PENDING);
+  writer->WritePacketToSocket(std::move(packet));
+  EXPECT_TRUE(writer->IsWriteBlocked());
+  EXPECT_EQ(2u, socket.writes().size());
+
+  EXPECT_CALL(delegate_, OnWriteUnblocked());
+  socket.CompletePendingWrite(quic::kMaxPacketSize);
+  EXPECT_FALSE(writer->IsWriteBlocked());
+  EXPECT_THAT(socket.writes(),
+              ElementsAre(ElementsAre(FullPacket('a')),
+                          ElementsAre(FullPacket('b')), ElementsAre("short")));
+}
+
+TEST_F(QuicChromiumPacketWriterTest, WriteSegmentsIndividuallyError) {
+  FakeWriteSocket socket(/*supports_segmented_writes=*/false);
+  std::unique_ptr<QuicChromiumPacketWriter> writer = CreateWriter(&socket);
+
+  auto packet =
+      base::MakeRefCounted<QuicChromiumPacketWriter::ReusableIOBuffer>(
+          quic::kMaxGsoPacketSize);
+  packet->Append(FullPacket('a').data(), quic::kMaxPacketSize);
+  packet->Append("short", 5);
+
+  // The whole packet goes back to the delegate.
+  socket.QueueResult(quic::kMaxPacketSize);
+  socket.QueueResult(ERR_CONNECTION_REFUSED);
+  EXPECT_CALL(delegate_, HandleWriteError(ERR_CONNECTION_REFUSED, _))
+      .WillRepeatedly(Return(ERR_CONNECTION_REFUSED));
+  EXPECT_CALL(delegate_, OnWriteError(ERR_CONNECTION_REFUSED));
+  writer->WritePacketToSocket(std::move(packet));
+  EXPECT_EQ(2u, socket.writes().size());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
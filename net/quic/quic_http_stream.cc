@@ -9,9 +9,11 @@
 #include "base/auto_reset.h"
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/feature_list.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/strings/string_split.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "net/base/features.h"
 #include "net/base/load_flags.h"
 #include "net/base/net_errors.h"
 #include "net/http/http_response_headers.h"
@@ -613,6 +615,13 @@ int QuicHttpStream::DoSendHeadersComplete(int rv) {
 
 int QuicHttpStream::DoReadRequestBody() {
   next_state_ = STATE_READ_REQUEST_BODY_COMPLETE;
+  // Without copying, the send buffer keeps the previous chunk until the peer
+  // acks it, so read into a new buffer rather than overwrite that chunk.
+  request_body_buf_ = nullptr;
+  if (!raw_request_body_buf_->HasOneRef()) {
+    raw_request_body_buf_ =
+        base::MakeRefCounted<IOBufferWithSize>(raw_request_body_buf_->size());
+  }
   return request_body_stream_->Read(
       raw_request_body_buf_.get(), raw_request_body_buf_->size(),
       base::BindOnce(&QuicHttpStream::OnIOComplete,
@@ -645,6 +654,18 @@ int QuicHttpStream::DoSendBody() {
   int len = request_body_buf_->BytesRemaining();
   if (len > 0 || eof) {
     next_state_ = STATE_SEND_BODY_COMPLETE;
+    if (len > 0 &&
+        base::FeatureList::IsEnabled(features::kQuicZeroCopyRequestBody)) {
+      // |request_body_buf_| is drained once the write completes, so give the
+      // stream a view of the data that never moves.
+      auto chunk = base::MakeRefCounted<DrainableIOBuffer>(
+          raw_request_body_buf_, raw_request_body_buf_->size());
+      chunk->SetOffset(request_body_buf_->BytesConsumed());
+      return stream_->WritevStreamDataNoCopy(
+          {chunk}, {len}, eof,
+          base::Bind(&QuicHttpStream::OnIOComplete,
+                     weak_factory_.GetWeakPtr()));
+    }
     quic::QuicStringPiece data(request_body_buf_->data(), len);
     return stream_->WriteStreamData(
         data, eof,
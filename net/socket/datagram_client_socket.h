@@ -5,7 +5,13 @@
 #ifndef NET_SOCKET_DATAGRAM_CLIENT_SOCKET_H_
 #define NET_SOCKET_DATAGRAM_CLIENT_SOCKET_H_
 
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "net/base/completion_once_callback.h"
 #include "net/base/datagram_buffer.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
 #include "net/base/net_export.h"
 #include "net/base/network_change_notifier.h"
 #include "net/socket/datagram_socket.h"
@@ -50,6 +56,46 @@ class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
   // By default, this method is no-op.
   virtual void EnableRecvOptimization() {}
 
+  // Reads up to |buffers.size()| datagrams, one datagram per buffer, with as
+  // few system calls as the platform allows. Returns the number of datagrams
+  // read, a net error code, or ERR_IO_PENDING, in which case |callback| is run
+  // with the result once datagrams arrive. |lengths| is resized to
+  // |buffers.size()|, and the entries for the datagrams read are set to each
+  // one's length, or to ERR_MSG_TOO_BIG if it didn't fit its buffer. The caller
+  // must keep |buffers| and |lengths| alive until the callback is run.
+  // By default, this method returns ERR_NOT_IMPLEMENTED, and callers should
+  // fall back to Read().
+  virtual int ReadMultiple(
+      const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+      std::vector<int>* lengths,
+      CompletionOnceCallback callback) {
+    return ERR_NOT_IMPLEMENTED;
+  }
+
+  // Asks the platform to coalesce datagrams from the peer on receive, which
+  // ReadMultiple() then splits up again. Returns OK, or ERR_NOT_IMPLEMENTED if
+  // unsupported, which is the default. Read() must not be used once this
+  // succeeds.
+  virtual int EnableCoalescedReads() { return ERR_NOT_IMPLEMENTED; }
+
+  // Returns OK if WriteSegmented() can be used on this socket, and
+  // ERR_NOT_IMPLEMENTED otherwise, which is the default.
+  virtual int EnableSegmentedWrites() { return ERR_NOT_IMPLEMENTED; }
+
+  // As Write, but sends |buf| as consecutive datagrams of |segment_size|
+  // bytes each, the last of which may be shorter, letting the platform split
+  // them (UDP GSO). Returns |buf_len| on success, or ERR_NOT_IMPLEMENTED if
+  // the platform turns out not to support it, in which case the datagrams have
+  // to be written one at a time.
+  virtual int WriteSegmented(
+      IOBuffer* buf,
+      int buf_len,
+      int segment_size,
+      CompletionOnceCallback callback,
+      const NetworkTrafficAnnotationTag& traffic_annotation) {
+    return ERR_NOT_IMPLEMENTED;
+  }
+
   // As Write, but internally this can delay writes and batch them up
   // for writing in a separate task.  This is to increase throughput
   // in bulk transfer scenarios (in QUIC) where a substantial
@@ -8,7 +8,6 @@
 #include <string.h>
 
 #include <algorithm>
-#include <map>
 #include <utility>
 
 #include "base/bind.h"
@@ -209,7 +208,7 @@ RSAKeyUsage CheckRSAKeyUsage(const X509Certificate* cert,
     return RSAKeyUsage::kOKNoExtension;
   }
 
-  std::map<der::Input, ParsedExtension> extensions;
+  ParsedExtensionMap extensions;
   if (!ParseExtensions(tbs.extensions_tlv, &extensions)) {
     return RSAKeyUsage::kError;
   }
@@ -189,4 +189,45 @@ void UDPClientSocket::EnableRecvOptimization() {
 #endif
 }
 
+int UDPClientSocket::ReadMultiple(
+    const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+    std::vector<int>* lengths,
+    CompletionOnceCallback callback) {
+#if defined(OS_POSIX)
+  return socket_.ReadMultiple(buffers, lengths, std::move(callback));
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+int UDPClientSocket::EnableCoalescedReads() {
+#if defined(OS_POSIX)
+  return socket_.EnableCoalescedReads();
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+int UDPClientSocket::EnableSegmentedWrites() {
+#if defined(OS_POSIX)
+  return socket_.EnableSegmentedWrites();
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+int UDPClientSocket::WriteSegmented(
+    IOBuffer* buf,
+    int buf_len,
+    int segment_size,
+    CompletionOnceCallback callback,
+    const NetworkTrafficAnnotationTag& traffic_annotation) {
+#if defined(OS_POSIX)
+  return socket_.WriteSegmented(buf, buf_len, segment_size,
+                                std::move(callback), traffic_annotation);
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 }  // namespace net
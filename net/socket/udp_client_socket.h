@@ -65,6 +65,17 @@ class NET_EXPORT_PRIVATE UDPClientSocket : public DatagramClientSocket {
   void SetMsgConfirm(bool confirm) override;
   const NetLogWithSource& NetLog() const override;
   void EnableRecvOptimization() override;
+  int ReadMultiple(const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+                   std::vector<int>* lengths,
+                   CompletionOnceCallback callback) override;
+  int EnableCoalescedReads() override;
+  int EnableSegmentedWrites() override;
+  int WriteSegmented(
+      IOBuffer* buf,
+      int buf_len,
+      int segment_size,
+      CompletionOnceCallback callback,
+      const NetworkTrafficAnnotationTag& traffic_annotation) override;
 
   void SetWriteAsyncEnabled(bool enabled) override;
   bool WriteAsyncEnabled() override;
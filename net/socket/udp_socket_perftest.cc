@@ -2,11 +2,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/perf_time_logger.h"
+#include "base/time/time.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
@@ -19,6 +24,7 @@
 #include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "testing/platform_test.h"
 
 using net::test::IsOk;
@@ -49,6 +55,17 @@ class UDPSocketPerfTest : public PlatformTest {
   // has effect on Windows.
   void WriteBenchmark(bool use_nonblocking_io);
 
+  // Receives packets on a connected client socket, |batch_size| packets per
+  // read. A |batch_size| of 1 uses Read(), larger sizes use ReadMultiple().
+  void ReadBenchmark(int batch_size);
+
+  // Reads |num_of_packets| packets from |socket|, and returns the number of
+  // read calls made.
+  int ReadPacketsFromSocket(
+      UDPClientSocket* socket,
+      int num_of_packets,
+      const std::vector<scoped_refptr<IOBufferWithSize>>& buffers);
+
  protected:
   static const int kPacketSize = 1024;
   scoped_refptr<IOBufferWithSize> buffer_;
@@ -126,6 +143,88 @@ void UDPSocketPerfTest::WriteBenchmark(bool use_nonblocking_io) {
   LOG(INFO) << "Write speed: " << packets / 1024 / elapsed << " MB/s";
 }
 
+int UDPSocketPerfTest::ReadPacketsFromSocket(
+    UDPClientSocket* socket,
+    int num_of_packets,
+    const std::vector<scoped_refptr<IOBufferWithSize>>& buffers) {
+  std::vector<int> lengths;
+  int num_reads = 0;
+  while (num_of_packets > 0) {
+    TestCompletionCallback callback;
+    int rv;
+    if (buffers.size() == 1) {
+      rv = callback.GetResult(socket->Read(
+          buffers[0].get(), buffers[0]->size(), callback.callback()));
+      EXPECT_EQ(kPacketSize, rv);
+      rv = 1;
+    } else {
+      rv = callback.GetResult(
+          socket->ReadMultiple(buffers, &lengths, callback.callback()));
+      EXPECT_GT(rv, 0);
+    }
+    if (rv <= 0)
+      break;
+    num_of_packets -= rv;
+    ++num_reads;
+  }
+  return num_reads;
+}
+
+void UDPSocketPerfTest::ReadBenchmark(int batch_size) {
+  base::MessageLoopForIO message_loop;
+  // Send packets in bursts that fit the default socket receive buffer, so
+  // none are dropped before the client reads them.
+  const int kBurstSize = 64;
+  const int kPackets = 100000;
+
+  IPEndPoint bind_address;
+  CreateUDPAddress("127.0.0.1", 0, &bind_address);
+  UDPServerSocket server(nullptr, NetLogSource());
+  ASSERT_THAT(server.Listen(bind_address), IsOk());
+  IPEndPoint server_address;
+  ASSERT_THAT(server.GetLocalAddress(&server_address), IsOk());
+
+  UDPClientSocket client(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource());
+  ASSERT_THAT(client.Connect(server_address), IsOk());
+  IPEndPoint client_address;
+  ASSERT_THAT(client.GetLocalAddress(&client_address), IsOk());
+
+  // Leave room to detect truncation.
+  std::vector<scoped_refptr<IOBufferWithSize>> buffers;
+  for (int i = 0; i < batch_size; ++i)
+    buffers.push_back(base::MakeRefCounted<IOBufferWithSize>(kPacketSize + 1));
+  scoped_refptr<IOBufferWithSize> packet =
+      base::MakeRefCounted<IOBufferWithSize>(kPacketSize);
+  memset(packet->data(), 'G', kPacketSize);
+
+  base::TimeDelta read_time;
+  base::TimeDelta read_cpu_time;
+  int num_reads = 0;
+  for (int sent = 0; sent < kPackets; sent += kBurstSize) {
+    for (int i = 0; i < kBurstSize; ++i) {
+      TestCompletionCallback callback;
+      ASSERT_EQ(kPacketSize,
+                callback.GetResult(server.SendTo(packet.get(), kPacketSize,
+                                                 client_address,
+                                                 callback.callback())));
+    }
+    base::TimeTicks start_ticks = base::TimeTicks::Now();
+    base::ThreadTicks start_thread_ticks = base::ThreadTicks::Now();
+    num_reads += ReadPacketsFromSocket(&client, kBurstSize, buffers);
+    read_cpu_time += base::ThreadTicks::Now() - start_thread_ticks;
+    read_time += base::TimeTicks::Now() - start_ticks;
+  }
+
+  std::string trace = base::StringPrintf("batch_size_%d", batch_size);
+  perf_test::PrintResult("udp_socket_read", "", trace,
+                         kPackets / read_time.InSecondsF(), "packets/s", true);
+  perf_test::PrintResult(
+      "udp_socket_read_cpu", "", trace,
+      read_cpu_time.InMicrosecondsF() * 1000 / kPackets, "ns/packet", true);
+  perf_test::PrintResult("udp_socket_read_calls", "", trace, num_reads,
+                         "calls", false);
+}
+
 TEST_F(UDPSocketPerfTest, Write) {
   base::PerfTimeLogger timer("UDP_socket_write");
   WriteBenchmark(false);
@@ -136,6 +235,23 @@ TEST_F(UDPSocketPerfTest, WriteNonBlocking) {
   WriteBenchmark(true);
 }
 
+TEST_F(UDPSocketPerfTest, Read) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  base::ThreadTicks::WaitUntilInitialized();
+  ReadBenchmark(1);
+}
+
+#if defined(OS_POSIX)
+TEST_F(UDPSocketPerfTest, ReadMultiple) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  base::ThreadTicks::WaitUntilInitialized();
+  for (int batch_size : {8, 16, 32})
+    ReadBenchmark(batch_size);
+}
+#endif  // defined(OS_POSIX)
+
 }  // namespace
 
 }  // namespace net
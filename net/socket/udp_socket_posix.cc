@@ -11,6 +11,9 @@
 #include <netinet/in.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/callback_helpers.h"
@@ -57,6 +60,20 @@
 #include <pthread.h>
 #endif  // defined(OS_MACOSX) && !defined(OS_IOS)
 
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+// Older kernel headers lack the UDP segmentation offload definitions, which
+// are ABI stable.
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif  // HAVE_UDP_SEGMENTATION_OFFLOAD
+
 namespace net {
 
 namespace {
@@ -197,6 +214,8 @@ UDPSocketPosix::UDPSocketPosix(DatagramSocket::BindType bind_type,
       write_async_outstanding_(0),
       read_buf_len_(0),
       recv_from_address_(NULL),
+      read_multiple_buffers_(nullptr),
+      read_multiple_lengths_(nullptr),
       write_buf_len_(0),
       net_log_(NetLogWithSource::Make(net_log, NetLogSourceType::UDP_SOCKET)),
       bound_network_(NetworkChangeNotifier::kInvalidNetworkHandle),
@@ -301,10 +320,18 @@ void UDPSocketPosix::Close() {
   read_buf_len_ = 0;
   read_callback_.Reset();
   recv_from_address_ = NULL;
+  read_multiple_buffers_ = nullptr;
+  read_multiple_lengths_ = nullptr;
   write_buf_ = NULL;
   write_buf_len_ = 0;
   write_callback_.Reset();
   send_to_address_.reset();
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  coalesced_read_buf_.reset();
+  coalesced_read_offset_ = 0;
+  coalesced_read_end_ = 0;
+  write_segment_size_ = 0;
+#endif
 
   bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
   DCHECK(ok);
@@ -410,6 +437,53 @@ int UDPSocketPosix::RecvFrom(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UDPSocketPosix::ReadMultiple(
+    const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+    std::vector<int>* lengths,
+    CompletionOnceCallback callback) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_NE(kInvalidSocket, socket_);
+  CHECK(read_callback_.is_null());
+  DCHECK(!recv_from_address_);
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(!buffers.empty());
+  DCHECK(lengths);
+
+  int result = InternalReadMultiple(buffers, lengths);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!base::MessageLoopCurrentForIO::Get()->WatchFileDescriptor(
+          socket_, true, base::MessagePumpForIO::WATCH_READ,
+          &read_socket_watcher_, &read_watcher_)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on read";
+    result = MapSystemError(errno);
+    LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  read_multiple_buffers_ = &buffers;
+  read_multiple_lengths_ = lengths;
+  read_callback_ = std::move(callback);
+  return ERR_IO_PENDING;
+}
+
+int UDPSocketPosix::EnableCoalescedReads() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(is_connected_);
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  int enable = 1;
+  if (setsockopt(socket_, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) != 0)
+    return ERR_NOT_IMPLEMENTED;
+  if (!coalesced_read_buf_)
+    coalesced_read_buf_.reset(new char[kMaxSegmentedDatagramSize]);
+  return OK;
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 int UDPSocketPosix::Write(
     IOBuffer* buf,
     int buf_len,
@@ -418,6 +492,61 @@ int UDPSocketPosix::Write(
   return SendToOrWrite(buf, buf_len, NULL, std::move(callback));
 }
 
+int UDPSocketPosix::EnableSegmentedWrites() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_NE(kInvalidSocket, socket_);
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  // Kernels without GSO reject the option outright.
+  int segment_size = 0;
+  socklen_t segment_size_len = sizeof(segment_size);
+  if (getsockopt(socket_, SOL_UDP, UDP_SEGMENT, &segment_size,
+                 &segment_size_len) != 0) {
+    return ERR_NOT_IMPLEMENTED;
+  }
+  return OK;
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+int UDPSocketPosix::WriteSegmented(
+    IOBuffer* buf,
+    int buf_len,
+    int segment_size,
+    CompletionOnceCallback callback,
+    const NetworkTrafficAnnotationTag& traffic_annotation) {
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_NE(kInvalidSocket, socket_);
+  CHECK(write_callback_.is_null());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK_GT(buf_len, 0);
+  DCHECK_GT(segment_size, 0);
+  DCHECK_LE(buf_len, kMaxSegmentedDatagramSize);
+
+  int result = InternalSendSegmented(buf, buf_len, segment_size);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!base::MessageLoopCurrentForIO::Get()->WatchFileDescriptor(
+          socket_, true, base::MessagePumpForIO::WATCH_WRITE,
+          &write_socket_watcher_, &write_watcher_)) {
+    DVPLOG(1) << "WatchFileDescriptor failed on write";
+    int result = MapSystemError(errno);
+    LogWrite(result, NULL, NULL);
+    return result;
+  }
+
+  write_buf_ = buf;
+  write_buf_len_ = buf_len;
+  write_segment_size_ = segment_size;
+  write_callback_ = std::move(callback);
+  return ERR_IO_PENDING;
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 int UDPSocketPosix::SendTo(IOBuffer* buf,
                            int buf_len,
                            const IPEndPoint& address,
@@ -738,11 +867,17 @@ void UDPSocketPosix::DoWriteCallback(int rv) {
 
 void UDPSocketPosix::DidCompleteRead() {
   int result =
-      InternalRecvFrom(read_buf_.get(), read_buf_len_, recv_from_address_);
+      read_multiple_buffers_
+          ? InternalReadMultiple(*read_multiple_buffers_,
+                                 read_multiple_lengths_)
+          : InternalRecvFrom(read_buf_.get(), read_buf_len_,
+                             recv_from_address_);
   if (result != ERR_IO_PENDING) {
     read_buf_ = NULL;
     read_buf_len_ = 0;
     recv_from_address_ = NULL;
+    read_multiple_buffers_ = nullptr;
+    read_multiple_lengths_ = nullptr;
     bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
     DCHECK(ok);
     DoReadCallback(result);
@@ -774,13 +909,27 @@ void UDPSocketPosix::LogRead(int result,
 }
 
 void UDPSocketPosix::DidCompleteWrite() {
-  int result =
+  int result;
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  if (write_segment_size_ > 0) {
+    result = InternalSendSegmented(write_buf_.get(), write_buf_len_,
+                                   write_segment_size_);
+  } else {
+    result = InternalSendTo(write_buf_.get(), write_buf_len_,
+                            send_to_address_.get());
+  }
+#else
+  result =
       InternalSendTo(write_buf_.get(), write_buf_len_, send_to_address_.get());
+#endif
 
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
     send_to_address_.reset();
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+    write_segment_size_ = 0;
+#endif
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -880,6 +1029,206 @@ int UDPSocketPosix::InternalRecvFromNonConnectedSocket(IOBuffer* buf,
   return result;
 }
 
+int UDPSocketPosix::InternalReadMultiple(
+    const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+    std::vector<int>* lengths) {
+  lengths->resize(buffers.size());
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  if (coalesced_read_buf_)
+    return InternalReadCoalesced(buffers, lengths);
+#endif
+#if HAVE_RECVMMSG
+  if (recvmmsg_enabled_ && buffers.size() > 1) {
+    int result = InternalRecvmmsg(buffers, lengths);
+    if (LIKELY(result != ERR_NOT_IMPLEMENTED))
+      return result;
+    DLOG(WARNING) << "recvmmsg() not implemented, falling back to recvmsg()";
+    recvmmsg_enabled_ = false;
+  }
+#endif
+  IOBufferWithSize* buffer = buffers.front().get();
+  int result = InternalRecvFrom(buffer, buffer->size(), nullptr);
+  // As with recvmmsg(), a truncated datagram is reported in |lengths| rather
+  // than failing the whole read.
+  if (result < 0 && result != ERR_MSG_TOO_BIG)
+    return result;
+  (*lengths)[0] = result;
+  return 1;
+}
+
+#if HAVE_RECVMMSG
+int UDPSocketPosix::Recvmmsg(int sockfd,
+                             struct mmsghdr* msgvec,
+                             unsigned int vlen,
+                             int flags) const {
+  return recvmmsg(sockfd, msgvec, vlen, flags, nullptr);
+}
+
+int UDPSocketPosix::InternalRecvmmsg(
+    const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+    std::vector<int>* lengths) {
+  DCHECK(is_connected_);
+  size_t num_buffers =
+      std::min(buffers.size(), static_cast<size_t>(kReadMultipleMaxBuffers));
+  base::StackVector<struct iovec, kReadMultipleMaxBuffers> msg_iov;
+  base::StackVector<struct mmsghdr, kReadMultipleMaxBuffers> msgvec;
+  msg_iov->resize(num_buffers);
+  msgvec->resize(num_buffers);
+  for (size_t i = 0; i < num_buffers; i++) {
+    msg_iov[i].iov_base = buffers[i]->data();
+    msg_iov[i].iov_len = buffers[i]->size();
+    std::memset(&msgvec[i], 0, sizeof(msgvec[i]));
+    msgvec[i].msg_hdr.msg_iov = &msg_iov[i];
+    msgvec[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // The socket is non-blocking, so this returns as soon as no more datagrams
+  // are queued.
+  int count = HANDLE_EINTR(Recvmmsg(socket_, &msgvec[0], num_buffers, 0));
+  if (count < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING && result != ERR_NOT_IMPLEMENTED)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  // The socket is connected, so every datagram comes from the peer.
+  SockaddrStorage sock_addr;
+  if (remote_address_) {
+    bool success =
+        remote_address_->ToSockAddr(sock_addr.addr, &sock_addr.addr_len);
+    DCHECK(success);
+  }
+  for (int i = 0; i < count; i++) {
+    int result = msgvec[i].msg_hdr.msg_flags & MSG_TRUNC
+                     ? ERR_MSG_TOO_BIG
+                     : static_cast<int>(msgvec[i].msg_len);
+    LogRead(result, buffers[i]->data(), sock_addr.addr_len, sock_addr.addr);
+    (*lengths)[i] = result;
+  }
+  return count;
+}
+#endif
+
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+int UDPSocketPosix::InternalReadCoalesced(
+    const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+    std::vector<int>* lengths) {
+  if (coalesced_read_offset_ == coalesced_read_end_) {
+    int result = InternalRecvCoalesced();
+    if (result < 0 && result != ERR_MSG_TOO_BIG)
+      return result;
+    if (result == ERR_MSG_TOO_BIG) {
+      (*lengths)[0] = result;
+      return 1;
+    }
+  }
+
+  // The socket is connected, so every datagram comes from the peer.
+  SockaddrStorage sock_addr;
+  if (remote_address_) {
+    bool success =
+        remote_address_->ToSockAddr(sock_addr.addr, &sock_addr.addr_len);
+    DCHECK(success);
+  }
+  int count = 0;
+  while (count < static_cast<int>(buffers.size()) &&
+         coalesced_read_offset_ < coalesced_read_end_) {
+    const char* datagram = coalesced_read_buf_.get() + coalesced_read_offset_;
+    int length = std::min(coalesced_read_segment_size_,
+                          coalesced_read_end_ - coalesced_read_offset_);
+    coalesced_read_offset_ += length;
+    IOBufferWithSize* buffer = buffers[count].get();
+    if (length > buffer->size()) {
+      length = ERR_MSG_TOO_BIG;
+    } else {
+      std::memcpy(buffer->data(), datagram, length);
+    }
+    LogRead(length, buffer->data(), sock_addr.addr_len, sock_addr.addr);
+    (*lengths)[count++] = length;
+  }
+  return count;
+}
+
+int UDPSocketPosix::InternalRecvCoalesced() {
+  DCHECK(is_connected_);
+  struct iovec iov = {};
+  iov.iov_base = coalesced_read_buf_.get();
+  iov.iov_len = kMaxSegmentedDatagramSize;
+
+  char control[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  int bytes_transferred = HANDLE_EINTR(recvmsg(socket_, &msg, 0));
+  if (bytes_transferred < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+  if (msg.msg_flags & MSG_TRUNC) {
+    LogRead(ERR_MSG_TOO_BIG, NULL, 0, NULL);
+    return ERR_MSG_TOO_BIG;
+  }
+
+  // Without a UDP_GRO control message the kernel delivered a single datagram.
+  int segment_size = bytes_transferred;
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+      std::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+      break;
+    }
+  }
+  coalesced_read_offset_ = 0;
+  coalesced_read_end_ = bytes_transferred;
+  coalesced_read_segment_size_ = segment_size > 0 ? segment_size : 1;
+  return bytes_transferred;
+}
+
+int UDPSocketPosix::InternalSendSegmented(IOBuffer* buf,
+                                          int buf_len,
+                                          int segment_size) {
+  struct iovec iov = {};
+  iov.iov_base = buf->data();
+  iov.iov_len = buf_len;
+
+  char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  // A single segment is sent as an ordinary datagram, which older kernels
+  // also accept.
+  if (segment_size < buf_len) {
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t gso_size = static_cast<uint16_t>(segment_size);
+    std::memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+  }
+
+  int result = HANDLE_EINTR(sendmsg(socket_, &msg, sendto_flags_));
+  if (result < 0) {
+    // The kernel accepts UDP_SEGMENT on any socket, but fails the send with
+    // EIO if the device can't checksum the segments.
+    if (errno == EIO && msg.msg_control)
+      result = ERR_NOT_IMPLEMENTED;
+    else
+      result = MapSystemError(errno);
+  }
+  if (result != ERR_IO_PENDING)
+    LogWrite(result, buf->data(), NULL);
+  return result;
+}
+#endif  // HAVE_UDP_SEGMENTATION_OFFLOAD
+
 int UDPSocketPosix::InternalSendTo(IOBuffer* buf,
                                    int buf_len,
                                    const IPEndPoint* address) {
@@ -10,6 +10,7 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -33,10 +34,16 @@
 
 #if defined(__ANDROID__) && defined(__aarch64__)
 #define HAVE_SENDMMSG 1
+#define HAVE_RECVMMSG 1
+#define HAVE_UDP_SEGMENTATION_OFFLOAD 1
 #elif defined(OS_LINUX)
 #define HAVE_SENDMMSG 1
+#define HAVE_RECVMMSG 1
+#define HAVE_UDP_SEGMENTATION_OFFLOAD 1
 #else
 #define HAVE_SENDMMSG 0
+#define HAVE_RECVMMSG 0
+#define HAVE_UDP_SEGMENTATION_OFFLOAD 0
 #endif
 
 namespace net {
@@ -74,6 +81,11 @@ const int kWriteAsyncMaxBuffersThreshold = 16;
 const int kWriteAsyncPostBuffersThreshold = kWriteAsyncMaxBuffersThreshold / 2;
 // Don't unblock writer unless pending async writes are less than this.
 const int kWriteAsyncCallbackBuffersThreshold = kWriteAsyncMaxBuffersThreshold;
+// Don't read more than this many datagrams in one |ReadMultiple()| call.
+const int kReadMultipleMaxBuffers = 32;
+// Largest datagram train that can be sent or received with UDP segmentation
+// offload, which is limited by the maximum IP packet size.
+const int kMaxSegmentedDatagramSize = 65535;
 
 // To allow mock |Send|/|Sendmsg| in testing.  This has to be
 // reference counted thread safe because |SendBuffers| and
@@ -207,6 +219,27 @@ class NET_EXPORT UDPSocketPosix {
   // has been connected.
   int Read(IOBuffer* buf, int buf_len, CompletionOnceCallback callback);
 
+  // Reads up to |buffers.size()| datagrams from the socket, one datagram per
+  // buffer, with a single recvmmsg() call on platforms that support it.
+  // Returns the number of datagrams read, a net error code, or ERR_IO_PENDING
+  // if none is available yet, in which case |callback| is run with the same
+  // result once datagrams arrive. |lengths| is resized to |buffers.size()|,
+  // and the entries for the datagrams read are set to each one's length, or to
+  // ERR_MSG_TOO_BIG if it didn't fit its buffer. The caller must keep
+  // |buffers| and |lengths| alive until the callback is run.
+  // Only usable from the client-side of a UDP socket, after the socket
+  // has been connected.
+  int ReadMultiple(const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+                   std::vector<int>* lengths,
+                   CompletionOnceCallback callback);
+
+  // Asks the kernel to coalesce consecutive datagrams from the peer into one
+  // large receive (UDP GRO). ReadMultiple() splits them up again, so callers
+  // still see one datagram per buffer, but Read() must not be used afterwards.
+  // Returns OK, or ERR_NOT_IMPLEMENTED if the kernel lacks support.
+  // Only usable after the socket has been connected.
+  int EnableCoalescedReads();
+
   // Writes to the socket.
   // Only usable from the client-side of a UDP socket, after the socket
   // has been connected.
@@ -215,6 +248,21 @@ class NET_EXPORT UDPSocketPosix {
             CompletionOnceCallback callback,
             const NetworkTrafficAnnotationTag& traffic_annotation);
 
+  // Checks that the kernel can split segmented writes (UDP GSO) for this
+  // socket. Returns OK, or ERR_NOT_IMPLEMENTED if the kernel lacks support.
+  int EnableSegmentedWrites();
+
+  // Writes |buf_len| bytes from |buf| as consecutive datagrams of
+  // |segment_size| bytes each, the last of which may be shorter, with a single
+  // system call. EnableSegmentedWrites() must have succeeded. Returns
+  // |buf_len| on success, or ERR_NOT_IMPLEMENTED if the device can't segment
+  // the datagrams, and otherwise behaves as Write().
+  int WriteSegmented(IOBuffer* buf,
+                     int buf_len,
+                     int segment_size,
+                     CompletionOnceCallback callback,
+                     const NetworkTrafficAnnotationTag& traffic_annotation);
+
   // Refer to datagram_client_socket.h
   int WriteAsync(DatagramBuffers buffers,
                  CompletionOnceCallback callback,
@@ -522,6 +570,33 @@ class NET_EXPORT UDPSocketPosix {
                                          int buf_len,
                                          IPEndPoint* address);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  int InternalSendSegmented(IOBuffer* buf, int buf_len, int segment_size);
+#endif
+
+  // Reads datagrams for ReadMultiple(). Returns the number of datagrams read or
+  // a net error code.
+  int InternalReadMultiple(
+      const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+      std::vector<int>* lengths);
+#if HAVE_RECVMMSG
+  // Virtual to allow mocking recvmmsg() in tests.
+  virtual int Recvmmsg(int sockfd,
+                       struct mmsghdr* msgvec,
+                       unsigned int vlen,
+                       int flags) const;
+  int InternalRecvmmsg(
+      const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+      std::vector<int>* lengths);
+#endif
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  // Hands out the datagrams of the last coalesced receive, receiving a new one
+  // first if they have all been handed out.
+  int InternalReadCoalesced(
+      const std::vector<scoped_refptr<IOBufferWithSize>>& buffers,
+      std::vector<int>* lengths);
+  int InternalRecvCoalesced();
+#endif
 
   // Applies |socket_options_| to |socket_|. Should be called before
   // Bind().
@@ -599,6 +674,29 @@ class NET_EXPORT UDPSocketPosix {
   int read_buf_len_;
   IPEndPoint* recv_from_address_;
 
+  // The buffers used to retry ReadMultiple requests. Owned by the caller.
+  const std::vector<scoped_refptr<IOBufferWithSize>>* read_multiple_buffers_;
+  std::vector<int>* read_multiple_lengths_;
+
+#if HAVE_RECVMMSG
+  // Cleared if recvmmsg() turns out not to be implemented, after which
+  // ReadMultiple() reads one datagram per call.
+  bool recvmmsg_enabled_ = true;
+#endif
+
+#if HAVE_UDP_SEGMENTATION_OFFLOAD
+  // Set by EnableCoalescedReads(). Holds the last coalesced receive, of which
+  // the bytes in [|coalesced_read_offset_|, |coalesced_read_end_|) have not
+  // been handed out yet, as datagrams of |coalesced_read_segment_size_|.
+  std::unique_ptr<char[]> coalesced_read_buf_;
+  int coalesced_read_offset_ = 0;
+  int coalesced_read_end_ = 0;
+  int coalesced_read_segment_size_ = 0;
+
+  // The segment size of a pending WriteSegmented(), or 0 for other writes.
+  int write_segment_size_ = 0;
+#endif
+
   // The buffer used by InternalWrite() to retry Write requests
   scoped_refptr<IOBuffer> write_buf_;
   int write_buf_len_;
@@ -4,13 +4,21 @@
 
 #include "net/socket/udp_socket_posix.h"
 
+#include <string>
+#include <vector>
+
 #include "base/bind.h"
 #include "net/base/completion_repeating_callback.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
 #include "net/log/test_net_log.h"
 #include "net/log/test_net_log_entry.h"
 #include "net/log/test_net_log_util.h"
 #include "net/socket/datagram_socket.h"
+#include "net/test/gtest_util.h"
 #include "net/test/test_with_scoped_task_environment.h"
 #include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -39,7 +47,7 @@ int SetWouldBlock() {
   return -1;
 }
 
-#if HAVE_SENDMMSG
+#if HAVE_SENDMMSG || HAVE_RECVMMSG
 int SetNotImplemented() {
   errno = ENOSYS;
   return -1;
@@ -99,6 +107,13 @@ class MockUDPSocketPosix : public UDPSocketPosix {
 
   MOCK_METHOD0(InternalWatchFileDescriptor, bool());
   MOCK_METHOD0(InternalStopWatchingFileDescriptor, void());
+#if HAVE_RECVMMSG
+  MOCK_CONST_METHOD4(Recvmmsg,
+                     int(int sockfd,
+                         struct mmsghdr* msgvec,
+                         unsigned int vlen,
+                         int flags));
+#endif
 
   void FlushPending() { UDPSocketPosix::FlushPending(); }
 
@@ -220,6 +235,27 @@ class UDPSocketPosixTest : public TestWithScopedTaskEnvironment {
         .WillOnce(Return(kNumMsgs));
   }
 
+  // Binds |server| to a local port and connects |socket_| to it, returning
+  // the address of |socket_|.
+  IPEndPoint ConnectToServer(UDPSocketPosix* server) {
+    IPEndPoint server_address(IPAddress::IPv4Localhost(), 0);
+    EXPECT_THAT(server->Open(ADDRESS_FAMILY_IPV4), IsOk());
+    EXPECT_THAT(server->Bind(server_address), IsOk());
+    EXPECT_THAT(server->GetLocalAddress(&server_address), IsOk());
+    EXPECT_THAT(socket_.Open(ADDRESS_FAMILY_IPV4), IsOk());
+    EXPECT_THAT(socket_.Connect(server_address), IsOk());
+    IPEndPoint client_address;
+    EXPECT_THAT(socket_.GetLocalAddress(&client_address), IsOk());
+    return client_address;
+  }
+
+  std::vector<scoped_refptr<IOBufferWithSize>> MakeReadBuffers() {
+    std::vector<scoped_refptr<IOBufferWithSize>> buffers;
+    for (size_t i = 0; i < kNumMsgs; i++)
+      buffers.push_back(base::MakeRefCounted<IOBufferWithSize>(kMaxPacketSize));
+    return buffers;
+  }
+
   TestNetLog client_log_;
   MockUDPSocketPosix socket_;
   DatagramBuffers buffers_;
@@ -338,6 +374,63 @@ TEST_F(UDPSocketPosixTest, SendInternalSendmmsgFallback) {
 
 #endif  // HAVE_SENDMMSG
 
+#if HAVE_RECVMMSG
+
+TEST_F(UDPSocketPosixTest, ReadMultipleRecvmmsg) {
+  UDPSocketPosix server(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource());
+  ConnectToServer(&server);
+  EXPECT_CALL(socket_, Recvmmsg(_, _, kNumMsgs, _))
+      .WillOnce(Invoke([](int sockfd, struct mmsghdr* msgvec,
+                          unsigned int vlen, int flags) {
+        msgvec[0].msg_len = kHelloMsg.length();
+        msgvec[1].msg_len = kMaxPacketSize;
+        msgvec[1].msg_hdr.msg_flags = MSG_TRUNC;
+        return 2;
+      }));
+
+  std::vector<scoped_refptr<IOBufferWithSize>> buffers = MakeReadBuffers();
+  std::vector<int> lengths;
+  TestCompletionCallback callback;
+  EXPECT_EQ(2, socket_.ReadMultiple(buffers, &lengths, callback.callback()));
+  ASSERT_EQ(kNumMsgs, lengths.size());
+  EXPECT_EQ(static_cast<int>(kHelloMsg.length()), lengths[0]);
+  EXPECT_EQ(ERR_MSG_TOO_BIG, lengths[1]);
+}
+
+// Tests that ReadMultiple() falls back to one recvmsg() per call for good
+// once recvmmsg() turns out not to be implemented.
+TEST_F(UDPSocketPosixTest, ReadMultipleRecvmmsgFallback) {
+  UDPSocketPosix server(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource());
+  IPEndPoint client_address = ConnectToServer(&server);
+  for (const std::string& msg : {kHelloMsg, kSecondMsg}) {
+    scoped_refptr<StringIOBuffer> buffer =
+        base::MakeRefCounted<StringIOBuffer>(msg);
+    TestCompletionCallback callback;
+    EXPECT_EQ(buffer->size(),
+              callback.GetResult(server.SendTo(buffer.get(), buffer->size(),
+                                               client_address,
+                                               callback.callback())));
+  }
+
+  // Only the first read tries recvmmsg().
+  EXPECT_CALL(socket_, Recvmmsg(_, _, kNumMsgs, _))
+      .WillOnce(InvokeWithoutArgs(SetNotImplemented));
+
+  // Loopback datagrams are queued by the time SendTo() returns, so the reads
+  // complete synchronously.
+  std::vector<scoped_refptr<IOBufferWithSize>> buffers = MakeReadBuffers();
+  std::vector<int> lengths;
+  TestCompletionCallback callback;
+  EXPECT_EQ(1, socket_.ReadMultiple(buffers, &lengths, callback.callback()));
+  ASSERT_EQ(kNumMsgs, lengths.size());
+  EXPECT_EQ(kHelloMsg, std::string(buffers[0]->data(), lengths[0]));
+
+  EXPECT_EQ(1, socket_.ReadMultiple(buffers, &lengths, callback.callback()));
+  EXPECT_EQ(kSecondMsg, std::string(buffers[0]->data(), lengths[0]));
+}
+
+#endif  // HAVE_RECVMMSG
+
 TEST_F(UDPSocketPosixTest, DidSendBuffers) {
   AddBuffers();
   SaveBufferPtrs();
@@ -1307,6 +1307,130 @@ TEST_F(UDPSocketTest, ReadWithSocketOptimizationTruncation) {
   client.Close();
 }
 
+#if defined(OS_POSIX)
+// Tests that ReadMultiple() returns every queued datagram in its own buffer,
+// reporting truncated datagrams individually.
+TEST_F(UDPSocketTest, ReadMultiple) {
+  const std::string kMessages[] = {"first", std::string(kMaxRead + 1, 'A'),
+                                   "third"};
+
+  IPEndPoint server_address(IPAddress::IPv4Localhost(), 0 /* port */);
+  UDPServerSocket server(NULL, NetLogSource());
+  server.AllowAddressReuse();
+  ASSERT_THAT(server.Listen(server_address), IsOk());
+  ASSERT_THAT(server.GetLocalAddress(&server_address), IsOk());
+
+  UDPClientSocket client(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource());
+  EXPECT_THAT(client.Connect(server_address), IsOk());
+  IPEndPoint client_address;
+  EXPECT_THAT(client.GetLocalAddress(&client_address), IsOk());
+
+  std::vector<scoped_refptr<IOBufferWithSize>> buffers;
+  for (size_t i = 0; i < base::size(kMessages) + 1; ++i)
+    buffers.push_back(base::MakeRefCounted<IOBufferWithSize>(kMaxRead));
+  std::vector<int> lengths;
+
+  // Nothing has been sent yet, so the read completes once the first datagram
+  // arrives.
+  TestCompletionCallback callback;
+  int rv = client.ReadMultiple(buffers, &lengths, callback.callback());
+  ASSERT_EQ(ERR_IO_PENDING, rv);
+  for (const std::string& message : kMessages) {
+    EXPECT_EQ(message.length(), static_cast<size_t>(SendToSocket(
+                                    &server, message, client_address)));
+  }
+  rv = callback.WaitForResult();
+  ASSERT_GE(rv, 1);
+  ASSERT_EQ(buffers.size(), lengths.size());
+  EXPECT_EQ(static_cast<int>(kMessages[0].length()), lengths[0]);
+  EXPECT_EQ(kMessages[0], std::string(buffers[0]->data(), lengths[0]));
+
+  // Collect the rest of the datagrams. Where recvmmsg() is available, they
+  // are all returned by a single read.
+  std::vector<int> results(lengths.begin(), lengths.begin() + rv);
+  std::vector<std::string> payloads;
+  for (int i = 0; i < rv; ++i) {
+    payloads.push_back(lengths[i] > 0
+                           ? std::string(buffers[i]->data(), lengths[i])
+                           : std::string());
+  }
+  while (results.size() < base::size(kMessages)) {
+    rv = callback.GetResult(
+        client.ReadMultiple(buffers, &lengths, callback.callback()));
+    ASSERT_GE(rv, 1);
+    for (int i = 0; i < rv; ++i) {
+      results.push_back(lengths[i]);
+      payloads.push_back(lengths[i] > 0
+                             ? std::string(buffers[i]->data(), lengths[i])
+                             : std::string());
+    }
+  }
+  ASSERT_EQ(base::size(kMessages), results.size());
+  EXPECT_EQ(ERR_MSG_TOO_BIG, results[1]);
+  EXPECT_EQ(static_cast<int>(kMessages[2].length()), results[2]);
+  EXPECT_EQ(kMessages[2], payloads[2]);
+
+  server.Close();
+  client.Close();
+}
+
+// Tests that a segmented write arrives as separate datagrams, and that
+// ReadMultiple() splits them up again if the receiver coalesces them.
+TEST_F(UDPSocketTest, SegmentedWriteAndCoalescedRead) {
+  const std::string kSegments[] = {std::string(100, 'a'),
+                                   std::string(100, 'b'), std::string(50, 'c')};
+
+  UDPSocket receiver(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource());
+  ASSERT_THAT(receiver.Open(ADDRESS_FAMILY_IPV4), IsOk());
+  ASSERT_THAT(receiver.Bind(IPEndPoint(IPAddress::IPv4Localhost(), 0)),
+              IsOk());
+  IPEndPoint receiver_address;
+  ASSERT_THAT(receiver.GetLocalAddress(&receiver_address), IsOk());
+
+  UDPClientSocket sender(DatagramSocket::DEFAULT_BIND, nullptr, NetLogSource());
+  ASSERT_THAT(sender.Connect(receiver_address), IsOk());
+  IPEndPoint sender_address;
+  ASSERT_THAT(sender.GetLocalAddress(&sender_address), IsOk());
+  ASSERT_THAT(receiver.Connect(sender_address), IsOk());
+
+  if (sender.EnableSegmentedWrites() != OK) {
+    DVLOG(0) << "Skipping test - UDP segmentation offload unsupported.";
+    return;
+  }
+  // Without GRO the datagrams are simply received one by one.
+  receiver.EnableCoalescedReads();
+
+  std::string payload;
+  for (const std::string& segment : kSegments)
+    payload += segment;
+  auto buffer = base::MakeRefCounted<StringIOBuffer>(payload);
+  TestCompletionCallback write_callback;
+  EXPECT_EQ(static_cast<int>(payload.size()),
+            write_callback.GetResult(sender.WriteSegmented(
+                buffer.get(), payload.size(), kSegments[0].size(),
+                write_callback.callback(), TRAFFIC_ANNOTATION_FOR_TESTS)));
+
+  std::vector<scoped_refptr<IOBufferWithSize>> buffers;
+  for (size_t i = 0; i < base::size(kSegments) + 1; ++i)
+    buffers.push_back(base::MakeRefCounted<IOBufferWithSize>(kMaxRead));
+  std::vector<int> lengths;
+  std::vector<std::string> received;
+  while (received.size() < base::size(kSegments)) {
+    TestCompletionCallback read_callback;
+    int rv = read_callback.GetResult(
+        receiver.ReadMultiple(buffers, &lengths, read_callback.callback()));
+    ASSERT_GE(rv, 1);
+    for (int i = 0; i < rv; ++i) {
+      ASSERT_GT(lengths[i], 0);
+      received.push_back(std::string(buffers[i]->data(), lengths[i]));
+    }
+  }
+  ASSERT_EQ(base::size(kSegments), received.size());
+  for (size_t i = 0; i < base::size(kSegments); ++i)
+    EXPECT_EQ(kSegments[i], received[i]);
+}
+#endif  // defined(OS_POSIX)
+
 // On Android, where socket tagging is supported, verify that UDPSocket::Tag
 // works as expected.
 #if defined(OS_ANDROID)
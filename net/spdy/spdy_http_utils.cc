@@ -5,14 +5,17 @@
 #include "net/spdy/spdy_http_utils.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "base/feature_list.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/time/time.h"
 #include "net/base/escape.h"
+#include "net/base/features.h"
 #include "net/base/load_flags.h"
 #include "net/base/url_util.h"
 #include "net/http/http_request_headers.h"
@@ -20,6 +23,7 @@
 #include "net/http/http_response_headers.h"
 #include "net/http/http_response_info.h"
 #include "net/http/http_util.h"
+#include "net/http/http_version.h"
 
 namespace net {
 
@@ -40,13 +44,14 @@ void AddSpdyHeader(const std::string& name,
 
 }  // namespace
 
-bool SpdyHeadersToHttpResponse(const spdy::SpdyHeaderBlock& headers,
-                               HttpResponseInfo* response) {
+scoped_refptr<HttpResponseHeaders>
+SpdyHeadersToHttpResponseHeadersUsingRawString(
+    const spdy::SpdyHeaderBlock& headers) {
   // The ":status" header is required.
   spdy::SpdyHeaderBlock::const_iterator it =
       headers.find(spdy::kHttp2StatusHeader);
   if (it == headers.end())
-    return false;
+    return nullptr;
   std::string status = it->second.as_string();
   std::string raw_headers("HTTP/1.1 ");
   raw_headers.append(status);
@@ -81,7 +86,55 @@ bool SpdyHeadersToHttpResponse(const spdy::SpdyHeaderBlock& headers,
     } while (end != value.npos);
   }
 
-  response->headers = new HttpResponseHeaders(raw_headers);
+  return base::MakeRefCounted<HttpResponseHeaders>(raw_headers);
+}
+
+scoped_refptr<HttpResponseHeaders> SpdyHeadersToHttpResponseHeadersUsingBuilder(
+    const spdy::SpdyHeaderBlock& headers) {
+  // The ":status" header is required.
+  spdy::SpdyHeaderBlock::const_iterator it =
+      headers.find(spdy::kHttp2StatusHeader);
+  if (it == headers.end())
+    return nullptr;
+  base::StringPiece status = it->second;
+  if (status.find('\0') != base::StringPiece::npos)
+    return SpdyHeadersToHttpResponseHeadersUsingRawString(headers);
+
+  HttpResponseHeaders::Builder builder(HttpVersion(1, 1), status);
+  for (const auto& header : headers) {
+    base::StringPiece name = header.first;
+    if (!name.empty() && name[0] == ':')
+      name.remove_prefix(1);
+    // Parsing skips lines whose name is not a token, which the builder does
+    // not do. HeaderCoalescer rejects such names, so this is only reached for
+    // header blocks that did not come from the network.
+    if (!HttpUtil::IsToken(name))
+      return SpdyHeadersToHttpResponseHeadersUsingRawString(headers);
+
+    // As above, a NUL-separated list of values becomes one line per value.
+    base::StringPiece value = header.second;
+    size_t end;
+    while ((end = value.find('\0')) != base::StringPiece::npos) {
+      builder.AddHeader(name, value.substr(0, end));
+      value.remove_prefix(end + 1);
+    }
+    builder.AddHeader(name, value);
+  }
+
+  return builder.Build();
+}
+
+bool SpdyHeadersToHttpResponse(const spdy::SpdyHeaderBlock& headers,
+                               HttpResponseInfo* response) {
+  scoped_refptr<HttpResponseHeaders> response_headers =
+      base::FeatureList::IsEnabled(
+          features::kSpdyHeadersToHttpResponseUseBuilder)
+          ? SpdyHeadersToHttpResponseHeadersUsingBuilder(headers)
+          : SpdyHeadersToHttpResponseHeadersUsingRawString(headers);
+  if (!response_headers)
+    return false;
+
+  response->headers = std::move(response_headers);
   response->was_fetched_via_spdy = true;
   return true;
 }
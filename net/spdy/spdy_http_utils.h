@@ -5,6 +5,7 @@
 #ifndef NET_SPDY_SPDY_HTTP_UTILS_H_
 #define NET_SPDY_SPDY_HTTP_UTILS_H_
 
+#include "base/memory/scoped_refptr.h"
 #include "net/base/net_export.h"
 #include "net/base/request_priority.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_framer.h"
@@ -14,6 +15,7 @@
 
 namespace net {
 
+class HttpResponseHeaders;
 class HttpResponseInfo;
 struct HttpRequestInfo;
 class HttpRequestHeaders;
@@ -26,6 +28,18 @@ class HttpRequestHeaders;
 NET_EXPORT bool SpdyHeadersToHttpResponse(const spdy::SpdyHeaderBlock& headers,
                                           HttpResponseInfo* response);
 
+// The two implementations of SpdyHeadersToHttpResponse(), exposed for tests
+// and benchmarks. Both return nullptr if |headers| has no ":status" header,
+// and otherwise return identical headers. The first formats |headers| into a
+// raw header string and parses it. The second copies |headers| into the
+// result once, with HttpResponseHeaders::Builder.
+NET_EXPORT scoped_refptr<HttpResponseHeaders>
+SpdyHeadersToHttpResponseHeadersUsingRawString(
+    const spdy::SpdyHeaderBlock& headers);
+NET_EXPORT scoped_refptr<HttpResponseHeaders>
+SpdyHeadersToHttpResponseHeadersUsingBuilder(
+    const spdy::SpdyHeaderBlock& headers);
+
 // Create a spdy::SpdyHeaderBlock from HttpRequestInfo and HttpRequestHeaders.
 NET_EXPORT void CreateSpdyHeadersFromHttpRequest(
     const HttpRequestInfo& info,
@@ -7,8 +7,10 @@
 #include <stdint.h>
 
 #include <limits>
+#include <string>
 
 #include "net/http/http_request_info.h"
+#include "net/http/http_response_headers.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_framer.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_test_utils.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -71,4 +73,70 @@ TEST(SpdyHttpUtilsTest, CreateSpdyHeadersFromHttpRequestConnectHTTP2) {
   EXPECT_EQ("Chrome/1.1", headers["user-agent"]);
 }
 
+TEST(SpdyHttpUtilsTest, SpdyHeadersToHttpResponseHeadersMissingStatus) {
+  spdy::SpdyHeaderBlock headers;
+  headers["content-type"] = "text/html";
+  EXPECT_FALSE(SpdyHeadersToHttpResponseHeadersUsingRawString(headers));
+  EXPECT_FALSE(SpdyHeadersToHttpResponseHeadersUsingBuilder(headers));
+}
+
+TEST(SpdyHttpUtilsTest, SpdyHeadersToHttpResponseHeadersBuilderMatchesParsing) {
+  spdy::SpdyHeaderBlock headers;
+  headers[":status"] = "200";
+  headers["content-type"] = "text/html";
+  headers["cache-control"] = "private, max-age=10";
+  headers["empty"] = "";
+  headers["padded"] = " value\t";
+  headers.AppendValueOrAddHeader("set-cookie", "a=1");
+  headers.AppendValueOrAddHeader("set-cookie", " b=2");
+  headers.AppendValueOrAddHeader("set-cookie", "");
+
+  scoped_refptr<HttpResponseHeaders> parsed =
+      SpdyHeadersToHttpResponseHeadersUsingRawString(headers);
+  scoped_refptr<HttpResponseHeaders> built =
+      SpdyHeadersToHttpResponseHeadersUsingBuilder(headers);
+  ASSERT_TRUE(parsed);
+  ASSERT_TRUE(built);
+
+  EXPECT_EQ(parsed->raw_headers(), built->raw_headers());
+  EXPECT_EQ(200, built->response_code());
+  EXPECT_EQ("HTTP/1.1 200", built->GetStatusLine());
+
+  size_t parsed_iter = 0;
+  size_t built_iter = 0;
+  std::string parsed_name, parsed_value, built_name, built_value;
+  while (parsed->EnumerateHeaderLines(&parsed_iter, &parsed_name,
+                                      &parsed_value)) {
+    ASSERT_TRUE(
+        built->EnumerateHeaderLines(&built_iter, &built_name, &built_value));
+    EXPECT_EQ(parsed_name, built_name);
+    EXPECT_EQ(parsed_value, built_value);
+  }
+  EXPECT_FALSE(
+      built->EnumerateHeaderLines(&built_iter, &built_name, &built_value));
+
+  std::string value;
+  EXPECT_TRUE(built->GetNormalizedHeader("padded", &value));
+  EXPECT_EQ("value", value);
+  EXPECT_TRUE(built->GetNormalizedHeader("cache-control", &value));
+  EXPECT_EQ("private, max-age=10", value);
+}
+
+// Header blocks that the builder cannot represent as is fall back to parsing.
+TEST(SpdyHttpUtilsTest, SpdyHeadersToHttpResponseHeadersBuilderFallback) {
+  spdy::SpdyHeaderBlock headers;
+  headers[":status"] = "200";
+  headers["invalid name"] = "dropped";
+  headers["content-type"] = "text/html";
+
+  scoped_refptr<HttpResponseHeaders> parsed =
+      SpdyHeadersToHttpResponseHeadersUsingRawString(headers);
+  scoped_refptr<HttpResponseHeaders> built =
+      SpdyHeadersToHttpResponseHeadersUsingBuilder(headers);
+  ASSERT_TRUE(built);
+  EXPECT_EQ(parsed->raw_headers(), built->raw_headers());
+  EXPECT_FALSE(built->HasHeader("invalid name"));
+  EXPECT_TRUE(built->HasHeader("content-type"));
+}
+
 }  // namespace net
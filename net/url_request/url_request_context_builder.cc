@@ -313,6 +313,12 @@ void URLRequestContextBuilder::set_reporting_policy(
     std::unique_ptr<ReportingPolicy> reporting_policy) {
   reporting_policy_ = std::move(reporting_policy);
 }
+
+void URLRequestContextBuilder::set_persistent_nel_store(
+    std::unique_ptr<NetworkErrorLoggingService::PersistentNelStore>
+        persistent_nel_store) {
+  persistent_nel_store_ = std::move(persistent_nel_store);
+}
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
 void URLRequestContextBuilder::SetInterceptors(
@@ -551,9 +557,13 @@ std::unique_ptr<URLRequestContext> URLRequestContextBuilder::Build() {
   }
 
   if (network_error_logging_enabled_) {
+    NetworkErrorLoggingService::PersistentNelStore* persistent_nel_store =
+        persistent_nel_store_.get();
+    if (persistent_nel_store_)
+      storage->set_persistent_nel_store(std::move(persistent_nel_store_));
     storage->set_network_error_logging_service(
         NetworkErrorLoggingService::Create(
-            NetworkErrorLoggingDelegate::Create()));
+            NetworkErrorLoggingDelegate::Create(), persistent_nel_store));
   }
 
   // If both Reporting and Network Error Logging are actually enabled, then
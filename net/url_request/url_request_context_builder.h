@@ -42,6 +42,10 @@
 #include "net/third_party/quic/core/quic_packets.h"
 #include "net/url_request/url_request_job_factory.h"
 
+#if BUILDFLAG(ENABLE_REPORTING)
+#include "net/network_error_logging/network_error_logging_service.h"
+#endif  // BUILDFLAG(ENABLE_REPORTING)
+
 namespace base {
 namespace android {
 class ApplicationStatusListener;
@@ -324,6 +328,13 @@ class NET_EXPORT URLRequestContextBuilder {
   void set_network_error_logging_enabled(bool network_error_logging_enabled) {
     network_error_logging_enabled_ = network_error_logging_enabled;
   }
+
+  // Sets the store that Network Error Logging policies are persisted in. Only
+  // used if Network Error Logging is enabled; policies are kept in memory only
+  // by default.
+  void set_persistent_nel_store(
+      std::unique_ptr<NetworkErrorLoggingService::PersistentNelStore>
+          persistent_nel_store);
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
   void SetInterceptors(std::vector<std::unique_ptr<URLRequestInterceptor>>
@@ -419,6 +430,8 @@ class NET_EXPORT URLRequestContextBuilder {
 #if BUILDFLAG(ENABLE_REPORTING)
   std::unique_ptr<ReportingPolicy> reporting_policy_;
   bool network_error_logging_enabled_;
+  std::unique_ptr<NetworkErrorLoggingService::PersistentNelStore>
+      persistent_nel_store_;
 #endif  // BUILDFLAG(ENABLE_REPORTING)
   std::vector<std::unique_ptr<URLRequestInterceptor>> url_request_interceptors_;
   CreateInterceptingJobFactory create_intercepting_job_factory_;
@@ -164,6 +164,13 @@ void URLRequestContextStorage::set_network_error_logging_service(
       network_error_logging_service.get());
   network_error_logging_service_ = std::move(network_error_logging_service);
 }
+
+void URLRequestContextStorage::set_persistent_nel_store(
+    std::unique_ptr<NetworkErrorLoggingService::PersistentNelStore>
+        persistent_nel_store) {
+  DCHECK(!network_error_logging_service_);
+  persistent_nel_store_ = std::move(persistent_nel_store);
+}
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
 }  // namespace net
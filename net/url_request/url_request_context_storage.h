@@ -13,6 +13,10 @@
 #include "net/base/net_export.h"
 #include "net/net_buildflags.h"
 
+#if BUILDFLAG(ENABLE_REPORTING)
+#include "net/network_error_logging/network_error_logging_service.h"
+#endif  // BUILDFLAG(ENABLE_REPORTING)
+
 namespace net {
 
 class CertVerifier;
@@ -37,7 +41,6 @@ class URLRequestJobFactory;
 class URLRequestThrottlerManager;
 
 #if BUILDFLAG(ENABLE_REPORTING)
-class NetworkErrorLoggingService;
 class ReportingService;
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
@@ -93,6 +96,12 @@ class NET_EXPORT URLRequestContextStorage {
   void set_network_error_logging_service(
       std::unique_ptr<NetworkErrorLoggingService>
           network_error_logging_service);
+
+  // Not pointed at by the URLRequestContext; the NetworkErrorLoggingService
+  // uses it. Must be set before the service.
+  void set_persistent_nel_store(
+      std::unique_ptr<NetworkErrorLoggingService::PersistentNelStore>
+          persistent_nel_store);
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
   // Everything else can be access through the URLRequestContext, but this
@@ -133,6 +142,9 @@ class NET_EXPORT URLRequestContextStorage {
 
 #if BUILDFLAG(ENABLE_REPORTING)
   std::unique_ptr<ReportingService> reporting_service_;
+  // Declared before the service, which uses it until it is destroyed.
+  std::unique_ptr<NetworkErrorLoggingService::PersistentNelStore>
+      persistent_nel_store_;
   std::unique_ptr<NetworkErrorLoggingService> network_error_logging_service_;
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
@@ -4,6 +4,10 @@
 
 #include <inttypes.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/files/file_path.h"
@@ -13,6 +17,7 @@
 #include "base/run_loop.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/time/time.h"
 #include "base/trace_event/memory_dump_manager.h"
 #include "base/trace_event/memory_dump_manager_test_utils.h"
@@ -20,7 +25,10 @@
 #include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/trace_config.h"
 #include "base/trace_event/traced_value.h"
+#include "net/base/elements_upload_data_stream.h"
+#include "net/base/features.h"
 #include "net/base/load_timing_info.h"
+#include "net/base/upload_bytes_element_reader.h"
 #include "net/cert/mock_cert_verifier.h"
 #include "net/dns/mapped_host_resolver.h"
 #include "net/dns/mock_host_resolver.h"
@@ -61,6 +69,10 @@ const char kHelloPath[] = "/hello.txt";
 const char kHelloAltSvcResponse[] = "Hello from QUIC Server";
 const char kHelloOriginResponse[] = "Hello from TCP Server";
 const int kHelloStatus = 200;
+// Used as a large response from the server, and as a large request body.
+const char kBulkPath[] = "/bulk";
+const size_t kBulkSize = 20 * 1024 * 1024;
+const double kMegabyte = 1024 * 1024;
 
 std::unique_ptr<test_server::HttpResponse> HandleRequest(
     const test_server::HttpRequest& request) {
@@ -77,13 +89,13 @@ std::unique_ptr<test_server::HttpResponse> HandleRequest(
 }
 
 void PrintPerfTest(const std::string& name,
-                   int value,
+                   double value,
                    const std::string& unit) {
   const ::testing::TestInfo* test_info =
       ::testing::UnitTest::GetInstance()->current_test_info();
   perf_test::PrintResult(test_info->test_case_name(),
                          std::string(".") + test_info->name(), name,
-                         static_cast<double>(value), unit, true);
+                         value, unit, true);
 }
 
 class URLRequestQuicPerfTest : public ::testing::Test {
@@ -141,11 +153,90 @@ class URLRequestQuicPerfTest : public ::testing::Test {
 
   URLRequestContext* context() const { return context_.get(); }
 
+  // Sends requests until one is served by the QUIC server, which makes sure a
+  // QUIC session is set up for later requests. Returns false if none is.
+  bool WaitForQuic() {
+    GURL url(base::StringPrintf("https://%s%s", kOriginHost, kHelloPath));
+    for (int i = 0; i < 10; ++i) {
+      TestDelegate delegate;
+      std::unique_ptr<URLRequest> request =
+          CreateRequest(url, DEFAULT_PRIORITY, &delegate);
+      request->Start();
+      base::RunLoop().Run();
+      if (delegate.data_received() == kHelloAltSvcResponse)
+        return true;
+    }
+    return false;
+  }
+
+  // Downloads, or uploads if |upload| is true, kBulkSize bytes over a new
+  // QUIC session, with UDP segmentation offload enabled if |offload| is true
+  // and request bodies handed to QUIC without copying if |zero_copy| is true.
+  // The QUIC server runs on this thread too, so the CPU time reported covers
+  // both ends of the transfer.
+  void RunBulkTransfer(bool upload, bool offload, bool zero_copy) {
+    std::vector<base::Feature> enabled_features;
+    std::vector<base::Feature> disabled_features;
+    (offload ? enabled_features : disabled_features)
+        .push_back(features::kQuicBatchedPacketReads);
+    (offload ? enabled_features : disabled_features)
+        .push_back(features::kQuicUdpSegmentationOffload);
+    (zero_copy ? enabled_features : disabled_features)
+        .push_back(features::kQuicZeroCopyRequestBody);
+    base::test::ScopedFeatureList feature_list;
+    feature_list.InitWithFeatures(enabled_features, disabled_features);
+    // Packet readers and writers pick up the features when they are created.
+    context()->http_transaction_factory()->GetSession()->CloseAllConnections();
+    ASSERT_TRUE(WaitForQuic());
+
+    TestDelegate delegate;
+    std::unique_ptr<URLRequest> request = CreateRequest(
+        GURL(base::StringPrintf("https://%s%s", kOriginHost,
+                                upload ? kHelloPath : kBulkPath)),
+        DEFAULT_PRIORITY, &delegate);
+    std::string body;
+    if (upload) {
+      body.assign(kBulkSize, 'u');
+      request->set_method("POST");
+      request->set_upload(ElementsUploadDataStream::CreateWithReader(
+          std::make_unique<UploadBytesElementReader>(body.data(), body.size()),
+          0));
+    }
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    base::ThreadTicks start_thread = base::ThreadTicks::Now();
+    request->Start();
+    base::RunLoop().Run();
+    base::TimeDelta cpu_time = base::ThreadTicks::Now() - start_thread;
+    base::TimeDelta wall_time = base::TimeTicks::Now() - start;
+
+    EXPECT_TRUE(request->status().is_success());
+    if (upload)
+      EXPECT_EQ(kHelloAltSvcResponse, delegate.data_received());
+    else
+      EXPECT_EQ(kBulkSize, delegate.data_received().size());
+
+    std::string trace;
+    if (offload)
+      trace += "_segmentation_offload";
+    if (zero_copy)
+      trace += "_zero_copy";
+    if (trace.empty())
+      trace = "_baseline";
+    PrintPerfTest("throughput" + trace,
+                  kBulkSize / kMegabyte / wall_time.InSecondsF(), "MB/s");
+    PrintPerfTest("cpu_time" + trace,
+                  cpu_time.InMillisecondsF() / (kBulkSize / kMegabyte),
+                  "ms/MB");
+  }
+
  private:
   void StartQuicServer() {
     quic::QuicConfig config;
     memory_cache_backend_.AddSimpleResponse(kOriginHost, kHelloPath,
                                             kHelloStatus, kHelloAltSvcResponse);
+    memory_cache_backend_.AddSimpleResponse(
+        kOriginHost, kBulkPath, kHelloStatus, std::string(kBulkSize, 'd'));
     quic_server_.reset(new QuicSimpleServer(
         quic::test::crypto_test_utils::ProofSourceForTesting(), config,
         quic::QuicCryptoServerConfig::ConfigOptions(),
@@ -273,4 +364,28 @@ TEST_F(URLRequestQuicPerfTest, TestGetRequest) {
   base::trace_event::MemoryDumpManager::GetInstance()->TeardownForTracing();
 }
 
+TEST_F(URLRequestQuicPerfTest, TestBulkDownload) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  base::ThreadTicks::WaitUntilInitialized();
+  for (bool offload : {false, true})
+    RunBulkTransfer(false, offload, false);
+}
+
+TEST_F(URLRequestQuicPerfTest, TestBulkUpload) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  base::ThreadTicks::WaitUntilInitialized();
+  for (bool offload : {false, true})
+    RunBulkTransfer(true, offload, false);
+}
+
+TEST_F(URLRequestQuicPerfTest, TestBulkUploadZeroCopy) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  base::ThreadTicks::WaitUntilInitialized();
+  for (bool zero_copy : {false, true})
+    RunBulkTransfer(true, false, zero_copy);
+}
+
 }  // namespace net
@@ -116,6 +116,7 @@
 #endif  // !defined(OS_IOS)
 
 #if BUILDFLAG(ENABLE_REPORTING)
+#include "net/extras/sqlite/sqlite_persistent_nel_store.h"
 #include "net/network_error_logging/network_error_logging_service.h"
 #include "net/reporting/reporting_browsing_data_remover.h"
 #include "net/reporting/reporting_policy.h"
@@ -623,6 +624,24 @@ NetworkContext::~NetworkContext() {
 #endif
   }
 
+#if BUILDFLAG(ENABLE_REPORTING)
+  // Like their cookies, the stored NEL policies of session-only origins don't
+  // outlive the session. If no header or request loaded the policies, this
+  // session set none, and they are not loaded now just to be removed: stored
+  // policies of session-only origins are dropped when they are next loaded.
+  if (HasPersistentNelStore() && url_request_context_ &&
+      url_request_context_->network_error_logging_service() &&
+      url_request_context_->network_error_logging_service()
+          ->HasLoadedPolicies() &&
+      cookie_manager_ &&
+      cookie_manager_->cookie_settings().HasSessionOnlyOrigins()) {
+    const CookieSettings* cookie_settings = &cookie_manager_->cookie_settings();
+    url_request_context_->network_error_logging_service()->RemoveBrowsingData(
+        base::BindRepeating(&CookieSettings::IsCookieSessionOnly,
+                            base::Unretained(cookie_settings)));
+  }
+#endif  // BUILDFLAG(ENABLE_REPORTING)
+
   if (domain_reliability_monitor_)
     domain_reliability_monitor_->Shutdown();
   // Because of the order of declaration in the class,
@@ -677,6 +696,13 @@ void NetworkContext::SetCertVerifierForTesting(
   g_cert_verifier_for_testing = cert_verifier;
 }
 
+bool NetworkContext::HasPersistentNelStore() const {
+  // Contexts that keep cookies on disk keep NEL policies next to them.
+  return params_ && params_->cookie_path &&
+         base::FeatureList::IsEnabled(features::kNetworkErrorLogging) &&
+         base::FeatureList::IsEnabled(features::kPersistentNetworkErrorLogging);
+}
+
 bool NetworkContext::IsPrimaryNetworkContext() const {
   return params_ && params_->primary_network_context;
 }
@@ -1850,8 +1876,22 @@ URLRequestContextOwner NetworkContext::ApplyContextParamsToBuilder(
     builder->set_reporting_policy(nullptr);
   }
 
-  builder->set_network_error_logging_enabled(
-      base::FeatureList::IsEnabled(features::kNetworkErrorLogging));
+  if (base::FeatureList::IsEnabled(features::kNetworkErrorLogging)) {
+    builder->set_network_error_logging_enabled(true);
+    if (HasPersistentNelStore()) {
+      scoped_refptr<base::SequencedTaskRunner> background_task_runner =
+          base::CreateSequencedTaskRunnerWithTraits(
+              {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+               base::TaskShutdownBehavior::BLOCK_SHUTDOWN});
+      builder->set_persistent_nel_store(
+          std::make_unique<net::SQLitePersistentNelStore>(
+              params_->cookie_path->DirName().Append(
+                  FILE_PATH_LITERAL("Network Error Logging")),
+              background_task_runner));
+    }
+  } else {
+    builder->set_network_error_logging_enabled(false);
+  }
 #endif  // BUILDFLAG(ENABLE_REPORTING)
 
 #if BUILDFLAG(IS_CT_SUPPORTED)
@@ -2037,6 +2077,19 @@ URLRequestContextOwner NetworkContext::ApplyContextParamsToBuilder(
       std::move(session_cleanup_channel_id_store),
       std::move(params_->cookie_manager_params));
 
+#if BUILDFLAG(ENABLE_REPORTING)
+  // ~NetworkContext only removes the policies of session-only origins if they
+  // were loaded. Any that are still stored, because no session loaded them or
+  // the origin became session-only later, are dropped when they are loaded.
+  if (HasPersistentNelStore() &&
+      result.url_request_context->network_error_logging_service()) {
+    result.url_request_context->network_error_logging_service()
+        ->SetDiscardStoredPolicyFilter(base::BindRepeating(
+            &CookieSettings::IsCookieSessionOnly,
+            base::Unretained(&cookie_manager_->cookie_settings())));
+  }
+#endif  // BUILDFLAG(ENABLE_REPORTING)
+
   return result;
 }
 
@@ -402,6 +402,10 @@ class COMPONENT_EXPORT(NETWORK_SERVICE) NetworkContext
   URLRequestContextOwner ApplyContextParamsToBuilder(
       URLRequestContextBuilderMojo* builder);
 
+  // Whether the Network Error Logging policies of this context are stored on
+  // disk.
+  bool HasPersistentNelStore() const;
+
   // Invoked when the HTTP cache was cleared. Invokes |callback|.
   void OnHttpCacheCleared(ClearHttpCacheCallback callback,
                           HttpCacheDataRemover* remover);
@@ -22,6 +22,11 @@ const base::Feature kNetworkService{"NetworkService",
 const base::Feature kOutOfBlinkCors{"OutOfBlinkCors",
                                     base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Keeps the Network Error Logging policies of contexts that store cookies on
+// disk in a database next to the cookies, so that they survive a restart.
+const base::Feature kPersistentNetworkErrorLogging{
+    "PersistentNetworkErrorLogging", base::FEATURE_DISABLED_BY_DEFAULT};
+
 const base::Feature kReporting{"Reporting", base::FEATURE_ENABLED_BY_DEFAULT};
 
 // Based on the field trial parameters, this feature will override the value of
@@ -12,6 +12,7 @@
 #include "components/prefs/persistent_pref_store.h"
 
 namespace {
+const char kProtection[] = "protection";
 const char kPreferenceMACs[] = "protection.macs";
 const char kSuperMACPref[] = "protection.super_mac";
 }
@@ -27,6 +28,11 @@ void DictionaryHashStoreContents::RegisterProfilePrefs(
   registry->RegisterStringPref(kSuperMACPref, std::string());
 }
 
+// static
+const char* DictionaryHashStoreContents::GetStorageKey() {
+  return kProtection;
+}
+
 bool DictionaryHashStoreContents::IsCopyable() const {
   return false;
 }
@@ -30,6 +30,10 @@ class DictionaryHashStoreContents : public HashStoreContents {
   // Registers required preferences.
   static void RegisterProfilePrefs(user_prefs::PrefRegistrySyncable* registry);
 
+  // Returns the top-level key of |storage| under which all of the MACs are
+  // stored.
+  static const char* GetStorageKey();
+
   // HashStoreContents implementation
   bool IsCopyable() const override;
   std::unique_ptr<HashStoreContents> MakeCopy() const override;
@@ -199,6 +199,12 @@ PrefFilter::OnWriteCallbackPair PrefHashFilter::FilterSerializeData(
   return callback_pair;
 }
 
+base::Optional<std::vector<std::string>>
+PrefHashFilter::GetKeysModifiedBySerializeData() const {
+  // FilterSerializeData() only stores MACs.
+  return std::vector<std::string>{DictionaryHashStoreContents::GetStorageKey()};
+}
+
 void PrefHashFilter::OnStoreDeletionFromDisk() {
   if (external_validation_hash_store_pair_) {
     external_validation_hash_store_pair_->second.get()->Reset();
@@ -91,6 +91,8 @@ class PrefHashFilter : public InterceptablePrefFilter {
   void FilterUpdate(const std::string& path) override;
   OnWriteCallbackPair FilterSerializeData(
       base::DictionaryValue* pref_store_contents) override;
+  base::Optional<std::vector<std::string>> GetKeysModifiedBySerializeData()
+      const override;
 
   void OnStoreDeletionFromDisk() override;
 
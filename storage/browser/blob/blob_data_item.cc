@@ -5,6 +5,7 @@
 #include "storage/browser/blob/blob_data_item.h"
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -17,6 +18,9 @@ namespace storage {
 namespace {
 const base::FilePath::CharType kFutureFileName[] =
     FILE_PATH_LITERAL("_future_name_");
+
+// ShrinkBytes() only reallocates when it frees at least 1/4 of the item.
+const uint64_t kMinShrinkReallocationDivisor = 4;
 }
 
 bool BlobDataItem::DataHandle::IsValid() {
@@ -29,7 +33,8 @@ scoped_refptr<BlobDataItem> BlobDataItem::CreateBytes(
     base::span<const char> bytes) {
   auto item =
       base::WrapRefCounted(new BlobDataItem(Type::kBytes, 0, bytes.size()));
-  item->bytes_.assign(bytes.begin(), bytes.end());
+  item->bytes_.reset(new char[bytes.size()]);
+  std::memcpy(item->bytes_.get(), bytes.data(), bytes.size());
   return item;
 }
 
@@ -131,7 +136,9 @@ BlobDataItem::~BlobDataItem() = default;
 
 void BlobDataItem::AllocateBytes() {
   DCHECK_EQ(type_, Type::kBytesDescription);
-  bytes_.resize(length_);
+  // Not zero-filled: the transport writes every byte before the blob can be
+  // read, and a blob whose transport fails is never readable.
+  bytes_.reset(new char[static_cast<size_t>(length_)]);
   type_ = Type::kBytes;
 }
 
@@ -139,13 +146,21 @@ void BlobDataItem::PopulateBytes(base::span<const char> data) {
   DCHECK_EQ(type_, Type::kBytesDescription);
   DCHECK_EQ(length_, data.size());
   type_ = Type::kBytes;
-  bytes_.assign(data.begin(), data.end());
+  bytes_.reset(new char[data.size()]);
+  std::memcpy(bytes_.get(), data.data(), data.size());
 }
 
 void BlobDataItem::ShrinkBytes(size_t new_length) {
   DCHECK_EQ(type_, Type::kBytes);
+  DCHECK_LE(new_length, length_);
+  // Reallocate so the memory given back to the BlobMemoryController is really
+  // released, unless too little is freed to be worth copying the rest.
+  if ((length_ - new_length) * kMinShrinkReallocationDivisor >= length_) {
+    std::unique_ptr<char[]> shrunk_bytes(new char[new_length]);
+    std::memcpy(shrunk_bytes.get(), bytes_.get(), new_length);
+    bytes_ = std::move(shrunk_bytes);
+  }
   length_ = new_length;
-  bytes_.resize(length_);
 }
 
 void BlobDataItem::PopulateFile(base::FilePath path,
@@ -91,7 +91,7 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
 
   base::span<const char> bytes() const {
     DCHECK_EQ(type_, Type::kBytes);
-    return base::make_span(bytes_);
+    return base::make_span(bytes_.get(), static_cast<size_t>(length_));
   }
 
   const base::FilePath& path() const {
@@ -158,11 +158,15 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
 
   base::span<char> mutable_bytes() {
     DCHECK_EQ(type_, Type::kBytes);
-    return base::make_span(bytes_);
+    return base::make_span(bytes_.get(), static_cast<size_t>(length_));
   }
 
+  // Allocates |length_| uninitialized bytes, so that populating a large item
+  // from the renderer touches its memory only once. The caller must fill all
+  // of them, or shrink the item to what it filled, before the blob completes.
   void AllocateBytes();
   void PopulateBytes(base::span<const char> data);
+  // Only reallocates when a large enough part of the bytes is freed.
   void ShrinkBytes(size_t new_length);
 
   void PopulateFile(base::FilePath path,
@@ -179,9 +183,9 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
   uint64_t offset_;
   uint64_t length_;
 
-  std::vector<char> bytes_;  // For Type::kBytes.
-  base::FilePath path_;      // For Type::kFile.
-  GURL filesystem_url_;      // For Type::kFileFilesystem.
+  std::unique_ptr<char[]> bytes_;  // For Type::kBytes.
+  base::FilePath path_;            // For Type::kFile.
+  GURL filesystem_url_;            // For Type::kFileFilesystem.
   base::Time
       expected_modification_time_;  // For Type::kFile and kFileFilesystem.
 
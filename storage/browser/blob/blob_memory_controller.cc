@@ -117,6 +117,13 @@ BlobStorageLimits CalculateBlobStorageLimitsImpl(
   }
   limits.effective_max_disk_space = limits.desired_max_disk_space;
 
+#if !defined(OS_ANDROID)
+  // Let new paging rounds overlap with page files that are still being
+  // written, so that building a series of large blobs doesn't stall on one
+  // file write at a time.
+  limits.max_concurrent_page_file_writes = 4;
+#endif
+
   CHECK(limits.IsValid());
 
   return limits;
@@ -894,15 +901,15 @@ size_t BlobMemoryController::CollectItemsForEviction(
 
 void BlobMemoryController::MaybeScheduleEvictionUntilSystemHealthy(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
-  // Don't do eviction when others are happening, as we don't change our
-  // pending_memory_quota_total_size_ value until after the paging files have
-  // been written.
-  if (pending_evictions_ != 0 || !file_paging_enabled_)
+  if (!file_paging_enabled_)
     return;
 
+  // Memory that is already being written to disk will be freed when those
+  // writes complete, so it doesn't count towards the usage we page for here.
+  DCHECK_LE(in_flight_memory_used_, blob_memory_used_);
   uint64_t total_memory_usage =
       static_cast<uint64_t>(pending_memory_quota_total_size_) +
-      blob_memory_used_;
+      blob_memory_used_ - in_flight_memory_used_;
 
   size_t in_memory_limit = limits_.memory_limit_before_paging();
   uint64_t min_page_file_size = limits_.min_page_file_size;
@@ -918,7 +925,12 @@ void BlobMemoryController::MaybeScheduleEvictionUntilSystemHealthy(
   // We try to page items to disk until our current system size + requested
   // memory is below our size limit.
   // Size limit is a lower |memory_limit_before_paging()| if we have disk space.
-  while (disk_used_ < limits_.effective_max_disk_space &&
+  // Don't start more eviction while too many page files are in flight, as we
+  // don't change our pending_memory_quota_total_size_ value until after the
+  // paging files have been written.
+  while (pending_evictions_ <
+             static_cast<int>(limits_.max_concurrent_page_file_writes) &&
+         disk_used_ < limits_.effective_max_disk_space &&
          total_memory_usage > in_memory_limit) {
     const char* reason = nullptr;
     if (memory_pressure_level !=
@@ -947,6 +959,10 @@ void BlobMemoryController::MaybeScheduleEvictionUntilSystemHealthy(
     }
 
     // Update our bookkeeping.
+    if (!pending_evictions_) {
+      memory_usage_before_eviction_ =
+          blob_memory_used_ + pending_memory_quota_total_size_;
+    }
     pending_evictions_++;
     disk_used_ += total_items_size;
     in_flight_memory_used_ += total_items_size;
@@ -972,8 +988,7 @@ void BlobMemoryController::MaybeScheduleEvictionUntilSystemHealthy(
                        total_items_size),
         base::BindOnce(&BlobMemoryController::OnEvictionComplete,
                        weak_factory_.GetWeakPtr(), std::move(file_reference),
-                       std::move(items_to_swap), total_items_size, reason,
-                       total_memory_usage));
+                       std::move(items_to_swap), total_items_size, reason));
 
     last_eviction_time_ = base::TimeTicks::Now();
   }
@@ -985,7 +1000,6 @@ void BlobMemoryController::OnEvictionComplete(
     std::vector<scoped_refptr<ShareableBlobDataItem>> items,
     size_t total_items_size,
     const char* evict_reason,
-    size_t memory_usage_before_eviction,
     std::pair<FileCreationInfo, int64_t /* avail_disk */> result) {
   if (!file_paging_enabled_)
     return;
@@ -1021,12 +1035,12 @@ void BlobMemoryController::OnEvictionComplete(
 
   // Record change in memory usage at the last eviction reply.
   size_t total_usage = blob_memory_used_ + pending_memory_quota_total_size_;
-  if (!pending_evictions_ && memory_usage_before_eviction >= total_usage) {
+  if (!pending_evictions_ && memory_usage_before_eviction_ >= total_usage) {
     std::string full_histogram_name =
         std::string("Storage.Blob.SizeEvictedToDiskInKB.") + evict_reason;
     base::UmaHistogramCounts100000(
         full_histogram_name,
-        (memory_usage_before_eviction - total_usage) / 1024);
+        (memory_usage_before_eviction_ - total_usage) / 1024);
   }
 
   // We want callback on blobs up to the amount we've freed.
@@ -247,7 +247,6 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobMemoryController {
       std::vector<scoped_refptr<ShareableBlobDataItem>> items,
       size_t total_items_size,
       const char* evict_reason,
-      size_t memory_usage_before_eviction,
       std::pair<FileCreationInfo, int64_t /* avail_disk */> result);
 
   void OnMemoryPressure(
@@ -298,6 +297,11 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobMemoryController {
   PendingFileQuotaTaskList pending_file_quota_tasks_;
 
   int pending_evictions_ = 0;
+  // The memory usage, including in-flight memory, when the first of the
+  // pending evictions was scheduled. Page file writes may overlap, so the
+  // Storage.Blob.SizeEvictedToDiskInKB histograms compare against this once
+  // the last of them completes.
+  size_t memory_usage_before_eviction_ = 0;
 
   bool file_paging_enabled_ = false;
   base::FilePath blob_storage_dir_;
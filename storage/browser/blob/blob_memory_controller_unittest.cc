@@ -11,6 +11,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
 #include "base/system/sys_info.h"
+#include "base/test/test_pending_task.h"
 #include "base/test/test_simple_task_runner.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -605,6 +606,135 @@ TEST_F(BlobMemoryControllerTest, MultipleFilesPaged) {
   EXPECT_EQ(0u, controller.disk_usage());
 }
 
+TEST_F(BlobMemoryControllerTest, PagingLimitsConcurrentPageFiles) {
+  const size_t kSize = kTestBlobStorageMaxBlobMemorySize / 2;
+  char kData[kSize];
+  std::memset(kData, 'e', kSize);
+
+  BlobMemoryController controller(temp_dir_.GetPath(), file_runner_);
+  SetTestMemoryLimits(&controller);
+  BlobStorageLimits limits = controller.limits();
+  limits.max_concurrent_page_file_writes = 1;
+  controller.set_limits_for_testing(limits);
+  AssertEnoughDiskSpace();
+
+  // Two populated items would fill two page files, but only one is written
+  // at a time.
+  BlobDataBuilder builder1("id1");
+  BlobDataBuilder::FutureData future_data1 = builder1.AppendFutureData(kSize);
+  BlobDataBuilder builder2("id2");
+  BlobDataBuilder::FutureData future_data2 = builder2.AppendFutureData(kSize);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items1 =
+      CreateSharedDataItems(builder1);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items2 =
+      CreateSharedDataItems(builder2);
+  controller.ReserveMemoryQuota(items1, GetMemoryRequestCallback());
+  controller.ReserveMemoryQuota(items2, GetMemoryRequestCallback());
+  future_data1.Populate(base::make_span(kData, kSize));
+  items1[0]->set_state(ItemState::POPULATED_WITH_QUOTA);
+  future_data2.Populate(base::make_span(kData, kSize));
+  items2[0]->set_state(ItemState::POPULATED_WITH_QUOTA);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> both_items = {items1[0],
+                                                                  items2[0]};
+  controller.NotifyMemoryItemsUsed(both_items);
+  both_items.clear();
+  EXPECT_EQ(1u, file_runner_->NumPendingTasks());
+
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(kSize, controller.disk_usage());
+  EXPECT_NE(items1[0]->item()->type(), items2[0]->item()->type());
+}
+
+TEST_F(BlobMemoryControllerTest, PagingOverlapsInFlightPageFiles) {
+  const size_t kSize = kTestBlobStorageMaxBlobMemorySize / 2;
+  char kData[kSize];
+  std::memset(kData, 'e', kSize);
+
+  BlobMemoryController controller(temp_dir_.GetPath(), file_runner_);
+  SetTestMemoryLimits(&controller);
+  BlobStorageLimits limits = controller.limits();
+  limits.max_concurrent_page_file_writes = 2;
+  controller.set_limits_for_testing(limits);
+  AssertEnoughDiskSpace();
+
+  // Fill our memory with two populated items, which get paged to two files.
+  BlobDataBuilder builder1("id1");
+  BlobDataBuilder::FutureData future_data1 = builder1.AppendFutureData(kSize);
+  BlobDataBuilder builder2("id2");
+  BlobDataBuilder::FutureData future_data2 = builder2.AppendFutureData(kSize);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items1 =
+      CreateSharedDataItems(builder1);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items2 =
+      CreateSharedDataItems(builder2);
+  controller.ReserveMemoryQuota(items1, GetMemoryRequestCallback());
+  controller.ReserveMemoryQuota(items2, GetMemoryRequestCallback());
+  future_data1.Populate(base::make_span(kData, kSize));
+  items1[0]->set_state(ItemState::POPULATED_WITH_QUOTA);
+  future_data2.Populate(base::make_span(kData, kSize));
+  items2[0]->set_state(ItemState::POPULATED_WITH_QUOTA);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> both_items = {items1[0],
+                                                                  items2[0]};
+  controller.NotifyMemoryItemsUsed(both_items);
+  both_items.clear();
+  EXPECT_EQ(2u, file_runner_->NumPendingTasks());
+
+  // This request has to wait for paging to free memory.
+  BlobDataBuilder builder3("id3");
+  BlobDataBuilder::FutureData future_data3 = builder3.AppendFutureData(kSize);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items3 =
+      CreateSharedDataItems(builder3);
+  memory_quota_result_ = false;
+  controller.ReserveMemoryQuota(items3, GetMemoryRequestCallback());
+  EXPECT_FALSE(memory_quota_result_);
+
+  // Finish writing only the first page file.
+  base::circular_deque<base::TestPendingTask> file_tasks =
+      file_runner_->TakePendingTasks();
+  base::ThreadRestrictions::SetIOAllowed(true);
+  std::move(file_tasks.front().task).Run();
+  base::ThreadRestrictions::SetIOAllowed(false);
+  file_tasks.pop_front();
+  for (base::TestPendingTask& task : file_tasks)
+    file_runner_->PostTask(task.location, std::move(task.task));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(memory_quota_result_);
+  future_data3.Populate(base::make_span(kData, kSize));
+  items3[0]->set_state(ItemState::POPULATED_WITH_QUOTA);
+  controller.NotifyMemoryItemsUsed(items3);
+
+  // The second page file is still in flight, but a new request can start
+  // paging the third item right away.
+  BlobDataBuilder builder4("id4");
+  builder4.AppendFutureData(kSize);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items4 =
+      CreateSharedDataItems(builder4);
+  memory_quota_result_ = false;
+  controller.ReserveMemoryQuota(items4, GetMemoryRequestCallback());
+  EXPECT_FALSE(memory_quota_result_);
+  EXPECT_EQ(2u, file_runner_->NumPendingTasks());
+
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(memory_quota_result_);
+  EXPECT_EQ(BlobDataItem::Type::kFile, items1[0]->item()->type());
+  EXPECT_EQ(BlobDataItem::Type::kFile, items2[0]->item()->type());
+  EXPECT_EQ(BlobDataItem::Type::kFile, items3[0]->item()->type());
+  EXPECT_EQ(kSize, controller.memory_usage());
+  EXPECT_EQ(3 * kSize, controller.disk_usage());
+
+  items1.clear();
+  items2.clear();
+  items3.clear();
+  items4.clear();
+
+  EXPECT_EQ(0u, controller.memory_usage());
+  base::RunLoop().RunUntilIdle();
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0u, controller.disk_usage());
+}
+
 TEST_F(BlobMemoryControllerTest, FullEviction) {
   BlobMemoryController controller(temp_dir_.GetPath(), file_runner_);
   SetTestMemoryLimits(&controller);
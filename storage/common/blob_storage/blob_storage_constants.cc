@@ -78,7 +78,8 @@ bool BlobStorageLimits::IsValid() const {
          max_shared_memory_size <= max_bytes_data_item_size &&
          min_page_file_size <= max_file_size &&
          min_page_file_size <= max_blob_in_memory_space &&
-         effective_max_disk_space <= desired_max_disk_space;
+         effective_max_disk_space <= desired_max_disk_space &&
+         max_concurrent_page_file_writes > 0;
 }
 
 bool BlobStatusIsError(BlobStatus status) {
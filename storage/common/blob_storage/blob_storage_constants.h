@@ -19,6 +19,7 @@ constexpr size_t kDefaultSharedMemorySize = 10u * 1024 * 1024;
 constexpr size_t kDefaultMaxBlobInMemorySpace = 500u * 1024 * 1024;
 constexpr uint64_t kDefaultMaxBlobDiskSpace = 0ull;
 constexpr uint64_t kDefaultMaxPageFileSize = 100ull * 1024 * 1024;
+constexpr size_t kDefaultMaxConcurrentPageFileWrites = 1u;
 
 #if defined(OS_ANDROID)
 // On minimal Android maximum in-memory space can be as low as 5MB.
@@ -89,6 +90,10 @@ struct COMPONENT_EXPORT(STORAGE_COMMON) BlobStorageLimits {
   uint64_t min_page_file_size = kDefaultMinPageFileSize;
   // This is the maximum file size we can create.
   uint64_t max_file_size = kDefaultMaxPageFileSize;
+  // This is the number of page files that can be in flight to disk before we
+  // stop starting new paging rounds. When greater than one, paging can resume
+  // while earlier page files are still being written.
+  size_t max_concurrent_page_file_writes = kDefaultMaxConcurrentPageFileWrites;
   // This overrides the minimum size for transporting a blob using the file
   // strategy. This allows perf tests to force file transportation. This is
   // usually set using the "blob-transport-by-file-min-size" switch (see
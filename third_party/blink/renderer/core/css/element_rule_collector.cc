@@ -30,6 +30,8 @@
 
 #include "third_party/blink/renderer/core/css/element_rule_collector.h"
 
+#include <algorithm>
+
 #include "third_party/blink/renderer/core/css/css_import_rule.h"
 #include "third_party/blink/renderer/core/css/css_keyframes_rule.h"
 #include "third_party/blink/renderer/core/css/css_media_rule.h"
@@ -42,6 +44,8 @@
 #include "third_party/blink/renderer/core/css/resolver/style_resolver.h"
 #include "third_party/blink/renderer/core/css/resolver/style_resolver_stats.h"
 #include "third_party/blink/renderer/core/css/resolver/style_rule_usage_tracker.h"
+#include "third_party/blink/renderer/core/css/rule_set.h"
+#include "third_party/blink/renderer/core/css/selector_filter.h"
 #include "third_party/blink/renderer/core/css/style_engine.h"
 #include "third_party/blink/renderer/core/dom/shadow_root.h"
 #include "third_party/blink/renderer/core/style/computed_style.h"
@@ -112,9 +116,8 @@ static bool RulesApplicableInCurrentTreeScope(
          element->ContainingTreeScope() == scoping_node->ContainingTreeScope();
 }
 
-template <typename RuleDataListType>
 void ElementRuleCollector::CollectMatchingRulesForList(
-    const RuleDataListType* rules,
+    const RuleDataList* rules,
     ShadowV0CascadeOrder cascade_order,
     const MatchRequest& match_request,
     PartNames* part_names) {
@@ -138,14 +141,27 @@ void ElementRuleCollector::CollectMatchingRulesForList(
   unsigned fast_rejected = 0;
   unsigned matched = 0;
 
-  for (const auto& rule_data : *rules) {
-    if (can_use_fast_reject_ &&
-        selector_filter_.FastRejectSelector<RuleData::kMaximumIdentifierCount>(
-            rule_data->DescendantSelectorIdentifierHashes())) {
+  const wtf_size_t rule_count = rules->size();
+  const unsigned kBatchSize = SelectorFilter::kMaximumFastRejectBatchSize;
+  uint64_t fast_reject_mask = 0;
+  for (wtf_size_t i = 0; i < rule_count; ++i) {
+    // Fast reject a batch of rules at a time, straight from the packed
+    // identifier hashes, so that rejected rules are never loaded.
+    const unsigned batch_index = i % kBatchSize;
+    if (can_use_fast_reject_ && !batch_index) {
+      const unsigned batch_size =
+          std::min<wtf_size_t>(rule_count - i, kBatchSize);
+      fast_reject_mask = selector_filter_.FastRejectSelectors<
+          RuleDataList::kMaximumIdentifierCount>(
+          rules->IdentifierHashesAt(i), batch_size);
+    }
+    if (fast_reject_mask & (uint64_t{1} << batch_index)) {
       fast_rejected++;
       continue;
     }
 
+    const RuleData* rule_data = rules->at(i);
+
     // Don't return cross-origin rules if we did not explicitly ask for them
     // through SetSameOriginOnly.
     if (same_origin_only_ && !rule_data->HasDocumentSecurityOrigin())
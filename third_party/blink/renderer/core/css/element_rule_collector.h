@@ -39,6 +39,7 @@ class CSSStyleSheet;
 class CSSRuleList;
 class PartNames;
 class RuleData;
+class RuleDataList;
 class SelectorFilter;
 class StaticCSSRuleList;
 class StyleRuleUsageTracker;
@@ -157,8 +158,7 @@ class ElementRuleCollector {
   void AddMatchedRulesToTracker(StyleRuleUsageTracker*) const;
 
  private:
-  template <typename RuleDataListType>
-  void CollectMatchingRulesForList(const RuleDataListType*,
+  void CollectMatchingRulesForList(const RuleDataList*,
                                    ShadowV0CascadeOrder,
                                    const MatchRequest&,
                                    PartNames* = nullptr);
@@ -0,0 +1,148 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/css/element_rule_collector.h"
+
+#include <memory>
+
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/blink/renderer/core/css/properties/longhands.h"
+#include "third_party/blink/renderer/core/css/resolver/style_resolver_stats.h"
+#include "third_party/blink/renderer/core/css/style_change_reason.h"
+#include "third_party/blink/renderer/core/css/style_engine.h"
+#include "third_party/blink/renderer/core/dom/document.h"
+#include "third_party/blink/renderer/core/html/html_element.h"
+#include "third_party/blink/renderer/core/style/computed_style.h"
+#include "third_party/blink/renderer/core/testing/dummy_page_holder.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
+
+namespace blink {
+
+class ElementRuleCollectorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    dummy_page_holder_ = DummyPageHolder::Create(IntSize(800, 600));
+  }
+
+  Document& GetDocument() { return dummy_page_holder_->GetDocument(); }
+
+  void SetBodyInnerHTML(const String& html) {
+    GetDocument().body()->SetInnerHTMLFromString(html);
+    GetDocument().UpdateStyleAndLayoutTree();
+  }
+
+  // Recalculates the style of the whole document and returns the time taken.
+  base::TimeDelta RecalcAllStyle() {
+    GetDocument().SetNeedsStyleRecalc(
+        kSubtreeStyleChange, StyleChangeReasonForTracing::Create(
+                                 style_change_reason::kStyleSheetChange));
+    base::ElapsedTimer timer;
+    GetDocument().UpdateStyleAndLayoutTree();
+    return timer.Elapsed();
+  }
+
+  void RunStyleRecalcBenchmark(const char* story, const String& html);
+
+ private:
+  std::unique_ptr<DummyPageHolder> dummy_page_holder_;
+};
+
+namespace {
+
+// |rule_count| rules with descendant selectors, most of which are rejected by
+// the ancestor filter for the elements of SyntheticTree().
+String SyntheticRules(int rule_count) {
+  StringBuilder builder;
+  builder.Append("<style>");
+  for (int i = 0; i < rule_count; ++i) {
+    builder.Append(".section-");
+    builder.AppendNumber(i % 97);
+    builder.Append(" .list-");
+    builder.AppendNumber(i % 13);
+    builder.Append(i % 2 ? " .item" : " div");
+    builder.Append(" { padding-left: ");
+    builder.AppendNumber(i % 50);
+    builder.Append("px }\n");
+  }
+  builder.Append("</style>");
+  return builder.ToString();
+}
+
+String SyntheticTree(int section_count, int items_per_section) {
+  StringBuilder builder;
+  for (int i = 0; i < section_count; ++i) {
+    builder.Append("<div class='section-");
+    builder.AppendNumber(i);
+    builder.Append("'><div class='list-");
+    builder.AppendNumber(i % 13);
+    builder.Append("'>");
+    for (int j = 0; j < items_per_section; ++j)
+      builder.Append("<div class='item'><span>text</span></div>");
+    builder.Append("</div></div>");
+  }
+  return builder.ToString();
+}
+
+}  // namespace
+
+void ElementRuleCollectorTest::RunStyleRecalcBenchmark(const char* story,
+                                                       const String& html) {
+  SetBodyInnerHTML(html);
+  GetDocument().GetStyleEngine().SetStatsEnabled(true);
+
+  const int kIterations = 20;
+  base::TimeDelta total;
+  for (int i = 0; i < kIterations; ++i)
+    total += RecalcAllStyle();
+
+  StyleResolverStats* stats = GetDocument().GetStyleEngine().Stats();
+  perf_test::PrintResult("style_recalc", "", story,
+                         total.InMillisecondsF() / kIterations, "ms", true);
+  perf_test::PrintResult("style_recalc_fast_rejected", "", story,
+                         stats->rules_fast_rejected / kIterations, "rules",
+                         false);
+  perf_test::PrintResult("style_recalc_rejected", "", story,
+                         stats->rules_rejected / kIterations, "rules", false);
+}
+
+TEST_F(ElementRuleCollectorTest, FastRejectAcrossBatches) {
+  // Enough rules in one bucket to span several fast reject batches, with the
+  // one that matches in the last batch.
+  StringBuilder builder;
+  builder.Append("<style>");
+  for (int i = 0; i < 150; ++i) {
+    builder.Append(".missing-");
+    builder.AppendNumber(i);
+    builder.Append(" .target { color: red }\n");
+  }
+  builder.Append(".ancestor .target { color: green }</style>");
+  builder.Append(
+      "<div class='ancestor'><div><div id='target' class='target'></div>"
+      "</div></div>");
+  SetBodyInnerHTML(builder.ToString());
+
+  GetDocument().GetStyleEngine().SetStatsEnabled(true);
+  RecalcAllStyle();
+
+  Element* target = GetDocument().getElementById("target");
+  ASSERT_TRUE(target);
+  EXPECT_EQ(MakeRGB(0, 128, 0),
+            target->GetComputedStyle()->VisitedDependentColor(
+                GetCSSPropertyColor()));
+  EXPECT_GE(GetDocument().GetStyleEngine().Stats()->rules_fast_rejected, 150u);
+}
+
+// Only the default style sheets, i.e. a real world rule set.
+TEST_F(ElementRuleCollectorTest, DISABLED_StyleRecalcDefaultRules) {
+  RunStyleRecalcBenchmark("default_rules", SyntheticTree(200, 10));
+}
+
+TEST_F(ElementRuleCollectorTest, DISABLED_StyleRecalcManyRules) {
+  RunStyleRecalcBenchmark("many_rules",
+                          SyntheticRules(5000) + SyntheticTree(200, 10));
+}
+
+}  // namespace blink
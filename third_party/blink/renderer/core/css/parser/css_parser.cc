@@ -75,6 +75,15 @@ ParseSheetResult CSSParser::ParseSheet(
       text, context, style_sheet, defer_property_parsing, allow_import_rules);
 }
 
+ParseSheetResult CSSParser::ParseTokenizedSheet(
+    const CSSParserContext* context,
+    StyleSheetContents* style_sheet,
+    const CSSTokenizedSheet& tokenized_sheet,
+    CSSDeferPropertyParsing defer_property_parsing) {
+  return CSSParserImpl::ParseStyleSheet(tokenized_sheet, context, style_sheet,
+                                        defer_property_parsing);
+}
+
 void CSSParser::ParseSheetForInspector(const CSSParserContext* context,
                                        StyleSheetContents* style_sheet,
                                        const String& text,
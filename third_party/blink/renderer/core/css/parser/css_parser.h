@@ -16,6 +16,7 @@ namespace blink {
 class Color;
 class CSSParserObserver;
 class CSSSelectorList;
+class CSSTokenizedSheet;
 class Element;
 class ImmutableCSSPropertyValueSet;
 class StyleRuleBase;
@@ -42,6 +43,14 @@ class CORE_EXPORT CSSParser {
       CSSDeferPropertyParsing defer_property_parsing =
           CSSDeferPropertyParsing::kNo,
       bool allow_import_rules = true);
+  // Parses a sheet whose tokens were produced ahead of time by
+  // CSSTokenizedSheet::Tokenize(), e.g. on a worker thread.
+  static ParseSheetResult ParseTokenizedSheet(
+      const CSSParserContext*,
+      StyleSheetContents*,
+      const CSSTokenizedSheet&,
+      CSSDeferPropertyParsing defer_property_parsing =
+          CSSDeferPropertyParsing::kNo);
   static CSSSelectorList ParseSelector(const CSSParserContext*,
                                        StyleSheetContents*,
                                        const String&);
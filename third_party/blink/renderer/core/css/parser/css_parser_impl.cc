@@ -22,6 +22,7 @@
 #include "third_party/blink/renderer/core/css/parser/css_property_parser.h"
 #include "third_party/blink/renderer/core/css/parser/css_selector_parser.h"
 #include "third_party/blink/renderer/core/css/parser/css_supports_parser.h"
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
 #include "third_party/blink/renderer/core/css/parser/css_tokenizer.h"
 #include "third_party/blink/renderer/core/css/parser/css_variable_parser.h"
 #include "third_party/blink/renderer/core/css/parser/media_query_parser.h"
@@ -262,13 +263,36 @@ ParseSheetResult CSSParserImpl::ParseStyleSheet(
     StyleSheetContents* style_sheet,
     CSSDeferPropertyParsing defer_property_parsing,
     bool allow_import_rules) {
+  CSSTokenizer tokenizer(string);
+  return ParseStyleSheet(tokenizer, string, context, style_sheet,
+                         defer_property_parsing, allow_import_rules);
+}
+
+ParseSheetResult CSSParserImpl::ParseStyleSheet(
+    const CSSTokenizedSheet& tokenized_sheet,
+    const CSSParserContext* context,
+    StyleSheetContents* style_sheet,
+    CSSDeferPropertyParsing defer_property_parsing,
+    bool allow_import_rules) {
+  CSSTokenizer tokenizer(tokenized_sheet);
+  return ParseStyleSheet(tokenizer, tokenized_sheet.Text(), context,
+                         style_sheet, defer_property_parsing,
+                         allow_import_rules);
+}
+
+ParseSheetResult CSSParserImpl::ParseStyleSheet(
+    CSSTokenizer& tokenizer,
+    const String& string,
+    const CSSParserContext* context,
+    StyleSheetContents* style_sheet,
+    CSSDeferPropertyParsing defer_property_parsing,
+    bool allow_import_rules) {
   TRACE_EVENT_BEGIN2("blink,blink_style", "CSSParserImpl::parseStyleSheet",
                      "baseUrl", context->BaseURL().GetString().Utf8(), "mode",
                      context->Mode());
 
   TRACE_EVENT_BEGIN0("blink,blink_style",
                      "CSSParserImpl::parseStyleSheet.parse");
-  CSSTokenizer tokenizer(string);
   CSSParserTokenStream stream(tokenizer);
   CSSParserImpl parser(context, style_sheet);
   if (defer_property_parsing == CSSDeferPropertyParsing::kYes) {
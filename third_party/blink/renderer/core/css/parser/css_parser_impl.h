@@ -23,6 +23,8 @@ class CSSLazyParsingState;
 class CSSParserContext;
 class CSSParserObserver;
 class CSSParserTokenStream;
+class CSSTokenizedSheet;
+class CSSTokenizer;
 class StyleRule;
 class StyleRuleBase;
 class StyleRuleCharset;
@@ -110,6 +112,14 @@ class CSSParserImpl {
       StyleSheetContents*,
       CSSDeferPropertyParsing = CSSDeferPropertyParsing::kNo,
       bool allow_import_rules = true);
+  // Like the above, but consumes tokens produced ahead of time, possibly on
+  // another thread, instead of tokenizing the text.
+  static ParseSheetResult ParseStyleSheet(
+      const CSSTokenizedSheet&,
+      const CSSParserContext*,
+      StyleSheetContents*,
+      CSSDeferPropertyParsing = CSSDeferPropertyParsing::kNo,
+      bool allow_import_rules = true);
   static CSSSelectorList ParsePageSelector(CSSParserTokenRange,
                                            StyleSheetContents*);
 
@@ -138,6 +148,13 @@ class CSSParserImpl {
     kFontFeatureRuleList,
   };
 
+  static ParseSheetResult ParseStyleSheet(CSSTokenizer&,
+                                          const String&,
+                                          const CSSParserContext*,
+                                          StyleSheetContents*,
+                                          CSSDeferPropertyParsing,
+                                          bool allow_import_rules);
+
   // Returns whether the first encountered rule was valid
   template <typename T>
   bool ConsumeRuleList(CSSParserTokenStream&, RuleListType, T callback);
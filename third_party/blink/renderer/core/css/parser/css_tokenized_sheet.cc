@@ -0,0 +1,41 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
+
+#include <utility>
+
+#include "base/memory/ptr_util.h"
+#include "third_party/blink/renderer/core/css/parser/css_tokenizer.h"
+
+namespace blink {
+
+// static
+std::unique_ptr<CSSTokenizedSheet> CSSTokenizedSheet::Tokenize(String text) {
+  auto sheet = base::WrapUnique(new CSSTokenizedSheet(std::move(text)));
+  CSSTokenizer tokenizer(sheet->text_);
+
+  // Most strings we tokenize have about 3.5 to 5 characters per token.
+  const wtf_size_t estimated_tokens = sheet->text_.length() / 3;
+  sheet->tokens_.ReserveInitialCapacity(estimated_tokens);
+  sheet->end_offsets_.ReserveInitialCapacity(estimated_tokens);
+
+  while (true) {
+    const CSSParserToken token = tokenizer.NextToken();
+    sheet->tokens_.push_back(token);
+    sheet->end_offsets_.push_back(tokenizer.Offset());
+    if (token.GetType() == kEOFToken)
+      break;
+  }
+  sheet->string_pool_ = std::move(tokenizer.string_pool_);
+  sheet->tokens_.ShrinkToFit();
+  sheet->end_offsets_.ShrinkToFit();
+  return sheet;
+}
+
+CSSTokenizedSheet::CSSTokenizedSheet(String text) : text_(std::move(text)) {}
+
+CSSTokenizedSheet::~CSSTokenizedSheet() = default;
+
+}  // namespace blink
@@ -0,0 +1,59 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_CSS_PARSER_CSS_TOKENIZED_SHEET_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_CSS_PARSER_CSS_TOKENIZED_SHEET_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/core/css/parser/css_parser_token.h"
+#include "third_party/blink/renderer/platform/wtf/allocator.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+// The complete token stream of a style sheet, produced ahead of parsing.
+//
+// Tokenize() does not touch any garbage collected or thread-bound state, so it
+// can run on a worker thread. The result owns the sheet text and every string
+// its tokens point into, which lets it be handed back to the main thread in
+// one piece. There, a CSSTokenizer constructed from it replays the tokens
+// instead of tokenizing the text again.
+class CORE_EXPORT CSSTokenizedSheet {
+  USING_FAST_MALLOC(CSSTokenizedSheet);
+
+ public:
+  // |text| must not be shared with another thread, e.g. it should be an
+  // IsolatedCopy() made on the calling thread. Move it in when the result is
+  // handed to another thread, so that no other reference to it is left
+  // behind.
+  static std::unique_ptr<CSSTokenizedSheet> Tokenize(String text);
+
+  ~CSSTokenizedSheet();
+
+  const String& Text() const { return text_; }
+  // The number of tokens, including comments and the final EOF token.
+  wtf_size_t TokenCount() const { return tokens_.size(); }
+
+ private:
+  friend class CSSTokenizer;
+
+  explicit CSSTokenizedSheet(String text);
+
+  String text_;
+  // Strings created for tokens with escapes; see CSSTokenizer::string_pool_.
+  Vector<String> string_pool_;
+  Vector<CSSParserToken> tokens_;
+  // The input offset just past each token in |tokens_|.
+  Vector<wtf_size_t> end_offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(CSSTokenizedSheet);
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_CSS_PARSER_CSS_TOKENIZED_SHEET_H_
@@ -0,0 +1,105 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
+
+#include <string>
+
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/blink/renderer/core/css/parser/css_parser.h"
+#include "third_party/blink/renderer/core/css/parser/css_parser_context.h"
+#include "third_party/blink/renderer/core/css/style_sheet_contents.h"
+#include "third_party/blink/renderer/platform/shared_buffer.h"
+#include "third_party/blink/renderer/platform/testing/unit_test_helpers.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
+
+namespace blink {
+
+namespace {
+
+// Style sheets checked into the tree, concatenated and repeated to the sizes
+// below so that the parser sees real selectors, at-rules and declarations
+// rather than one generated rule over and over.
+const char* const kSheets[] = {
+    "fullscreen.css",      "mathml.css",  "svg.css", "view-source.css",
+    "viewportAndroid.css", "xhtmlmp.css",
+};
+
+const wtf_size_t kSheetSizes[] = {1 << 20, 4 << 20};
+
+const int kIterations = 5;
+
+String ReadSheets() {
+  StringBuilder builder;
+  for (const char* name : kSheets) {
+    scoped_refptr<SharedBuffer> data = test::ReadFromFile(
+        test::BlinkRootDir() + "/renderer/core/css/" + name);
+    Vector<char> bytes = data->CopyAs<Vector<char>>();
+    builder.Append(String::FromUTF8(bytes.data(), bytes.size()));
+    builder.Append('\n');
+  }
+  return builder.ToString();
+}
+
+String SheetOfSize(const String& sheets, wtf_size_t size) {
+  StringBuilder builder;
+  while (builder.length() < size)
+    builder.Append(sheets);
+  return builder.ToString();
+}
+
+CSSParserContext* ParserContext() {
+  return CSSParserContext::Create(kHTMLStandardMode,
+                                  SecureContextMode::kInsecureContext);
+}
+
+}  // namespace
+
+// Reports how long the main thread is blocked by parsing a large sheet: either
+// tokenizing and parsing the text there, or only parsing tokens that were
+// produced on a worker thread.
+TEST(CSSTokenizedSheetPerfTest, MainThreadBlockingTime) {
+  String sheets = ReadSheets();
+  ASSERT_FALSE(sheets.IsEmpty());
+
+  for (wtf_size_t size : kSheetSizes) {
+    String text = SheetOfSize(sheets, size);
+    std::string story = std::to_string(text.length() >> 10) + "KiB";
+
+    base::TimeDelta text_time;
+    base::TimeDelta tokenize_time;
+    base::TimeDelta tokenized_time;
+    for (int i = 0; i < kIterations; ++i) {
+      CSSParserContext* context = ParserContext();
+      base::ElapsedTimer text_timer;
+      CSSParser::ParseSheet(context, StyleSheetContents::Create(context), text);
+      text_time += text_timer.Elapsed();
+
+      base::ElapsedTimer tokenize_timer;
+      std::unique_ptr<CSSTokenizedSheet> tokenized =
+          CSSTokenizedSheet::Tokenize(text);
+      tokenize_time += tokenize_timer.Elapsed();
+
+      context = ParserContext();
+      base::ElapsedTimer tokenized_timer;
+      CSSParser::ParseTokenizedSheet(
+          context, StyleSheetContents::Create(context), *tokenized);
+      tokenized_time += tokenized_timer.Elapsed();
+    }
+
+    perf_test::PrintResult("main_thread_parse", "", story + "_text",
+                           text_time.InMillisecondsF() / kIterations, "ms",
+                           true);
+    perf_test::PrintResult("main_thread_parse", "", story + "_tokenized",
+                           tokenized_time.InMillisecondsF() / kIterations,
+                           "ms", true);
+    perf_test::PrintResult("off_thread_tokenize", "", story,
+                           tokenize_time.InMillisecondsF() / kIterations, "ms",
+                           true);
+  }
+}
+
+}  // namespace blink
@@ -0,0 +1,105 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/core/css/css_property_value_set.h"
+#include "third_party/blink/renderer/core/css/parser/css_parser.h"
+#include "third_party/blink/renderer/core/css/parser/css_parser_context.h"
+#include "third_party/blink/renderer/core/css/parser/css_tokenizer.h"
+#include "third_party/blink/renderer/core/css/style_rule.h"
+#include "third_party/blink/renderer/core/css/style_sheet_contents.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
+
+namespace blink {
+
+namespace {
+
+String LargeSheetText(int rule_count) {
+  StringBuilder builder;
+  for (int i = 0; i < rule_count; ++i) {
+    builder.Append(".item-");
+    builder.AppendNumber(i);
+    builder.Append(" > a:hover, #id-");
+    builder.AppendNumber(i);
+    builder.Append(
+        " .c\\6c ass { color: rgb(1, 2, 3); margin: 1px 2em 3% auto; "
+        "background: url(\"img.png\") no-repeat; font-family: 'Arial'; }\n");
+  }
+  return builder.ToString();
+}
+
+StyleSheetContents* ParseText(const String& text) {
+  CSSParserContext* context = CSSParserContext::Create(
+      kHTMLStandardMode, SecureContextMode::kInsecureContext);
+  StyleSheetContents* sheet = StyleSheetContents::Create(context);
+  CSSParser::ParseSheet(context, sheet, text);
+  return sheet;
+}
+
+StyleSheetContents* ParseTokenized(const CSSTokenizedSheet& tokenized) {
+  CSSParserContext* context = CSSParserContext::Create(
+      kHTMLStandardMode, SecureContextMode::kInsecureContext);
+  StyleSheetContents* sheet = StyleSheetContents::Create(context);
+  CSSParser::ParseTokenizedSheet(context, sheet, tokenized);
+  return sheet;
+}
+
+}  // namespace
+
+TEST(CSSTokenizedSheetTest, ReplayMatchesTokenizer) {
+  const char* sheets[] = {
+      "",
+      "a { color: red }",
+      "/* comment */ @media (min-width: 10px) { .x\\31 { top: 1e3px } }",
+      "#\\66oo \"str\\\"ing\" url(  a\\)b ) U+0-7F <!-- --> 12.5% -1",
+      "a { b: c",
+  };
+  for (const char* text : sheets) {
+    SCOPED_TRACE(text);
+    CSSTokenizer expected(text);
+    std::unique_ptr<CSSTokenizedSheet> tokenized =
+        CSSTokenizedSheet::Tokenize(text);
+    CSSTokenizer actual(*tokenized);
+
+    wtf_size_t count = 0;
+    while (true) {
+      CSSParserToken expected_token = expected.TokenizeSingleWithComments();
+      CSSParserToken actual_token = actual.TokenizeSingleWithComments();
+      ++count;
+      ASSERT_EQ(expected_token, actual_token);
+      ASSERT_EQ(expected.Offset(), actual.Offset());
+      if (expected_token.IsEOF())
+        break;
+    }
+    EXPECT_EQ(count, tokenized->TokenCount());
+    // Reading past the end keeps returning EOF.
+    EXPECT_TRUE(actual.TokenizeSingleWithComments().IsEOF());
+  }
+}
+
+TEST(CSSTokenizedSheetTest, ParseMatchesText) {
+  String text = LargeSheetText(20) + "@import 'late.css'; @font-face {}";
+  StyleSheetContents* expected = ParseText(text);
+  StyleSheetContents* actual =
+      ParseTokenized(*CSSTokenizedSheet::Tokenize(text));
+
+  ASSERT_EQ(expected->RuleCount(), actual->RuleCount());
+  for (wtf_size_t i = 0; i < expected->ChildRules().size(); ++i) {
+    StyleRuleBase* expected_rule = expected->ChildRules()[i];
+    StyleRuleBase* actual_rule = actual->ChildRules()[i];
+    ASSERT_EQ(expected_rule->GetType(), actual_rule->GetType());
+    if (!expected_rule->IsStyleRule())
+      continue;
+    StyleRule* expected_style = ToStyleRule(expected_rule);
+    StyleRule* actual_style = ToStyleRule(actual_rule);
+    EXPECT_EQ(expected_style->SelectorList().SelectorsText(),
+              actual_style->SelectorList().SelectorsText());
+    EXPECT_EQ(expected_style->Properties().AsText(),
+              actual_style->Properties().AsText());
+  }
+}
+
+}  // namespace blink
@@ -10,6 +10,7 @@ namespace blink {
 
 #include "third_party/blink/renderer/core/css/parser/css_parser_idioms.h"
 #include "third_party/blink/renderer/core/css/parser/css_parser_token_range.h"
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
 #include "third_party/blink/renderer/core/html/parser/html_parser_idioms.h"
 #include "third_party/blink/renderer/platform/wtf/text/character_names.h"
 
@@ -28,6 +29,11 @@ CSSTokenizer::CSSTokenizer(const String& string, wtf_size_t offset)
   input_.Advance(offset);
 }
 
+CSSTokenizer::CSSTokenizer(const CSSTokenizedSheet& sheet)
+    : input_(sheet.Text()), tokenized_sheet_(&sheet) {
+  DCHECK(!sheet.tokens_.IsEmpty());
+}
+
 Vector<CSSParserToken, 32> CSSTokenizer::TokenizeToEOF() {
   // To avoid resizing we err on the side of reserving too much space.
   // Most strings we tokenize have about 3.5 to 5 characters per token.
@@ -289,6 +295,9 @@ CSSParserToken CSSTokenizer::EndOfFile(UChar cc) {
 }
 
 CSSParserToken CSSTokenizer::NextToken() {
+  if (UNLIKELY(tokenized_sheet_))
+    return NextTokenFromSheet();
+
   // Unlike the HTMLTokenizer, the CSS Syntax spec is written
   // as a stateless, (fixed-size) look-ahead tokenizer.
   // We could move to the stateful model and instead create
@@ -312,6 +321,19 @@ CSSParserToken CSSTokenizer::NextToken() {
   return CSSParserToken(kDelimiterToken, cc);
 }
 
+CSSParserToken CSSTokenizer::NextTokenFromSheet() {
+  // The last token is always EOF, which is returned repeatedly like the
+  // regular tokenizer does once the input is exhausted.
+  const wtf_size_t index = tokenized_sheet_index_;
+  if (index + 1 < tokenized_sheet_->tokens_.size())
+    ++tokenized_sheet_index_;
+  const wtf_size_t end_offset = tokenized_sheet_->end_offsets_[index];
+  if (end_offset > input_.Offset())
+    input_.Advance(end_offset - input_.Offset());
+  ++token_count_;
+  return tokenized_sheet_->tokens_[index];
+}
+
 // This method merges the following spec sections for efficiency
 // http://www.w3.org/TR/css3-syntax/#consume-a-number
 // http://www.w3.org/TR/css3-syntax/#convert-a-string-to-a-number
@@ -18,6 +18,7 @@
 
 namespace blink {
 
+class CSSTokenizedSheet;
 class CSSTokenizerInputStream;
 
 class CORE_EXPORT CSSTokenizer {
@@ -25,6 +26,9 @@ class CORE_EXPORT CSSTokenizer {
 
  public:
   CSSTokenizer(const String&, wtf_size_t offset = 0);
+  // Replays the tokens of |sheet| rather than tokenizing its text. |sheet|
+  // must outlive the tokenizer and any tokens it returns.
+  explicit CSSTokenizer(const CSSTokenizedSheet& sheet);
 
   Vector<CSSParserToken, 32> TokenizeToEOF();
   wtf_size_t TokenCount();
@@ -37,6 +41,7 @@ class CORE_EXPORT CSSTokenizer {
   CSSParserToken TokenizeSingleWithComments();
 
   CSSParserToken NextToken();
+  CSSParserToken NextTokenFromSheet();
 
   UChar Consume();
   void Reconsume(UChar);
@@ -107,7 +112,12 @@ class CORE_EXPORT CSSTokenizer {
   // We only allocate strings when escapes are used.
   Vector<String> string_pool_;
 
+  // Set when replaying a CSSTokenizedSheet.
+  const CSSTokenizedSheet* tokenized_sheet_ = nullptr;
+  wtf_size_t tokenized_sheet_index_ = 0;
+
   friend class CSSParserTokenStream;
+  friend class CSSTokenizedSheet;
 
   wtf_size_t prev_offset_ = 0;
   wtf_size_t token_count_ = 0;
@@ -85,13 +85,41 @@ RuleData::RuleData(StyleRule* rule,
       has_document_security_origin_(add_rule_flags &
                                     kRuleHasDocumentSecurityOrigin),
       property_whitelist_(
-          DeterminePropertyWhitelistType(add_rule_flags, Selector())),
-      descendant_selector_identifier_hashes_() {
-  SelectorFilter::CollectIdentifierHashes(
-      Selector(), descendant_selector_identifier_hashes_,
-      kMaximumIdentifierCount);
+          DeterminePropertyWhitelistType(add_rule_flags, Selector())) {}
+
+void RuleDataList::Append(const RuleData* rule_data) {
+  unsigned hashes[kMaximumIdentifierCount] = {};
+  SelectorFilter::CollectIdentifierHashes(rule_data->Selector(), hashes,
+                                          kMaximumIdentifierCount);
+  rules_.push_back(rule_data);
+  identifier_hashes_.Append(hashes, kMaximumIdentifierCount);
 }
 
+void RuleDataList::ReserveCapacity(wtf_size_t capacity) {
+  rules_.ReserveCapacity(capacity);
+  identifier_hashes_.ReserveCapacity(capacity * kMaximumIdentifierCount);
+}
+
+void RuleDataList::ShrinkToFit() {
+  rules_.ShrinkToFit();
+  identifier_hashes_.ShrinkToFit();
+}
+
+void RuleDataList::Trace(blink::Visitor* visitor) {
+  visitor->Trace(rules_);
+}
+
+RuleSet::RuleSet()
+    : link_pseudo_class_rules_(MakeGarbageCollected<RuleDataList>()),
+      cue_pseudo_rules_(MakeGarbageCollected<RuleDataList>()),
+      focus_pseudo_class_rules_(MakeGarbageCollected<RuleDataList>()),
+      spatial_navigation_interest_class_rules_(
+          MakeGarbageCollected<RuleDataList>()),
+      universal_rules_(MakeGarbageCollected<RuleDataList>()),
+      shadow_host_rules_(MakeGarbageCollected<RuleDataList>()),
+      part_pseudo_rules_(MakeGarbageCollected<RuleDataList>()),
+      rule_count_(0) {}
+
 void RuleSet::AddToRuleSet(const AtomicString& key,
                            PendingRuleMap& map,
                            const RuleData* rule_data) {
@@ -199,23 +227,23 @@ bool RuleSet::FindBestRuleSetAndAdd(const CSSSelector& component,
 
   switch (pseudo_type) {
     case CSSSelector::kPseudoCue:
-      cue_pseudo_rules_.push_back(rule_data);
+      cue_pseudo_rules_->Append(rule_data);
       return true;
     case CSSSelector::kPseudoLink:
     case CSSSelector::kPseudoVisited:
     case CSSSelector::kPseudoAnyLink:
     case CSSSelector::kPseudoWebkitAnyLink:
-      link_pseudo_class_rules_.push_back(rule_data);
+      link_pseudo_class_rules_->Append(rule_data);
       return true;
     case CSSSelector::kPseudoSpatialNavigationInterest:
-      spatial_navigation_interest_class_rules_.push_back(rule_data);
+      spatial_navigation_interest_class_rules_->Append(rule_data);
       return true;
     case CSSSelector::kPseudoFocus:
-      focus_pseudo_class_rules_.push_back(rule_data);
+      focus_pseudo_class_rules_->Append(rule_data);
       return true;
     case CSSSelector::kPseudoPlaceholder:
       if (it->FollowsPart()) {
-        part_pseudo_rules_.push_back(rule_data);
+        part_pseudo_rules_->Append(rule_data);
       } else {
         AddToRuleSet(AtomicString("-webkit-input-placeholder"),
                      EnsurePendingRules()->shadow_pseudo_element_rules,
@@ -224,11 +252,11 @@ bool RuleSet::FindBestRuleSetAndAdd(const CSSSelector& component,
       return true;
     case CSSSelector::kPseudoHost:
     case CSSSelector::kPseudoHostContext:
-      shadow_host_rules_.push_back(rule_data);
+      shadow_host_rules_->Append(rule_data);
       return true;
     case CSSSelector::kPseudoPart:
       if (RuntimeEnabledFeatures::CSSPartPseudoElementEnabled()) {
-        part_pseudo_rules_.push_back(rule_data);
+        part_pseudo_rules_->Append(rule_data);
       }
       return true;
     default:
@@ -260,7 +288,7 @@ void RuleSet::AddRule(StyleRule* rule,
   if (!FindBestRuleSetAndAdd(rule_data->Selector(), rule_data)) {
     // If we didn't find a specialized map to stick it in, file under universal
     // rules.
-    universal_rules_.push_back(rule_data);
+    universal_rules_->Append(rule_data);
   }
 }
 
@@ -369,16 +397,13 @@ void RuleSet::CompactPendingRules(PendingRuleMap& pending_map,
   for (auto& item : pending_map) {
     HeapLinkedStack<Member<const RuleData>>* pending_rules =
         item.value.Release();
-    Member<HeapVector<Member<const RuleData>>>& rules =
+    Member<RuleDataList>& rules =
         compact_map.insert(item.key, nullptr).stored_value->value;
-    if (!rules) {
-      rules = MakeGarbageCollected<HeapVector<Member<const RuleData>>>();
-      rules->ReserveInitialCapacity(pending_rules->size());
-    } else {
-      rules->ReserveCapacity(pending_rules->size());
-    }
+    if (!rules)
+      rules = MakeGarbageCollected<RuleDataList>();
+    rules->ReserveCapacity(rules->size() + pending_rules->size());
     while (!pending_rules->IsEmpty()) {
-      rules->push_back(pending_rules->Peek());
+      rules->Append(pending_rules->Peek());
       pending_rules->Pop();
     }
   }
@@ -392,18 +417,18 @@ void RuleSet::CompactRules() {
   CompactPendingRules(pending_rules->tag_rules, tag_rules_);
   CompactPendingRules(pending_rules->shadow_pseudo_element_rules,
                       shadow_pseudo_element_rules_);
-  link_pseudo_class_rules_.ShrinkToFit();
-  cue_pseudo_rules_.ShrinkToFit();
-  focus_pseudo_class_rules_.ShrinkToFit();
-  spatial_navigation_interest_class_rules_.ShrinkToFit();
-  universal_rules_.ShrinkToFit();
-  shadow_host_rules_.ShrinkToFit();
+  link_pseudo_class_rules_->ShrinkToFit();
+  cue_pseudo_rules_->ShrinkToFit();
+  focus_pseudo_class_rules_->ShrinkToFit();
+  spatial_navigation_interest_class_rules_->ShrinkToFit();
+  universal_rules_->ShrinkToFit();
+  shadow_host_rules_->ShrinkToFit();
   page_rules_.ShrinkToFit();
   font_face_rules_.ShrinkToFit();
   font_feature_values_rules_.ShrinkToFit();
   keyframes_rules_.ShrinkToFit();
   deep_combinator_or_shadow_pseudo_rules_.ShrinkToFit();
-  part_pseudo_rules_.ShrinkToFit();
+  part_pseudo_rules_->ShrinkToFit();
   content_pseudo_element_rules_.ShrinkToFit();
   slotted_pseudo_element_rules_.ShrinkToFit();
 }
@@ -33,6 +33,7 @@
 #include "third_party/blink/renderer/platform/heap/heap_linked_stack.h"
 #include "third_party/blink/renderer/platform/wtf/forward.h"
 #include "third_party/blink/renderer/platform/wtf/hash_map.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
 
 namespace blink {
 
@@ -110,13 +111,6 @@ class CORE_EXPORT RuleData : public GarbageCollected<RuleData> {
                ? kPropertyWhitelistNone
                : static_cast<PropertyWhitelistType>(property_whitelist_);
   }
-  // Try to balance between memory usage (there can be lots of RuleData objects)
-  // and good filtering performance.
-  static const unsigned kMaximumIdentifierCount = 4;
-  const unsigned* DescendantSelectorIdentifierHashes() const {
-    return descendant_selector_identifier_hashes_;
-  }
-
   void Trace(blink::Visitor*);
 
   // This number is picked fairly arbitrary. If lowered, be aware that there
@@ -140,8 +134,6 @@ class CORE_EXPORT RuleData : public GarbageCollected<RuleData> {
   unsigned has_document_security_origin_ : 1;
   unsigned property_whitelist_ : 2;
   // 29 bits above
-  // Use plain array instead of a Vector to minimize memory overhead.
-  unsigned descendant_selector_identifier_hashes_[kMaximumIdentifierCount];
 };
 
 }  // namespace blink
@@ -155,12 +147,57 @@ struct SameSizeAsRuleData {
   Member<void*> a;
   unsigned b;
   unsigned c;
-  unsigned d[4];
 };
 
 static_assert(sizeof(RuleData) == sizeof(SameSizeAsRuleData),
               "RuleData should stay small");
 
+// The RuleData of one RuleSet bucket, in matching order.
+//
+// Next to the rules, the list keeps the descendant selector identifier hashes
+// of every rule packed back to back in a single array. This lets
+// ElementRuleCollector fast reject whole runs of candidates against the
+// SelectorFilter by streaming through that array, without loading the
+// RuleData, StyleRule or CSSSelector of the rules it rejects.
+class CORE_EXPORT RuleDataList final
+    : public GarbageCollectedFinalized<RuleDataList> {
+ public:
+  using const_iterator = HeapVector<Member<const RuleData>>::const_iterator;
+
+  // Try to balance between memory usage (there can be lots of rules) and good
+  // filtering performance.
+  static const unsigned kMaximumIdentifierCount = 4;
+
+  RuleDataList() = default;
+
+  void Append(const RuleData*);
+  void ReserveCapacity(wtf_size_t);
+  void ShrinkToFit();
+
+  wtf_size_t size() const { return rules_.size(); }
+  bool IsEmpty() const { return rules_.IsEmpty(); }
+  const RuleData* at(wtf_size_t index) const { return rules_[index]; }
+  const RuleData* operator[](wtf_size_t index) const { return at(index); }
+  const_iterator begin() const { return rules_.begin(); }
+  const_iterator end() const { return rules_.end(); }
+
+  // The kMaximumIdentifierCount hashes of the rule at |index|, zero
+  // terminated if there are fewer. The hashes of the following rules come
+  // directly after them.
+  const unsigned* IdentifierHashesAt(wtf_size_t index) const {
+    DCHECK_LT(index, size());
+    return identifier_hashes_.data() + index * kMaximumIdentifierCount;
+  }
+
+  void Trace(blink::Visitor*);
+
+ private:
+  HeapVector<Member<const RuleData>> rules_;
+  Vector<unsigned> identifier_hashes_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuleDataList);
+};
+
 // Holds RuleData objects. It partitions them into various indexed groups,
 // e.g. it stores separately rules that match against id, class, tag, shadow
 // host, etc. It indexes these by some key where possible, e.g. rules that match
@@ -172,7 +209,7 @@ class CORE_EXPORT RuleSet : public GarbageCollectedFinalized<RuleSet> {
  public:
   static RuleSet* Create() { return MakeGarbageCollected<RuleSet>(); }
 
-  RuleSet() : rule_count_(0) {}
+  RuleSet();
 
   void AddRulesFromSheet(StyleSheetContents*,
                          const MediaQueryEvaluator&,
@@ -182,54 +219,49 @@ class CORE_EXPORT RuleSet : public GarbageCollectedFinalized<RuleSet> {
 
   const RuleFeatureSet& Features() const { return features_; }
 
-  const HeapVector<Member<const RuleData>>* IdRules(
-      const AtomicString& key) const {
+  const RuleDataList* IdRules(const AtomicString& key) const {
     DCHECK(!pending_rules_);
     return id_rules_.at(key);
   }
-  const HeapVector<Member<const RuleData>>* ClassRules(
-      const AtomicString& key) const {
+  const RuleDataList* ClassRules(const AtomicString& key) const {
     DCHECK(!pending_rules_);
     return class_rules_.at(key);
   }
-  const HeapVector<Member<const RuleData>>* TagRules(
-      const AtomicString& key) const {
+  const RuleDataList* TagRules(const AtomicString& key) const {
     DCHECK(!pending_rules_);
     return tag_rules_.at(key);
   }
-  const HeapVector<Member<const RuleData>>* ShadowPseudoElementRules(
-      const AtomicString& key) const {
+  const RuleDataList* ShadowPseudoElementRules(const AtomicString& key) const {
     DCHECK(!pending_rules_);
     return shadow_pseudo_element_rules_.at(key);
   }
-  const HeapVector<Member<const RuleData>>* LinkPseudoClassRules() const {
+  const RuleDataList* LinkPseudoClassRules() const {
     DCHECK(!pending_rules_);
-    return &link_pseudo_class_rules_;
+    return link_pseudo_class_rules_;
   }
-  const HeapVector<Member<const RuleData>>* CuePseudoRules() const {
+  const RuleDataList* CuePseudoRules() const {
     DCHECK(!pending_rules_);
-    return &cue_pseudo_rules_;
+    return cue_pseudo_rules_;
   }
-  const HeapVector<Member<const RuleData>>* FocusPseudoClassRules() const {
+  const RuleDataList* FocusPseudoClassRules() const {
     DCHECK(!pending_rules_);
-    return &focus_pseudo_class_rules_;
+    return focus_pseudo_class_rules_;
   }
-  const HeapVector<Member<const RuleData>>*
-  SpatialNavigationInterestPseudoClassRules() const {
+  const RuleDataList* SpatialNavigationInterestPseudoClassRules() const {
     DCHECK(!pending_rules_);
-    return &spatial_navigation_interest_class_rules_;
+    return spatial_navigation_interest_class_rules_;
   }
-  const HeapVector<Member<const RuleData>>* UniversalRules() const {
+  const RuleDataList* UniversalRules() const {
     DCHECK(!pending_rules_);
-    return &universal_rules_;
+    return universal_rules_;
   }
-  const HeapVector<Member<const RuleData>>* ShadowHostRules() const {
+  const RuleDataList* ShadowHostRules() const {
     DCHECK(!pending_rules_);
-    return &shadow_host_rules_;
+    return shadow_host_rules_;
   }
-  const HeapVector<Member<const RuleData>>* PartPseudoRules() const {
+  const RuleDataList* PartPseudoRules() const {
     DCHECK(!pending_rules_);
-    return &part_pseudo_rules_;
+    return part_pseudo_rules_;
   }
   const HeapVector<Member<StyleRulePage>>& PageRules() const {
     DCHECK(!pending_rules_);
@@ -287,8 +319,7 @@ class CORE_EXPORT RuleSet : public GarbageCollectedFinalized<RuleSet> {
   using PendingRuleMap =
       HeapHashMap<AtomicString,
                   Member<HeapLinkedStack<Member<const RuleData>>>>;
-  using CompactRuleMap =
-      HeapHashMap<AtomicString, Member<HeapVector<Member<const RuleData>>>>;
+  using CompactRuleMap = HeapHashMap<AtomicString, Member<RuleDataList>>;
 
   void AddToRuleSet(const AtomicString& key, PendingRuleMap&, const RuleData*);
   void AddPageRule(StyleRulePage*);
@@ -331,13 +362,13 @@ class CORE_EXPORT RuleSet : public GarbageCollectedFinalized<RuleSet> {
   CompactRuleMap class_rules_;
   CompactRuleMap tag_rules_;
   CompactRuleMap shadow_pseudo_element_rules_;
-  HeapVector<Member<const RuleData>> link_pseudo_class_rules_;
-  HeapVector<Member<const RuleData>> cue_pseudo_rules_;
-  HeapVector<Member<const RuleData>> focus_pseudo_class_rules_;
-  HeapVector<Member<const RuleData>> spatial_navigation_interest_class_rules_;
-  HeapVector<Member<const RuleData>> universal_rules_;
-  HeapVector<Member<const RuleData>> shadow_host_rules_;
-  HeapVector<Member<const RuleData>> part_pseudo_rules_;
+  Member<RuleDataList> link_pseudo_class_rules_;
+  Member<RuleDataList> cue_pseudo_rules_;
+  Member<RuleDataList> focus_pseudo_class_rules_;
+  Member<RuleDataList> spatial_navigation_interest_class_rules_;
+  Member<RuleDataList> universal_rules_;
+  Member<RuleDataList> shadow_host_rules_;
+  Member<RuleDataList> part_pseudo_rules_;
   RuleFeatureSet features_;
   HeapVector<Member<StyleRulePage>> page_rules_;
   HeapVector<Member<StyleRuleFontFace>> font_face_rules_;
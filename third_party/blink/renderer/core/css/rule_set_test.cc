@@ -31,6 +31,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/blink/renderer/core/css/css_test_helpers.h"
+#include "third_party/blink/renderer/core/css/selector_filter.h"
 #include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
 
 namespace blink {
@@ -43,7 +44,7 @@ StyleRule* CreateDummyStyleRule() {
   TestStyleSheet sheet;
   sheet.AddCSSRules("#id { color: tomato; }");
   const RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.IdRules("id");
+  const RuleDataList* rules = rule_set.IdRules("id");
   DCHECK_EQ(1u, rules->size());
   return rules->at(0)->Rule();
 }
@@ -56,7 +57,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_CustomPseudoElements) {
   sheet.AddCSSRules("summary::-webkit-details-marker { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("-webkit-details-marker");
-  const HeapVector<Member<const RuleData>>* rules =
+  const RuleDataList* rules =
       rule_set.ShadowPseudoElementRules(str);
   ASSERT_EQ(1u, rules->size());
   ASSERT_EQ(str, rules->at(0)->Selector().Value());
@@ -68,7 +69,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_Id) {
   sheet.AddCSSRules("#id { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("id");
-  const HeapVector<Member<const RuleData>>* rules = rule_set.IdRules(str);
+  const RuleDataList* rules = rule_set.IdRules(str);
   ASSERT_EQ(1u, rules->size());
   ASSERT_EQ(str, rules->at(0)->Selector().Value());
 }
@@ -79,7 +80,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_NthChild) {
   sheet.AddCSSRules("div:nth-child(2) { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("div");
-  const HeapVector<Member<const RuleData>>* rules = rule_set.TagRules(str);
+  const RuleDataList* rules = rule_set.TagRules(str);
   ASSERT_EQ(1u, rules->size());
   ASSERT_EQ(str, rules->at(0)->Selector().TagQName().LocalName());
 }
@@ -91,7 +92,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_ClassThenId) {
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("id");
   // id is prefered over class even if class preceeds it in the selector.
-  const HeapVector<Member<const RuleData>>* rules = rule_set.IdRules(str);
+  const RuleDataList* rules = rule_set.IdRules(str);
   ASSERT_EQ(1u, rules->size());
   AtomicString class_str("class");
   ASSERT_EQ(class_str, rules->at(0)->Selector().Value());
@@ -103,7 +104,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_IdThenClass) {
   sheet.AddCSSRules("#id.class { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("id");
-  const HeapVector<Member<const RuleData>>* rules = rule_set.IdRules(str);
+  const RuleDataList* rules = rule_set.IdRules(str);
   ASSERT_EQ(1u, rules->size());
   ASSERT_EQ(str, rules->at(0)->Selector().Value());
 }
@@ -114,7 +115,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_AttrThenId) {
   sheet.AddCSSRules("[attr]#id { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("id");
-  const HeapVector<Member<const RuleData>>* rules = rule_set.IdRules(str);
+  const RuleDataList* rules = rule_set.IdRules(str);
   ASSERT_EQ(1u, rules->size());
   AtomicString attr_str("attr");
   ASSERT_EQ(attr_str, rules->at(0)->Selector().Attribute().LocalName());
@@ -126,7 +127,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_TagThenAttrThenId) {
   sheet.AddCSSRules("div[attr]#id { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("id");
-  const HeapVector<Member<const RuleData>>* rules = rule_set.IdRules(str);
+  const RuleDataList* rules = rule_set.IdRules(str);
   ASSERT_EQ(1u, rules->size());
   AtomicString tag_str("div");
   ASSERT_EQ(tag_str, rules->at(0)->Selector().TagQName().LocalName());
@@ -138,7 +139,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_DivWithContent) {
   sheet.AddCSSRules("div::content { }");
   RuleSet& rule_set = sheet.GetRuleSet();
   AtomicString str("div");
-  const HeapVector<Member<const RuleData>>* rules = rule_set.TagRules(str);
+  const RuleDataList* rules = rule_set.TagRules(str);
   ASSERT_EQ(1u, rules->size());
   AtomicString value_str("content");
   ASSERT_EQ(value_str, rules->at(0)->Selector().TagHistory()->Value());
@@ -149,7 +150,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_Host) {
 
   sheet.AddCSSRules(":host { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.ShadowHostRules();
+  const RuleDataList* rules = rule_set.ShadowHostRules();
   ASSERT_EQ(1u, rules->size());
 }
 
@@ -158,7 +159,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostWithId) {
 
   sheet.AddCSSRules(":host(#x) { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.ShadowHostRules();
+  const RuleDataList* rules = rule_set.ShadowHostRules();
   ASSERT_EQ(1u, rules->size());
 }
 
@@ -167,7 +168,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostContext) {
 
   sheet.AddCSSRules(":host-context(*) { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.ShadowHostRules();
+  const RuleDataList* rules = rule_set.ShadowHostRules();
   ASSERT_EQ(1u, rules->size());
 }
 
@@ -176,7 +177,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostContextWithId) {
 
   sheet.AddCSSRules(":host-context(#x) { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.ShadowHostRules();
+  const RuleDataList* rules = rule_set.ShadowHostRules();
   ASSERT_EQ(1u, rules->size());
 }
 
@@ -185,11 +186,9 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostAndHostContextNotInRightmost) {
 
   sheet.AddCSSRules(":host-context(#x) .y, :host(.a) > #b  { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* shadow_rules =
-      rule_set.ShadowHostRules();
-  const HeapVector<Member<const RuleData>>* id_rules = rule_set.IdRules("b");
-  const HeapVector<Member<const RuleData>>* class_rules =
-      rule_set.ClassRules("y");
+  const RuleDataList* shadow_rules = rule_set.ShadowHostRules();
+  const RuleDataList* id_rules = rule_set.IdRules("b");
+  const RuleDataList* class_rules = rule_set.ClassRules("y");
   ASSERT_EQ(0u, shadow_rules->size());
   ASSERT_EQ(1u, id_rules->size());
   ASSERT_EQ(1u, class_rules->size());
@@ -200,7 +199,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostAndClass) {
 
   sheet.AddCSSRules(".foo:host { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.ShadowHostRules();
+  const RuleDataList* rules = rule_set.ShadowHostRules();
   ASSERT_EQ(0u, rules->size());
 }
 
@@ -209,7 +208,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_HostContextAndClass) {
 
   sheet.AddCSSRules(".foo:host-context(*) { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.ShadowHostRules();
+  const RuleDataList* rules = rule_set.ShadowHostRules();
   ASSERT_EQ(0u, rules->size());
 }
 
@@ -219,7 +218,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_Focus) {
   sheet.AddCSSRules(":focus { }");
   sheet.AddCSSRules("[attr]:focus { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules =
+  const RuleDataList* rules =
       rule_set.FocusPseudoClassRules();
   ASSERT_EQ(2u, rules->size());
 }
@@ -234,7 +233,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_LinkVisited) {
   sheet.AddCSSRules(":-webkit-any-link { }");
   sheet.AddCSSRules("[attr]:-webkit-any-link { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules =
+  const RuleDataList* rules =
       rule_set.LinkPseudoClassRules();
   ASSERT_EQ(6u, rules->size());
 }
@@ -245,7 +244,7 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_Cue) {
   sheet.AddCSSRules("::cue(b) { }");
   sheet.AddCSSRules("video::cue(u) { }");
   RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.CuePseudoRules();
+  const RuleDataList* rules = rule_set.CuePseudoRules();
   ASSERT_EQ(2u, rules->size());
 }
 
@@ -266,19 +265,19 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_PseudoIs) {
   RuleSet& rule_set = sheet.GetRuleSet();
   {
     AtomicString str("c");
-    const HeapVector<Member<const RuleData>>* rules = rule_set.ClassRules(str);
+    const RuleDataList* rules = rule_set.ClassRules(str);
     ASSERT_EQ(1u, rules->size());
     ASSERT_EQ(str, rules->at(0)->Selector().Value());
   }
   {
     AtomicString str("e");
-    const HeapVector<Member<const RuleData>>* rules = rule_set.ClassRules(str);
+    const RuleDataList* rules = rule_set.ClassRules(str);
     ASSERT_EQ(1u, rules->size());
     ASSERT_EQ(str, rules->at(0)->Selector().Value());
   }
   {
     AtomicString str("f");
-    const HeapVector<Member<const RuleData>>* rules = rule_set.ClassRules(str);
+    const RuleDataList* rules = rule_set.ClassRules(str);
     ASSERT_EQ(1u, rules->size());
     ASSERT_EQ(str, rules->at(0)->Selector().Value());
   }
@@ -291,19 +290,19 @@ TEST(RuleSetTest, findBestRuleSetAndAdd_PseudoWhere) {
   RuleSet& rule_set = sheet.GetRuleSet();
   {
     AtomicString str("c");
-    const HeapVector<Member<const RuleData>>* rules = rule_set.ClassRules(str);
+    const RuleDataList* rules = rule_set.ClassRules(str);
     ASSERT_EQ(1u, rules->size());
     ASSERT_EQ(str, rules->at(0)->Selector().Value());
   }
   {
     AtomicString str("e");
-    const HeapVector<Member<const RuleData>>* rules = rule_set.ClassRules(str);
+    const RuleDataList* rules = rule_set.ClassRules(str);
     ASSERT_EQ(1u, rules->size());
     ASSERT_EQ(str, rules->at(0)->Selector().Value());
   }
   {
     AtomicString str("f");
-    const HeapVector<Member<const RuleData>>* rules = rule_set.ClassRules(str);
+    const RuleDataList* rules = rule_set.ClassRules(str);
     ASSERT_EQ(1u, rules->size());
     ASSERT_EQ(str, rules->at(0)->Selector().Value());
   }
@@ -363,12 +362,32 @@ TEST(RuleSetTest, SelectorIndexLimit) {
   TestStyleSheet sheet;
   sheet.AddCSSRules(builder.ToString().Ascii().data());
   const RuleSet& rule_set = sheet.GetRuleSet();
-  const HeapVector<Member<const RuleData>>* rules = rule_set.TagRules("b");
+  const RuleDataList* rules = rule_set.TagRules("b");
   ASSERT_EQ(1u, rules->size());
   EXPECT_EQ("b", rules->at(0)->Selector().TagQName().LocalName());
   EXPECT_FALSE(rule_set.TagRules("span"));
 }
 
+TEST(RuleSetTest, RuleDataListPacksIdentifierHashes) {
+  TestStyleSheet sheet;
+
+  sheet.AddCSSRules(".a .x { } #b > div .x { } .x { } .c .d .e .f .g .x { }");
+  RuleSet& rule_set = sheet.GetRuleSet();
+  const RuleDataList* rules = rule_set.ClassRules("x");
+  ASSERT_EQ(4u, rules->size());
+  for (wtf_size_t i = 0; i < rules->size(); ++i) {
+    unsigned expected[RuleDataList::kMaximumIdentifierCount] = {};
+    SelectorFilter::CollectIdentifierHashes(
+        rules->at(i)->Selector(), expected,
+        RuleDataList::kMaximumIdentifierCount);
+    const unsigned* actual = rules->IdentifierHashesAt(i);
+    for (unsigned j = 0; j < RuleDataList::kMaximumIdentifierCount; ++j)
+      EXPECT_EQ(expected[j], actual[j]);
+  }
+  // A rule without ancestor identifiers can never be fast rejected.
+  EXPECT_EQ(0u, rules->IdentifierHashesAt(2)[0]);
+}
+
 TEST(RuleSetTest, RuleDataSelectorIndexLimit) {
   StyleRule* rule = CreateDummyStyleRule();
   AddRuleFlags flags = kRuleHasNoSpecialState;
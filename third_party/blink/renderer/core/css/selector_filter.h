@@ -31,6 +31,8 @@
 #ifndef THIRD_PARTY_BLINK_RENDERER_CORE_CSS_SELECTOR_FILTER_H_
 #define THIRD_PARTY_BLINK_RENDERER_CORE_CSS_SELECTOR_FILTER_H_
 
+#include <stdint.h>
+
 #include <memory>
 
 #include "base/macros.h"
@@ -71,6 +73,14 @@ class CORE_EXPORT SelectorFilter {
 
   template <unsigned maximumIdentifierCount>
   inline bool FastRejectSelector(const unsigned* identifier_hashes) const;
+  // Like FastRejectSelector(), for |count| selectors whose hashes are packed
+  // back to back, maximumIdentifierCount per selector. Bit n of the result is
+  // set if selector n can be rejected. |count| must be at most
+  // kMaximumFastRejectBatchSize.
+  static constexpr unsigned kMaximumFastRejectBatchSize = 64;
+  template <unsigned maximumIdentifierCount>
+  inline uint64_t FastRejectSelectors(const unsigned* identifier_hashes,
+                                      unsigned count) const;
   static void CollectIdentifierHashes(const CSSSelector&,
                                       unsigned* identifier_hashes,
                                       unsigned maximum_identifier_count);
@@ -102,6 +112,20 @@ inline bool SelectorFilter::FastRejectSelector(
   return false;
 }
 
+template <unsigned maximumIdentifierCount>
+inline uint64_t SelectorFilter::FastRejectSelectors(
+    const unsigned* identifier_hashes,
+    unsigned count) const {
+  DCHECK_LE(count, kMaximumFastRejectBatchSize);
+  uint64_t rejected = 0;
+  for (unsigned i = 0; i < count; ++i) {
+    if (FastRejectSelector<maximumIdentifierCount>(identifier_hashes))
+      rejected |= uint64_t{1} << i;
+    identifier_hashes += maximumIdentifierCount;
+  }
+  return rejected;
+}
+
 }  // namespace blink
 
 WTF_ALLOW_INIT_WITH_MEM_FUNCTIONS(blink::SelectorFilter::ParentStackFrame)
@@ -325,22 +325,28 @@ const AtomicString& StyleSheetContents::NamespaceURIFromPrefix(
   return namespaces_.at(prefix);
 }
 
+// static
+String StyleSheetContents::AuthorStyleSheetText(
+    const CSSStyleSheetResource* cached_style_sheet,
+    const CSSParserContext* context) {
+  const ResourceResponse& response = cached_style_sheet->GetResponse();
+  CSSStyleSheetResource::MIMETypeCheck mime_type_check =
+      (IsQuirksModeBehavior(context->Mode()) && response.IsCorsSameOrigin())
+          ? CSSStyleSheetResource::MIMETypeCheck::kLax
+          : CSSStyleSheetResource::MIMETypeCheck::kStrict;
+  return cached_style_sheet->SheetText(context, mime_type_check);
+}
+
 void StyleSheetContents::ParseAuthorStyleSheet(
     const CSSStyleSheetResource* cached_style_sheet,
-    const SecurityOrigin* security_origin) {
+    const SecurityOrigin* security_origin,
+    const String& sheet_text,
+    const CSSTokenizedSheet* tokenized_sheet) {
   TRACE_EVENT1(
       "blink,devtools.timeline", "ParseAuthorStyleSheet", "data",
       inspector_parse_author_style_sheet_event::Data(cached_style_sheet));
 
   const ResourceResponse& response = cached_style_sheet->GetResponse();
-  CSSStyleSheetResource::MIMETypeCheck mime_type_check =
-      (IsQuirksModeBehavior(parser_context_->Mode()) &&
-       response.IsCorsSameOrigin())
-          ? CSSStyleSheetResource::MIMETypeCheck::kLax
-          : CSSStyleSheetResource::MIMETypeCheck::kStrict;
-  String sheet_text =
-      cached_style_sheet->SheetText(parser_context_, mime_type_check);
-
   source_map_url_ = response.HttpHeaderField(http_names::kSourceMap);
   if (source_map_url_.IsEmpty()) {
     // Try to get deprecated header.
@@ -349,8 +355,17 @@ void StyleSheetContents::ParseAuthorStyleSheet(
 
   const CSSParserContext* context =
       CSSParserContext::CreateWithStyleSheetContents(ParserContext(), this);
-  CSSParser::ParseSheet(context, this, sheet_text,
-                        CSSDeferPropertyParsing::kYes);
+  if (tokenized_sheet) {
+    CSSParser::ParseTokenizedSheet(context, this, *tokenized_sheet,
+                                   CSSDeferPropertyParsing::kYes);
+    return;
+  }
+  CSSParser::ParseSheet(
+      context, this,
+      sheet_text.IsNull()
+          ? AuthorStyleSheetText(cached_style_sheet, parser_context_)
+          : sheet_text,
+      CSSDeferPropertyParsing::kYes);
 }
 
 ParseSheetResult StyleSheetContents::ParseString(const String& sheet_text,
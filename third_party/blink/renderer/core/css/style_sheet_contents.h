@@ -37,6 +37,7 @@ namespace blink {
 
 class CSSStyleSheet;
 class CSSStyleSheetResource;
+class CSSTokenizedSheet;
 class Document;
 class Node;
 class SecurityOrigin;
@@ -78,8 +79,20 @@ class CORE_EXPORT StyleSheetContents
   const AtomicString& DefaultNamespace() const { return default_namespace_; }
   const AtomicString& NamespaceURIFromPrefix(const AtomicString& prefix) const;
 
-  void ParseAuthorStyleSheet(const CSSStyleSheetResource*,
-                             const SecurityOrigin*);
+  // Returns the text of |cached_style_sheet| to be parsed with |context|, or
+  // a null string if the response's MIME type does not allow its use.
+  static String AuthorStyleSheetText(
+      const CSSStyleSheetResource* cached_style_sheet,
+      const CSSParserContext* context);
+
+  // |sheet_text| is AuthorStyleSheetText() for this sheet if the caller
+  // already has it, and a null string otherwise. If |tokenized_sheet| is
+  // given, it must hold the tokens of that text, and is parsed instead of it.
+  void ParseAuthorStyleSheet(
+      const CSSStyleSheetResource*,
+      const SecurityOrigin*,
+      const String& sheet_text = String(),
+      const CSSTokenizedSheet* tokenized_sheet = nullptr);
   ParseSheetResult ParseString(const String&, bool allow_import_rules = true);
   ParseSheetResult ParseStringAtPosition(const String&,
                                          const TextPosition&,
@@ -0,0 +1,25 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/core/css/parser/css_tokenizer.h"
+#include "third_party/blink/renderer/core/css/threaded/multi_threaded_test_util.h"
+
+namespace blink {
+
+class CSSTokenizedSheetThreadedTest : public MultiThreadedTest {};
+
+TSAN_TEST_F(CSSTokenizedSheetThreadedTest, Tokenize) {
+  RunOnThreads([]() {
+    String text("#\\66oo .bar { content: \"\\41 b\"; width: calc(1px + 2%) }");
+    std::unique_ptr<CSSTokenizedSheet> tokenized =
+        CSSTokenizedSheet::Tokenize(text);
+    CSSTokenizer tokenizer(text);
+    EXPECT_EQ(tokenizer.TokenizeToEOF().size() + 1, tokenized->TokenCount());
+  });
+}
+
+}  // namespace blink
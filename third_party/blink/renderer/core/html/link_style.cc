@@ -5,11 +5,13 @@
 #include "third_party/blink/renderer/core/html/link_style.h"
 
 #include "services/network/public/mojom/referrer_policy.mojom-shared.h"
+#include "third_party/blink/renderer/core/css/parser/css_tokenized_sheet.h"
 #include "third_party/blink/renderer/core/css/style_sheet_contents.h"
 #include "third_party/blink/renderer/core/dom/document.h"
 #include "third_party/blink/renderer/core/frame/csp/content_security_policy.h"
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/frame/local_frame_client.h"
+#include "third_party/blink/renderer/core/frame/settings.h"
 #include "third_party/blink/renderer/core/html/cross_origin_attribute.h"
 #include "third_party/blink/renderer/core/html/html_link_element.h"
 #include "third_party/blink/renderer/core/html_names.h"
@@ -17,11 +19,15 @@
 #include "third_party/blink/renderer/core/loader/link_load_parameters.h"
 #include "third_party/blink/renderer/core/loader/resource/css_style_sheet_resource.h"
 #include "third_party/blink/renderer/core/loader/subresource_integrity_helper.h"
+#include "third_party/blink/renderer/platform/cross_thread_functional.h"
 #include "third_party/blink/renderer/platform/histogram.h"
+#include "third_party/blink/renderer/platform/instrumentation/tracing/trace_event.h"
 #include "third_party/blink/renderer/platform/loader/fetch/fetch_parameters.h"
 #include "third_party/blink/renderer/platform/loader/subresource_integrity.h"
 #include "third_party/blink/renderer/platform/network/mime/content_type.h"
 #include "third_party/blink/renderer/platform/network/mime/mime_type_registry.h"
+#include "third_party/blink/renderer/platform/scheduler/public/post_cross_thread_task.h"
+#include "third_party/blink/renderer/platform/scheduler/public/worker_pool.h"
 #include "third_party/blink/renderer/platform/weborigin/kurl.h"
 #include "third_party/blink/renderer/platform/weborigin/security_policy.h"
 #include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
@@ -110,6 +116,92 @@ void LinkStyle::NotifyFinished(Resource* resource) {
     return;
   }
 
+  // Decoded at most once, and only if it has to be measured.
+  String sheet_text;
+  if (ShouldTokenizeOffMainThread(cached_style_sheet, parser_context,
+                                  &sheet_text)) {
+    return;
+  }
+
+  ParseAndSetSheet(cached_style_sheet, parser_context, sheet_text, nullptr);
+}
+
+bool LinkStyle::ShouldTokenizeOffMainThread(
+    CSSStyleSheetResource* cached_style_sheet,
+    CSSParserContext* parser_context,
+    String* sheet_text_out) {
+  Settings* settings = GetDocument().GetSettings();
+  if (!settings || !settings->GetOffMainThreadCSSTokenizationEnabled())
+    return false;
+
+  String sheet_text = StyleSheetContents::AuthorStyleSheetText(
+      cached_style_sheet, parser_context);
+  if (sheet_text.length() < kMinimumSheetLengthForOffMainThreadTokenization) {
+    *sheet_text_out = sheet_text;
+    return false;
+  }
+
+  // The sheet stays pending, and so keeps blocking rendering if it was
+  // blocking, until DidTokenizeSheet() parses it. Only the tokenization moves
+  // off the main thread: rules are garbage collected objects that have to be
+  // created on the main thread heap.
+  pending_parser_context_ = parser_context;
+  ++tokenization_request_id_;
+  worker_pool::PostTask(
+      FROM_HERE,
+      CrossThreadBind(&LinkStyle::TokenizeSheetOnWorker, sheet_text,
+                      GetDocument().GetTaskRunner(TaskType::kNetworking),
+                      WrapCrossThreadWeakPersistent(this),
+                      tokenization_request_id_));
+  return true;
+}
+
+// static
+void LinkStyle::TokenizeSheetOnWorker(
+    const String& sheet_text,
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    CrossThreadWeakPersistent<LinkStyle> link_style,
+    unsigned request_id) {
+  TRACE_EVENT1("blink,blink_style", "LinkStyle::TokenizeSheetOnWorker",
+               "length", sheet_text.length());
+  // |sheet_text| stays referenced by this task's bound arguments, which are
+  // destroyed on this thread after the sheet is posted. The sheet gets its own
+  // copy, so that the main thread is the only one to reference its text.
+  std::unique_ptr<CSSTokenizedSheet> tokenized_sheet =
+      CSSTokenizedSheet::Tokenize(sheet_text.IsolatedCopy());
+  PostCrossThreadTask(
+      *task_runner, FROM_HERE,
+      CrossThreadBind(&LinkStyle::DidTokenizeSheet, link_style, request_id,
+                      WTF::Passed(std::move(tokenized_sheet))));
+}
+
+void LinkStyle::DidTokenizeSheet(
+    unsigned request_id,
+    std::unique_ptr<CSSTokenizedSheet> tokenized_sheet) {
+  DCHECK(IsMainThread());
+  // A newer load may have replaced the one this sheet was tokenized for.
+  if (request_id != tokenization_request_id_ || !pending_parser_context_ ||
+      !GetResource()) {
+    return;
+  }
+  CSSParserContext* parser_context = pending_parser_context_.Release();
+
+  if (!owner_->isConnected()) {
+    loading_ = false;
+    RemovePendingSheet();
+    if (sheet_)
+      ClearSheet();
+    return;
+  }
+
+  ParseAndSetSheet(ToCSSStyleSheetResource(GetResource()), parser_context,
+                   String(), tokenized_sheet.get());
+}
+
+void LinkStyle::ParseAndSetSheet(CSSStyleSheetResource* cached_style_sheet,
+                                 CSSParserContext* parser_context,
+                                 const String& sheet_text,
+                                 const CSSTokenizedSheet* tokenized_sheet) {
   StyleSheetContents* style_sheet =
       StyleSheetContents::Create(cached_style_sheet->Url(), parser_context);
 
@@ -122,7 +214,8 @@ void LinkStyle::NotifyFinished(Resource* resource) {
     SetSheetTitle(owner_->title());
 
   style_sheet->ParseAuthorStyleSheet(cached_style_sheet,
-                                     GetDocument().GetSecurityOrigin());
+                                     GetDocument().GetSecurityOrigin(),
+                                     sheet_text, tokenized_sheet);
 
   loading_ = false;
   style_sheet->NotifyLoadedSheet(cached_style_sheet);
@@ -251,6 +344,8 @@ LinkStyle::LoadReturnValue LinkStyle::LoadStylesheetIfNeeded(
     RemovePendingSheet();
     ClearResource();
   }
+  // Drop the result of any tokenization still running for the old resource.
+  pending_parser_context_ = nullptr;
 
   if (!owner_->ShouldLoadLink())
     return kBail;
@@ -365,6 +460,7 @@ void LinkStyle::OwnerRemoved() {
 
 void LinkStyle::Trace(Visitor* visitor) {
   visitor->Trace(sheet_);
+  visitor->Trace(pending_parser_context_);
   LinkResource::Trace(visitor);
   ResourceClient::Trace(visitor);
 }
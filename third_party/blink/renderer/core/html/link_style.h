@@ -5,16 +5,22 @@
 #ifndef THIRD_PARTY_BLINK_RENDERER_CORE_HTML_LINK_STYLE_H_
 #define THIRD_PARTY_BLINK_RENDERER_CORE_HTML_LINK_STYLE_H_
 
+#include <memory>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/single_thread_task_runner.h"
 #include "third_party/blink/renderer/core/css/style_engine.h"
 #include "third_party/blink/renderer/core/dom/node.h"
 #include "third_party/blink/renderer/core/html/link_resource.h"
 #include "third_party/blink/renderer/core/loader/resource/css_style_sheet_resource.h"
+#include "third_party/blink/renderer/platform/heap/persistent.h"
 #include "third_party/blink/renderer/platform/loader/fetch/fetch_parameters.h"
 #include "third_party/blink/renderer/platform/loader/fetch/resource_client.h"
 #include "third_party/blink/renderer/platform/wtf/forward.h"
 
 namespace blink {
 
+class CSSTokenizedSheet;
 class HTMLLinkElement;
 struct LinkLoadParameters;
 
@@ -70,11 +76,38 @@ class LinkStyle final : public LinkResource, ResourceClient {
 
   enum PendingSheetType { kNone, kNonBlocking, kBlocking };
 
+  // Sheets at least this long are tokenized on a worker thread when the
+  // offMainThreadCSSTokenizationEnabled setting is on.
+  static constexpr wtf_size_t kMinimumSheetLengthForOffMainThreadTokenization =
+      64 * 1024;
+
+  // Returns true if |cached_style_sheet| is being tokenized off the main
+  // thread, in which case DidTokenizeSheet() finishes processing it.
+  // Otherwise sets |sheet_text_out| to the text of the sheet if it had to be
+  // decoded, so that it isn't decoded again.
+  bool ShouldTokenizeOffMainThread(CSSStyleSheetResource* cached_style_sheet,
+                                   CSSParserContext*,
+                                   String* sheet_text_out);
+  static void TokenizeSheetOnWorker(
+      const String& sheet_text,
+      scoped_refptr<base::SingleThreadTaskRunner>,
+      CrossThreadWeakPersistent<LinkStyle>,
+      unsigned request_id);
+  void DidTokenizeSheet(unsigned request_id,
+                        std::unique_ptr<CSSTokenizedSheet>);
+  void ParseAndSetSheet(CSSStyleSheetResource*,
+                        CSSParserContext*,
+                        const String& sheet_text,
+                        const CSSTokenizedSheet*);
+
   void ClearSheet();
   void AddPendingSheet(PendingSheetType);
   void RemovePendingSheet();
 
   Member<CSSStyleSheet> sheet_;
+  // Set while the sheet is tokenized off the main thread.
+  Member<CSSParserContext> pending_parser_context_;
+  unsigned tokenization_request_id_ = 0;
   DisabledState disabled_state_;
   PendingSheetType pending_sheet_type_;
   StyleEngineContext style_engine_context_;
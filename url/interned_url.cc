@@ -0,0 +1,164 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/interned_url.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/trace_event/memory_usage_estimator.h"
+
+namespace url {
+
+class InternedURL::Data : public base::RefCountedThreadSafe<Data> {
+ public:
+  explicit Data(const GURL& url) : url_(url), origin_(Origin::Create(url)) {}
+
+  const GURL& url() const { return url_; }
+
+  // Only meaningful if it isn't opaque: an opaque origin's nonce must not be
+  // shared by every InternedURL with this spec.
+  const Origin& origin() const { return origin_; }
+
+  size_t EstimateMemoryUsage() const {
+    return sizeof(Data) + url_.EstimateMemoryUsage() +
+           base::trace_event::EstimateMemoryUsage(origin_.scheme()) +
+           base::trace_event::EstimateMemoryUsage(origin_.host());
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<Data>;
+
+  ~Data() = default;
+
+  const GURL url_;
+  const Origin origin_;
+
+  DISALLOW_COPY_AND_ASSIGN(Data);
+};
+
+namespace {
+
+// Don't bother freeing unreferenced entries in tables smaller than this.
+constexpr size_t kMinPurgeSize = 1024;
+
+// The process-wide table of interned URLs, keyed by spec.
+//
+// The table holds a reference to every entry, so an entry that only the table
+// references can't gain a new one without going through Intern(). That makes
+// it safe to free such entries under the lock, which Intern() does each time
+// the table has doubled in size since the last time it did so. This keeps
+// Release() lock-free, at the cost of freeing unreferenced entries late.
+class InternTable {
+ public:
+  InternTable() = default;
+
+  scoped_refptr<InternedURL::Data> Intern(const GURL& url) {
+    base::AutoLock lock(lock_);
+    auto it = table_.find(url.possibly_invalid_spec());
+    if (it != table_.end())
+      return it->second;
+
+    if (table_.size() >= purge_size_)
+      PurgeUnreferenced();
+
+    auto data = base::MakeRefCounted<InternedURL::Data>(url);
+    // The key points into the spec of the interned GURL, which lives as long
+    // as the entry.
+    table_.emplace(data->url().possibly_invalid_spec(), data);
+    return data;
+  }
+
+  size_t size() {
+    base::AutoLock lock(lock_);
+    return table_.size();
+  }
+
+  size_t EstimateMemoryUsage() {
+    base::AutoLock lock(lock_);
+    size_t usage =
+        base::trace_event::EstimateHashMapMemoryUsage<Table::value_type>(
+            table_.bucket_count(), table_.size());
+    for (const auto& entry : table_)
+      usage += entry.second->EstimateMemoryUsage();
+    return usage;
+  }
+
+ private:
+  using Table = std::unordered_map<base::StringPiece,
+                                   scoped_refptr<InternedURL::Data>,
+                                   base::StringPieceHash>;
+
+  void PurgeUnreferenced() {
+    for (auto it = table_.begin(); it != table_.end();) {
+      if (it->second->HasOneRef())
+        it = table_.erase(it);
+      else
+        ++it;
+    }
+    purge_size_ = std::max(kMinPurgeSize, 2 * table_.size());
+  }
+
+  base::Lock lock_;
+  Table table_;
+  size_t purge_size_ = kMinPurgeSize;
+
+  DISALLOW_COPY_AND_ASSIGN(InternTable);
+};
+
+base::LazyInstance<InternTable>::Leaky g_intern_table =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+InternedURL::InternedURL() = default;
+
+InternedURL::InternedURL(const GURL& url) {
+  if (!url.is_empty())
+    data_ = g_intern_table.Get().Intern(url);
+}
+
+InternedURL::InternedURL(const InternedURL& other) = default;
+InternedURL::InternedURL(InternedURL&& other) noexcept = default;
+InternedURL& InternedURL::operator=(const InternedURL& other) = default;
+InternedURL& InternedURL::operator=(InternedURL&& other) noexcept = default;
+InternedURL::~InternedURL() = default;
+
+const GURL& InternedURL::url() const {
+  return data_ ? data_->url() : GURL::EmptyGURL();
+}
+
+bool InternedURL::has_opaque_origin() const {
+  return !data_ || data_->origin().opaque();
+}
+
+const Origin& InternedURL::origin() const {
+  DCHECK(!has_opaque_origin());
+  return data_->origin();
+}
+
+Origin InternedURL::CreateOrigin() const {
+  if (!data_)
+    return Origin();
+  if (data_->origin().opaque())
+    return Origin::Create(data_->url());
+  return data_->origin();
+}
+
+// static
+size_t InternedURL::GetInternedCountForTesting() {
+  return g_intern_table.Get().size();
+}
+
+// static
+size_t InternedURL::EstimateSharedMemoryUsage() {
+  return g_intern_table.Get().EstimateMemoryUsage();
+}
+
+}  // namespace url
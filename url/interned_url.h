@@ -0,0 +1,106 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef URL_INTERNED_URL_H_
+#define URL_INTERNED_URL_H_
+
+#include <stddef.h>
+
+#include <functional>
+
+#include "base/component_export.h"
+#include "base/memory/ref_counted.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace url {
+
+// An immutable, shared representation of a GURL, for classes that keep large
+// numbers of URLs that are often the same, such as history entries or cache
+// keys. Every InternedURL made from the same spec shares one refcounted copy
+// of the GURL, including its parsed components, and of its origin, so holding
+// one costs a pointer, and copying, hashing and comparing one never looks at
+// the spec.
+//
+// The shared copies live in a process-wide table and are freed some time
+// after the last InternedURL referring to them goes away. InternedURL is
+// opt-in: use GURL unless profiling shows duplicate URLs matter.
+//
+// Tuple origins are computed once per interned spec and shared: origin()
+// returns a reference to the shared one. Opaque origins (data: URLs, for
+// example) are never shared: each call to CreateOrigin() creates a fresh one,
+// exactly like url::Origin::Create(url()), so that two InternedURLs with the
+// same opaque-origin spec are never same-origin.
+//
+// InternedURLs may be created, copied and destroyed on any thread.
+class COMPONENT_EXPORT(URL) InternedURL {
+ public:
+  // The shared, immutable GURL and origin. Only used by the implementation.
+  class Data;
+
+  // Creates an empty InternedURL, whose url() is an empty GURL.
+  InternedURL();
+
+  // Interns |url|. GURLs that compare equal are interned to the same data.
+  explicit InternedURL(const GURL& url);
+
+  InternedURL(const InternedURL& other);
+  InternedURL(InternedURL&& other) noexcept;
+  InternedURL& operator=(const InternedURL& other);
+  InternedURL& operator=(InternedURL&& other) noexcept;
+  ~InternedURL();
+
+  // Returns the interned URL.
+  const GURL& url() const;
+
+  // Returns whether the origin of url() is opaque. Empty and invalid URLs
+  // have opaque origins.
+  bool has_opaque_origin() const;
+
+  // Returns the shared origin of url(), which must not be opaque.
+  const Origin& origin() const;
+
+  // Returns the origin of url(), like Origin::Create(url()). This is a copy of
+  // origin() if it is not opaque, or else a new opaque origin.
+  Origin CreateOrigin() const;
+
+  bool is_empty() const { return !data_; }
+
+  bool operator==(const InternedURL& other) const {
+    return data_ == other.data_;
+  }
+  bool operator!=(const InternedURL& other) const {
+    return data_ != other.data_;
+  }
+
+  // Returns the number of distinct URLs currently interned, including ones no
+  // longer referenced that have not been freed yet.
+  static size_t GetInternedCountForTesting();
+
+  // Estimates the dynamic memory usage of all interned URLs, which is shared
+  // by every InternedURL and so not counted by EstimateMemoryUsage().
+  // See base/trace_event/memory_usage_estimator.h for more info.
+  static size_t EstimateSharedMemoryUsage();
+
+  // Estimates dynamic memory usage.
+  // See base/trace_event/memory_usage_estimator.h for more info.
+  size_t EstimateMemoryUsage() const { return 0; }
+
+ private:
+  friend struct InternedURLHash;
+
+  scoped_refptr<Data> data_;
+};
+
+// Hashes an InternedURL by the identity of its shared data, for use in
+// unordered containers.
+struct InternedURLHash {
+  size_t operator()(const InternedURL& url) const {
+    return std::hash<const void*>()(url.data_.get());
+  }
+};
+
+}  // namespace url
+
+#endif  // URL_INTERNED_URL_H_
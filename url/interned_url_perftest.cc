@@ -0,0 +1,117 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/interned_url.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/trace_event/memory_usage_estimator.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace url {
+
+namespace {
+
+// A synthetic history working set: kNumVisits visits spread over kNumURLs
+// distinct URLs on kNumHosts hosts, each visit recording its URL and origin.
+const int kNumVisits = 500000;
+const int kNumURLs = 50000;
+const int kNumHosts = 2000;
+
+// Prime number noticeably larger than kNumURLs, so that multiplying it by an
+// incrementing index modulo kNumURLs visits the URLs in a reproducible but
+// scattered order.
+const int kRandomSeed = 1000003;
+static_assert(kRandomSeed > 10 * kNumURLs,
+              "kRandomSeed not high enough for number of URLs");
+
+GURL URLForIndex(int i) {
+  return GURL(base::StringPrintf(
+      "https://www.host%d.example.com/articles/%d/some-article-title.html"
+      "?utm_source=newsletter&utm_medium=email",
+      i % kNumHosts, i));
+}
+
+std::vector<GURL> VisitedURLs() {
+  std::vector<GURL> urls;
+  urls.reserve(kNumVisits);
+  for (int64_t i = 0; i < kNumVisits; ++i)
+    urls.push_back(URLForIndex(static_cast<int>((i * kRandomSeed) % kNumURLs)));
+  return urls;
+}
+
+void PrintResult(const std::string& measurement,
+                 const std::string& trace,
+                 double value,
+                 const std::string& units) {
+  perf_test::PrintResult(measurement, "", trace, value, units, true);
+}
+
+struct Visit {
+  GURL url;
+  Origin origin;
+};
+
+struct InternedVisit {
+  InternedURL url;
+};
+
+TEST(InternedURLPerfTest, HistoryWorkingSet) {
+  std::vector<GURL> urls = VisitedURLs();
+
+  std::vector<Visit> visits;
+  visits.reserve(kNumVisits);
+  for (const GURL& url : urls)
+    visits.push_back({url, Origin::Create(url)});
+  size_t visits_usage = visits.capacity() * sizeof(Visit);
+  for (const Visit& visit : visits) {
+    visits_usage +=
+        visit.url.EstimateMemoryUsage() +
+        base::trace_event::EstimateMemoryUsage(visit.origin.scheme()) +
+        base::trace_event::EstimateMemoryUsage(visit.origin.host());
+  }
+  PrintResult("history_working_set", "gurl_and_origin", visits_usage, "bytes");
+  visits.clear();
+  visits.shrink_to_fit();
+
+  size_t shared_usage_before = InternedURL::EstimateSharedMemoryUsage();
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::vector<InternedVisit> interned_visits;
+  interned_visits.reserve(kNumVisits);
+  for (const GURL& url : urls)
+    interned_visits.push_back({InternedURL(url)});
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  size_t interned_usage = interned_visits.capacity() * sizeof(InternedVisit) +
+                          InternedURL::EstimateSharedMemoryUsage() -
+                          shared_usage_before;
+  PrintResult("history_working_set", "interned_url", interned_usage, "bytes");
+  PrintResult("intern", "throughput", kNumVisits / elapsed.InSecondsF(),
+              "urls/s");
+
+  // Every visit to the same URL shares the same data, so comparing them is a
+  // pointer comparison.
+  start = base::TimeTicks::Now();
+  int matches = 0;
+  for (int i = 1; i < kNumVisits; ++i) {
+    if (interned_visits[i].url == interned_visits[i - 1].url)
+      ++matches;
+  }
+  elapsed = base::TimeTicks::Now() - start;
+  EXPECT_EQ(0, matches);
+  PrintResult("compare", "throughput", (kNumVisits - 1) / elapsed.InSecondsF(),
+              "comparisons/s");
+}
+
+}  // namespace
+
+}  // namespace url
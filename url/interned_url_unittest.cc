@@ -0,0 +1,103 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/interned_url.h"
+
+#include <unordered_set>
+
+#include "base/strings/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace url {
+
+namespace {
+
+TEST(InternedURLTest, Empty) {
+  InternedURL empty;
+  EXPECT_TRUE(empty.is_empty());
+  EXPECT_TRUE(empty.url().is_empty());
+  EXPECT_TRUE(empty.has_opaque_origin());
+  EXPECT_TRUE(empty.CreateOrigin().opaque());
+  EXPECT_EQ(empty, InternedURL(GURL()));
+}
+
+TEST(InternedURLTest, SharesDataForEqualURLs) {
+  GURL url("https://www.example.com/path?query#ref");
+  InternedURL interned1(url);
+  InternedURL interned2(GURL("HTTPS://www.EXAMPLE.com/path?query#ref"));
+  InternedURL other(GURL("https://www.example.com/other"));
+
+  EXPECT_EQ(url, interned1.url());
+  ASSERT_FALSE(interned1.has_opaque_origin());
+  EXPECT_EQ(Origin::Create(url), interned1.origin());
+  EXPECT_EQ(Origin::Create(url), interned1.CreateOrigin());
+  EXPECT_EQ(interned1, interned2);
+  EXPECT_EQ(&interned1.url(), &interned2.url());
+  EXPECT_EQ(&interned1.origin(), &interned2.origin());
+  EXPECT_NE(interned1, other);
+  EXPECT_EQ(InternedURLHash()(interned1), InternedURLHash()(interned2));
+
+  // Copies share the data as well.
+  InternedURL copy = interned1;
+  EXPECT_EQ(&interned1.url(), &copy.url());
+}
+
+TEST(InternedURLTest, InvalidURL) {
+  GURL invalid("http://[bad");
+  ASSERT_FALSE(invalid.is_valid());
+  InternedURL interned(invalid);
+  EXPECT_FALSE(interned.is_empty());
+  EXPECT_FALSE(interned.url().is_valid());
+  EXPECT_EQ(invalid.possibly_invalid_spec(),
+            interned.url().possibly_invalid_spec());
+  EXPECT_TRUE(interned.has_opaque_origin());
+  EXPECT_TRUE(interned.CreateOrigin().opaque());
+}
+
+// Opaque origins get a fresh nonce each time, as from Origin::Create().
+TEST(InternedURLTest, OpaqueOriginsAreNotShared) {
+  GURL url("data:text/html,<p>hello</p>");
+  InternedURL interned1(url);
+  InternedURL interned2(url);
+  ASSERT_EQ(interned1, interned2);
+  ASSERT_TRUE(interned1.has_opaque_origin());
+  EXPECT_FALSE(
+      interned1.CreateOrigin().IsSameOriginWith(interned2.CreateOrigin()));
+  EXPECT_FALSE(
+      interned1.CreateOrigin().IsSameOriginWith(interned1.CreateOrigin()));
+
+  InternedURL blank1(GURL("about:blank"));
+  InternedURL blank2(GURL("about:blank"));
+  EXPECT_FALSE(blank1.CreateOrigin().IsSameOriginWith(blank2.CreateOrigin()));
+
+  EXPECT_FALSE(InternedURL().CreateOrigin().IsSameOriginWith(
+      InternedURL().CreateOrigin()));
+}
+
+TEST(InternedURLTest, UnorderedSet) {
+  std::unordered_set<InternedURL, InternedURLHash> set;
+  set.insert(InternedURL(GURL("https://a.test/")));
+  set.insert(InternedURL(GURL("https://b.test/")));
+  set.insert(InternedURL(GURL("https://a.test/")));
+  EXPECT_EQ(2u, set.size());
+  EXPECT_EQ(1u, set.count(InternedURL(GURL("https://b.test/"))));
+}
+
+// Unreferenced URLs are eventually freed, while referenced ones stay interned.
+TEST(InternedURLTest, FreesUnreferencedURLs) {
+  InternedURL kept(GURL("https://kept.test/"));
+  const GURL* kept_url = &kept.url();
+
+  for (int i = 0; i < 10000; ++i)
+    InternedURL(GURL(base::StringPrintf("https://freed.test/%d", i)));
+  EXPECT_LT(InternedURL::GetInternedCountForTesting(), 10000u);
+
+  EXPECT_EQ(kept_url, &InternedURL(GURL("https://kept.test/")).url());
+}
+
+}  // namespace
+
+}  // namespace url
@@ -118,7 +118,17 @@ bool DoScheme(const CHAR* spec,
   // schemes to be incorrect.
   bool success = true;
   int end = scheme.end();
-  for (int i = scheme.begin; i < end; i++) {
+  int i = scheme.begin;
+
+  // Copy the leading run of characters that are already canonical in one go.
+  // This needs the first character to be a valid one, i.e. a letter.
+  UCHAR first_ch = static_cast<UCHAR>(spec[i]);
+  if (first_ch >= 'a' && first_ch <= 'z') {
+    i = FindEndOfPlainRun(spec, i, end, PLAIN_SCHEME);
+    AppendPlainRun(spec, scheme.begin, i, output);
+  }
+
+  for (; i < end; i++) {
     UCHAR ch = static_cast<UCHAR>(spec[i]);
     char replacement = 0;
     if (ch < 0x80) {
@@ -131,6 +131,15 @@ bool DoSimpleHost(const INCHAR* host,
 
   bool success = true;
   for (int i = 0; i < host_len; ++i) {
+    // Copy any run of characters that are already canonical in one go.
+    int plain_end = FindEndOfPlainRun(host, i, host_len, PLAIN_HOST);
+    if (plain_end > i) {
+      AppendPlainRun(host, i, plain_end, output);
+      i = plain_end;
+      if (i == host_len)
+        break;
+    }
+
     unsigned int source = host[i];
     if (source == '%') {
       // Unescape first, if possible.
@@ -6,12 +6,19 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <cstdio>
 #include <string>
 
+#include "base/bits.h"
 #include "base/strings/utf_string_conversion_utils.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace url {
 
@@ -61,6 +68,141 @@ void DoAppendInvalidNarrowString(const CHAR* spec, int begin, int end,
   }
 }
 
+inline bool IsInRange(unsigned c, unsigned lo, unsigned hi) {
+  return c >= lo && c <= hi;
+}
+
+// Returns true if |c| is of the given PlainCharType. These must accept exactly
+// the characters PlainBytes() below does.
+template <PlainCharType type>
+bool IsPlainChar(unsigned c);
+
+template <>
+inline bool IsPlainChar<PLAIN_SCHEME>(unsigned c) {
+  return IsInRange(c, 'a', 'z') || IsInRange(c, '0', '9') || c == '+' ||
+         c == '-' || c == '.';
+}
+
+template <>
+inline bool IsPlainChar<PLAIN_HOST>(unsigned c) {
+  return IsInRange(c, 'a', 'z') || IsInRange(c, '0', '9') || c == '-' ||
+         c == '.';
+}
+
+template <>
+inline bool IsPlainChar<PLAIN_PATH>(unsigned c) {
+  // '/' to ';' covers the digits and ':'.
+  return IsInRange(c | 0x20, 'a', 'z') || IsInRange(c, '/', ';') ||
+         c == '=' || c == '_' || c == '-';
+}
+
+template <>
+inline bool IsPlainChar<PLAIN_QUERY>(unsigned c) {
+  // '(' to ';' covers the digits and ")*+,-./:".
+  return IsInRange(c | 0x20, 'a', 'z') || IsInRange(c, '(', ';') ||
+         c == '%' || c == '&' || c == '=' || c == '_';
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// Returns a mask of the bytes of |v| in [lo, hi]. The comparisons are signed,
+// so bytes with the high bit set never match.
+inline __m128i BytesInRange(__m128i v, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                       _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+
+inline __m128i BytesEqual(__m128i v, char c) {
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+// Returns a mask of the letters of either case in |v|. Setting the 0x20 bit
+// maps upper case letters onto lower case ones, and no other byte onto a
+// letter.
+inline __m128i Letters(__m128i v) {
+  return BytesInRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+}
+
+// Returns a mask of the bytes of |v| of the given PlainCharType.
+template <PlainCharType type>
+__m128i PlainBytes(__m128i v);
+
+template <>
+inline __m128i PlainBytes<PLAIN_SCHEME>(__m128i v) {
+  return _mm_or_si128(
+      _mm_or_si128(BytesInRange(v, 'a', 'z'), BytesInRange(v, '0', '9')),
+      _mm_or_si128(BytesEqual(v, '+'),
+                   _mm_or_si128(BytesEqual(v, '-'), BytesEqual(v, '.'))));
+}
+
+template <>
+inline __m128i PlainBytes<PLAIN_HOST>(__m128i v) {
+  return _mm_or_si128(
+      _mm_or_si128(BytesInRange(v, 'a', 'z'), BytesInRange(v, '0', '9')),
+      _mm_or_si128(BytesEqual(v, '-'), BytesEqual(v, '.')));
+}
+
+template <>
+inline __m128i PlainBytes<PLAIN_PATH>(__m128i v) {
+  return _mm_or_si128(
+      _mm_or_si128(Letters(v), BytesInRange(v, '/', ';')),
+      _mm_or_si128(BytesEqual(v, '='),
+                   _mm_or_si128(BytesEqual(v, '_'), BytesEqual(v, '-'))));
+}
+
+template <>
+inline __m128i PlainBytes<PLAIN_QUERY>(__m128i v) {
+  return _mm_or_si128(
+      _mm_or_si128(Letters(v), BytesInRange(v, '(', ';')),
+      _mm_or_si128(_mm_or_si128(BytesEqual(v, '%'), BytesEqual(v, '&')),
+                   _mm_or_si128(BytesEqual(v, '='), BytesEqual(v, '_'))));
+}
+
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+template <PlainCharType type>
+int DoFindEndOfPlainRun(const char* spec, int begin, int end) {
+  int i = begin;
+#if defined(ARCH_CPU_X86_FAMILY)
+  for (; end - i >= 16; i += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&spec[i]));
+    uint32_t plain = _mm_movemask_epi8(PlainBytes<type>(block));
+    if (plain != 0xffff)
+      return i + base::bits::CountTrailingZeroBits(~plain);
+  }
+#endif
+  while (i < end && IsPlainChar<type>(static_cast<unsigned char>(spec[i])))
+    i++;
+  return i;
+}
+
+template <PlainCharType type>
+int DoFindEndOfPlainRun(const base::char16* spec, int begin, int end) {
+  int i = begin;
+  while (i < end && IsPlainChar<type>(spec[i]))
+    i++;
+  return i;
+}
+
+template <typename CHAR>
+int DoFindEndOfPlainRunOfType(const CHAR* spec,
+                              int begin,
+                              int end,
+                              PlainCharType type) {
+  switch (type) {
+    case PLAIN_SCHEME:
+      return DoFindEndOfPlainRun<PLAIN_SCHEME>(spec, begin, end);
+    case PLAIN_HOST:
+      return DoFindEndOfPlainRun<PLAIN_HOST>(spec, begin, end);
+    case PLAIN_PATH:
+      return DoFindEndOfPlainRun<PLAIN_PATH>(spec, begin, end);
+    case PLAIN_QUERY:
+      return DoFindEndOfPlainRun<PLAIN_QUERY>(spec, begin, end);
+  }
+  NOTREACHED();
+  return begin;
+}
+
 // Overrides one component, see the Replacements structure for
 // what the various combionations of source pointer and component mean.
 void DoOverrideComponent(const char* override_source,
@@ -248,6 +390,20 @@ void AppendStringOfType(const base::char16* source, int length,
       source, length, type, output);
 }
 
+int FindEndOfPlainRun(const char* spec,
+                      int begin,
+                      int end,
+                      PlainCharType type) {
+  return DoFindEndOfPlainRunOfType(spec, begin, end, type);
+}
+
+int FindEndOfPlainRun(const base::char16* spec,
+                      int begin,
+                      int end,
+                      PlainCharType type) {
+  return DoFindEndOfPlainRunOfType(spec, begin, end, type);
+}
+
 bool ReadUTFChar(const char* str, int* begin, int length,
                  unsigned* code_point_out) {
   // This depends on ints and int32s being the same thing. If they're not, it
@@ -83,6 +83,53 @@ void AppendStringOfType(const base::char16* source, int length,
                         SharedCharTypes type,
                         CanonOutput* output);
 
+// Bulk-copy fast path ---------------------------------------------------------
+
+// Classes of characters that a canonicalizer copies to its output unchanged:
+// no escaping, unescaping, case folding or other special handling. Each class
+// covers the common characters of its component, not all of them, so callers
+// must still handle any other character the slow way.
+enum PlainCharType {
+  // [a-z0-9+-.]
+  PLAIN_SCHEME,
+
+  // [a-z0-9-.]
+  PLAIN_HOST,
+
+  // [a-zA-Z0-9/:;=_-]. Dots are excluded since they may start a "." or ".."
+  // path segment.
+  PLAIN_PATH,
+
+  // [a-zA-Z0-9%&()*+,./:;=_-]
+  PLAIN_QUERY,
+};
+
+// Returns the index of the first character at or after |begin| in |spec| that
+// is not of the given |type|, or |end| if there is none. 8-bit input is
+// classified 16 bytes at a time where SSE2 is available.
+int FindEndOfPlainRun(const char* spec, int begin, int end, PlainCharType type);
+int FindEndOfPlainRun(const base::char16* spec,
+                      int begin,
+                      int end,
+                      PlainCharType type);
+
+// Appends the characters in [begin, end) of |spec|, which must all have been
+// found to be plain by FindEndOfPlainRun, to |output|.
+template <typename CHAR, typename OUTCHAR>
+inline void AppendPlainRun(const CHAR* spec,
+                           int begin,
+                           int end,
+                           CanonOutputT<OUTCHAR>* output) {
+  for (int i = begin; i < end; i++)
+    output->push_back(static_cast<OUTCHAR>(spec[i]));
+}
+inline void AppendPlainRun(const char* spec,
+                           int begin,
+                           int end,
+                           CanonOutput* output) {
+  output->Append(&spec[begin], end - begin);
+}
+
 // Maps the hex numerical values 0x0 to 0xf to the corresponding ASCII digit
 // that will be used to represent it.
 COMPONENT_EXPORT(URL) extern const char kHexCharLookup[0x10];
@@ -261,6 +261,15 @@ bool DoPartialPath(const CHAR* spec,
 
   bool success = true;
   for (int i = path.begin; i < end; i++) {
+    // Copy any run of characters that need no special handling in one go.
+    int plain_end = FindEndOfPlainRun(spec, i, end, PLAIN_PATH);
+    if (plain_end > i) {
+      AppendPlainRun(spec, i, plain_end, output);
+      i = plain_end;
+      if (i == end)
+        break;
+    }
+
     UCHAR uch = static_cast<UCHAR>(spec[i]);
     if (sizeof(CHAR) > 1 && uch >= 0x80) {
       // We only need to test wide input for having non-ASCII characters. For
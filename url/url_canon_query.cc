@@ -59,6 +59,15 @@ template<typename CHAR>
 void AppendRaw8BitQueryString(const CHAR* source, int length,
                               CanonOutput* output) {
   for (int i = 0; i < length; i++) {
+    // Copy any run of common characters that need no escaping in one go.
+    int plain_end = FindEndOfPlainRun(source, i, length, PLAIN_QUERY);
+    if (plain_end > i) {
+      AppendPlainRun(source, i, plain_end, output);
+      i = plain_end;
+      if (i == length)
+        break;
+    }
+
     if (!IsQueryChar(static_cast<unsigned char>(source[i])))
       AppendEscapedChar(static_cast<unsigned char>(source[i]), output);
     else  // Doesn't need escaping.
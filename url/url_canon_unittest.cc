@@ -1238,6 +1238,12 @@ TEST(URLCanonTest, Query) {
     {"q=<asdf>", L"q=<asdf>", "?q=%3Casdf%3E"},
       // Escape double quotemarks in the query.
     {"q=\"asdf\"", L"q=\"asdf\"", "?q=%22asdf%22"},
+      // Characters to escape past the first 16, and after long runs of ones
+      // that need no escaping.
+    {"utm_source=newsletter&q=<a b>&utm_medium=email&utm_campaign=spring",
+     L"utm_source=newsletter&q=<a b>&utm_medium=email&utm_campaign=spring",
+     "?utm_source=newsletter&q=%3Ca%20b%3E&utm_medium=email&"
+     "utm_campaign=spring"},
   };
 
   for (size_t i = 0; i < base::size(query_cases); i++) {
@@ -1280,6 +1286,50 @@ TEST(URLCanonTest, Query) {
   EXPECT_EQ("?a%20%00z%01", out_str);
 }
 
+TEST(URLCanonTest, FindEndOfPlainRun) {
+  struct PlainRunCase {
+    const char* input;
+    PlainCharType type;
+    int expected_end;
+  } plain_run_cases[] = {
+    {"", PLAIN_PATH, 0},
+    {"http", PLAIN_SCHEME, 4},
+    {"HTTP", PLAIN_SCHEME, 0},
+    {"chrome-extension", PLAIN_SCHEME, 16},
+    {"www.example.com", PLAIN_HOST, 15},
+    {"www.subdomain.example.Com", PLAIN_HOST, 22},
+    {"www.subdomain.example.com:443", PLAIN_HOST, 25},
+    {"/Path/To/Some/Resource/index.html", PLAIN_PATH, 28},
+    {"/path/to/some/resource\\index", PLAIN_PATH, 22},
+    {"/path/to/some/resource%20with%20spaces", PLAIN_PATH, 22},
+    {"/path/to/some/resource/\xc3\xa9t\xc3\xa9", PLAIN_PATH, 23},
+    {"q=url+canonicalization&ie=UTF-8", PLAIN_QUERY, 31},
+    {"q=url+canonicalization&ie=UTF-8#ref", PLAIN_QUERY, 31},
+    {"q=url+canonicalization&ie=UTF-8&x=\"y\"", PLAIN_QUERY, 34},
+  };
+
+  for (const auto& test_case : plain_run_cases) {
+    SCOPED_TRACE(test_case.input);
+    int len = static_cast<int>(strlen(test_case.input));
+    EXPECT_EQ(test_case.expected_end,
+              FindEndOfPlainRun(test_case.input, 0, len, test_case.type));
+
+    base::string16 input16(base::UTF8ToUTF16(test_case.input));
+    // The UTF-16 input is shorter wherever the UTF-8 one has multi-byte
+    // characters, but those always end a run.
+    EXPECT_EQ(test_case.expected_end,
+              FindEndOfPlainRun(input16.c_str(), 0,
+                                static_cast<int>(input16.length()),
+                                test_case.type));
+  }
+
+  // Runs may start anywhere, and never extend past |end|.
+  const char kPath[] = "/path/to/some/resource/index.html";
+  EXPECT_EQ(28, FindEndOfPlainRun(kPath, 5, 33, PLAIN_PATH));
+  EXPECT_EQ(33, FindEndOfPlainRun(kPath, 29, 33, PLAIN_PATH));
+  EXPECT_EQ(20, FindEndOfPlainRun(kPath, 3, 20, PLAIN_PATH));
+}
+
 TEST(URLCanonTest, Ref) {
   // Refs are trivial, it just checks the encoding.
   DualComponentCase ref_cases[] = {
@@ -2,9 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+
+#include "base/stl_util.h"
 #include "base/strings/string_piece.h"
 #include "base/test/perf_time_logger.h"
+#include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "url/gurl.h"
 #include "url/third_party/mozilla/url_parse.h"
 #include "url/url_canon.h"
@@ -132,4 +137,138 @@ TEST(URLParse, GURL) {
   gurl_timer.Done();
 }
 
+// A sample of URLs as seen by the loading stack of a browser: documents,
+// subresources from CDNs, ad and analytics beacons with long queries, and the
+// occasional URL that needs real canonicalization work.
+constexpr base::StringPiece kCorpus[] = {
+    "https://www.google.com/",
+    "https://www.google.com/search?q=url+canonicalization&oq=url+canon&"
+    "aqs=chrome..69i57j0l5.2817j0j7&sourceid=chrome&ie=UTF-8",
+    "https://www.gstatic.com/og/_/js/k=og.og2.en_US.pvJrxLHtDSk.O/rt=j/m=def/"
+    "exm=in,fot/d=1/ed=1/rs=AA2YrTtrA2PzmhYtgsxpZx9Oj2Y5eCmDXw",
+    "https://en.wikipedia.org/wiki/Uniform_Resource_Locator",
+    "https://upload.wikimedia.org/wikipedia/commons/thumb/d/d6/"
+    "URI_syntax_diagram.svg/1200px-URI_syntax_diagram.svg.png",
+    "https://fonts.googleapis.com/css?family=Roboto:300,400,500,700&"
+    "display=swap",
+    "https://cdn.jsdelivr.net/npm/bootstrap@4.3.1/dist/js/bootstrap.min.js",
+    "https://www.amazon.com/Stephen-King-Thrillers-Horror-People/dp/0766012336/"
+    "ref=sr_1_2/133-4144931-4505264?ie=UTF8&s=books&qid=2144880915&sr=8-2",
+    "https://images-na.ssl-images-amazon.com/images/I/"
+    "51Zymoq7UnL._AC_SY400_.jpg",
+    "https://www.facebook.com/tr/?id=1234567890123456&ev=PageView&"
+    "dl=https%3A%2F%2Fexample.com%2Farticle%2F2019%2F03%2F05&rl=&"
+    "if=false&ts=1551808344000&v=2.8.40",
+    "https://www.google-analytics.com/collect?v=1&_v=j73&a=1745326574&"
+    "t=pageview&_s=1&dl=https%3A%2F%2Fexample.com%2F&ul=en-us&de=UTF-8&"
+    "dt=Example%20Domain&sd=24-bit&sr=1920x1080&vp=1903x937&je=0&"
+    "_u=AACAAEAB~&jid=&gjid=&cid=1234567890.1551808344&tid=UA-12345678-1",
+    "https://securepubads.g.doubleclick.net/gampad/ads?gdfp_req=1&"
+    "pvsid=3528316447916519&correlator=4146718426853432&output=ldjh&"
+    "impl=fifs&adsid=ChEI8PbD5AUQ&sz=300x250|728x90",
+    "https://github.com/chromium/chromium/blob/master/url/url_canon_path.cc",
+    "https://stackoverflow.com/questions/1547899/"
+    "which-characters-make-a-url-invalid",
+    "https://www.youtube.com/watch?v=dQw4w9WgXcQ&list=RDdQw4w9WgXcQ&t=42s",
+    "https://news.ycombinator.com/item?id=19307118",
+    "https://twitter.com/search?q=%23chromium&src=typed_query&f=live",
+    "http://store.apple.com/1-800-MY-APPLE/WebObjects/AppleStore.woa/wa/"
+    "RSLID?nnmm=browse&mco=578E9744&node=home/desktop/mac_pro",
+    "HTTP://WWW.EXAMPLE.COM/Path/To/../Resource.html?Query=Value",
+    "https://example.com/a%20b/./c/%7Euser/file name.txt?x=\"quoted\"",
+    "http://192.168.0.1:8080/cgi-bin/status.cgi?refresh=5",
+    "https://xn--nxasmq6b.com/%CE%B1%CE%B2%CE%B3/index.html",
+};
+
+// Number of times each benchmark canonicalizes the whole corpus.
+constexpr int kCorpusIterations = 50000;
+
+void PrintURLsPerSecond(const std::string& trace, base::TimeDelta elapsed) {
+  perf_test::PrintResult(
+      "url_canon", "", trace,
+      kCorpusIterations * base::size(kCorpus) / elapsed.InSecondsF(), "urls/s",
+      true);
+}
+
+// Parses and canonicalizes every URL in the corpus, with no mallocs.
+TEST(URLParse, CorpusParseCanon) {
+  url::Parsed parsed;
+  url::Parsed out_parsed;
+  url::RawCanonOutput<1024> output;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kCorpusIterations; i++) {
+    for (base::StringPiece url : kCorpus) {
+      url::ParseStandardURL(url.data(), url.size(), &parsed);
+      output.set_length(0);
+      url::CanonicalizeStandardURL(
+          url.data(), url.size(), parsed,
+          url::SCHEME_WITH_HOST_PORT_AND_USER_INFORMATION, nullptr, &output,
+          &out_parsed);
+    }
+  }
+  PrintURLsPerSecond("parse_canon", base::TimeTicks::Now() - start);
+}
+
+// Canonicalizes each of the components with a bulk-copy fast path separately,
+// so a regression in one of them stands out.
+TEST(URLParse, CorpusComponentCanon) {
+  url::Parsed parsed[base::size(kCorpus)];
+  for (size_t i = 0; i < base::size(kCorpus); i++)
+    url::ParseStandardURL(kCorpus[i].data(), kCorpus[i].size(), &parsed[i]);
+
+  url::Component out_component;
+  url::RawCanonOutput<1024> output;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kCorpusIterations; i++) {
+    for (size_t j = 0; j < base::size(kCorpus); j++) {
+      output.set_length(0);
+      url::CanonicalizeScheme(kCorpus[j].data(), parsed[j].scheme, &output,
+                              &out_component);
+    }
+  }
+  PrintURLsPerSecond("scheme", base::TimeTicks::Now() - start);
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kCorpusIterations; i++) {
+    for (size_t j = 0; j < base::size(kCorpus); j++) {
+      output.set_length(0);
+      url::CanonicalizeHost(kCorpus[j].data(), parsed[j].host, &output,
+                            &out_component);
+    }
+  }
+  PrintURLsPerSecond("host", base::TimeTicks::Now() - start);
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kCorpusIterations; i++) {
+    for (size_t j = 0; j < base::size(kCorpus); j++) {
+      output.set_length(0);
+      url::CanonicalizePath(kCorpus[j].data(), parsed[j].path, &output,
+                            &out_component);
+    }
+  }
+  PrintURLsPerSecond("path", base::TimeTicks::Now() - start);
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kCorpusIterations; i++) {
+    for (size_t j = 0; j < base::size(kCorpus); j++) {
+      output.set_length(0);
+      url::CanonicalizeQuery(kCorpus[j].data(), parsed[j].query, nullptr,
+                             &output, &out_component);
+    }
+  }
+  PrintURLsPerSecond("query", base::TimeTicks::Now() - start);
+}
+
+// Constructs a GURL for every URL in the corpus.
+TEST(URLParse, CorpusGURL) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kCorpusIterations; i++) {
+    for (base::StringPiece url : kCorpus)
+      GURL gurl(url);
+  }
+  PrintURLsPerSecond("gurl", base::TimeTicks::Now() - start);
+}
+
 }  // namespace